@@ -0,0 +1,46 @@
+#pragma once
+
+#include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// One I2S reader task fills a single-producer ring of 16-bit samples. Every
+// listener keeps its own read cursor, so each one gets the full sample stream.
+// The task stops reading I2S while no listener is attached.
+typedef struct
+{
+    int id;
+    uint32_t cursor;    // Absolute sample position of the next read
+    uint32_t overruns;  // Times this listener fell a full ring behind and skipped to the live edge
+    uint32_t underruns; // Reads that timed out waiting for the next block
+} audio_listener_t;
+
+typedef struct
+{
+    uint32_t blocks;      // Blocks read from I2S
+    uint32_t read_errors; // Failed or short i2s_read calls
+    uint32_t overruns;    // Summed over all listeners, past and present
+    uint32_t underruns;
+    uint8_t listeners;
+} audio_capture_stats_t;
+
+// i2s_events is the queue given to i2s_driver_install(), or NULL; the task
+// drains it to count the DMA buffers the driver dropped.
+esp_err_t audio_capture_start(QueueHandle_t i2s_events);
+
+// Joins at the live edge. Fails with ESP_ERR_NO_MEM when AUDIO_MAX_LISTENERS
+// are attached, and with ESP_ERR_INVALID_STATE when capture is not running.
+esp_err_t audio_listener_attach(audio_listener_t *listener);
+void audio_listener_detach(audio_listener_t *listener);
+
+// Copies up to max_samples. Waits up to timeout when nothing new is
+// available; returns 0 if nothing arrived in time.
+size_t audio_listener_read(audio_listener_t *listener, int16_t *out, size_t max_samples, TickType_t timeout);
+
+// Samples ready for this listener, for callers that poll instead of waiting
+// in audio_listener_read(). May exceed the ring size after an overrun.
+size_t audio_listener_available(const audio_listener_t *listener);
+
+void audio_capture_get_stats(audio_capture_stats_t *stats);
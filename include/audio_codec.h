@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define WAVE_FORMAT_PCM 0x0001
+#define WAVE_FORMAT_MULAW 0x0007
+#define WAVE_FORMAT_IMA_ADPCM 0x0011
+
+#define ADPCM_BLOCK_ALIGN 256                                    // Bytes per mono IMA-ADPCM block
+#define ADPCM_SAMPLES_PER_BLOCK ((ADPCM_BLOCK_ALIGN - 4) * 2 + 1) // Header sample plus two per byte
+
+typedef struct audio_encoder audio_encoder_t;
+
+// Encodes 16-bit mono PCM between i2s_read() and the socket. Selected by
+// name with ?codec= on the audio stream.
+typedef struct
+{
+    const char *name;
+    uint16_t format_tag; // WAVE_FORMAT_* written into the WAV fmt chunk
+    uint16_t bits_per_sample;
+    uint16_t block_align;
+    uint16_t samples_per_block;
+    size_t (*encode)(audio_encoder_t *encoder, const int16_t *in, size_t samples, uint8_t *out);
+} audio_codec_t;
+
+struct audio_encoder
+{
+    const audio_codec_t *codec;
+
+    // IMA-ADPCM: samples are buffered until a full block can be written
+    int32_t predictor;
+    int8_t step_index;
+    uint16_t pending_count;
+    int16_t pending[ADPCM_SAMPLES_PER_BLOCK];
+};
+
+extern const audio_codec_t audio_codec_pcm;
+extern const audio_codec_t audio_codec_ulaw;
+extern const audio_codec_t audio_codec_adpcm;
+
+// Returns NULL for unknown names.
+const audio_codec_t *audio_codec_find(const char *name);
+
+void audio_encoder_init(audio_encoder_t *encoder, const audio_codec_t *codec);
+
+// Upper bound of encoded bytes for a call to audio_encoder_encode() with this many samples.
+size_t audio_encoder_max_output(const audio_encoder_t *encoder, size_t samples);
+
+// Returns the number of bytes written to out.
+size_t audio_encoder_encode(audio_encoder_t *encoder, const int16_t *in, size_t samples, uint8_t *out);
+
+uint8_t ulaw_encode_sample(int16_t sample);
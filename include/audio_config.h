@@ -7,4 +7,12 @@
 #define SAMPLE_RATE 16000 // Sample rate of the audio
 #define SAMPLE_BITS 16    // Bits per sample of the audio
 #define DMA_BUF_COUNT 2
-#define DMA_BUF_LEN 1024
\ No newline at end of file
+#define DMA_BUF_LEN 1024
+
+#define AUDIO_BLOCK_SAMPLES (DMA_BUF_LEN / 2) // Samples per i2s_read, DMA_BUF_LEN bytes of 16 bit audio
+#define AUDIO_RING_SAMPLES 16384             // Shared capture ring, about one second; must be a power of two
+#define AUDIO_MAX_LISTENERS 4
+
+#define AUDIO_TASK_CORE 1
+#define AUDIO_TASK_PRIORITY 6
+#define AUDIO_TASK_STACK 4096
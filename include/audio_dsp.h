@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// In-place processing of every captured block, in this order: DC blocker,
+// biquad high-pass, noise gate and automatic gain control. All kernels are
+// fixed point; coefficients are only recomputed when a parameter changes.
+typedef struct
+{
+    bool dc_block;
+    bool highpass;
+    uint16_t highpass_hz;
+    bool agc;
+    uint8_t agc_target;   // Output level the AGC aims for, in dB below full scale
+    uint8_t agc_max_gain; // dB
+    bool gate;
+    uint8_t gate_threshold; // Blocks quieter than this many dB below full scale are muted
+} audio_dsp_params_t;
+
+void audio_dsp_init();
+
+// Both run on the audio capture task, filter first. Level metering sits in
+// between so that it sees the signal before the gate and AGC reshape it.
+void audio_dsp_filter(int16_t *samples, size_t count);
+void audio_dsp_gain(int16_t *samples, size_t count);
+
+// Sets one of the audio_* /control variables. Returns -1 for an unknown name
+// or a value out of range, like the sensor setters do.
+int audio_dsp_set(const char *name, int value);
+void audio_dsp_get_params(audio_dsp_params_t *params);
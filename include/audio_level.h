@@ -0,0 +1,39 @@
+#pragma once
+
+#include <esp_http_server.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SOUND_THRESHOLD_DEFAULT 30 // dB below full scale
+#define SOUND_HYSTERESIS_DB 3      // The level must fall this far below the threshold to end a sound event
+#define SOUND_HOLD_MS 500          // and stay there this long
+
+// Levels of the most recent audio block, measured after the DC blocker and
+// high-pass filter but before the gate and AGC.
+typedef struct
+{
+    uint16_t rms;
+    uint16_t peak;
+    int16_t dbfs;            // RMS level, -96 for silence
+    int16_t noise_floor;     // Slowly tracked quiet level, dBFS
+    uint16_t zero_crossings; // Per block
+    bool voice;              // Speech-like: well above the noise floor with a low zero-crossing rate
+    bool sound;              // Above the sound event threshold
+    int64_t timestamp;
+} audio_level_t;
+
+// Runs on the audio capture task for every block. Posts EVENT_SOUND events
+// when the level crosses the sound threshold.
+void audio_level_update(const int16_t *samples, size_t count);
+
+// True when sound events are enabled, in which case the capture task keeps
+// reading even with no listener attached.
+bool audio_level_detecting();
+
+void audio_level_get(audio_level_t *level);
+
+// Sets audio_sound_threshold, in dB below full scale; 0 disables sound events.
+int audio_level_set(const char *name, int value);
+
+// Handler for /audio/level
+esp_err_t audio_level_handler(httpd_req_t *req);
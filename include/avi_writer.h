@@ -0,0 +1,80 @@
+#pragma once
+
+#include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define AVI_BUFFER_SIZE (16 * 1024)             // Per write buffer; a whole number of 512 byte sectors
+#define AVI_HEADER_SIZE 512                     // Headers fill exactly the first sector, frame data starts after it
+#define AVI_MOVI_OFFSET (AVI_HEADER_SIZE - 4)   // The 'movi' fourcc, which idx1 offsets count from
+#define AVI_PREALLOCATE_BYTES (32 * 1024 * 1024) // Clusters reserved at open so the FAT is not extended on every write
+#define AVI_CHECKPOINT_FRAMES 75                // Rewrite the headers this often, 5 s at 15 fps
+#define AVI_MAX_FRAMES 36000                    // 40 min at 15 fps
+#define AVI_MAX_BYTES (1000UL * 1024 * 1024)    // Stay under the 1 GB AVI 1.0 RIFF limit
+
+#define AVI_FLUSH_TASK_CORE 0
+#define AVI_FLUSH_TASK_PRIORITY 3
+#define AVI_FLUSH_TASK_STACK 3072
+
+typedef struct
+{
+    uint32_t ckid;
+    uint32_t flags;
+    uint32_t offset; // From the 'movi' fourcc
+    uint32_t size;
+} avi_index_entry_t;
+
+// Incremental MJPEG AVI writer with an optional 16 bit PCM audio track.
+//
+// Chunks are gathered in one of two AVI_BUFFER_SIZE buffers. A full buffer is
+// handed to a flush task and written at its file offset with pwrite() while
+// the other one fills, so every write to the card is a whole, sector aligned
+// buffer; only the tail at close is partial. The file is preallocated at
+// open and trimmed at close.
+//
+// The idx1 index is appended at close. Until then every AVI_CHECKPOINT_FRAMES
+// the header sector is rewritten with the sizes and frame counts of the data
+// already on the card, so after a power cut the file holds a valid, if
+// unindexed, AVI up to the last checkpoint.
+typedef struct
+{
+    int fd;
+    char path[96];
+    uint16_t width;
+    uint16_t height;
+    uint32_t audio_rate; // 0 for no audio track
+
+    uint8_t *buffers[2];
+    int active;
+    size_t fill;
+    uint64_t buffer_offset; // File offset of the active buffer
+
+    avi_index_entry_t *index;
+    uint32_t index_count;
+    uint32_t index_capacity;
+    uint32_t frames;
+    uint32_t audio_samples;
+    uint32_t max_frame;
+    int64_t first_timestamp;
+    int64_t last_timestamp;
+    uint32_t us_per_frame;
+    uint32_t index_offset; // Set by a successful close: file offset of the idx1 entries
+    uint32_t size;         // and the final file size
+
+    SemaphoreHandle_t flush_idle; // Taken while a buffer is being written
+    volatile uint64_t flushed;    // End of the data known to be on the card
+    volatile esp_err_t error;
+    uint8_t header[AVI_HEADER_SIZE];
+} avi_writer_t;
+
+esp_err_t avi_writer_open(avi_writer_t *writer, const char *path, uint32_t audio_rate);
+
+// The first frame also fixes the video size.
+esp_err_t avi_writer_add_frame(avi_writer_t *writer, const uint8_t *jpg, size_t len, int64_t timestamp);
+esp_err_t avi_writer_add_audio(avi_writer_t *writer, const int16_t *samples, size_t count);
+
+// Writes the index and final headers and closes the file. Also releases
+// everything after a failed write.
+esp_err_t avi_writer_close(avi_writer_t *writer);
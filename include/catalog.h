@@ -0,0 +1,46 @@
+#pragma once
+
+#include <esp_err.h>
+#include <stdint.h>
+
+#define CATALOG_DELETED 0x1 // The clip's file has been reclaimed; the record stays so indexes do not shift
+
+// One finished clip. Records are appended to CATALOG_PATH as clips close, so
+// the file is sorted by start time as long as the clock only moves forward.
+typedef struct
+{
+    int64_t start_ms;      // Wall-clock time of the first frame, ms since the epoch
+    uint32_t duration_ms;
+    uint32_t frames;
+    uint32_t bytes;        // File size
+    uint32_t index_offset; // File offset of the first idx1 entry
+    uint32_t us_per_frame;
+    uint32_t flags;        // CATALOG_DELETED
+    char name[16];         // File name without CLIP_DIR and extension
+} catalog_entry_t;
+
+esp_err_t catalog_init();
+
+// Appends a record. Clips recorded before the clock was set have no place in
+// a time index and are left out.
+esp_err_t catalog_add(const catalog_entry_t *entry);
+
+// Number of records. The first call after boot scans the file and builds the
+// in-RAM search fence.
+uint32_t catalog_count();
+
+// Number of records that start at or before ms; the one before that index is
+// the clip that may contain ms. O(log n): a binary search over the fence, then
+// one over the CATALOG_FENCE_STRIDE records it points at.
+uint32_t catalog_upper_bound(int64_t ms);
+
+// Flags the record of a reclaimed clip, found by its start time and name, so
+// listings and seeks skip it. ESP_ERR_NOT_FOUND for a clip that never made it
+// into the catalog, or one recorded while the clock ran backwards.
+esp_err_t catalog_mark_deleted(const char *name, int64_t start_ms);
+
+// Reads up to max records starting at first; returns how many were read.
+uint32_t catalog_read(uint32_t first, catalog_entry_t *entries, uint32_t max);
+
+// Wall-clock ms of an esp_timer_get_time() timestamp, or -1 while the clock is not set.
+int64_t catalog_wall_ms(int64_t timestamp);
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// One JPEG in the clip ring. Frames are numbered by a running id; the index
+// slot is id % max_frames.
+typedef struct
+{
+    uint32_t offset; // Into the data buffer
+    uint32_t len;
+    int64_t timestamp;
+} clip_frame_t;
+
+// Pre-event ring. Frames are stored back to back in one byte buffer, so the
+// pre-roll is bounded by bytes rather than by a frame count: large frames
+// just mean fewer of them. The oldest frames are evicted once they fall out
+// of the pre-roll window or their space is needed, except frames pinned for
+// a clip that is still being written; when only those are left, the new
+// frame is dropped instead.
+//
+// Single producer (clip_ring_push), single flushing consumer. Frame data is
+// copied outside the lock, the index is only touched under it.
+typedef struct
+{
+    uint8_t *buf;
+    size_t size;
+    clip_frame_t *frames;
+    uint16_t max_frames;
+    uint32_t first; // Id of the oldest stored frame
+    uint32_t next;  // Id the next pushed frame gets
+    bool pinning;
+    uint32_t pin;   // With pinning set, frames from this id on may not be evicted
+    size_t head;    // Offset where the next frame goes if it fits
+    size_t bytes;   // JPEG bytes currently stored
+
+    uint32_t pushed;
+    uint32_t dropped;        // Frames refused because pinned frames held the space
+    uint32_t evicted_budget; // Frames evicted early to make room
+    uint32_t evicted_age;    // Frames that aged out of the pre-roll window
+    portMUX_TYPE lock;
+} clip_ring_t;
+
+esp_err_t clip_ring_init(clip_ring_t *ring, size_t budget, uint16_t max_frames);
+
+// Stores a frame and evicts whatever is older than max_age_us relative to it.
+// Returns ESP_ERR_NO_MEM when the frame had to be dropped.
+esp_err_t clip_ring_push(clip_ring_t *ring, const uint8_t *jpg, size_t len, int64_t timestamp, int64_t max_age_us);
+
+// Pins all frames taken at or after since and returns the id of the first one
+// (or of the next frame to come when none qualifies).
+uint32_t clip_ring_pin(clip_ring_t *ring, int64_t since);
+// Moves the pin forward once frames before id have been written out.
+void clip_ring_advance(clip_ring_t *ring, uint32_t id);
+void clip_ring_unpin(clip_ring_t *ring);
+
+// Looks up frame id. False if it has not been pushed yet or was evicted.
+// The data stays valid while the frame is pinned.
+bool clip_ring_get(clip_ring_t *ring, uint32_t id, clip_frame_t *frame, const uint8_t **data);
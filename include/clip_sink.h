@@ -0,0 +1,50 @@
+#pragma once
+
+#include <esp_err.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "avi_writer.h"
+
+// Destination of a recorded clip. The recorder calls open, then write once
+// per frame in order, then close, all from its writer task. Implementations
+// keep their state behind ctx.
+typedef struct clip_sink_t clip_sink_t;
+struct clip_sink_t
+{
+    const char *name;
+    esp_err_t (*open)(clip_sink_t *sink, const char *clip_name, int64_t timestamp);
+    esp_err_t (*write)(clip_sink_t *sink, const uint8_t *jpg, size_t len, int64_t timestamp);
+    esp_err_t (*close)(clip_sink_t *sink);
+    void *ctx;
+};
+
+// Writes every clip as a plain concatenation of JPEGs (<dir>/<clip_name>.mjpg)
+// through stdio, which is the SD card's VFS on the device and the local file
+// system on a host build.
+typedef struct
+{
+    char dir[48];
+    char path[96];
+    FILE *file;
+    uint32_t frames;
+    size_t bytes;
+} clip_file_sink_t;
+
+void clip_file_sink_init(clip_sink_t *sink, clip_file_sink_t *state, const char *dir);
+
+// Writes every clip as an indexed MJPEG AVI (<dir>/<clip_name>.avi) and adds
+// it to the catalog when it closes. The writer state is large and lives here
+// rather than on the writer task's stack.
+typedef struct
+{
+    char dir[48];
+    char path[96];
+    char name[16];
+    int64_t start_ms; // Wall clock, -1 when it was not set
+    bool open;
+    avi_writer_t avi;
+} clip_avi_sink_t;
+
+void clip_avi_sink_init(clip_sink_t *sink, clip_avi_sink_t *state, const char *dir);
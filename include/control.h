@@ -0,0 +1,42 @@
+#pragma once
+
+#include <esp_camera.h>
+#include <esp_err.h>
+#include <esp_http_server.h>
+
+#define CONTROL_MAX_SETTINGS 40 // Settings accepted in one /control request
+#define CONTROL_BODY_MAX 1024   // Largest JSON body accepted by POST /control
+#define CONTROL_ANSWER_MAX (64 + CONTROL_MAX_SETTINGS * 32) // Names are at most 21 characters
+
+#define STATUS_JSON_MAX 1024 // Room for the cached /status answer
+
+// Camera and module settings behind /control. Every name is resolved through
+// one sorted table, so a request naming anything unknown is turned down
+// before a single setting is touched.
+//
+// /status reports the sensor state. Building it reads sensor registers over
+// SCCB, so the JSON is kept and only built again after something changed.
+
+// Applies one setting. Returns the setter's result, 0 on success, or -2 for
+// a name that is not in the table.
+int control_set(sensor_t *sensor, const char *name, int value);
+
+// GET /control?var=<name>&val=<value> sets one value, as the page has always
+// done. GET /control?<name>=<value>&<name>=<value>... and POST /control with
+// a flat JSON object ({"framesize":9,"quality":10,"hmirror":true}) set many
+// in the order given. The answer lists the result of each one; it is a 500
+// if any setter failed and a 400, with nothing applied, if the request does
+// not parse or names an unknown setting.
+esp_err_t control_handler(httpd_req_t *req);
+
+// What control_handler() does once it has the request: parses the query, or
+// the JSON body when body is not NULL, applies it to sensor and writes the
+// answer into json (CONTROL_ANSWER_MAX bytes). Returns the HTTP status.
+int control_apply(sensor_t *sensor, char *query, const char *body, char *json);
+
+// Handler for /status: sensor_t status, xclk, pixformat and, on an OV2640,
+// the PLL registers the page shows, as one flat JSON object.
+esp_err_t status_handler(httpd_req_t *req);
+
+// Drops the cached /status. Called by every handler that changes the sensor.
+void control_changed();
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <esp_err.h>
+#include <esp_http_server.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define EVENT_LOG_SIZE 32              // Recent events kept for replay; must be a power of two
+#define EVENTS_MAX_CLIENTS 4           // Concurrent /events connections
+#define EVENTS_KEEPALIVE_MS 15000
+#define EVENTS_POLL_MAX 8              // Events returned by one long-poll response
+#define EVENTS_POLL_TIMEOUT_MS 25000   // Default wait of a long poll
+#define EVENTS_POLL_MAX_TIMEOUT_MS 60000
+
+typedef enum
+{
+    EVENT_SOUND,
+    EVENT_MOTION, // PIR on GPIO_13
+    EVENT_VISION, // Software motion detector
+} event_type_t;
+
+// A timestamped state change. Events are numbered so clients can ask for
+// everything after the last one they saw.
+typedef struct
+{
+    uint32_t seq;
+    event_type_t type;
+    bool active;       // Start (true) or stop (false)
+    int64_t timestamp; // esp_timer_get_time()
+    int32_t value;     // Type specific: level in dBFS for EVENT_SOUND, score for EVENT_VISION
+} event_t;
+
+esp_err_t events_start();
+
+void events_post(event_type_t type, bool active, int32_t value);
+void events_post_from_isr(event_type_t type, bool active, int32_t value);
+
+uint32_t events_latest_seq();
+
+// Copies up to max events newer than since, oldest first.
+size_t events_read(uint32_t since, event_t *out, size_t max);
+
+const char *event_type_name(event_type_t type);
+
+// Formats one event as a JSON object, including how long ago it happened as
+// latency_ms. Returns the length, like snprintf.
+int event_to_json(const event_t *event, char *buf, size_t len);
+
+// Handler for /events: answers with a text/event-stream and keeps the
+// connection open; new events are pushed from the events task.
+// With ?since=<seq> and/or ?timeout=<ms> it long-polls instead: it answers
+// with the events after since as soon as there are any, or with an empty
+// list once the timeout runs out.
+esp_err_t events_handler(httpd_req_t *req);
+
+// From the web server's close_fn, before the socket is closed: stops the
+// events task writing to the session, waiting out a send in flight.
+void events_session_closing(httpd_handle_t hd, int sockfd);
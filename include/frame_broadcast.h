@@ -0,0 +1,34 @@
+#pragma once
+
+#include <esp_camera.h>
+#include <freertos/FreeRTOS.h>
+
+#include "frame_ring.h"
+
+// The capture task grabs each frame once, copies it into the PSRAM frame ring
+// and hands the driver buffer straight back, so network consumers can never
+// stall the camera. Subscribers take a reference with frame_broadcast_acquire()
+// and must hand it back with frame_broadcast_release() once sent.
+esp_err_t frame_broadcast_start();
+
+// Returns a subscriber id, or -1 when STREAM_MAX_CLIENTS are already attached.
+// The capture task only runs while at least one subscriber is attached.
+int frame_broadcast_subscribe();
+void frame_broadcast_unsubscribe(int sub);
+
+// Same, for the firmware's own consumers and one-off captures, which draw on
+// FRAME_INTERNAL_SUBSCRIBERS slots of their own so they never take a viewer's.
+int frame_broadcast_subscribe_internal();
+
+// Blocks until a frame newer than last_seq is published (or returns the current
+// one right away if it is already newer). Returns NULL on timeout.
+frame_slot_t *frame_broadcast_acquire(int sub, uint32_t last_seq, TickType_t timeout);
+void frame_broadcast_release(frame_slot_t *frame);
+
+// For one-off consumers such as /capture: the latest frame if it is at most
+// max_age_us old, else the next one captured, subscribing just long enough to
+// have the capture task running. Returns NULL on timeout.
+frame_slot_t *frame_broadcast_latest(int64_t max_age_us, TickType_t timeout);
+
+// Drop/overrun counters and the latest frame for consumers that do not subscribe.
+frame_ring_t *frame_broadcast_ring();
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// One JPEG frame in the ring. The producer fills buf between
+// frame_ring_begin_write() and frame_ring_commit(); consumers read it between
+// frame_ring_acquire() and frame_ring_release().
+typedef struct
+{
+    uint8_t *buf;
+    size_t len;
+    size_t capacity;
+    size_t width;
+    size_t height;
+    int64_t timestamp; // esp_timer_get_time() when the frame was committed
+    uint32_t seq;      // Increments by one for every committed frame
+    uint16_t refs;     // Consumers holding the slot, plus one while it is being written or is the latest
+    bool consumed;     // Acquired at least once since it was committed
+} frame_slot_t;
+
+// Fixed pool of PSRAM frame slots with a "latest complete frame" pointer.
+// The producer never waits: when every slot is pinned by consumers the new
+// frame is dropped instead.
+typedef struct
+{
+    frame_slot_t *slots;
+    uint8_t slot_count;
+    frame_slot_t *latest;
+    uint32_t seq;
+    uint32_t dropped;  // Frames discarded because no slot was free or large enough
+    uint32_t overruns; // Frames replaced by a newer one before any consumer picked them up
+    portMUX_TYPE lock;
+} frame_ring_t;
+
+esp_err_t frame_ring_init(frame_ring_t *ring, uint8_t slot_count, size_t slot_size);
+
+// Reserves a free slot able to hold len bytes, growing it if needed.
+// Returns NULL (and counts a drop) when nothing is available.
+frame_slot_t *frame_ring_begin_write(frame_ring_t *ring, size_t len);
+void frame_ring_commit(frame_ring_t *ring, frame_slot_t *slot, size_t width, size_t height, int64_t timestamp);
+void frame_ring_abort(frame_ring_t *ring, frame_slot_t *slot);
+
+// Takes a reference to the latest frame if it is newer than last_seq, else NULL.
+frame_slot_t *frame_ring_acquire(frame_ring_t *ring, uint32_t last_seq);
+// Takes a reference to the latest frame whatever its seq, NULL before the first one.
+frame_slot_t *frame_ring_acquire_latest(frame_ring_t *ring);
+void frame_ring_release(frame_ring_t *ring, frame_slot_t *slot);
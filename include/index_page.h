@@ -346,6 +346,18 @@ const uint8_t index_simple_html[] = R"=====(<!doctype html>
                 display: none
             }
 
+            .live-event {
+                position: absolute;
+                left: 5px;
+                top: 5px;
+                padding: 0 4px;
+                border-radius: 4px;
+                background: #ff3034;
+                color: #fff;
+                font-size: 12px;
+                line-height: 16px
+            }
+
             input[type=text] {
                 border: 1px solid #363636;
                 font-size: 14px;
@@ -600,6 +612,13 @@ const uint8_t index_simple_html[] = R"=====(<!doctype html>
                                 <label class="slider" for="face_recognize"></label>
                             </div>
                         </div>
+                        <div class="input-group" id="ws-audio-group">
+                            <label for="ws-audio">Audio</label>
+                            <div class="switch">
+                                <input id="ws-audio" type="checkbox">
+                                <label class="slider" for="ws-audio"></label>
+                            </div>
+                        </div>
                         <section id="buttons">
                             <button id="get-still">Get Still</button>
                             <button id="toggle-stream">Start Stream</button>
@@ -703,6 +722,7 @@ const uint8_t index_simple_html[] = R"=====(<!doctype html>
                 <figure>
                     <div id="stream-container" class="image-container hidden">
                         <a id="save-still" href="#" class="button save" download="capture.jpg">Save</a>
+                        <div class="live-event hidden" id="live-event"></div>
                         <div class="close" id="close-stream">Ã</div>
                         <img id="stream" src="" crossorigin>
                     </div>
@@ -712,7 +732,8 @@ const uint8_t index_simple_html[] = R"=====(<!doctype html>
         <script>
 document.addEventListener('DOMContentLoaded', function (event) {
   var baseHost = document.location.origin
-  var streamUrl = baseHost + ':81'
+  var streamUrl = baseHost + '/stream'
+  var wsUrl = baseHost.replace(/^http/, 'ws') + '/ws'
 
   function fetchUrl(url, cb){
     fetch(url)
@@ -1012,17 +1033,175 @@ document.addEventListener('DOMContentLoaded', function (event) {
   const saveButton = document.getElementById('save-still')
   const ledGroup = document.getElementById('led-group')
 
+  const audioToggle = document.getElementById('ws-audio')
+  const liveEvent = document.getElementById('live-event')
+
+  // /ws carries the video, audio and events on one connection. Frames are
+  // shown through blob URLs on the same <img>, and 16 bit PCM is queued to an
+  // AudioWorklet that starts once 200 ms are buffered and drops what lags
+  // more than a second behind.
+  const pcmWorklet = `
+    class LivePcm extends AudioWorkletProcessor {
+      constructor() {
+        super()
+        this.queue = []
+        this.queued = 0
+        this.started = false
+        this.port.onmessage = e => {
+          this.queue.push(e.data)
+          this.queued += e.data.length
+          while (this.queued > sampleRate && this.queue.length > 1) {
+            this.queued -= this.queue.shift().length
+          }
+        }
+      }
+      process(inputs, outputs) {
+        const out = outputs[0][0]
+        if (!this.started && this.queued < sampleRate / 5) {
+          return true
+        }
+        this.started = true
+        let i = 0
+        while (i < out.length && this.queue.length) {
+          const block = this.queue[0]
+          const n = Math.min(out.length - i, block.length)
+          out.set(block.subarray(0, n), i)
+          i += n
+          this.queued -= n
+          if (n === block.length) {
+            this.queue.shift()
+          } else {
+            this.queue[0] = block.subarray(n)
+          }
+        }
+        if (i < out.length) {
+          this.started = false
+        }
+        return true
+      }
+    }
+    registerProcessor('live-pcm', LivePcm)`
+
+  let live = null
+
+  const stopLive = () => {
+    if (!live) {
+      return
+    }
+    live.ws.onclose = null
+    live.ws.close()
+    if (live.audio) {
+      live.audio.close()
+    }
+    if (live.frameUrl) {
+      URL.revokeObjectURL(live.frameUrl)
+    }
+    hide(liveEvent)
+    live = null
+  }
+
+  const startAudio = async (state, hello) => {
+    const audio = new AudioContext({ sampleRate: hello.audio.sample_rate })
+    state.audio = audio
+    const moduleUrl = URL.createObjectURL(new Blob([pcmWorklet], { type: 'application/javascript' }))
+    await audio.audioWorklet.addModule(moduleUrl)
+    URL.revokeObjectURL(moduleUrl)
+    if (live !== state) {
+      return
+    }
+    state.pcm = new AudioWorkletNode(audio, 'live-pcm')
+    state.pcm.connect(audio.destination)
+    audio.resume()
+  }
+
+  const onLiveMessage = (state, data) => {
+    const header = new DataView(data, 0, 16)
+    const payload = new Uint8Array(data, 16)
+    switch (header.getUint8(0)) {
+      case 0: // hello
+        state.hello = JSON.parse(new TextDecoder().decode(payload))
+        if (state.hello.audio) {
+          startAudio(state, state.hello).catch(e => console.log('audio: ' + e))
+        }
+        break
+      case 1: { // JPEG
+        const url = URL.createObjectURL(new Blob([payload], { type: 'image/jpeg' }))
+        view.src = url
+        if (state.frameUrl) {
+          URL.revokeObjectURL(state.frameUrl)
+        }
+        state.frameUrl = url
+        break
+      }
+      case 2: { // PCM
+        if (!state.pcm) {
+          break
+        }
+        const pcm = new Int16Array(data.slice(16))
+        const samples = new Float32Array(pcm.length)
+        for (let i = 0; i < pcm.length; i++) {
+          samples[i] = pcm[i] / 32768
+        }
+        state.pcm.port.postMessage(samples, [samples.buffer])
+        break
+      }
+      case 3: { // event
+        const ev = JSON.parse(new TextDecoder().decode(payload))
+        liveEvent.textContent = ev.type
+        if (ev.active) {
+          show(liveEvent)
+        } else {
+          hide(liveEvent)
+        }
+        break
+      }
+    }
+  }
+
+  const startLive = () => {
+    const audio = audioToggle.checked ? 'pcm' : 'off'
+    const state = { ws: new WebSocket(`${wsUrl}?video=main&audio=${audio}`) }
+    state.ws.binaryType = 'arraybuffer'
+    state.ws.onmessage = e => onLiveMessage(state, e.data)
+    state.ws.onclose = () => {
+      if (live !== state) {
+        return
+      }
+      const fallback = !state.hello
+      stopLive()
+      if (fallback) {
+        // No room on /ws, or a server without it: use the MJPEG stream
+        view.src = `${streamUrl}`
+      } else {
+        streamButton.innerHTML = 'Start Stream'
+      }
+    }
+    live = state
+  }
+
   const stopStream = () => {
+    stopLive()
     window.stop();
     streamButton.innerHTML = 'Start Stream'
   }
 
   const startStream = () => {
-    view.src = `${streamUrl}`
+    if ('WebSocket' in window) {
+      startLive()
+    } else {
+      view.src = `${streamUrl}`
+    }
     show(viewContainer)
     streamButton.innerHTML = 'Stop Stream'
   }
 
+  audioToggle.onchange = () => {
+    if (live) {
+      stopLive()
+      startLive()
+    }
+  }
+
   // Attach actions to buttons
   stillButton.onclick = () => {
     stopStream()
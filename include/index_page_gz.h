@@ -0,0 +1,526 @@
+// Generated by tools/gzip_index.py from index_page.h; do not edit.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define INDEX_PAGE_ETAG "\"cd3a2905447a1649\""       // The page as it is
+#define INDEX_PAGE_ETAG_GZ "\"cd3a2905447a1649-gz\"" // This gzip copy of it
+
+// 8201 bytes, 49285 uncompressed
+const uint8_t index_simple_html_gz[] = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xed, 0x3d, 0xdb, 0x76, 0xdb, 0x46,
+    0x92, 0xef, 0xfa, 0x8a, 0x36, 0x92, 0x31, 0xc1, 0x23, 0x92, 0x22, 0x29, 0x4a, 0x56, 0x64, 0x89,
+    0x5e, 0x5b, 0x96, 0xed, 0xcc, 0x58, 0x89, 0xc7, 0x4a, 0x9c, 0xcc, 0xf1, 0xc9, 0xda, 0x20, 0xd1,
+    0x24, 0x11, 0x83, 0x00, 0x07, 0x00, 0x45, 0x31, 0x3e, 0x7a, 0xda, 0x8f, 0xd8, 0xff, 0xd9, 0xfd,
+    0xb1, 0xad, 0xea, 0x0b, 0xd0, 0xb8, 0x83, 0xa4, 0x4c, 0x7a, 0x32, 0x6b, 0xfb, 0x98, 0xb8, 0x74,
+    0x57, 0xd7, 0xbd, 0xab, 0xab, 0x2f, 0x38, 0x7b, 0x60, 0xba, 0xc3, 0x60, 0x39, 0xa3, 0x64, 0x12,
+    0x4c, 0xed, 0xfe, 0xde, 0x19, 0xff, 0x21, 0xf0, 0xe7, 0x6c, 0x42, 0x0d, 0x93, 0x5f, 0xb2, 0xdb,
+    0x29, 0x0d, 0x0c, 0x32, 0x9c, 0x18, 0x9e, 0x4f, 0x83, 0x73, 0x6d, 0x1e, 0x8c, 0x9a, 0x27, 0x5a,
+    0xf2, 0xb5, 0x63, 0x4c, 0xe9, 0xb9, 0x76, 0x63, 0xd1, 0xc5, 0xcc, 0xf5, 0x02, 0x8d, 0x0c, 0x5d,
+    0x27, 0xa0, 0x0e, 0x14, 0x5f, 0x58, 0x66, 0x30, 0x39, 0x37, 0xe9, 0x8d, 0x35, 0xa4, 0x4d, 0x76,
+    0xd3, 0xb0, 0x1c, 0x2b, 0xb0, 0x0c, 0xbb, 0xe9, 0x0f, 0x0d, 0x9b, 0x9e, 0x77, 0x54, 0x58, 0x81,
+    0x15, 0xd8, 0xb4, 0x7f, 0x79, 0xfd, 0xe6, 0xb0, 0x4b, 0x7e, 0x7c, 0xd7, 0xed, 0x1d, 0xb7, 0xcf,
+    0x0e, 0xf8, 0xb3, 0xa8, 0x8c, 0x1f, 0x2c, 0xd5, 0x7b, 0xfc, 0x33, 0x70, 0xcd, 0x25, 0xf9, 0x1c,
+    0x7b, 0x84, 0x7f, 0x46, 0x80, 0x44, 0x73, 0x64, 0x4c, 0x2d, 0x7b, 0x79, 0x4a, 0x9e, 0x7a, 0xd0,
+    0x66, 0xe3, 0x15, 0xb5, 0x6f, 0x68, 0x60, 0x0d, 0x8d, 0x86, 0x6f, 0x38, 0x7e, 0xd3, 0xa7, 0x9e,
+    0x35, 0x7a, 0x9c, 0xaa, 0x38, 0x30, 0x86, 0x9f, 0xc6, 0x9e, 0x3b, 0x77, 0xcc, 0x53, 0xf2, 0x4d,
+    0xe7, 0x04, 0xff, 0xa6, 0x0b, 0x0d, 0x5d, 0xdb, 0xf5, 0xe0, 0xfd, 0xe5, 0x0b, 0xfc, 0xfb, 0x38,
+    0xbb, 0x75, 0xdf, 0xfa, 0x83, 0x9e, 0x92, 0xce, 0xf1, 0xec, 0x36, 0xf6, 0xfe, 0x6e, 0x2f, 0x76,
+    0x3b, 0xe9, 0xe6, 0x61, 0x2f, 0xea, 0x9f, 0x14, 0xd7, 0xf7, 0xe9, 0x30, 0xb0, 0x5c, 0xa7, 0x35,
+    0x35, 0x2c, 0x27, 0x03, 0x92, 0x69, 0xf9, 0x33, 0xdb, 0x00, 0x1e, 0x8c, 0x6c, 0x5a, 0x08, 0xe7,
+    0x9b, 0x29, 0x75, 0xe6, 0x8d, 0x12, 0x68, 0x08, 0xa4, 0x69, 0x5a, 0x1e, 0x2f, 0x75, 0x8a, 0x7c,
+    0x98, 0x4f, 0x9d, 0x52, 0xb0, 0x45, 0x78, 0x39, 0xae, 0x43, 0x1f, 0x67, 0x37, 0xb4, 0xf0, 0x8c,
+    0x19, 0x16, 0xc0, 0xdf, 0x74, 0x91, 0xa9, 0xe5, 0x70, 0xa5, 0x3a, 0x25, 0x87, 0xbd, 0xf6, 0xec,
+    0xb6, 0x44, 0x94, 0x87, 0xc7, 0xf8, 0x37, 0x5d, 0x68, 0x66, 0x98, 0xa6, 0xe5, 0x8c, 0x4f, 0xc9,
+    0x49, 0x26, 0x08, 0xd7, 0x33, 0xa9, 0xd7, 0xf4, 0x0c, 0xd3, 0x9a, 0xfb, 0xa7, 0xa4, 0x97, 0x55,
+    0x66, 0x6a, 0x78, 0x63, 0xc0, 0x25, 0x70, 0x01, 0xd9, 0x66, 0xa7, 0x5d, 0x50, 0xc4, 0xb3, 0xc6,
+    0x93, 0x00, 0x44, 0x9a, 0x2a, 0x93, 0x64, 0x9a, 0x30, 0xa1, 0x32, 0x79, 0x16, 0xf2, 0x2d, 0x9b,
+    0x6b, 0x86, 0x6d, 0x8d, 0x9d, 0xa6, 0x15, 0xd0, 0x29, 0x90, 0xe3, 0x07, 0x1e, 0x0d, 0x86, 0x93,
+    0x22, 0x54, 0x46, 0xd6, 0x78, 0xee, 0xd1, 0x0c, 0x44, 0x42, 0xbe, 0x15, 0x10, 0x0c, 0x2f, 0xd3,
+    0xaf, 0x9a, 0x0b, 0x3a, 0xf8, 0x64, 0x05, 0x4d, 0xc1, 0x93, 0x01, 0x1d, 0xb9, 0x1e, 0xcd, 0x2c,
+    0x29, 0x4b, 0xd8, 0xee, 0xf0, 0x53, 0xd3, 0x0f, 0x0c, 0x2f, 0xa8, 0x02, 0xd0, 0x18, 0x05, 0xd4,
+    0x2b, 0x87, 0x47, 0x51, 0x2b, 0xca, 0xa1, 0xe5, 0x37, 0x2b, 0x0a, 0x58, 0x8e, 0x6d, 0x39, 0xb4,
+    0x3a, 0x7a, 0x79, 0xed, 0xc6, 0xc1, 0xf1, 0x52, 0x15, 0x04, 0x63, 0x4d, 0xc7, 0x45, 0x5a, 0xc2,
+    0x68, 0x4d, 0x37, 0x26, 0xec, 0xa6, 0xd3, 0x6e, 0xff, 0x25, 0xfd, 0x72, 0x42, 0xb9, 0x9a, 0x1a,
+    0xf3, 0xc0, 0xdd, 0xdc, 0x22, 0x4e, 0x4a, 0x74, 0xfd, 0x3f, 0xa6, 0xd4, 0xb4, 0x0c, 0xa2, 0x2b,
+    0xe6, 0x7c, 0xd2, 0x06, 0x9d, 0xaa, 0x13, 0xc3, 0x31, 0x89, 0xee, 0x7a, 0x16, 0x18, 0x82, 0xc1,
+    0xdc, 0x8d, 0x0d, 0x4f, 0xa0, 0xe3, 0x98, 0xd1, 0x7a, 0x06, 0xc9, 0x05, 0x36, 0xa3, 0x72, 0x24,
+    0xdb, 0x6c, 0x2a, 0xba, 0x9c, 0x4a, 0x06, 0x94, 0x41, 0x63, 0xa9, 0xbc, 0xaa, 0xc8, 0x8c, 0x33,
+    0xf6, 0xb6, 0x59, 0x28, 0x3b, 0x59, 0x48, 0xca, 0x10, 0xba, 0xd9, 0xa1, 0x0e, 0x45, 0x6f, 0x26,
+    0xa4, 0x49, 0xd0, 0x4b, 0xd6, 0xb3, 0xeb, 0x08, 0xa0, 0xd9, 0x22, 0x4f, 0x2a, 0xc5, 0x0a, 0xe4,
+    0x66, 0x93, 0x1a, 0xf9, 0x0e, 0xfe, 0x77, 0x76, 0x9b, 0x47, 0x49, 0xae, 0x17, 0x59, 0xcd, 0x93,
+    0xac, 0xe0, 0x4d, 0x56, 0xf2, 0x28, 0x95, 0xbd, 0xca, 0x4a, 0x9e, 0x65, 0x15, 0xef, 0xb2, 0x82,
+    0x87, 0xa9, 0xe4, 0x65, 0xb8, 0x38, 0xcb, 0xe3, 0x8d, 0x6f, 0x06, 0xf3, 0x20, 0x70, 0x1d, 0x7f,
+    0xa3, 0x2e, 0x2a, 0xcf, 0xce, 0x7e, 0x9f, 0xfb, 0x81, 0x35, 0x5a, 0x36, 0x85, 0x49, 0x83, 0x9d,
+    0xcd, 0x0c, 0x08, 0x21, 0x07, 0x34, 0x58, 0x50, 0x5a, 0x1c, 0x6e, 0x38, 0xc6, 0x0d, 0xf8, 0x9d,
+    0xf1, 0xd8, 0xce, 0xd2, 0xbd, 0xe1, 0xdc, 0xf3, 0x31, 0x6e, 0x9b, 0xb9, 0x16, 0x00, 0xf6, 0x1e,
+    0x97, 0xf8, 0xcd, 0x8a, 0x0d, 0x35, 0x87, 0x83, 0x8c, 0xb6, 0xdc, 0x79, 0x80, 0x3c, 0xce, 0x94,
+    0x84, 0x0b, 0xe4, 0x58, 0xc1, 0x32, 0xf3, 0x9d, 0xb0, 0xc4, 0x76, 0xbe, 0x5f, 0x6e, 0x57, 0xc7,
+    0xeb, 0x74, 0x38, 0xa1, 0xc3, 0x4f, 0xd4, 0xdc, 0x2f, 0x0d, 0xc3, 0xca, 0xc2, 0xc3, 0x96, 0xe5,
+    0xcc, 0xe6, 0x41, 0x13, 0xc3, 0xa9, 0xd9, 0x17, 0x91, 0x39, 0x53, 0x48, 0x49, 0x62, 0xb7, 0x5b,
+    0x14, 0x54, 0x1c, 0xcd, 0x6e, 0x8b, 0x99, 0xa0, 0x22, 0xdb, 0xb7, 0x8d, 0x01, 0xb5, 0x8b, 0x50,
+    0x16, 0xc6, 0x90, 0xe3, 0x76, 0x85, 0xaf, 0xca, 0x8f, 0xdd, 0x12, 0xb1, 0x68, 0xef, 0xd1, 0x5f,
+    0x2a, 0xf3, 0x91, 0x5d, 0x37, 0x62, 0x8f, 0x7c, 0x6a, 0x83, 0x81, 0xe5, 0x85, 0xde, 0x50, 0x66,
+    0x01, 0x38, 0x14, 0x36, 0xe0, 0x19, 0xce, 0x98, 0x82, 0x2f, 0xb8, 0x6d, 0xc8, 0xcb, 0xe2, 0x81,
+    0x41, 0x25, 0xf2, 0xd1, 0x55, 0x1f, 0x15, 0x0f, 0x44, 0xb8, 0x43, 0x68, 0x90, 0x16, 0xbf, 0x58,
+    0x23, 0x2a, 0x51, 0xe4, 0x5b, 0x88, 0x48, 0xa7, 0x9b, 0x1f, 0xaa, 0x67, 0x5a, 0x4e, 0x5c, 0xb7,
+    0x32, 0x03, 0xfd, 0x52, 0xd7, 0x20, 0x87, 0x7c, 0xa3, 0x51, 0xd9, 0xa0, 0x71, 0x34, 0x3a, 0x6c,
+    0x1f, 0xf6, 0x4a, 0x23, 0xa7, 0x4c, 0x2a, 0x13, 0x03, 0xc7, 0xc7, 0x05, 0x6e, 0xa5, 0x50, 0x09,
+    0x7c, 0xe3, 0x26, 0x33, 0x68, 0x77, 0x7d, 0x8b, 0x8f, 0xdc, 0x8c, 0x81, 0x0f, 0x63, 0xb7, 0x20,
+    0x63, 0xe8, 0x25, 0x14, 0xbd, 0x9b, 0x89, 0x1f, 0x0b, 0xe9, 0x32, 0x4d, 0x40, 0xb2, 0x37, 0x1b,
+    0xed, 0x98, 0x04, 0xb2, 0x8b, 0x28, 0x02, 0xce, 0x0c, 0x2a, 0x03, 0x7a, 0x1b, 0x34, 0x4d, 0x3a,
+    0x74, 0x3d, 0x1e, 0x0d, 0xe6, 0x8c, 0x1c, 0x13, 0x82, 0x2c, 0xd7, 0xd8, 0xd3, 0x89, 0x7b, 0x43,
+    0xbd, 0x0c, 0x66, 0x25, 0x84, 0xda, 0xfb, 0xae, 0x67, 0x56, 0x80, 0x66, 0x40, 0xf7, 0x98, 0xc9,
+    0xfb, 0x38, 0xb8, 0x6e, 0x67, 0xd8, 0xed, 0x94, 0x83, 0x6b, 0x81, 0xcd, 0x18, 0x03, 0x9b, 0x9a,
+    0x05, 0xbd, 0x99, 0x49, 0x47, 0xc6, 0xdc, 0x0e, 0x4a, 0xb4, 0xd2, 0x68, 0xe3, 0xdf, 0xa2, 0x16,
+    0x99, 0x1b, 0x7a, 0x8f, 0x79, 0xa1, 0x73, 0xe6, 0x38, 0x7e, 0xcb, 0x68, 0x53, 0x86, 0x1a, 0xc6,
+    0x6c, 0x46, 0x0d, 0x28, 0x35, 0xa4, 0x79, 0x72, 0xa8, 0x34, 0xc4, 0xc8, 0xf6, 0xf3, 0x95, 0xc6,
+    0xed, 0xa5, 0x06, 0x1b, 0x06, 0x8f, 0x2b, 0xd1, 0x7c, 0x3a, 0x72, 0x87, 0x73, 0xbf, 0xb0, 0x3f,
+    0x5f, 0x0d, 0xde, 0xa9, 0x64, 0x99, 0x6f, 0x5b, 0xcc, 0xfc, 0xe7, 0x8e, 0x83, 0x12, 0x6d, 0x06,
+    0x1e, 0x90, 0x99, 0xd1, 0x50, 0x35, 0xc6, 0xad, 0xe5, 0xc3, 0x62, 0x8c, 0xcd, 0xcb, 0x5d, 0x25,
+    0xdc, 0x54, 0xbb, 0xc0, 0xd3, 0x12, 0xf0, 0x21, 0x96, 0x29, 0x41, 0x6d, 0xc6, 0x97, 0x60, 0x32,
+    0x9f, 0x66, 0xc5, 0x51, 0xb2, 0xb1, 0x0e, 0x74, 0xfa, 0xbc, 0x39, 0x6f, 0x3c, 0x30, 0xf4, 0x76,
+    0xa3, 0xdd, 0x38, 0x84, 0xff, 0xea, 0xab, 0x2a, 0x97, 0x60, 0x6f, 0xb7, 0x5b, 0x21, 0xdd, 0x73,
+    0x54, 0x9e, 0x56, 0xca, 0x73, 0xf6, 0xa5, 0xb2, 0xa8, 0x6e, 0x49, 0xf1, 0xfc, 0x52, 0xa7, 0x55,
+    0xd2, 0x0f, 0xe7, 0xa8, 0xf4, 0xea, 0x8a, 0x98, 0xa1, 0x2d, 0xab, 0x8a, 0x78, 0xea, 0xfe, 0xd1,
+    0xe4, 0x41, 0xc8, 0xbf, 0xbd, 0xb6, 0x2b, 0xac, 0xf8, 0x53, 0x6b, 0xfa, 0xca, 0x7c, 0xf1, 0x77,
+    0xad, 0x1b, 0xed, 0x7c, 0xa9, 0x37, 0x45, 0xd4, 0x07, 0x18, 0x3a, 0x30, 0x06, 0xf5, 0x60, 0x30,
+    0x9a, 0x1b, 0x19, 0x2a, 0x65, 0xd6, 0xe0, 0xc1, 0xc8, 0xb2, 0xed, 0xa6, 0xed, 0x2e, 0xca, 0x23,
+    0x91, 0x62, 0x4d, 0x4e, 0xe9, 0x69, 0xb9, 0xca, 0xaf, 0x8b, 0xed, 0x1c, 0x3c, 0xd7, 0xbf, 0x04,
+    0xb6, 0xff, 0x6e, 0x5d, 0x8b, 0x62, 0x1a, 0xeb, 0x75, 0x14, 0x6b, 0xe8, 0xe3, 0x66, 0x0d, 0x55,
+    0x52, 0x25, 0x1e, 0x09, 0x16, 0x0f, 0x7b, 0x16, 0x56, 0x30, 0x9c, 0xac, 0x31, 0xf4, 0x8c, 0x06,
+    0x46, 0x1e, 0xb5, 0x0d, 0x8c, 0xe0, 0xd7, 0xca, 0x50, 0x94, 0x0e, 0xdf, 0xd4, 0xea, 0x55, 0x28,
+    0x61, 0xac, 0xfb, 0x7a, 0xb2, 0x4b, 0x2d, 0x1e, 0x3b, 0xe4, 0xfb, 0xea, 0xa3, 0x76, 0x19, 0xd5,
+    0xa5, 0x96, 0xd1, 0xdd, 0xd4, 0xa3, 0x4b, 0xa7, 0x3d, 0xf6, 0xe8, 0xb2, 0x02, 0x31, 0x0d, 0xf1,
+    0x7b, 0xca, 0xf3, 0xc7, 0xeb, 0xa7, 0x4a, 0x58, 0x07, 0x20, 0xb4, 0xa8, 0xd5, 0xf3, 0x2b, 0x34,
+    0x9d, 0xdf, 0x64, 0x15, 0x7d, 0x0c, 0xb3, 0xa3, 0x9a, 0x56, 0xc1, 0xdd, 0xfc, 0x65, 0xd5, 0x21,
+    0xbb, 0xec, 0x7d, 0xb3, 0xc7, 0xf3, 0x74, 0x14, 0xe4, 0x4c, 0xfe, 0xb0, 0x38, 0xf5, 0xb0, 0xd8,
+    0xbb, 0x35, 0x95, 0x6c, 0x4a, 0xa9, 0xe7, 0x08, 0x93, 0x98, 0xf9, 0xda, 0x97, 0x09, 0x19, 0xbd,
+    0xe7, 0xca, 0xc0, 0xf3, 0x45, 0x22, 0xc3, 0x67, 0x26, 0x66, 0x28, 0x33, 0x15, 0x5d, 0x3e, 0x88,
+    0x87, 0xfe, 0xaa, 0x77, 0x8f, 0x33, 0xe7, 0x56, 0x0a, 0x0a, 0x17, 0x27, 0xd9, 0x73, 0xb2, 0x80,
+    0xe9, 0x2e, 0x2b, 0x77, 0x80, 0xac, 0xfa, 0xa2, 0xde, 0xea, 0x56, 0x59, 0xe4, 0x61, 0xd2, 0x99,
+    0xac, 0xe2, 0x94, 0xe7, 0xd4, 0x80, 0xb0, 0x17, 0xd5, 0xd5, 0x00, 0x88, 0xde, 0x9a, 0xea, 0xae,
+    0xe4, 0x58, 0x3b, 0xc7, 0xed, 0x92, 0x26, 0x87, 0xb6, 0xeb, 0x6f, 0x98, 0x00, 0xcb, 0xcf, 0x7f,
+    0x1d, 0xad, 0xdd, 0x75, 0x17, 0xda, 0x54, 0xb1, 0x39, 0x26, 0x78, 0xde, 0x69, 0x67, 0x7a, 0xda,
+    0xc2, 0x2c, 0x25, 0xcb, 0xa0, 0xb1, 0xf9, 0xcb, 0x53, 0x32, 0xa4, 0xd9, 0x6e, 0x34, 0x9e, 0xa8,
+    0xab, 0x92, 0x2a, 0x2d, 0x94, 0xc3, 0xc4, 0x32, 0x4d, 0xea, 0x94, 0xad, 0xff, 0x28, 0x04, 0x61,
+    0x83, 0x36, 0x34, 0xe9, 0x4d, 0xf6, 0xd4, 0x6e, 0x15, 0x79, 0x72, 0x5f, 0xb5, 0xa2, 0x38, 0xcb,
+    0xb2, 0x91, 0x55, 0xa6, 0xc1, 0xab, 0x45, 0x73, 0x45, 0x12, 0x53, 0x6d, 0xb8, 0x5b, 0x29, 0xaf,
+    0x5a, 0x31, 0x0e, 0x43, 0x55, 0xf8, 0x6d, 0x5b, 0xfe, 0xa5, 0x70, 0x85, 0x48, 0xe7, 0x4b, 0x3b,
+    0x1f, 0xd1, 0x67, 0xe7, 0x4d, 0x4a, 0xc4, 0xa3, 0xba, 0x42, 0x54, 0xbb, 0x85, 0x8a, 0x82, 0x2c,
+    0x03, 0x3e, 0x60, 0xa9, 0xb4, 0x3a, 0x24, 0xb0, 0x62, 0x73, 0x52, 0x2d, 0x31, 0x4d, 0x27, 0x66,
+    0x54, 0x9b, 0x79, 0x13, 0x55, 0xf7, 0x38, 0x6b, 0xc9, 0x34, 0x20, 0xd9, 0x6e, 0x2e, 0x6b, 0x76,
+    0x14, 0x64, 0x16, 0x20, 0x19, 0xf6, 0xd6, 0x72, 0x9d, 0x5a, 0xbc, 0xd4, 0xba, 0x7e, 0xe6, 0xec,
+    0x40, 0x59, 0x58, 0x78, 0x76, 0x10, 0xad, 0x81, 0x3c, 0xc3, 0xd5, 0x85, 0xea, 0xfa, 0x43, 0xd1,
+    0xce, 0xd0, 0x36, 0x7c, 0xff, 0x5c, 0xc3, 0x55, 0x72, 0x5a, 0x7c, 0x39, 0xe2, 0x99, 0x69, 0xdd,
+    0x10, 0xcb, 0x3c, 0xd7, 0x6c, 0x77, 0xec, 0x26, 0xde, 0xb1, 0xf7, 0x5c, 0xca, 0x10, 0x12, 0x9c,
+    0x6b, 0xb1, 0xa9, 0x5a, 0x8d, 0xd5, 0x8a, 0x1e, 0x69, 0xfd, 0x87, 0xdf, 0x7c, 0xf7, 0xe8, 0xd1,
+    0xf1, 0xe3, 0x87, 0xce, 0xc0, 0x9f, 0x89, 0xff, 0x7f, 0xe2, 0x33, 0xdb, 0x3f, 0xbe, 0xeb, 0x1e,
+    0xf7, 0x60, 0xe4, 0x4c, 0x83, 0x00, 0x54, 0xcf, 0x3f, 0x3b, 0x60, 0x40, 0x13, 0x88, 0x1c, 0x00,
+    0x26, 0x39, 0xb8, 0x89, 0xc8, 0x31, 0x0b, 0x3d, 0x59, 0xc4, 0x87, 0x60, 0x68, 0x60, 0x78, 0x19,
+    0x45, 0x58, 0x31, 0x3e, 0x2e, 0x61, 0xae, 0x44, 0x63, 0x32, 0x19, 0xb8, 0xb7, 0x49, 0x0a, 0x18,
+    0x51, 0x42, 0x60, 0xa2, 0x14, 0x35, 0xf3, 0x00, 0x42, 0x35, 0x56, 0x1d, 0xe7, 0xa9, 0xa1, 0x4c,
+    0x66, 0xa1, 0x98, 0x08, 0xb0, 0xf0, 0xed, 0xd0, 0xfe, 0x24, 0x65, 0xaf, 0x49, 0xa1, 0x38, 0x6e,
+    0xc0, 0x7b, 0x9d, 0x9c, 0xa6, 0x62, 0xa4, 0x8a, 0x3a, 0xca, 0x0c, 0x2c, 0xa7, 0x02, 0x58, 0xdb,
+    0x64, 0xd0, 0xf9, 0xb3, 0x62, 0x48, 0x49, 0xb9, 0xca, 0xca, 0x5a, 0xff, 0xd7, 0x8b, 0xd7, 0x7f,
+    0x23, 0x57, 0xaf, 0xfe, 0xc8, 0x94, 0x50, 0x19, 0x52, 0xe8, 0xa3, 0x2b, 0xb4, 0xac, 0xc8, 0x43,
+    0xf2, 0x44, 0x13, 0x92, 0x61, 0x10, 0x30, 0x70, 0xb2, 0xa9, 0x33, 0x0e, 0x26, 0xe7, 0x5a, 0x47,
+    0xc3, 0xd5, 0x41, 0xf2, 0xae, 0xab, 0x11, 0xf4, 0xdf, 0xec, 0xe2, 0xc6, 0xb0, 0xe7, 0x78, 0xd5,
+    0xae, 0x42, 0x6b, 0x5a, 0xb5, 0x32, 0x8b, 0x09, 0xc7, 0x12, 0xf2, 0x58, 0x71, 0xc4, 0x71, 0x2e,
+    0x6b, 0xfd, 0x6b, 0x1a, 0x9c, 0x1d, 0xf0, 0x57, 0x25, 0x52, 0x2b, 0x6e, 0x1b, 0x2c, 0x99, 0xab,
+    0x43, 0x91, 0x0a, 0x15, 0x09, 0x7e, 0xe4, 0x19, 0x53, 0x8a, 0x5c, 0xa9, 0x24, 0x79, 0x55, 0xea,
+    0x61, 0x4d, 0xad, 0xff, 0x96, 0xb2, 0x58, 0x04, 0xd0, 0xa8, 0x24, 0xf8, 0x33, 0x11, 0xee, 0xc7,
+    0xda, 0x0f, 0xf5, 0x59, 0x4c, 0xef, 0x35, 0x0d, 0xae, 0xe6, 0x15, 0xf8, 0xfe, 0xa0, 0xd9, 0x24,
+    0xdd, 0xab, 0x37, 0xa4, 0xd9, 0xac, 0x50, 0xd8, 0x9d, 0x31, 0x73, 0x12, 0xf2, 0xef, 0x1c, 0x6a,
+    0xfd, 0x9f, 0x7f, 0x7d, 0xf9, 0x54, 0x87, 0x10, 0xbb, 0x7d, 0xdb, 0xe9, 0xb6, 0xdb, 0xf5, 0xb3,
+    0x03, 0x5e, 0x64, 0x75, 0x58, 0x5d, 0x90, 0x2b, 0x83, 0xd5, 0x3d, 0x01, 0x58, 0xed, 0x6e, 0x6f,
+    0x03, 0x58, 0x1d, 0xad, 0xff, 0xea, 0x39, 0x87, 0xf4, 0xa8, 0xbb, 0x09, 0x52, 0xa0, 0xe0, 0x0c,
+    0x27, 0x40, 0xe7, 0xf6, 0xd1, 0xf1, 0xc9, 0xfa, 0x90, 0xbe, 0x03, 0xea, 0xde, 0x01, 0xa4, 0x13,
+    0x60, 0xd4, 0xf1, 0x26, 0x7c, 0x3a, 0xd1, 0xfa, 0x08, 0x07, 0x3c, 0xfa, 0x6d, 0xef, 0x64, 0x03,
+    0x38, 0x8f, 0x80, 0x45, 0x08, 0x08, 0x80, 0xdc, 0x1e, 0x6e, 0xc2, 0xa3, 0x63, 0xad, 0x7f, 0xf1,
+    0xfd, 0x0b, 0xbd, 0x07, 0x84, 0x75, 0xbf, 0x3b, 0x5e, 0x1f, 0xce, 0x91, 0xd6, 0xff, 0x3b, 0x22,
+    0x04, 0xc8, 0xdc, 0x76, 0x7b, 0x1b, 0x20, 0xd4, 0xd3, 0xfa, 0x50, 0x1f, 0x61, 0xac, 0x0d, 0x02,
+    0xf4, 0xfa, 0x15, 0x43, 0x06, 0x01, 0x75, 0x1e, 0x6d, 0x40, 0x15, 0x68, 0xf5, 0xdf, 0x91, 0x3d,
+    0x00, 0xe4, 0xb6, 0xd3, 0xdb, 0x44, 0xa7, 0x01, 0x10, 0x43, 0x09, 0x6c, 0x0d, 0x4d, 0x6d, 0x7d,
+    0x48, 0xa0, 0xd3, 0xdf, 0x1d, 0xdf, 0x7e, 0x77, 0x5c, 0x0d, 0x00, 0xfa, 0x48, 0xf4, 0x37, 0x45,
+    0x5e, 0xb4, 0xd8, 0xc9, 0x16, 0x39, 0xd0, 0x7f, 0xce, 0x61, 0x84, 0x19, 0x2c, 0x57, 0x76, 0x9f,
+    0xa2, 0x1e, 0xf0, 0x84, 0x5f, 0x54, 0xf3, 0x9c, 0x0a, 0x26, 0xe1, 0x62, 0x27, 0xad, 0xdf, 0xab,
+    0xd0, 0x43, 0xc5, 0x42, 0x18, 0x56, 0x37, 0x86, 0x3f, 0xeb, 0x36, 0x51, 0xf3, 0xb0, 0xc3, 0x04,
+    0x93, 0x38, 0xd4, 0x14, 0x0f, 0xb2, 0x96, 0x6b, 0xce, 0xc0, 0xd5, 0xb8, 0xd5, 0xfa, 0xc7, 0x87,
+    0xa5, 0x5d, 0xda, 0xfa, 0xc2, 0x18, 0xb0, 0x5c, 0x86, 0x43, 0x7d, 0x7f, 0x65, 0x79, 0x44, 0x55,
+    0xb5, 0xfe, 0xb3, 0xf0, 0x7a, 0x13, 0xa9, 0x34, 0xbb, 0x1b, 0x88, 0x45, 0x41, 0x87, 0x4b, 0xa6,
+    0xd9, 0x15, 0xa2, 0x89, 0x82, 0x97, 0xfb, 0x15, 0x4c, 0xf7, 0x0b, 0xca, 0x05, 0x03, 0x70, 0xcf,
+    0xf0, 0x83, 0x95, 0xa5, 0x22, 0x2b, 0x82, 0x87, 0x16, 0x57, 0x3b, 0x93, 0x48, 0x88, 0xca, 0x9f,
+    0x40, 0x1e, 0xbe, 0x11, 0xcc, 0xf9, 0xb2, 0xb2, 0x95, 0x25, 0x12, 0x55, 0x85, 0x78, 0x20, 0xbc,
+    0xde, 0x99, 0x54, 0x14, 0x74, 0xfe, 0x0c, 0x72, 0x99, 0xd1, 0xa1, 0x65, 0xd8, 0x1f, 0xe8, 0x68,
+    0x04, 0x1d, 0xd6, 0xea, 0xb2, 0x89, 0x55, 0x07, 0xf9, 0xf0, 0x7b, 0x72, 0xc9, 0xee, 0x57, 0x8e,
+    0xcd, 0x13, 0xe0, 0xd6, 0x0f, 0xd0, 0x93, 0xbd, 0xb7, 0xc8, 0xf7, 0x53, 0x36, 0x24, 0xe2, 0x57,
+    0x5a, 0xff, 0x07, 0x37, 0xc4, 0x73, 0xfd, 0x00, 0xe3, 0x07, 0x3a, 0x66, 0xe9, 0xf4, 0x4d, 0xa2,
+    0x9d, 0x97, 0x9e, 0xb1, 0x64, 0xfb, 0x35, 0x37, 0x09, 0xbe, 0xde, 0x52, 0x93, 0xfc, 0x64, 0x39,
+    0xc1, 0x26, 0x31, 0xe0, 0x4b, 0x8f, 0x52, 0x67, 0x33, 0x28, 0x10, 0x92, 0x3e, 0x83, 0x8b, 0xcd,
+    0x80, 0x1c, 0xe3, 0x78, 0x75, 0x66, 0x19, 0x5f, 0x43, 0xb8, 0x65, 0x2c, 0x06, 0x2b, 0x9b, 0x05,
+    0xd4, 0xd1, 0xfa, 0x4f, 0x7f, 0x79, 0xb6, 0xb2, 0x93, 0xe2, 0x93, 0xd2, 0x55, 0x34, 0x3c, 0xca,
+    0x47, 0x60, 0x63, 0xa9, 0x44, 0x51, 0xb6, 0xe5, 0x54, 0x4d, 0x16, 0x65, 0xd0, 0x25, 0x11, 0x64,
+    0x73, 0x78, 0x9a, 0x42, 0x66, 0x35, 0x1a, 0xbf, 0x9c, 0x07, 0x03, 0x24, 0x3e, 0x8c, 0x0d, 0xcb,
+    0x59, 0x47, 0x48, 0xac, 0x22, 0x93, 0x14, 0x79, 0x09, 0x57, 0xdb, 0x12, 0x17, 0x6f, 0x76, 0x67,
+    0x32, 0x13, 0x54, 0xef, 0x5a, 0x70, 0x80, 0xc8, 0xd4, 0x35, 0x57, 0x4f, 0x03, 0x89, 0x7a, 0x5a,
+    0x1f, 0xa4, 0x76, 0x05, 0x17, 0x2b, 0xf7, 0x32, 0x12, 0xc0, 0x17, 0xee, 0x5e, 0x9e, 0xce, 0x03,
+    0x77, 0x93, 0x9e, 0xe5, 0x7a, 0xee, 0x38, 0xcb, 0x4d, 0xba, 0x95, 0x0b, 0xdb, 0x9d, 0x9b, 0xcb,
+    0x4d, 0xfa, 0x94, 0x1f, 0x47, 0x23, 0x6b, 0x48, 0x37, 0xe9, 0x51, 0x5e, 0xb9, 0x53, 0xfa, 0x55,
+    0x78, 0x71, 0x3a, 0x5c, 0xdd, 0x41, 0xd0, 0x21, 0x48, 0xf1, 0xf2, 0x82, 0x5c, 0x5f, 0xfe, 0x70,
+    0xfd, 0xe3, 0xdb, 0xed, 0x78, 0x07, 0x68, 0x73, 0x47, 0x8e, 0x01, 0xa9, 0xdd, 0xb9, 0x33, 0xa7,
+    0xc3, 0xee, 0x3a, 0x72, 0xea, 0x72, 0x41, 0x3d, 0xbf, 0x7e, 0xb3, 0x2d, 0x29, 0x75, 0x77, 0x27,
+    0xa6, 0xee, 0xd7, 0x20, 0xa7, 0x0f, 0x36, 0xbd, 0xa1, 0xf6, 0x1a, 0xb2, 0xe2, 0x15, 0x51, 0x5e,
+    0xe4, 0x35, 0x5e, 0xed, 0x6c, 0x20, 0x17, 0xa2, 0xf2, 0x27, 0x18, 0xc6, 0x81, 0x56, 0x7c, 0x60,
+    0x48, 0xaf, 0x63, 0x3c, 0xbc, 0xa6, 0xd6, 0xbf, 0xbc, 0x9d, 0xb9, 0xfe, 0xdc, 0xa3, 0x9b, 0x48,
+    0xa4, 0xbd, 0x91, 0x40, 0x24, 0x2a, 0x5c, 0x22, 0x6d, 0x21, 0x10, 0x9c, 0x24, 0x51, 0xe6, 0xcf,
+    0x7a, 0xf7, 0x2a, 0x15, 0x04, 0xfe, 0x25, 0x05, 0x33, 0x5e, 0xa3, 0xdf, 0x19, 0x63, 0xbf, 0xf3,
+    0xf2, 0x62, 0x3b, 0xae, 0x6c, 0xbc, 0xb3, 0x0e, 0x67, 0xbc, 0xd3, 0x0e, 0x87, 0x88, 0x39, 0x6c,
+    0xc9, 0x85, 0x35, 0x07, 0x11, 0xa2, 0x22, 0x8c, 0x9d, 0xd7, 0x19, 0x40, 0x28, 0x96, 0xd3, 0xb9,
+    0xdd, 0xc4, 0x74, 0x24, 0x1a, 0x71, 0xcb, 0x39, 0x8c, 0xec, 0xe6, 0xe8, 0x5e, 0xad, 0xe6, 0xb0,
+    0x14, 0xdb, 0x4d, 0x8c, 0x06, 0x29, 0x19, 0x52, 0xcb, 0xc6, 0x5d, 0xe1, 0xab, 0x0a, 0x44, 0xa9,
+    0xcb, 0x65, 0x42, 0x2e, 0xf8, 0xdd, 0x26, 0xb2, 0xe9, 0x6e, 0x22, 0x1b, 0x15, 0xa3, 0xb8, 0x78,
+    0x8e, 0xbf, 0x50, 0x4f, 0xd3, 0xe9, 0x9e, 0x7c, 0x49, 0xf1, 0x0c, 0x66, 0xab, 0xfb, 0x34, 0xa8,
+    0xa3, 0xf5, 0x9f, 0xbd, 0xd9, 0x8e, 0x4f, 0xc3, 0xc6, 0x2a, 0xfa, 0xb4, 0x8d, 0x3c, 0x18, 0x23,
+    0x6a, 0xe7, 0xc3, 0xe8, 0x35, 0xa4, 0xb1, 0x40, 0xc4, 0x7f, 0xd9, 0x92, 0x34, 0x16, 0xb3, 0x5d,
+    0xf5, 0x30, 0x8b, 0xaf, 0x41, 0x3e, 0x9e, 0xb1, 0xf8, 0x30, 0x9e, 0x1a, 0x2b, 0xcb, 0x48, 0xd4,
+    0xd3, 0xfa, 0x6f, 0x8d, 0x05, 0x79, 0x79, 0xf5, 0x74, 0x2b, 0xb2, 0x92, 0x8d, 0xee, 0x46, 0x5e,
+    0x21, 0xc9, 0xbb, 0x96, 0x99, 0x4d, 0x9d, 0xd5, 0x8d, 0x0a, 0x2b, 0x69, 0xfd, 0xd7, 0xd4, 0xf1,
+    0xc9, 0x85, 0xeb, 0x89, 0x13, 0xfc, 0xb6, 0x22, 0x35, 0xd6, 0xf2, 0x6e, 0x44, 0xc6, 0x89, 0xde,
+    0xb5, 0xbc, 0x26, 0x53, 0xcb, 0xf3, 0x5c, 0x6f, 0x65, 0x91, 0x89, 0x7a, 0x5a, 0xff, 0x55, 0xf3,
+    0x8a, 0x5d, 0x6d, 0x45, 0x5c, 0xb2, 0xd5, 0xdd, 0x48, 0x2c, 0xa4, 0x79, 0xd7, 0x42, 0xbb, 0x19,
+    0xd9, 0xd6, 0x6c, 0x65, 0x91, 0xb1, 0x5a, 0x5a, 0xff, 0x5d, 0xf3, 0x05, 0xfc, 0x6e, 0x45, 0x5c,
+    0xbc, 0xc5, 0xdd, 0x08, 0x4b, 0x50, 0xbb, 0x6b, 0x51, 0x99, 0xc3, 0xc5, 0xca, 0x82, 0x82, 0x3a,
+    0x5a, 0xff, 0xf9, 0xc5, 0x2f, 0x44, 0x7f, 0xee, 0x2e, 0x1c, 0x5c, 0x70, 0x49, 0x2e, 0x7f, 0xa8,
+    0x6f, 0x45, 0x62, 0xd8, 0xf4, 0x6e, 0xe4, 0xc5, 0x88, 0xde, 0xb5, 0xb4, 0xd8, 0x86, 0x97, 0x81,
+    0xe1, 0xad, 0xb1, 0xf6, 0x85, 0x57, 0xc4, 0xb5, 0x2f, 0x70, 0x45, 0x9e, 0x19, 0xdb, 0x71, 0x88,
+    0x61, 0xbb, 0xdb, 0x08, 0xda, 0x23, 0x22, 0x77, 0x1f, 0x65, 0x98, 0x15, 0x44, 0x14, 0x0f, 0x31,
+    0xcc, 0x0f, 0xb8, 0x45, 0x05, 0x77, 0xc1, 0x2e, 0x21, 0xd6, 0xb8, 0x7c, 0x4e, 0xbe, 0x97, 0xb7,
+    0x15, 0xa8, 0x59, 0x3b, 0x67, 0x97, 0x37, 0xb4, 0x8d, 0xe3, 0x13, 0x1f, 0xdc, 0x76, 0x8f, 0x8e,
+    0x36, 0x1b, 0xde, 0xe6, 0xa5, 0x51, 0x8f, 0x8e, 0xbe, 0xa0, 0x4c, 0x46, 0xc6, 0x90, 0x7e, 0x30,
+    0x69, 0xb0, 0xce, 0x62, 0x18, 0xa5, 0xae, 0xd6, 0x7f, 0x01, 0x37, 0xe4, 0x39, 0xbb, 0xd9, 0x56,
+    0x18, 0xa8, 0xb6, 0xbf, 0x0d, 0x4b, 0x8a, 0xd1, 0xbb, 0x6b, 0x63, 0x62, 0xc8, 0x40, 0xd0, 0xed,
+    0x8e, 0x9d, 0xb5, 0xf6, 0x16, 0xc4, 0xaa, 0x0b, 0xf1, 0xbd, 0xe5, 0xf7, 0xdb, 0x15, 0x60, 0x84,
+    0xc4, 0xd6, 0x64, 0xa8, 0xd0, 0xbd, 0xf3, 0x6c, 0x86, 0xdf, 0x34, 0xe6, 0xa6, 0xe5, 0xae, 0x9e,
+    0xd2, 0x10, 0x15, 0x71, 0xde, 0x1d, 0x7e, 0xb6, 0x93, 0xd9, 0x90, 0x6d, 0x26, 0x25, 0xb5, 0x59,
+    0xd6, 0x22, 0xa4, 0x64, 0x1b, 0xc2, 0x50, 0x77, 0x7b, 0x89, 0x13, 0x67, 0xcb, 0xb8, 0x2e, 0x76,
+    0x1d, 0xb1, 0xdc, 0x26, 0x0d, 0x9a, 0x7e, 0x60, 0xd9, 0xb6, 0xd6, 0x7f, 0x49, 0x03, 0x72, 0x8d,
+    0x97, 0x15, 0xb7, 0x19, 0x29, 0x50, 0xe4, 0x1e, 0xc3, 0xc0, 0xa3, 0xc6, 0x54, 0xeb, 0x5f, 0xe3,
+    0x59, 0xbc, 0x00, 0x0b, 0xef, 0x56, 0x07, 0xc6, 0x34, 0x9a, 0x3a, 0x9e, 0x0b, 0x48, 0x85, 0x16,
+    0x23, 0xce, 0xf8, 0xd3, 0x88, 0xbc, 0x52, 0x9e, 0xf5, 0x2f, 0x59, 0x61, 0x82, 0x26, 0x5f, 0xde,
+    0x5c, 0xe5, 0xfd, 0x4f, 0x6c, 0xc3, 0x23, 0xee, 0x60, 0x8c, 0x9f, 0xd4, 0x0d, 0x52, 0xe5, 0x3b,
+    0xc3, 0xfb, 0x67, 0xfe, 0xcc, 0x70, 0x64, 0x31, 0xb6, 0xd7, 0x77, 0x21, 0x36, 0x6f, 0x0e, 0x5c,
+    0xdb, 0x84, 0x82, 0x4f, 0xcd, 0x1b, 0x3c, 0xb5, 0xcc, 0x24, 0xd7, 0xe1, 0x36, 0x44, 0xac, 0x02,
+    0x6a, 0x21, 0x21, 0x94, 0xc8, 0x76, 0xe2, 0x49, 0xf0, 0x7c, 0xc3, 0x28, 0x9e, 0xf3, 0x54, 0x20,
+    0xdc, 0x9c, 0x9d, 0x93, 0x1e, 0x1d, 0x87, 0x8c, 0xcc, 0xda, 0x50, 0x9b, 0xb9, 0x8f, 0xf2, 0x2d,
+    0x1d, 0x5b, 0x3e, 0xe0, 0x48, 0x40, 0x2d, 0x0e, 0xd8, 0xde, 0x33, 0xae, 0xca, 0xd5, 0xf6, 0x35,
+    0xaa, 0x4d, 0x8a, 0x0d, 0xee, 0x99, 0xbb, 0x55, 0x57, 0x0a, 0xdf, 0x93, 0x7b, 0x4b, 0xe3, 0x10,
+    0xcb, 0x94, 0xfe, 0x41, 0xb3, 0x39, 0xe9, 0xe1, 0x2e, 0x3a, 0x22, 0x49, 0x3b, 0x3b, 0x98, 0xf4,
+    0xca, 0x36, 0x80, 0x95, 0x6e, 0x81, 0x04, 0x4a, 0xd7, 0xde, 0x01, 0x89, 0x5c, 0xea, 0x03, 0x36,
+    0x0d, 0x72, 0x65, 0xf8, 0x9f, 0x1a, 0xe4, 0x1d, 0x06, 0x5b, 0x5b, 0xdc, 0x08, 0x89, 0xb8, 0x1b,
+    0xa6, 0xe9, 0xe5, 0x6e, 0x86, 0xec, 0xc5, 0x36, 0x43, 0x1e, 0xcb, 0xcd, 0x90, 0xca, 0xb4, 0xc7,
+    0x6d, 0xa7, 0xd3, 0xb9, 0xc7, 0xfd, 0x90, 0xf7, 0x42, 0xd2, 0x14, 0x98, 0x59, 0x91, 0xa4, 0x9e,
+    0x24, 0xa9, 0xa7, 0x90, 0x74, 0xd2, 0xfe, 0xda, 0x28, 0x12, 0x93, 0xea, 0x5f, 0x09, 0x49, 0x95,
+    0x36, 0xad, 0x32, 0xdd, 0xbe, 0xaf, 0x3d, 0xab, 0x99, 0xce, 0xf0, 0xa8, 0xd0, 0x17, 0x2a, 0x36,
+    0xff, 0xf2, 0x3e, 0x6d, 0x7e, 0xbc, 0x81, 0xcd, 0x8f, 0x53, 0x36, 0xbf, 0x45, 0x63, 0x97, 0x88,
+    0xff, 0xc9, 0x0c, 0x5e, 0x92, 0xb5, 0x82, 0xd1, 0x67, 0x92, 0xb5, 0x5d, 0x0b, 0x09, 0x35, 0xe1,
+    0xe5, 0x7d, 0x5a, 0x48, 0x8e, 0xde, 0xae, 0xa5, 0xa4, 0xc2, 0xe7, 0xf4, 0xb7, 0xd3, 0x27, 0xb1,
+    0x48, 0x4a, 0x15, 0xa7, 0x68, 0x1d, 0x77, 0x7d, 0x1e, 0xf6, 0x44, 0xd8, 0x74, 0x1f, 0xe2, 0xa9,
+    0xbe, 0x39, 0xfe, 0x0b, 0x07, 0x65, 0x78, 0x3c, 0xc5, 0x4c, 0x89, 0x70, 0x2b, 0x07, 0x66, 0x17,
+    0xaf, 0xff, 0xb6, 0x5a, 0x2c, 0x96, 0x6c, 0x69, 0x7b, 0xf1, 0xd8, 0x7a, 0xda, 0xaa, 0x32, 0x4c,
+    0xe0, 0x0e, 0x1e, 0x07, 0x8f, 0x89, 0xe8, 0xfe, 0x1a, 0x52, 0x9e, 0x31, 0xf0, 0x53, 0x9c, 0x42,
+    0x58, 0x2d, 0x6f, 0x04, 0xce, 0x1c, 0xa1, 0x48, 0x20, 0xc3, 0xb5, 0xf4, 0x6b, 0xc4, 0x1d, 0x8d,
+    0xd8, 0x67, 0xdc, 0x1e, 0xa1, 0xc3, 0xf0, 0x3f, 0xe1, 0xf3, 0x76, 0x27, 0x44, 0x29, 0x6b, 0xb0,
+    0x17, 0x61, 0x18, 0xe2, 0xc6, 0x54, 0x4c, 0x28, 0xda, 0xbd, 0xb1, 0xe0, 0x90, 0xb3, 0xe0, 0xf9,
+    0xf7, 0xef, 0xb2, 0x78, 0xc0, 0x6d, 0xad, 0x9d, 0x66, 0xc1, 0xe1, 0xfa, 0x07, 0x5d, 0x74, 0x2a,
+    0x73, 0xab, 0x1d, 0x71, 0xeb, 0x70, 0x14, 0xed, 0xd7, 0xdd, 0xc4, 0x65, 0x65, 0x70, 0xe0, 0x88,
+    0xaf, 0xc8, 0x27, 0x6f, 0x54, 0x0b, 0xa8, 0xa4, 0x07, 0x47, 0xab, 0xe8, 0x81, 0x79, 0xb8, 0x81,
+    0x1a, 0x1c, 0xe5, 0xa8, 0xc1, 0x7d, 0xf1, 0xa0, 0xa7, 0xf5, 0xdf, 0xac, 0xa3, 0x06, 0xbd, 0x8a,
+    0x6a, 0x70, 0x28, 0xd5, 0x20, 0xda, 0xcc, 0xdd, 0xab, 0xca, 0x2c, 0x45, 0x0b, 0x1e, 0x8d, 0x70,
+    0x0d, 0xd3, 0xa3, 0x6a, 0x96, 0xb0, 0x3d, 0x9f, 0xbb, 0xb0, 0x9c, 0xd5, 0xfd, 0xed, 0x2f, 0x96,
+    0x63, 0xba, 0x8b, 0xd5, 0x5c, 0xae, 0xda, 0xd0, 0xd7, 0xee, 0x6e, 0x57, 0x1b, 0xb5, 0x62, 0x66,
+    0xa7, 0x79, 0x8b, 0x91, 0xbd, 0xe3, 0xbb, 0x1e, 0x49, 0x1f, 0xe3, 0x12, 0xdb, 0x0d, 0x2a, 0x4b,
+    0x57, 0x0b, 0x02, 0xd2, 0xfb, 0x5f, 0xbe, 0x7f, 0x41, 0xd6, 0x38, 0x63, 0x23, 0x03, 0x58, 0x87,
+    0x9f, 0x44, 0x42, 0xd6, 0x38, 0x8a, 0x24, 0x03, 0x5a, 0xce, 0x7e, 0x21, 0x3c, 0x15, 0x86, 0xac,
+    0x77, 0x2c, 0x4c, 0xe9, 0xd6, 0x19, 0x25, 0x76, 0xd9, 0x2c, 0x5f, 0xc1, 0xad, 0x15, 0x62, 0x2c,
+    0x7f, 0x2d, 0x05, 0x10, 0xd5, 0x6f, 0xd9, 0xd6, 0x22, 0x9f, 0x06, 0x5f, 0x3a, 0x32, 0xfc, 0xf5,
+    0x54, 0x71, 0x66, 0x61, 0xe3, 0x2b, 0x3a, 0xb3, 0x28, 0xce, 0x07, 0x65, 0xda, 0xf9, 0xe0, 0xe5,
+    0x1f, 0x19, 0x24, 0x2d, 0xd7, 0x27, 0xe9, 0xf0, 0xbe, 0x48, 0xda, 0xa0, 0xab, 0x0a, 0xb5, 0x2b,
+    0x70, 0x03, 0xc3, 0x5e, 0x5b, 0xb9, 0x78, 0x6d, 0xd0, 0x2d, 0xee, 0x73, 0xc9, 0x35, 0x90, 0xba,
+    0x55, 0x05, 0x93, 0x08, 0x54, 0x13, 0x46, 0x2f, 0x2d, 0x8c, 0x93, 0xaf, 0x4d, 0xbf, 0x38, 0x45,
+    0xcb, 0xf5, 0x29, 0x3a, 0xfe, 0x9a, 0xd4, 0xcb, 0x9d, 0x07, 0xf8, 0x74, 0x6d, 0xe7, 0xc5, 0xab,
+    0xa3, 0xf3, 0x62, 0x57, 0xdb, 0x57, 0xb0, 0x10, 0x83, 0xb5, 0xe5, 0x71, 0xd8, 0xfd, 0xda, 0x3c,
+    0x18, 0x27, 0x69, 0x03, 0x15, 0xeb, 0xf6, 0xb6, 0xa8, 0x62, 0xca, 0x44, 0x93, 0xe8, 0x07, 0x45,
+    0x00, 0xa3, 0x89, 0xb9, 0x81, 0x28, 0xa0, 0x59, 0x65, 0x26, 0x29, 0xbb, 0x57, 0x3e, 0x3b, 0x80,
+    0xa0, 0x30, 0xe3, 0x08, 0xc9, 0x6c, 0x3c, 0xcf, 0xf8, 0x17, 0x41, 0x73, 0x8e, 0x7f, 0x0c, 0x8f,
+    0x9d, 0x64, 0xd3, 0x6a, 0xd1, 0x59, 0xd1, 0x61, 0xa0, 0x99, 0x3c, 0x43, 0xba, 0xf4, 0x88, 0xc7,
+    0x33, 0x43, 0x9c, 0x87, 0x72, 0x43, 0xc5, 0x1c, 0x20, 0x99, 0x78, 0x74, 0x74, 0xae, 0x7d, 0x13,
+    0xc2, 0x14, 0xdc, 0xc2, 0x22, 0x1a, 0x01, 0x97, 0xec, 0xd8, 0xae, 0x81, 0xc1, 0xaa, 0x31, 0x0b,
+    0x00, 0xd3, 0xd6, 0xef, 0x33, 0x4c, 0xf2, 0x1a, 0x78, 0x78, 0x86, 0x51, 0x6d, 0xbe, 0x58, 0x39,
+    0xaa, 0x58, 0xdd, 0xbe, 0x13, 0x3d, 0xd6, 0xfa, 0x2b, 0xcc, 0x3e, 0xb3, 0x33, 0xac, 0xc5, 0x9a,
+    0x29, 0xbc, 0x0c, 0x67, 0x20, 0xff, 0xf7, 0xbf, 0xfe, 0xe7, 0xbf, 0xcb, 0xe0, 0xe0, 0x77, 0x66,
+    0x23, 0x86, 0x82, 0x5a, 0x7a, 0xc3, 0x73, 0x0d, 0x28, 0xf7, 0x5c, 0x1f, 0x42, 0x5b, 0x6b, 0x6c,
+    0xe5, 0x88, 0x3e, 0x4f, 0x7a, 0x07, 0x59, 0xe2, 0x4b, 0x14, 0xce, 0x18, 0xeb, 0x9c, 0xf9, 0x43,
+    0xcf, 0x9a, 0x41, 0xe8, 0x67, 0xba, 0xc3, 0xf9, 0x14, 0x38, 0xd0, 0x32, 0x4c, 0xf3, 0x12, 0x59,
+    0xf1, 0x1a, 0x33, 0xd6, 0x20, 0x49, 0xbd, 0xf6, 0xfc, 0xc7, 0xab, 0x0b, 0x7e, 0x20, 0xe9, 0x6b,
+    0xe0, 0x3f, 0x35, 0x6b, 0x0d, 0x32, 0x9a, 0x3b, 0x7c, 0x34, 0xa0, 0x33, 0xb6, 0xf1, 0xef, 0xfd,
+    0xde, 0x18, 0x1e, 0x19, 0x18, 0x3e, 0x7d, 0xe5, 0xfa, 0x01, 0x39, 0x27, 0x21, 0x44, 0xdb, 0x1d,
+    0xb2, 0x03, 0x6f, 0x5a, 0x9c, 0x2e, 0x51, 0x92, 0x13, 0xfe, 0xb3, 0x67, 0x43, 0xd1, 0xb0, 0xd6,
+    0x3e, 0xa9, 0x1d, 0xf0, 0x17, 0x35, 0x51, 0x6c, 0xe1, 0xc7, 0x8b, 0xb4, 0x3c, 0x3a, 0xb3, 0x8d,
+    0x21, 0xd5, 0x0f, 0xfe, 0x73, 0x12, 0x04, 0xb3, 0x83, 0x06, 0xa9, 0x2d, 0xfc, 0x5a, 0x9d, 0xd5,
+    0x84, 0x0b, 0xb4, 0x84, 0x10, 0xb9, 0x11, 0x7e, 0xfb, 0x17, 0xaa, 0xeb, 0x73, 0xcf, 0x6e, 0x90,
+    0xe1, 0xa0, 0xce, 0x8f, 0x9f, 0x65, 0x8f, 0xf1, 0x99, 0x3c, 0xe2, 0xbd, 0x15, 0x4c, 0xa8, 0xa3,
+    0x47, 0x34, 0x81, 0x59, 0xce, 0x5c, 0xc7, 0x8f, 0x7d, 0xc6, 0xd8, 0x1a, 0x45, 0xcf, 0x5b, 0x30,
+    0xb4, 0x08, 0xe6, 0x3e, 0x79, 0x70, 0x7e, 0x4e, 0x30, 0xd4, 0x8e, 0x1d, 0x6b, 0x3b, 0x1c, 0x24,
+    0xcb, 0x35, 0x48, 0xe2, 0xc1, 0x4f, 0xe0, 0xa4, 0x94, 0xb3, 0xe8, 0xef, 0x08, 0xb5, 0x13, 0x87,
+    0xa1, 0x87, 0x15, 0xd0, 0x9f, 0xe9, 0xf5, 0x38, 0x82, 0xba, 0x69, 0x04, 0x46, 0x3d, 0x7e, 0x94,
+    0x2e, 0xb4, 0x0a, 0x98, 0x34, 0x08, 0x7b, 0xa5, 0x9e, 0xeb, 0x7b, 0x57, 0x6f, 0x01, 0xf7, 0x81,
+    0xde, 0xb0, 0x36, 0xf5, 0xbc, 0xe4, 0xf7, 0x99, 0xa1, 0x76, 0xb3, 0xd3, 0x20, 0xf8, 0x26, 0x5e,
+    0x57, 0x41, 0x72, 0x4f, 0x3e, 0x93, 0x4c, 0x2b, 0x06, 0x9b, 0x01, 0x92, 0x83, 0xbb, 0x8b, 0x89,
+    0x08, 0xbc, 0xe0, 0x5b, 0x3a, 0x06, 0x8e, 0x8d, 0x1b, 0x62, 0x28, 0xdf, 0x60, 0xe3, 0xf8, 0x06,
+    0x77, 0xcf, 0x8a, 0xd4, 0x0e, 0x0e, 0xc0, 0xb9, 0x80, 0x7b, 0xa4, 0xa0, 0x4f, 0x63, 0xbd, 0x26,
+    0xa6, 0x52, 0x41, 0x17, 0x6b, 0xed, 0xdb, 0xda, 0x3e, 0x00, 0x68, 0x05, 0xee, 0x75, 0xe0, 0x59,
+    0xce, 0x18, 0x06, 0x41, 0xf5, 0x08, 0x1a, 0x7b, 0x8d, 0x20, 0x13, 0xef, 0xd9, 0x73, 0xd6, 0x48,
+    0xf2, 0x85, 0x2e, 0x9e, 0xef, 0xd7, 0xea, 0x35, 0x81, 0x3c, 0xbb, 0x07, 0x2d, 0xd4, 0xf9, 0xc5,
+    0x43, 0x86, 0x63, 0x9d, 0x9c, 0x9d, 0x89, 0x66, 0x78, 0x29, 0x7c, 0x08, 0x85, 0xd8, 0x4f, 0xe2,
+    0x55, 0xa8, 0x8a, 0x1f, 0xbf, 0xfd, 0x2c, 0x55, 0xf9, 0xee, 0x00, 0xb0, 0x7e, 0x82, 0xb9, 0x8c,
+    0x6f, 0x3f, 0xc3, 0xff, 0x77, 0x0f, 0x59, 0x02, 0xe3, 0xdb, 0xcf, 0xf8, 0x73, 0xf7, 0x10, 0x5a,
+    0x82, 0x6b, 0xd6, 0xde, 0xdd, 0x47, 0xc6, 0x87, 0x34, 0xf7, 0xc6, 0xb9, 0xdc, 0x0b, 0xd9, 0xb6,
+    0x32, 0x4e, 0xe3, 0x02, 0xa4, 0x3e, 0x46, 0x96, 0xaf, 0x0f, 0x5d, 0x13, 0xc4, 0x13, 0x80, 0x26,
+    0x4b, 0xa1, 0xdb, 0x20, 0x12, 0xc9, 0xa8, 0xf0, 0x6c, 0x69, 0x6b, 0xc4, 0x4a, 0x12, 0x61, 0x2a,
+    0x91, 0x82, 0xc8, 0x92, 0x33, 0xc3, 0xf3, 0xe9, 0xf7, 0x4e, 0xa0, 0x07, 0x31, 0xa3, 0xc8, 0xe1,
+    0x78, 0xbf, 0x1f, 0x23, 0x01, 0xff, 0x40, 0x3d, 0x28, 0x57, 0x13, 0x42, 0x0b, 0x95, 0x6d, 0x2f,
+    0xd4, 0xc3, 0x08, 0x53, 0xfe, 0x32, 0x47, 0x0f, 0x7f, 0x1d, 0xda, 0x9f, 0x74, 0x3c, 0xed, 0x36,
+    0xe9, 0x2a, 0x52, 0x2c, 0xc2, 0x42, 0x4f, 0xf0, 0x3f, 0xe0, 0x0b, 0xfe, 0xe4, 0xca, 0x07, 0xa0,
+    0xf2, 0xc1, 0x84, 0xce, 0x92, 0x11, 0x1f, 0x6e, 0x1b, 0x84, 0x5f, 0x2c, 0xc1, 0x32, 0x1c, 0x13,
+    0xef, 0xf1, 0x67, 0x29, 0xa5, 0x87, 0x0f, 0xc4, 0x15, 0x3c, 0x63, 0xd1, 0x33, 0x3e, 0xe2, 0x17,
+    0x58, 0x8a, 0x45, 0x3b, 0xac, 0x14, 0xbf, 0x82, 0x67, 0x78, 0xf2, 0x13, 0xe8, 0x6e, 0x83, 0x0c,
+    0x2c, 0xc7, 0x61, 0x17, 0x25, 0xd8, 0x47, 0x41, 0xc7, 0x13, 0xff, 0x16, 0x28, 0x10, 0xa8, 0xdd,
+    0x3d, 0xf4, 0x97, 0xe1, 0xdd, 0xf2, 0xee, 0x21, 0xc5, 0x77, 0x0c, 0x49, 0xb8, 0x5e, 0x8a, 0x6b,
+    0x78, 0x0e, 0xf8, 0xe1, 0x1b, 0x89, 0x30, 0x7b, 0xb0, 0x8c, 0x1e, 0x40, 0x89, 0x00, 0xdf, 0x0b,
+    0xe4, 0xe1, 0x6e, 0x19, 0xde, 0x61, 0x6d, 0x56, 0x57, 0x90, 0x01, 0xb7, 0xcb, 0xe8, 0x16, 0xde,
+    0xb2, 0x53, 0xac, 0x10, 0x09, 0x4e, 0xd3, 0xdd, 0x43, 0x41, 0x13, 0x3c, 0x12, 0x57, 0x49, 0x56,
+    0xa3, 0x4f, 0x08, 0x84, 0x17, 0x79, 0xc6, 0xc3, 0x05, 0xa5, 0xe7, 0x01, 0xfb, 0xb8, 0xb4, 0x29,
+    0x5e, 0x3e, 0x5b, 0x7e, 0x6f, 0xea, 0x35, 0x31, 0x35, 0x5c, 0x43, 0x1f, 0xa6, 0xd6, 0x69, 0xb9,
+    0xce, 0xd0, 0xb6, 0x86, 0x68, 0x28, 0x7a, 0x9d, 0x9c, 0xf7, 0x85, 0x1f, 0x43, 0x85, 0x86, 0xe2,
+    0xaa, 0x92, 0xe6, 0x82, 0x96, 0x93, 0x9b, 0xb5, 0x7a, 0x8b, 0xe9, 0xa1, 0xd0, 0x35, 0x04, 0x21,
+    0x4c, 0xb0, 0x1a, 0x0c, 0x2c, 0x9c, 0x01, 0x23, 0x65, 0x2d, 0x85, 0x40, 0x58, 0x69, 0x05, 0x0a,
+    0x03, 0xa3, 0xba, 0xda, 0x76, 0xc2, 0xcb, 0x16, 0x58, 0xb5, 0x34, 0xe0, 0x07, 0x49, 0x03, 0x06,
+    0x51, 0x79, 0x81, 0x5e, 0xbb, 0xc4, 0xed, 0x20, 0xef, 0x6b, 0xfb, 0x58, 0x68, 0xbf, 0xf6, 0xdb,
+    0x29, 0xa9, 0xed, 0xab, 0x96, 0x7c, 0x97, 0x34, 0x39, 0x2e, 0xb1, 0x71, 0x45, 0x89, 0x8d, 0x15,
+    0x89, 0x8d, 0xef, 0x57, 0x62, 0xea, 0x94, 0xf4, 0x26, 0x52, 0x53, 0xe7, 0x80, 0x0b, 0x24, 0x57,
+    0x5a, 0x5f, 0x08, 0x4d, 0x48, 0x6b, 0x9c, 0x25, 0xad, 0x75, 0xc4, 0xc4, 0xbb, 0x38, 0xb0, 0x1e,
+    0xea, 0xbd, 0xfa, 0xe9, 0xea, 0x35, 0xba, 0xca, 0x6c, 0x91, 0x85, 0x12, 0x4b, 0x86, 0x23, 0x19,
+    0x10, 0xb0, 0xef, 0x8c, 0x39, 0xee, 0x58, 0x1f, 0xba, 0x5f, 0x23, 0x3a, 0x03, 0x89, 0x3d, 0x68,
+    0x89, 0x22, 0x08, 0xc7, 0x5b, 0xcd, 0x76, 0xd1, 0xd9, 0x4a, 0xe3, 0x8d, 0x6a, 0x15, 0xe8, 0x02,
+    0x56, 0xa8, 0x24, 0x44, 0x0e, 0x39, 0x65, 0x30, 0x4a, 0x9f, 0xb0, 0x75, 0x13, 0x61, 0xf6, 0xea,
+    0x57, 0x75, 0x6a, 0xd2, 0xa7, 0x47, 0xbe, 0xcd, 0x2f, 0xe5, 0x8e, 0xf0, 0xfc, 0x95, 0x18, 0x24,
+    0xb2, 0xe9, 0x19, 0x0a, 0x2e, 0x7b, 0x82, 0x4a, 0x60, 0x64, 0x12, 0x35, 0x1f, 0xce, 0x72, 0x15,
+    0x38, 0xcb, 0x0c, 0x38, 0xa2, 0xe7, 0xa9, 0x04, 0x46, 0xa4, 0xdc, 0x72, 0xa1, 0x2c, 0x57, 0x80,
+    0x92, 0x85, 0x8b, 0xec, 0xe9, 0xaa, 0xd1, 0x24, 0xd2, 0x33, 0xf9, 0x70, 0x96, 0xab, 0xc0, 0x59,
+    0x66, 0xe8, 0x73, 0x32, 0x1a, 0x69, 0xcb, 0x7f, 0xeb, 0xc7, 0x1f, 0x23, 0x03, 0xbc, 0x45, 0xf4,
+    0xb3, 0x13, 0x2b, 0x19, 0xbf, 0x93, 0xd1, 0x22, 0xb5, 0x33, 0x7b, 0x03, 0x6a, 0xb7, 0x8c, 0x00,
+    0xfc, 0xd3, 0x60, 0x1e, 0x50, 0xbf, 0x85, 0x11, 0x6e, 0xc8, 0xc6, 0xd4, 0xab, 0x96, 0x03, 0x08,
+    0x30, 0x80, 0xf5, 0xd3, 0x76, 0x52, 0x3d, 0x53, 0xb0, 0xf8, 0xe3, 0x3c, 0x70, 0xfc, 0x6d, 0x0e,
+    0x44, 0xd1, 0xc3, 0xc4, 0x6b, 0xe0, 0xc3, 0x3c, 0x68, 0x6c, 0x14, 0xa3, 0xc0, 0xea, 0x1e, 0x1d,
+    0xa5, 0xfb, 0x19, 0xd1, 0x80, 0xf8, 0x3e, 0x21, 0x42, 0xc0, 0xcc, 0x58, 0x34, 0x34, 0x1b, 0x42,
+    0x20, 0x48, 0x6a, 0x72, 0xf2, 0xb0, 0x76, 0x9a, 0x8a, 0xb8, 0xa1, 0x86, 0x98, 0x0e, 0x24, 0x4f,
+    0x38, 0x8e, 0xb1, 0x4f, 0xc5, 0x0c, 0x60, 0x74, 0x1e, 0x7e, 0x5c, 0x8f, 0x03, 0x63, 0xdb, 0x6b,
+    0x42, 0x48, 0xfc, 0x19, 0x0e, 0x5c, 0x13, 0x8f, 0xf8, 0x2c, 0x53, 0xd3, 0x75, 0x68, 0x76, 0xab,
+    0xb1, 0xf8, 0x5d, 0x34, 0x24, 0xee, 0xc4, 0x9e, 0x85, 0xa8, 0x9a, 0x47, 0x83, 0xb9, 0xe7, 0x88,
+    0x78, 0x3e, 0x1d, 0xdf, 0x64, 0x0e, 0x25, 0xb7, 0xa8, 0x9b, 0x07, 0x07, 0xe4, 0x69, 0x10, 0x18,
+    0x20, 0x00, 0x9c, 0x31, 0x9d, 0x20, 0x7f, 0x88, 0x21, 0x92, 0x12, 0xae, 0x87, 0x4a, 0xc9, 0x97,
+    0x37, 0x53, 0x6e, 0xb7, 0xf8, 0x2d, 0x42, 0x69, 0xce, 0x0c, 0x54, 0xeb, 0x9f, 0x73, 0xea, 0x2d,
+    0xaf, 0x19, 0xc3, 0x5c, 0xef, 0xa9, 0x6d, 0xeb, 0xb5, 0x56, 0x34, 0x01, 0x5e, 0xe3, 0x63, 0xf0,
+    0x16, 0x80, 0xba, 0x84, 0x36, 0x40, 0xc6, 0x91, 0xce, 0xcb, 0x5c, 0x85, 0x90, 0x3b, 0x8c, 0xbb,
+    0xce, 0x85, 0x30, 0x92, 0x83, 0x7e, 0x28, 0xe1, 0x3a, 0x9f, 0xe8, 0x72, 0x3e, 0x03, 0xf6, 0x47,
+    0xc3, 0xf8, 0x7a, 0xfa, 0x1b, 0x3d, 0xc0, 0x1d, 0xda, 0x82, 0x92, 0x17, 0x62, 0x20, 0xd7, 0x39,
+    0xcc, 0x28, 0x14, 0x89, 0x80, 0x69, 0x27, 0x5a, 0x62, 0xfa, 0xfb, 0x42, 0x77, 0x7b, 0xd9, 0x77,
+    0x19, 0x29, 0x10, 0x81, 0xa0, 0x60, 0x9e, 0xec, 0xbc, 0x12, 0x2d, 0x24, 0xd2, 0x13, 0x77, 0xf5,
+    0xbd, 0xc8, 0x33, 0xcc, 0x67, 0xa6, 0x11, 0xd0, 0xb8, 0x73, 0x08, 0x75, 0x41, 0xbe, 0x9c, 0xba,
+    0x01, 0x4d, 0x78, 0x0c, 0x0b, 0xb7, 0xec, 0x18, 0xf6, 0xbb, 0x48, 0x1b, 0xbf, 0xa8, 0xf9, 0xeb,
+    0x1b, 0xd9, 0x7f, 0x2a, 0x07, 0x51, 0x6d, 0xdc, 0x9c, 0xd2, 0x90, 0xd0, 0x1f, 0x44, 0x5a, 0xa2,
+    0xf2, 0x21, 0xe6, 0x16, 0xf6, 0xe2, 0x96, 0xfb, 0xe0, 0x01, 0xbb, 0xda, 0x0b, 0x85, 0x26, 0xbd,
+    0xc7, 0x39, 0x89, 0x5e, 0x24, 0x04, 0x9c, 0x86, 0x9d, 0x80, 0x21, 0x81, 0x2b, 0x10, 0xb8, 0x6d,
+    0x85, 0xe2, 0x9d, 0x41, 0xb4, 0x89, 0xba, 0xf0, 0xff, 0x5e, 0xff, 0x2b, 0xf2, 0xfa, 0x5f, 0xce,
+    0xc5, 0x57, 0xcf, 0xc2, 0xf1, 0x7a, 0xd9, 0x69, 0xc1, 0xfd, 0x1a, 0x44, 0x3b, 0x99, 0x79, 0x3f,
+    0xe1, 0xba, 0x23, 0xfd, 0x9a, 0x58, 0x26, 0x47, 0x3a, 0xd2, 0x2c, 0xe4, 0x11, 0xa6, 0xfe, 0x31,
+    0x35, 0x8e, 0x79, 0x72, 0xbd, 0xc6, 0x67, 0x11, 0x98, 0x3f, 0xbe, 0x8b, 0x42, 0x92, 0x89, 0xbb,
+    0x28, 0xaa, 0xe9, 0x81, 0xd7, 0xb9, 0xa1, 0x89, 0xca, 0x61, 0x6d, 0xb1, 0xb1, 0xa8, 0xb4, 0x69,
+    0xb9, 0x01, 0x49, 0x74, 0x06, 0x50, 0x40, 0x3e, 0x81, 0xaa, 0x81, 0xc7, 0xac, 0x46, 0x01, 0x4b,
+    0x9d, 0x32, 0xa8, 0x12, 0xad, 0x42, 0xc0, 0x2c, 0xcc, 0x8b, 0x43, 0xe6, 0xae, 0x74, 0x05, 0x27,
+    0xab, 0x3e, 0x86, 0x1a, 0xf1, 0xdb, 0x73, 0xe2, 0xcc, 0x6d, 0x1b, 0x74, 0x10, 0x49, 0x00, 0x1d,
+    0x54, 0xdf, 0x66, 0xba, 0xe8, 0x7f, 0x5d, 0x7f, 0x16, 0x62, 0x1e, 0xe3, 0xc0, 0xc3, 0x87, 0x71,
+    0x68, 0x38, 0xc9, 0xc0, 0xc3, 0xf8, 0xb0, 0x35, 0x5e, 0xfe, 0xc2, 0x75, 0x46, 0xd6, 0x38, 0xea,
+    0x67, 0x05, 0x4a, 0xd0, 0x59, 0x3f, 0x88, 0x31, 0x5e, 0x89, 0x71, 0x00, 0x11, 0xcb, 0x64, 0x0c,
+    0x62, 0xe7, 0xb5, 0xa6, 0xb2, 0xb1, 0x4f, 0x98, 0xd6, 0xeb, 0x54, 0x9c, 0xe4, 0x58, 0x07, 0xfe,
+    0xa3, 0x32, 0x47, 0x0f, 0xe2, 0x29, 0x82, 0x04, 0xc4, 0x71, 0x0c, 0x22, 0x12, 0x96, 0xc0, 0x9b,
+    0x79, 0x28, 0x84, 0x87, 0x67, 0x9a, 0x89, 0x73, 0xd5, 0xd4, 0xcf, 0xec, 0xb2, 0xc6, 0x01, 0x0c,
+    0x9e, 0xbb, 0x56, 0x2f, 0x8a, 0x0d, 0x58, 0xc1, 0x1c, 0x20, 0xac, 0x81, 0x34, 0x90, 0x42, 0xcc,
+    0xe5, 0xa1, 0xd6, 0x19, 0x0c, 0x61, 0xe0, 0x16, 0x03, 0x64, 0x05, 0x6b, 0x15, 0x2e, 0x8b, 0x40,
+    0x25, 0x36, 0xc4, 0x66, 0x00, 0xe4, 0x86, 0xa8, 0xf3, 0x2d, 0x86, 0x7c, 0x88, 0x8e, 0xc0, 0x85,
+    0x8d, 0xc5, 0x9f, 0xe7, 0xb6, 0x44, 0x12, 0x7b, 0xe7, 0x53, 0xed, 0xf4, 0x49, 0xb3, 0x23, 0xb1,
+    0x87, 0xa2, 0x2f, 0x71, 0xbd, 0x42, 0x48, 0x43, 0xf8, 0x20, 0x1e, 0xbe, 0xa6, 0xd2, 0xd7, 0xaa,
+    0x9e, 0xf1, 0x4e, 0xf6, 0x73, 0xbc, 0xe3, 0xb9, 0xcf, 0x3e, 0xa7, 0x43, 0xd4, 0xcf, 0x4e, 0xaa,
+    0x3d, 0xc3, 0x86, 0xdd, 0x4d, 0x01, 0x4c, 0x3e, 0xc1, 0x9c, 0x04, 0x3a, 0x1f, 0x4c, 0xad, 0x20,
+    0x03, 0x60, 0xad, 0x53, 0x5b, 0xa5, 0xe7, 0x52, 0xad, 0x9c, 0x7b, 0x4a, 0x16, 0xd4, 0x03, 0xa0,
+    0x58, 0x3a, 0x9e, 0x7d, 0xa6, 0xc5, 0xb5, 0x9f, 0xdc, 0x18, 0x1e, 0x26, 0xd9, 0x51, 0xc0, 0x89,
+    0xc9, 0x9f, 0x3d, 0x65, 0xd6, 0x92, 0x81, 0x88, 0xcf, 0x5b, 0xca, 0xb9, 0xc2, 0xf8, 0x18, 0x40,
+    0x9d, 0x2c, 0xfb, 0xe8, 0x51, 0xa8, 0xe7, 0x63, 0x52, 0x83, 0x7c, 0xfb, 0x99, 0x81, 0xb8, 0x23,
+    0x23, 0xf0, 0x32, 0xfe, 0x84, 0x9a, 0x6c, 0x4a, 0x22, 0xc0, 0x2f, 0xb5, 0xe2, 0x84, 0x4f, 0x6c,
+    0x9e, 0xf2, 0xee, 0x63, 0x5d, 0x9d, 0xf5, 0x63, 0xb4, 0x94, 0x0e, 0x53, 0xd8, 0x54, 0x78, 0xf1,
+    0x08, 0x85, 0x07, 0xf6, 0x19, 0x49, 0xa9, 0xd0, 0xb6, 0xa1, 0x04, 0x44, 0x43, 0xd0, 0xcc, 0x0f,
+    0x10, 0xf7, 0x24, 0xd4, 0xb4, 0x2e, 0x06, 0x58, 0x20, 0x01, 0x53, 0xba, 0x4a, 0x2e, 0x23, 0x1c,
+    0x46, 0x71, 0x36, 0xc5, 0x38, 0xcc, 0x89, 0x11, 0xb4, 0x94, 0xcf, 0xf5, 0x8a, 0xf8, 0x21, 0xe4,
+    0xc5, 0xef, 0x3e, 0x0c, 0x8b, 0xea, 0x7b, 0xca, 0xe4, 0x67, 0x12, 0x06, 0x36, 0xa0, 0x00, 0x88,
+    0xb1, 0x28, 0x8f, 0x4d, 0xf1, 0x5d, 0xf8, 0xb5, 0xc8, 0x53, 0xe5, 0x8e, 0xea, 0x88, 0xda, 0xd3,
+    0xb2, 0x6e, 0x96, 0xb5, 0xfb, 0x9e, 0xa9, 0xcc, 0x6f, 0x22, 0x03, 0xa3, 0x78, 0xbc, 0xfa, 0x2a,
+    0xe8, 0xa4, 0x06, 0x97, 0x25, 0xa8, 0xdc, 0x63, 0x98, 0xad, 0x8c, 0x32, 0x19, 0x3c, 0x08, 0x66,
+    0x53, 0xc3, 0x4b, 0x35, 0x16, 0xcc, 0x1e, 0x4b, 0xc6, 0x47, 0x7b, 0x0a, 0x7b, 0x32, 0xe3, 0xc0,
+    0x5c, 0x76, 0x71, 0xed, 0xe2, 0xe6, 0x7a, 0x63, 0xd1, 0x45, 0x61, 0xe2, 0x95, 0x2f, 0x54, 0xa8,
+    0xc7, 0x2a, 0x5c, 0x84, 0x2b, 0x60, 0x4a, 0x6b, 0x46, 0xab, 0x65, 0x14, 0x18, 0x6c, 0x29, 0x4c,
+    0xb5, 0x79, 0x11, 0x56, 0x34, 0x56, 0x15, 0xa1, 0x96, 0xd7, 0x8d, 0xed, 0x97, 0x57, 0xea, 0xab,
+    0x5d, 0x4f, 0x51, 0x7d, 0x65, 0x8b, 0xbc, 0x52, 0x9b, 0xd9, 0x7d, 0x79, 0x65, 0x75, 0xa5, 0x8c,
+    0x8a, 0xbb, 0x71, 0x53, 0xa1, 0x72, 0xb4, 0x58, 0x48, 0xa9, 0x2a, 0x7b, 0xb3, 0xa2, 0x8a, 0xe1,
+    0x59, 0x39, 0x35, 0x45, 0xbe, 0xec, 0x98, 0x04, 0xf1, 0xc5, 0xde, 0x82, 0xba, 0xf2, 0x40, 0x05,
+    0xb5, 0x49, 0xeb, 0x86, 0xb2, 0x45, 0x32, 0x85, 0x6d, 0x86, 0xab, 0x8a, 0x6a, 0xd2, 0x65, 0x1d,
+    0x2c, 0x7c, 0xe8, 0x64, 0x3c, 0xcf, 0xa2, 0x3e, 0x01, 0x1f, 0x02, 0x0a, 0x63, 0x52, 0xb7, 0xc1,
+    0x11, 0x21, 0x86, 0x63, 0x12, 0x56, 0xdc, 0xc7, 0xa4, 0x11, 0xf4, 0x69, 0xd8, 0x98, 0x23, 0xbe,
+    0xa3, 0x4c, 0x5e, 0xb0, 0xef, 0x8e, 0x12, 0x70, 0x8a, 0x1c, 0x14, 0xf6, 0xec, 0x0e, 0x00, 0x01,
+    0xa2, 0xc6, 0x13, 0xfc, 0xb0, 0xf4, 0x80, 0xfc, 0xfc, 0xf6, 0x35, 0xab, 0x8a, 0x90, 0x7d, 0x28,
+    0xcd, 0x16, 0x19, 0xf5, 0x1b, 0x0c, 0x70, 0xe7, 0x98, 0x0c, 0xac, 0x80, 0xbc, 0xb9, 0xb8, 0x22,
+    0x96, 0x8f, 0x1d, 0xd1, 0x1c, 0x3a, 0xdd, 0x00, 0x1b, 0x15, 0xd9, 0x2a, 0x44, 0xe1, 0x17, 0xd7,
+    0xfb, 0xc4, 0x72, 0xdf, 0x13, 0x43, 0x4c, 0x0e, 0x20, 0xbc, 0x21, 0xc5, 0x9c, 0x18, 0x99, 0xb2,
+    0xc6, 0xc9, 0x60, 0x3e, 0x1a, 0x51, 0x0f, 0x2a, 0x23, 0x54, 0xd3, 0x73, 0x67, 0x3e, 0x59, 0x60,
+    0x71, 0xdb, 0x18, 0xfb, 0x1c, 0xd4, 0xd4, 0x85, 0x62, 0x00, 0xc2, 0x21, 0x06, 0xf1, 0x21, 0x12,
+    0x82, 0x72, 0x03, 0x3a, 0xb1, 0x1c, 0xb3, 0x15, 0x8d, 0xdd, 0x87, 0x53, 0xd9, 0x16, 0xf4, 0x86,
+    0xbc, 0x87, 0xc4, 0x71, 0x08, 0x79, 0x0d, 0x3c, 0x7b, 0x33, 0x9c, 0x12, 0x7a, 0x0b, 0x91, 0x8d,
+    0xe9, 0xc7, 0xd0, 0x7a, 0xe3, 0xb9, 0x43, 0x8a, 0x8b, 0xa3, 0xa2, 0x00, 0x03, 0x81, 0x79, 0x73,
+    0xf4, 0x62, 0xba, 0x1a, 0x65, 0xfa, 0xf3, 0x19, 0xf5, 0xf4, 0xc8, 0xb6, 0x83, 0x89, 0xe5, 0xb7,
+    0x18, 0xcd, 0xd0, 0xdc, 0xfb, 0xdf, 0x32, 0x9e, 0x63, 0x70, 0xdf, 0x8e, 0x3f, 0x67, 0xf4, 0xc7,
+    0xc6, 0x3c, 0xca, 0xcb, 0x99, 0xeb, 0x05, 0xd0, 0x87, 0x81, 0x44, 0x7c, 0x83, 0x65, 0xa7, 0x68,
+    0xd2, 0x41, 0x46, 0xb0, 0x5b, 0xb3, 0xb9, 0x0f, 0x2e, 0xb4, 0xc5, 0x96, 0xe6, 0x64, 0x96, 0x30,
+    0xc9, 0x3e, 0x40, 0x60, 0x05, 0x5a, 0x7c, 0xa5, 0xa2, 0x52, 0x6c, 0x31, 0xb1, 0x40, 0x3f, 0x75,
+    0xb5, 0x74, 0x1f, 0xc5, 0x3b, 0xb3, 0xe9, 0x5b, 0x83, 0x8f, 0x17, 0x94, 0xb6, 0x78, 0x75, 0x28,
+    0xd1, 0x49, 0xa6, 0xfb, 0x54, 0x00, 0xcd, 0x73, 0xb5, 0x8e, 0x3f, 0xb1, 0x46, 0xb8, 0xc8, 0x28,
+    0xd5, 0xf4, 0x5d, 0x3a, 0x7c, 0x16, 0xbf, 0x33, 0x2e, 0x0b, 0x9d, 0x2d, 0xc4, 0xf4, 0xe5, 0x74,
+    0x80, 0x5f, 0x4f, 0x04, 0x20, 0x6c, 0xe2, 0x02, 0xb8, 0x23, 0x5e, 0xbf, 0x6f, 0xff, 0x06, 0xff,
+    0x62, 0x23, 0x84, 0x07, 0x31, 0x5e, 0xc7, 0x68, 0x31, 0xc9, 0x99, 0x4a, 0xe7, 0x01, 0x39, 0xaa,
+    0x27, 0xd6, 0x48, 0xb1, 0x7e, 0x5a, 0x0c, 0x75, 0x93, 0x18, 0x27, 0x64, 0x18, 0x2b, 0xc5, 0x86,
+    0x90, 0x31, 0x89, 0x0b, 0x26, 0x5b, 0xd0, 0x24, 0xe0, 0x2a, 0xb9, 0x98, 0xc5, 0xda, 0xc4, 0x62,
+    0x2f, 0x46, 0x24, 0xfb, 0xac, 0x3b, 0x51, 0x79, 0xaa, 0x92, 0x29, 0x4b, 0xa1, 0x67, 0xbb, 0x32,
+    0x82, 0x49, 0x6b, 0x6a, 0x39, 0xba, 0xd2, 0x4a, 0x93, 0x58, 0x0d, 0x0e, 0x42, 0x36, 0xa1, 0x54,
+    0xc5, 0x72, 0x3e, 0x0d, 0x74, 0xfe, 0x1e, 0x42, 0x53, 0xf0, 0x1e, 0xc6, 0x52, 0x6f, 0x37, 0x88,
+    0x53, 0x6f, 0x10, 0x4b, 0x2d, 0x6a, 0xa1, 0x16, 0x39, 0x7b, 0xb9, 0x12, 0x57, 0x5f, 0x21, 0xeb,
+    0x1d, 0x36, 0x62, 0x89, 0x35, 0x9c, 0xab, 0x32, 0x52, 0x47, 0x54, 0xe5, 0xc8, 0x4a, 0xd9, 0xc6,
+    0x38, 0x40, 0x24, 0xf4, 0x10, 0x6d, 0xa7, 0x5e, 0xa8, 0x5d, 0x1c, 0xaf, 0xb8, 0x10, 0xea, 0x69,
+    0xab, 0xca, 0xb3, 0xcc, 0xbb, 0xbd, 0x7c, 0xd5, 0xb8, 0x53, 0xd2, 0x48, 0x32, 0xfb, 0x1e, 0x3a,
+    0x14, 0xe1, 0xab, 0xc1, 0x2b, 0xd5, 0x1a, 0xd2, 0x05, 0xd5, 0x59, 0xd8, 0x8d, 0x9a, 0x82, 0xef,
+    0x08, 0x4f, 0x4b, 0x28, 0xd3, 0x4e, 0x81, 0x3b, 0x7b, 0xcd, 0x5f, 0xa8, 0x01, 0x2c, 0x53, 0x69,
+    0xac, 0x90, 0x0c, 0x27, 0x95, 0xe6, 0xf1, 0x75, 0x6b, 0xe1, 0xb3, 0x10, 0xd8, 0xf5, 0x43, 0xd0,
+    0xea, 0x2b, 0xf6, 0x42, 0x70, 0x1b, 0x41, 0xb2, 0xe7, 0xac, 0x97, 0x88, 0xe0, 0x46, 0xcf, 0x62,
+    0xc5, 0xef, 0xe2, 0x95, 0xd8, 0xe7, 0xaa, 0x7f, 0xf6, 0xec, 0xa8, 0x1e, 0xf4, 0x12, 0x10, 0x88,
+    0xdd, 0xb8, 0x9f, 0xe8, 0x8f, 0x83, 0xdf, 0xa1, 0x77, 0x81, 0xfb, 0x44, 0x51, 0x05, 0x0e, 0x1f,
+    0x2e, 0xca, 0xde, 0xae, 0x1e, 0x22, 0x19, 0x21, 0xad, 0x4e, 0xc5, 0xa1, 0x5c, 0x98, 0xc7, 0x86,
+    0xd7, 0x86, 0xbf, 0x74, 0x86, 0x22, 0x34, 0x6e, 0x90, 0x09, 0xb5, 0x6d, 0x57, 0xe1, 0x93, 0xd2,
+    0x01, 0x23, 0x28, 0x88, 0xb3, 0x58, 0x3d, 0xb6, 0xcc, 0xf4, 0x36, 0xd0, 0x3f, 0x2b, 0x86, 0x7f,
+    0xca, 0x2b, 0x0b, 0x52, 0xf9, 0xf3, 0x0f, 0x1e, 0x7a, 0x04, 0x11, 0xb2, 0xb1, 0x26, 0x5a, 0x12,
+    0x16, 0xfb, 0x55, 0xda, 0x98, 0xba, 0xe6, 0xdc, 0xa6, 0x7c, 0x0d, 0x29, 0x92, 0x3e, 0x84, 0xc0,
+    0x23, 0x50, 0x48, 0xc7, 0xb6, 0x9f, 0x41, 0xef, 0xa9, 0xbf, 0x8f, 0x3a, 0x25, 0x88, 0x0e, 0x3f,
+    0xb3, 0xf5, 0xe4, 0xa7, 0xa4, 0x66, 0xcc, 0x66, 0x30, 0x50, 0x61, 0xeb, 0x57, 0x0f, 0x7e, 0x37,
+    0x6e, 0x0c, 0xbe, 0x5e, 0xb6, 0x06, 0x8d, 0xf3, 0xd6, 0x8d, 0x85, 0x61, 0x09, 0x4a, 0x38, 0x0e,
+    0x02, 0x06, 0x26, 0xe9, 0xae, 0x58, 0xdb, 0x7a, 0x88, 0x02, 0xaf, 0x91, 0x25, 0x80, 0x44, 0x11,
+    0x29, 0x3e, 0x96, 0xfc, 0x49, 0x8c, 0x2e, 0x52, 0xfa, 0xc4, 0xe9, 0x07, 0xec, 0x55, 0x4e, 0x0a,
+    0x2c, 0x70, 0xf8, 0xa4, 0x33, 0xb4, 0x1a, 0x24, 0x52, 0xf2, 0x7a, 0xbc, 0x5e, 0x4b, 0xc4, 0x19,
+    0xbc, 0x20, 0x8c, 0x4c, 0x20, 0xc2, 0x72, 0x18, 0xc5, 0x82, 0x44, 0xf6, 0x18, 0xc6, 0x43, 0x10,
+    0xe7, 0xe8, 0x89, 0x6c, 0xa5, 0xeb, 0xa0, 0x15, 0x5c, 0x85, 0xfd, 0xa0, 0x14, 0x38, 0xeb, 0xec,
+    0x92, 0xf2, 0x9e, 0xc0, 0x88, 0x8d, 0x05, 0xc6, 0x88, 0xe6, 0x73, 0x28, 0xf1, 0x0e, 0x02, 0x66,
+    0xb6, 0x9a, 0x95, 0xcd, 0x41, 0x43, 0x5c, 0xae, 0x14, 0x9e, 0x19, 0x4b, 0x5c, 0xee, 0x2d, 0x4a,
+    0xff, 0x6c, 0x39, 0xc1, 0xc9, 0x53, 0xe6, 0x44, 0x78, 0x79, 0x59, 0x58, 0x66, 0x1f, 0x38, 0x6c,
+    0x0c, 0xc2, 0x58, 0x51, 0xbd, 0x5d, 0x4f, 0x24, 0x22, 0xda, 0xa7, 0x18, 0x9c, 0x30, 0x5d, 0x8a,
+    0x02, 0x05, 0xc6, 0x02, 0xf6, 0x0c, 0xda, 0xf9, 0xeb, 0xf5, 0x8f, 0x3f, 0xb4, 0xd8, 0xd0, 0x85,
+    0x69, 0x05, 0xae, 0xd2, 0x7d, 0x4e, 0x71, 0xc6, 0x0f, 0x62, 0x09, 0xe0, 0x0a, 0x5e, 0xe9, 0x02,
+    0xab, 0x7a, 0x3d, 0xe6, 0xb2, 0x14, 0x38, 0x49, 0x33, 0x15, 0xcd, 0x08, 0xc3, 0x90, 0xec, 0x51,
+    0x2a, 0xc8, 0xf5, 0xb9, 0x2c, 0x82, 0x88, 0x2d, 0x71, 0x65, 0x90, 0x40, 0x05, 0xc9, 0x3e, 0xa1,
+    0xf5, 0x7a, 0x86, 0x9b, 0x4b, 0x25, 0x34, 0x3a, 0xa7, 0xa0, 0xb8, 0x40, 0xe5, 0x5f, 0xdf, 0x5c,
+    0xbe, 0x4c, 0x74, 0xc4, 0xf3, 0x2a, 0x16, 0xc0, 0x89, 0x53, 0xd5, 0x9f, 0x2d, 0xeb, 0x3f, 0xf8,
+    0x7d, 0x46, 0xc7, 0x91, 0xca, 0xb3, 0x9c, 0x08, 0x48, 0xae, 0xe5, 0x7b, 0x43, 0xcc, 0xdf, 0x7a,
+    0x76, 0x06, 0x33, 0xd2, 0x8e, 0x27, 0x4f, 0xf7, 0x13, 0xe5, 0x33, 0xe8, 0x8c, 0x97, 0x48, 0x34,
+    0xa9, 0x32, 0xe1, 0x4e, 0x65, 0x46, 0x57, 0x30, 0x03, 0x62, 0xde, 0x78, 0xc8, 0x11, 0x2a, 0x7e,
+    0x1c, 0x37, 0x15, 0x90, 0xda, 0x7a, 0x18, 0xb2, 0x0a, 0x55, 0x84, 0x71, 0x6d, 0xe7, 0x38, 0x52,
+    0xc5, 0x96, 0x0f, 0xfe, 0x81, 0xe2, 0xa0, 0xb2, 0x9e, 0xa8, 0xc2, 0x7d, 0x95, 0x2f, 0xaa, 0xbd,
+    0x00, 0xd6, 0x06, 0x87, 0x5d, 0x5e, 0x11, 0xad, 0x2e, 0xd9, 0xd9, 0xe3, 0xc4, 0xb0, 0x1e, 0x86,
+    0x26, 0x8f, 0x09, 0xf6, 0x83, 0x51, 0x39, 0xb8, 0xdf, 0xdf, 0x4f, 0xa8, 0x15, 0x87, 0xff, 0xde,
+    0xc2, 0x9e, 0x16, 0x4a, 0xe2, 0xc5, 0x01, 0x39, 0xec, 0x3e, 0x3a, 0x3e, 0xc9, 0x65, 0x22, 0x02,
+    0x64, 0xc1, 0xeb, 0xcc, 0xf5, 0x03, 0x61, 0xb6, 0xba, 0x00, 0xd4, 0x20, 0xef, 0xc5, 0x55, 0x8b,
+    0x47, 0xf9, 0xbf, 0xd5, 0xcb, 0xb9, 0x7c, 0x28, 0xb8, 0xcc, 0x46, 0x2e, 0x09, 0x06, 0xd0, 0x9b,
+    0xb5, 0xad, 0x2a, 0xec, 0x73, 0xd8, 0x0a, 0x78, 0xb1, 0xfd, 0x00, 0xe3, 0xec, 0x1b, 0x96, 0x64,
+    0x8c, 0x4f, 0x75, 0xdf, 0xb4, 0x30, 0x75, 0x71, 0x93, 0x95, 0x69, 0x4e, 0xf4, 0x5d, 0x45, 0xf9,
+    0xe4, 0xac, 0xa2, 0x05, 0xf4, 0xdf, 0x65, 0x74, 0x7e, 0x19, 0x11, 0x41, 0xbc, 0xa7, 0x53, 0x86,
+    0x9c, 0x4a, 0xea, 0xb3, 0x86, 0x4e, 0x99, 0x80, 0xb5, 0xb9, 0xa3, 0x51, 0x4d, 0xa9, 0xc5, 0x44,
+    0x06, 0xb5, 0x3e, 0x93, 0x85, 0x7f, 0xca, 0x94, 0xe8, 0x17, 0x3a, 0xb8, 0x86, 0x88, 0x0a, 0x02,
+    0xc2, 0x8f, 0xdf, 0x7e, 0x66, 0x5b, 0x23, 0xee, 0x9e, 0xb0, 0x41, 0xe4, 0xf9, 0xd4, 0xb0, 0x9c,
+    0x87, 0x0c, 0xfc, 0xf9, 0xb7, 0x9f, 0xd9, 0xef, 0xdd, 0xc7, 0x7a, 0xac, 0x87, 0x80, 0xb8, 0x62,
+    0x00, 0x7e, 0xdd, 0x5b, 0xfe, 0xc4, 0x66, 0x49, 0xa0, 0x6b, 0x43, 0x55, 0xe4, 0x92, 0xae, 0xc5,
+    0xcb, 0xa5, 0x46, 0x36, 0x31, 0x37, 0x2f, 0x9d, 0x98, 0x3a, 0xa4, 0x51, 0xaa, 0xca, 0xa8, 0x26,
+    0x9e, 0xd8, 0x2b, 0xea, 0xd2, 0x62, 0x9d, 0x9a, 0xa2, 0x5f, 0x8c, 0x09, 0x10, 0xe3, 0xd9, 0x03,
+    0x83, 0xc5, 0xd7, 0x0f, 0x14, 0xb7, 0xb9, 0x27, 0xb5, 0x9a, 0xc7, 0x61, 0x61, 0x68, 0x8a, 0xed,
+    0xc8, 0x2a, 0x6a, 0x0b, 0xa0, 0xa2, 0x3f, 0xb8, 0xc4, 0x73, 0xdd, 0x29, 0x0e, 0x91, 0x61, 0x20,
+    0x0e, 0x83, 0x16, 0x8f, 0x8d, 0x50, 0xbd, 0x1b, 0xe8, 0x93, 0xa0, 0x17, 0x99, 0xe0, 0x58, 0xc5,
+    0x0a, 0x4e, 0xc9, 0xdc, 0xa7, 0x6c, 0x0c, 0x7d, 0x85, 0x6e, 0x54, 0x64, 0x55, 0xb2, 0x1c, 0xdf,
+    0x47, 0x5c, 0x2d, 0x2d, 0x36, 0xb1, 0xdc, 0x7d, 0xcc, 0x5b, 0x3d, 0xa9, 0x66, 0x65, 0xe2, 0x8b,
+    0x28, 0xd5, 0x83, 0x0a, 0x6b, 0x19, 0x71, 0xaa, 0x08, 0xb4, 0x18, 0xd1, 0x49, 0x65, 0x73, 0x67,
+    0xbc, 0x5e, 0x82, 0xcf, 0x09, 0x76, 0x2c, 0xd8, 0x72, 0xaf, 0x16, 0x3e, 0xd5, 0xc5, 0x2c, 0x51,
+    0x75, 0x74, 0x92, 0xca, 0x9d, 0xd9, 0x20, 0xb2, 0xbb, 0x16, 0x6a, 0x65, 0x8d, 0x58, 0x8e, 0x68,
+    0x34, 0xe2, 0x7d, 0x68, 0x19, 0x32, 0x42, 0x8d, 0x73, 0xa8, 0x98, 0xa1, 0x42, 0x81, 0xd1, 0x94,
+    0x63, 0xd9, 0xb5, 0x7a, 0x29, 0x31, 0xee, 0x2c, 0x49, 0x8b, 0x6a, 0x7c, 0xa9, 0x85, 0x25, 0x9f,
+    0x63, 0x81, 0x97, 0x8a, 0x7d, 0x42, 0xc1, 0x52, 0xe4, 0xa4, 0xd7, 0xfc, 0xf0, 0x44, 0xaa, 0x8f,
+    0xf9, 0x15, 0x71, 0x26, 0x26, 0xae, 0xc9, 0x8c, 0x12, 0x7b, 0x39, 0xd9, 0xef, 0x48, 0xaa, 0x02,
+    0x74, 0x9c, 0x35, 0xca, 0x94, 0x01, 0xdf, 0x00, 0xf7, 0xe4, 0xc3, 0x70, 0x00, 0xc6, 0xfe, 0x1c,
+    0x6d, 0xc2, 0x01, 0x06, 0xd5, 0x05, 0xcf, 0xb2, 0xb9, 0xc5, 0xc5, 0x19, 0x25, 0xe9, 0xaa, 0x22,
+    0xc1, 0x7c, 0x63, 0x36, 0xb4, 0x18, 0xfb, 0xb3, 0xc1, 0xa9, 0x99, 0xc9, 0x4b, 0x47, 0xce, 0x22,
+    0xe7, 0xc9, 0xed, 0x3c, 0x2d, 0x39, 0x19, 0x53, 0x28, 0x00, 0xe2, 0xc2, 0x89, 0x21, 0x9b, 0xd0,
+    0x2d, 0x45, 0x6f, 0x93, 0xd2, 0x52, 0x93, 0x9d, 0x39, 0xb8, 0xc7, 0xa7, 0x59, 0x13, 0xf3, 0x72,
+    0x9c, 0x01, 0x61, 0xd6, 0x32, 0x07, 0x04, 0xee, 0x60, 0x1b, 0x1a, 0x0e, 0x0c, 0x1b, 0xd4, 0x4c,
+    0x21, 0x8f, 0xc0, 0x44, 0xb2, 0x50, 0xd7, 0x78, 0x01, 0x4d, 0x18, 0x28, 0xbf, 0x6b, 0xb1, 0x93,
+    0x46, 0x70, 0xc2, 0x18, 0x75, 0x80, 0xdd, 0xc4, 0x5e, 0x4f, 0xd8, 0x59, 0x9f, 0xf2, 0x3d, 0xbf,
+    0xe3, 0x05, 0xc2, 0x56, 0x06, 0xae, 0xb9, 0x6c, 0xc1, 0xf0, 0x85, 0x3a, 0xe6, 0xc5, 0xc4, 0xb2,
+    0x4d, 0x9d, 0x57, 0x0d, 0x77, 0x34, 0x79, 0x28, 0x1c, 0xec, 0x5d, 0x01, 0x8a, 0x80, 0x0a, 0xd1,
+    0xb3, 0x1c, 0x82, 0xd5, 0xba, 0xa6, 0xdc, 0xfc, 0x24, 0x8a, 0xb5, 0x4c, 0xcf, 0x58, 0x7c, 0x8f,
+    0xf1, 0x20, 0x53, 0x87, 0x46, 0xbb, 0xd1, 0x16, 0x05, 0x02, 0x6f, 0x19, 0x99, 0x33, 0xc0, 0xc5,
+    0x6e, 0x01, 0x22, 0xbb, 0x08, 0x6e, 0xe0, 0x3e, 0xe7, 0x8f, 0x74, 0x35, 0xa0, 0x0c, 0xd7, 0x87,
+    0x29, 0x6c, 0xc4, 0x2d, 0xa0, 0xc8, 0x2a, 0x5e, 0xfc, 0xb1, 0x0a, 0x34, 0x1a, 0x37, 0x50, 0x3d,
+    0xab, 0xaa, 0xdc, 0x20, 0x8a, 0xd5, 0x91, 0x92, 0x17, 0x30, 0x40, 0xfd, 0x07, 0x35, 0x30, 0x35,
+    0xb8, 0x4f, 0x74, 0xad, 0xad, 0xed, 0xeb, 0xec, 0xf9, 0x15, 0x90, 0x33, 0xd1, 0xeb, 0xfb, 0x9d,
+    0x7a, 0x5d, 0xc4, 0x6e, 0xcd, 0xae, 0x2c, 0x02, 0x3f, 0xac, 0x0c, 0x6f, 0x24, 0xff, 0xfd, 0x2b,
+    0x77, 0xee, 0xf9, 0x45, 0x05, 0xae, 0x2c, 0x07, 0xa7, 0x3c, 0x8a, 0x8a, 0x5c, 0xb3, 0xdc, 0x68,
+    0xaa, 0x88, 0xc6, 0xf6, 0xb5, 0xca, 0x29, 0x7d, 0x36, 0x36, 0x80, 0x10, 0xa7, 0x1e, 0x4b, 0x7a,
+    0xe2, 0x10, 0x81, 0xe2, 0x92, 0x44, 0x5d, 0x2e, 0x12, 0xbe, 0x53, 0x95, 0x23, 0x9a, 0x3a, 0x13,
+    0x8b, 0x3a, 0x52, 0xf2, 0x4f, 0x38, 0x2c, 0x31, 0x19, 0x95, 0x5a, 0xac, 0x58, 0x65, 0xbe, 0x2f,
+    0x73, 0x22, 0xab, 0x70, 0xe2, 0x2f, 0xee, 0x78, 0x93, 0x8b, 0x19, 0xe2, 0x93, 0x7c, 0x17, 0x73,
+    0xb0, 0xf1, 0xa9, 0xf4, 0xa8, 0xfc, 0x19, 0xce, 0xec, 0x47, 0x49, 0xfc, 0xf1, 0xb0, 0x28, 0x09,
+    0x0f, 0xaf, 0x95, 0xbc, 0xbd, 0x58, 0x16, 0x50, 0x52, 0x41, 0xf9, 0x94, 0x9f, 0x52, 0x57, 0x59,
+    0x6e, 0x50, 0x38, 0x31, 0x93, 0xfc, 0xf8, 0x1c, 0x03, 0x01, 0x50, 0xf3, 0xba, 0x9c, 0x18, 0xfd,
+    0x50, 0x2e, 0xca, 0x00, 0x60, 0x25, 0x11, 0x24, 0x2a, 0x2e, 0x2f, 0x67, 0xfd, 0x44, 0x7a, 0xed,
+    0x44, 0xc2, 0x17, 0xe6, 0xad, 0x99, 0x48, 0xaf, 0x97, 0x50, 0x7b, 0x34, 0xf9, 0x51, 0xcf, 0x88,
+    0x85, 0xb4, 0x98, 0xdf, 0x54, 0xe5, 0xb7, 0x5c, 0x37, 0x52, 0x52, 0x43, 0xfd, 0xf6, 0x28, 0x67,
+    0x17, 0xad, 0xc8, 0x2e, 0x2a, 0xd8, 0x85, 0x15, 0xa2, 0x78, 0xba, 0x7c, 0x11, 0x4b, 0xa8, 0xff,
+    0xbf, 0x3c, 0x8b, 0x28, 0x5b, 0x0c, 0x0a, 0xf1, 0x14, 0x8b, 0x44, 0x14, 0xf2, 0x8a, 0x2b, 0xc4,
+    0x3e, 0x50, 0xce, 0xc9, 0x5a, 0x0c, 0xaa, 0x91, 0x25, 0x17, 0x99, 0x60, 0x85, 0x88, 0xac, 0xec,
+    0xa5, 0x28, 0x92, 0x94, 0xf0, 0x63, 0x01, 0x6c, 0x66, 0x86, 0x0d, 0x96, 0xf1, 0xa8, 0x83, 0x68,
+    0x5d, 0x19, 0x7b, 0x5f, 0x3a, 0xaf, 0xc7, 0x8b, 0x29, 0x44, 0x86, 0x8b, 0x59, 0x4a, 0xab, 0x86,
+    0x25, 0x95, 0xda, 0x21, 0x1e, 0x85, 0xb5, 0x65, 0x21, 0x3e, 0x51, 0x16, 0xde, 0x56, 0x62, 0x56,
+    0x58, 0x3a, 0x32, 0x9c, 0x08, 0x80, 0x5c, 0x0c, 0x73, 0x94, 0x5c, 0x3c, 0xc5, 0x67, 0x89, 0x39,
+    0xb1, 0x89, 0xb9, 0x60, 0xb5, 0x40, 0x48, 0x52, 0xac, 0x4c, 0x68, 0x20, 0xbc, 0x7e, 0x51, 0x30,
+    0x59, 0x88, 0x0a, 0x5f, 0x5c, 0xae, 0xbd, 0xb1, 0x29, 0x8e, 0xa4, 0xc5, 0xd1, 0x55, 0x78, 0xec,
+    0x14, 0x8c, 0x4c, 0x6c, 0x77, 0x41, 0x71, 0xa1, 0xb8, 0xdc, 0xd7, 0x43, 0x06, 0x74, 0x84, 0x13,
+    0x6b, 0x6c, 0xf9, 0x10, 0xfa, 0x20, 0x4c, 0x85, 0x93, 0x11, 0x04, 0x12, 0xa0, 0xd2, 0x0f, 0xb4,
+    0xb0, 0x43, 0x2c, 0x25, 0x2f, 0xbd, 0xac, 0x32, 0xc6, 0x4e, 0x5e, 0x27, 0xe2, 0xe5, 0x03, 0x41,
+    0x63, 0xca, 0x11, 0x15, 0x2d, 0x58, 0x5a, 0x81, 0x85, 0xe1, 0xeb, 0xaf, 0x96, 0x8b, 0xd9, 0x04,
+    0x94, 0x32, 0x32, 0xac, 0x16, 0xf1, 0x32, 0xa2, 0x35, 0xc5, 0xcd, 0xac, 0x55, 0x61, 0x05, 0x12,
+    0xc5, 0x99, 0x8d, 0x4c, 0x2f, 0x9f, 0x2f, 0x15, 0xce, 0x71, 0xde, 0xb1, 0x86, 0xc7, 0x41, 0x88,
+    0xc3, 0x1f, 0xf8, 0x1d, 0x06, 0x8c, 0xfd, 0xbd, 0xb3, 0x83, 0x49, 0x30, 0xb5, 0xfb, 0x7b, 0xff,
+    0x07, 0x43, 0xe4, 0x07, 0x63, 0x85, 0xc0, 0x00, 0x00,
+};
+const size_t index_simple_html_gz_len = sizeof(index_simple_html_gz);
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <esp_err.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Partial baseline JPEG decoder that only recovers the DC coefficient of each
+// luma block. The Huffman stream still has to be walked to skip the AC
+// coefficients, but there is no dequantisation of AC terms, no IDCT and no
+// colour conversion, so a frame costs a small fraction of a full decode.
+// The result is the average brightness of every 8x8 block: a 1/8 scale grey
+// image.
+
+#define JPEG_DC_MAX_COMPONENTS 3
+#define JPEG_DC_LOOKUP_BITS 9
+
+typedef struct
+{
+    // Indexed by the next JPEG_DC_LOOKUP_BITS input bits, for codes that short
+    uint8_t lookup_len[1 << JPEG_DC_LOOKUP_BITS]; // Code length, 0 if the code is longer
+    uint8_t lookup_val[1 << JPEG_DC_LOOKUP_BITS];
+    uint8_t lookup_skip[1 << JPEG_DC_LOOKUP_BITS]; // AC only: code length plus coefficient bits, 0 if that does not fit
+    int32_t maxcode[17]; // Largest code of each length, -1 if there is none
+    int32_t valoffset[17];
+    uint8_t values[256];
+} jpeg_huffman_t;
+
+typedef struct
+{
+    uint16_t quant[4];         // DC entry of each quantisation table
+    jpeg_huffman_t dc_tables[2];
+    jpeg_huffman_t ac_tables[2];
+} jpeg_dc_decoder_t;
+
+// Decodes jpg into out, one byte per luma block, row by row. width and height
+// receive the size of the grey image in blocks. Fails with
+// ESP_ERR_NOT_SUPPORTED for progressive or 12 bit JPEGs and with
+// ESP_ERR_INVALID_SIZE when out is too small.
+esp_err_t jpeg_dc_decode(jpeg_dc_decoder_t *decoder, const uint8_t *jpg, size_t len,
+                         uint8_t *out, size_t out_size, uint16_t *width, uint16_t *height);
+
+// Reads the image size from the frame header without decoding anything.
+esp_err_t jpeg_dc_size(const uint8_t *jpg, size_t len, uint16_t *width, uint16_t *height);
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <esp_err.h>
+#include <esp_http_server.h>
+#include <freertos/FreeRTOS.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define METRICS_CORES 2
+#define METRICS_BUCKETS 10       // Latency histogram buckets, plus +Inf
+#define METRICS_STREAM_SLOTS 8   // Stream clients tracked at once, main and substream together
+#define METRICS_CHUNK_SIZE 768   // Text rendered per httpd_resp_send_chunk()
+
+// Counters for /metrics, cheap enough for the hot paths. Every counter has a
+// 32-bit cell per core; a task only ever adds to the cell of the core it runs
+// on, with a relaxed atomic add in case another task on that core preempts
+// it, so no two cores write the same word and nothing ever takes a lock. The
+// cells wrap; they are folded into a 64-bit total on every scrape and by
+// metrics_fold(), which is exact as long as a counter grows by less than
+// 4 GiB between two folds, however rarely /metrics is read.
+typedef struct
+{
+    uint32_t cells[METRICS_CORES];
+    uint32_t seen;  // Under the fold lock: sum of the cells at the last fold
+    uint64_t total; // Under the fold lock
+} metrics_counter_t;
+
+// Latency histogram; buckets are per bucket here and made cumulative when rendered
+typedef struct
+{
+    metrics_counter_t buckets[METRICS_BUCKETS + 1];
+    metrics_counter_t sum_us;
+} metrics_histogram_t;
+
+typedef struct
+{
+    metrics_counter_t capture_frames;   // Frames taken from the camera driver
+    metrics_counter_t capture_failures; // esp_camera_fb_get() returning nothing or a non-JPEG frame
+    metrics_histogram_t capture_wait;   // Time spent in esp_camera_fb_get()
+    metrics_counter_t stream_frames;    // Over all stream clients, past and present
+    metrics_counter_t stream_bytes;
+    metrics_counter_t audio_bytes;      // Read from I2S
+    metrics_counter_t i2s_overruns;     // DMA buffers the I2S driver dropped because reads fell behind
+} metrics_t;
+
+extern metrics_t metrics;
+
+static inline void metrics_add(metrics_counter_t *counter, uint32_t n)
+{
+    __atomic_fetch_add(&counter->cells[xPortGetCoreID()], n, __ATOMIC_RELAXED);
+}
+
+void metrics_observe(metrics_histogram_t *histogram, uint32_t us);
+
+// A stream client's own counters, labelled with its slot and the stream name.
+// Returns -1 when every slot is in use; the other calls ignore -1.
+int metrics_stream_open(const char *stream);
+void metrics_stream_sent(int slot, size_t bytes, uint32_t us);
+void metrics_stream_close(int slot);
+
+// Folds every counter's cells into its total. The events task calls it on
+// every keepalive tick, EVENTS_KEEPALIVE_MS apart.
+void metrics_fold();
+
+// Handler for /metrics, in the Prometheus text format. Renders into a fixed
+// buffer on the stack and sends it chunk by chunk, so it never allocates.
+esp_err_t metrics_handler(httpd_req_t *req);
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <esp_err.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define MOTION_MAX_BLOCKS (200 * 150) // Luma blocks of a UXGA frame
+#define MOTION_THRESHOLD_DEFAULT 12   // Brightness change of a block that counts as motion, 0-255
+#define MOTION_MIN_BLOCKS_DEFAULT 6   // Changed blocks needed to report motion
+#define MOTION_LEARN_SHIFT 4          // The background moves 1/16 of the way to each new frame
+#define MOTION_WARMUP_FRAMES 8        // Frames used to build the background before reporting
+#define MOTION_HOLD_MS 2000           // Quiet time before an EVENT_VISION stop is posted
+
+#define MOTION_TASK_CORE 0
+#define MOTION_TASK_PRIORITY 4
+#define MOTION_TASK_STACK 4096
+
+// Vision motion detector. A task on the second core follows the shared frame
+// broadcast, reduces every JPEG to a 1/8 scale grey image from the DC
+// coefficients alone and compares it with a running-average background.
+// Start and stop are posted to the event log as EVENT_VISION.
+typedef struct
+{
+    bool enabled;
+    bool motion;
+    uint16_t changed_blocks;
+    uint16_t total_blocks;
+    uint16_t score;      // Changed area in per mille; a block 16 levels past the threshold counts twice
+    uint32_t frames;     // Frames analysed
+    uint32_t skipped;    // Frames published while the previous one was still being analysed
+    uint32_t errors;     // Frames the DC decoder rejected
+    uint32_t decode_us;  // Time spent on the last frame, decode and compare
+    int64_t timestamp;   // Capture time of the last analysed frame
+    int64_t last_motion; // Capture time of the last frame with motion, 0 if none yet
+} motion_state_t;
+
+esp_err_t motion_detect_start();
+
+// Runs one JPEG through the detector the way the task runs every broadcast
+// frame, for replaying a recorded sequence. Not for use once
+// motion_detect_start() has been called.
+esp_err_t motion_detect_feed(const uint8_t *jpg, size_t len, int64_t timestamp);
+
+void motion_detect_get(motion_state_t *state);
+
+// Sets motion_detect (on/off), motion_threshold or motion_min_blocks.
+// Returns -1 for an unknown name or a value out of range.
+int motion_detect_set(const char *name, int value);
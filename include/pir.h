@@ -0,0 +1,12 @@
+#pragma once
+
+#include <esp_err.h>
+#include <stdint.h>
+
+// PIR sensor on GPIO_13. Every edge is timestamped in the interrupt handler
+// and logged as an EVENT_MOTION start or stop, so a pulse that falls between
+// two polls of /motion still reaches /events.
+esp_err_t pir_start();
+
+bool pir_state();
+uint32_t pir_edges();
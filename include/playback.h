@@ -0,0 +1,26 @@
+#pragma once
+
+#include <esp_err.h>
+#include <esp_http_server.h>
+
+// Recorded clips over HTTP. The handlers only look things up and send the
+// response head; the transfer itself runs on the playback task, which takes
+// the session over the way /events does, so a long download does not hold
+// up the web server.
+esp_err_t playback_start();
+
+// Handler for /recordings?from=&to=: catalog entries overlapping the range,
+// in unix seconds, as JSON. At most RECORDINGS_LIST_MAX per answer; "more"
+// says to ask again from the end of the last one.
+esp_err_t recordings_handler(httpd_req_t *req);
+
+// Handler for /recordings/clip.
+// ?name=<clip> sends the AVI file, honouring a single byte Range.
+// ?t=<unix seconds> finds the clip recorded at that time and plays it from the
+// frame at t as multipart MJPEG, paced like the recording.
+esp_err_t recording_clip_handler(httpd_req_t *req);
+
+// From the web server's close_fn, before the socket is closed: stops the
+// playback task reading for and writing to the session, waiting out a send
+// in flight.
+void playback_session_closing(httpd_handle_t hd, int sockfd);
@@ -0,0 +1,33 @@
+#define STORAGE_ENABLED 0 // The SD slot shares GPIO 2, 14 and 15 with the I2S microphone: storage replaces audio
+#define STORAGE_MOUNT_POINT "/sdcard"
+#define CLIP_DIR STORAGE_MOUNT_POINT "/clips"
+
+#define NTP_SERVER "pool.ntp.org" // Wall-clock time for clip names; clips are named by uptime until it is set
+#define VALID_TIME 1600000000     // Anything earlier means NTP has not set the clock yet
+
+#define PREROLL_BUDGET_BYTES (1536 * 1024) // PSRAM kept for the pre-event ring
+#define PREROLL_MAX_FRAMES 256             // Index entries, about 12 s at 20 fps
+#define PREROLL_MS 5000                    // Video kept from before the trigger
+#define POSTROLL_MS 10000                  // and recorded after the last one
+
+#define RECORD_TASK_CORE 0
+#define RECORD_TASK_PRIORITY 3
+#define RECORD_TASK_STACK 4096
+#define RECORD_WRITER_PRIORITY 2 // Storage writes; lower than the ring ingest so slow cards only delay the clip
+#define RECORD_WRITER_STACK 4096
+
+#define CATALOG_PATH CLIP_DIR "/catalog.bin" // Fixed-size records of every finished clip, in recording order
+#define CATALOG_FENCE_STRIDE 64              // One start time per this many records is kept in RAM for searching
+#define RECORDINGS_LIST_MAX 200              // Clips in one /recordings answer
+
+#define PLAYBACK_MAX_CLIENTS 2 // Concurrent downloads and playbacks
+#define PLAYBACK_BUFFER_SIZE (16 * 1024)
+#define PLAYBACK_TASK_PRIORITY 2
+#define PLAYBACK_TASK_STACK 4096
+
+#define RETENTION_JOURNAL_PATH CLIP_DIR "/retention.jnl"
+#define RETENTION_MAX_CLIPS 2048                 // Clips kept on the card; the oldest go first beyond that
+#define RETENTION_JOURNAL_SLOTS 4096             // Journal records, at least twice RETENTION_MAX_CLIPS
+#define RETENTION_FREE_LOW (256ULL * 1024 * 1024)  // Start deleting the oldest clips below this much free space
+#define RETENTION_FREE_HIGH (512ULL * 1024 * 1024) // and stop once this much is free again
+#define RETENTION_DAY_QUOTA (4ULL * 1024 * 1024 * 1024) // Clip bytes kept for one UTC day
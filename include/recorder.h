@@ -0,0 +1,44 @@
+#pragma once
+
+#include <esp_err.h>
+#include <esp_http_server.h>
+#include <stdint.h>
+
+#include "clip_sink.h"
+
+// Event recorder. One task copies every broadcast frame into a byte-budgeted
+// PSRAM pre-roll ring; on a trigger a second task writes the PREROLL_MS
+// before it and everything up to POSTROLL_MS after the last trigger to the
+// sink. Storage writes never hold up capture: if the card falls behind, the
+// ring fills with pinned frames and new frames are dropped and counted.
+typedef struct
+{
+    bool recording;
+    char clip[24];            // Name of the current or last clip
+    uint32_t clips;           // Clips started
+    uint32_t clip_errors;     // Clips that could not be opened or were cut short by a write error
+    uint32_t frames_written;
+    uint64_t bytes_written;
+    uint32_t triggers;
+    // Pre-roll ring
+    uint32_t ring_frames;
+    uint32_t ring_bytes;
+    uint32_t ring_budget;
+    uint32_t pushed;
+    uint32_t dropped;
+    uint32_t evicted_budget;
+    uint32_t evicted_age;
+} recorder_stats_t;
+
+esp_err_t recorder_start(clip_sink_t *sink);
+bool recorder_running();
+
+// Starts a clip, or extends the one being written. timestamp is the
+// esp_timer_get_time() of the trigger, which may lie a little in the past.
+void recorder_trigger(int64_t timestamp);
+
+void recorder_get_stats(recorder_stats_t *stats);
+
+// Handler for /record: triggers a clip and answers with the recorder stats.
+// /record?status only reports.
+esp_err_t record_handler(httpd_req_t *req);
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <esp_err.h>
+#include <stdint.h>
+
+// Keeps the card from filling up without ever listing a directory.
+//
+// Every stored clip gets a running id and a journal record. Records live in a
+// fixed ring file, record seq in slot seq % RETENTION_JOURNAL_SLOTS, each with
+// its own CRC, so the file is only ever written at the next slot and a torn
+// write just leaves one invalid record. A clip's ADD record that is about to
+// be overwritten while the clip is still stored is written again at the head,
+// so the ring always holds one ADD per stored clip and a DEL for recently
+// reclaimed ones. At boot the state is rebuilt by reading the ring twice:
+// once for the newest seq and id, once to apply the records.
+//
+// Clips are kept in id order with deleted ones left as gaps, so the oldest
+// clip is always at the front and reclaiming it is O(1). Reclaiming starts
+// when free space falls below RETENTION_FREE_LOW and goes on until
+// RETENTION_FREE_HIGH. A day (UTC) holding more than RETENTION_DAY_QUOTA
+// bytes loses its own oldest clips first.
+//
+// Not thread safe: the recorder's writer task is the only caller once
+// retention_start() has returned.
+typedef struct
+{
+    uint32_t clips;     // Stored
+    uint64_t bytes;
+    uint32_t reclaimed; // Since boot, for space or clip count
+    uint32_t over_quota; // Since boot, for the per-day quota
+    uint32_t journal_seq;
+} retention_stats_t;
+
+// Replays the journal and reclaims space if needed. Needs the card mounted.
+esp_err_t retention_start();
+bool retention_running();
+
+// Closes the journal and forgets the state, as a reset would; for the card
+// going away, and for tests that replay the journal again.
+void retention_stop();
+
+// Records a clip file (CLIP_DIR/<name>.avi) about to be written, sized at
+// its preallocation, so that a reset while recording leaves no file the
+// journal does not know about. Also makes room for it. start_ms is
+// wall-clock, or -1 when the clock was not set; such clips count against no day.
+esp_err_t retention_open(const char *name, int64_t start_ms);
+
+// Records the final size of the clip last opened, then enforces the quota
+// and the free space watermarks.
+esp_err_t retention_close(uint32_t bytes);
+
+// Wall-clock start of the oldest stored clip, -1 if unknown.
+int64_t retention_oldest_ms();
+
+void retention_get_stats(retention_stats_t *stats);
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <esp_err.h>
+#include <stdint.h>
+
+// SD card in 1-bit SD_MMC mode, mounted at STORAGE_MOUNT_POINT. Only built in
+// with STORAGE_ENABLED, since the card uses the microphone's pins, and in
+// pio test builds.
+esp_err_t storage_mount();
+bool storage_mounted();
+
+uint64_t storage_total_bytes();
+uint64_t storage_used_bytes();
+uint64_t storage_free_bytes();
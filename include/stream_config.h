@@ -0,0 +1,11 @@
+#define STREAM_MAX_CLIENTS 4         // Main stream viewers at once
+#define FRAME_INTERNAL_SUBSCRIBERS 4 // Motion detection, recorder, substream and /ws, which subscribe once each
+#define FRAME_SUBSCRIBERS (STREAM_MAX_CLIENTS + FRAME_INTERNAL_SUBSCRIBERS)
+#define FRAME_RING_SLOTS (FRAME_SUBSCRIBERS + 2) // JPEG frames kept in PSRAM: one pinned per subscriber, the latest and the one being written
+#define FRAME_SLOT_SIZE (160 * 1024) // Initial size of each slot, grown on demand for larger frames
+#define FRAME_WAIT_TIMEOUT_MS 2000 // Give up on a stream client if no new frame arrives in this time
+#define CAPTURE_MAX_AGE_MS 100     // /capture reuses the latest streamed frame up to this age unless ?maxage= says otherwise
+
+#define CAPTURE_TASK_CORE 1
+#define CAPTURE_TASK_PRIORITY 5
+#define CAPTURE_TASK_STACK 4096
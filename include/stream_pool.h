@@ -0,0 +1,82 @@
+#pragma once
+
+#include <esp_err.h>
+#include <esp_http_server.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "stream_writer.h"
+
+#define STREAM_WORKERS 4          // Long-running responses served at once, over every port
+#define STREAM_QUERY_MAX 64
+#define STREAM_HEAD_MAX 512       // Longest request head taken on a legacy port
+#define STREAM_HEAD_TIMEOUT_MS 2000
+#define STREAM_SEND_TIMEOUT_MS 5000 // Same as httpd's send_wait_timeout
+
+#define STREAM_WORKER_PRIORITY 5
+#define STREAM_WORKER_STACK 4096 // Check stream_worker_stack_free_bytes on /metrics before lowering
+#define STREAM_LISTENER_CORE 0
+#define STREAM_LISTENER_PRIORITY 5
+#define STREAM_LISTENER_STACK 2560
+
+// One long-running response, from the worker's point of view
+typedef struct
+{
+    const void *arg; // The route's arg
+    char query[STREAM_QUERY_MAX];
+    stream_writer_t writer;
+} stream_job_t;
+
+// Produces the whole response and returns when it is over; the pool then
+// closes the connection, so the body may be delimited by the close.
+typedef void (*stream_job_fn)(stream_job_t *job);
+
+typedef struct
+{
+    const char *uri;
+    stream_job_fn run;
+    const void *arg;
+} stream_route_t;
+
+// A port kept open for the URLs that were served by servers of their own
+typedef struct
+{
+    uint16_t port;
+    const stream_route_t *routes;
+    size_t route_count;
+} stream_port_t;
+
+// Streams, audio and other responses that last as long as the client stays
+// run on a pool of pinned worker tasks instead of on the web server's task,
+// so one viewer does not hold up the next request. Workers are created the
+// first time they are needed and then kept. A single listener task accepts
+// on the legacy ports and hands each socket straight to a worker, which
+// reads the request line itself, so a slow client never holds up an accept.
+esp_err_t stream_pool_start(const stream_port_t *ports, size_t port_count);
+
+// Handler for a long-running URL on the web server, with a stream_route_t as
+// its user_ctx: the session is handed to a free worker and httpd goes back
+// to serving requests. 503 when every worker is busy.
+esp_err_t stream_pool_handler(httpd_req_t *req);
+
+// From the web server's close_fn, before the socket is closed: no write of
+// the session's worker starts after this, and one in flight has finished.
+// httpd only calls free_ctx once the descriptor is closed, and by then
+// accept() may have handed its number to another connection.
+void stream_pool_session_closing(httpd_handle_t hd, int sockfd);
+
+// The job's writer calls. They fail without touching the socket once
+// stream_pool_session_closing() has run for the session.
+esp_err_t stream_job_begin(stream_job_t *job, const char *content_type, const char *body, size_t body_len);
+esp_err_t stream_job_send(stream_job_t *job, const void *const *bufs, const size_t *lens, int buf_count);
+esp_err_t stream_job_send_jpeg(stream_job_t *job, const uint8_t *jpg, size_t len, int64_t timestamp, const char *boundary);
+
+// Answers with an error status instead, for a job that cannot start
+esp_err_t stream_job_error(stream_job_t *job, const char *status, const char *message);
+
+// Workers running a job right now, for /metrics
+int stream_pool_busy();
+
+// Least stack a worker has had to spare since it started, in bytes, or -1
+// for a worker that was never needed, for /metrics
+int stream_pool_stack_free(int worker);
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <esp_http_server.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define PART_BOUNDARY "123456789000000000000987654321" // Of every multipart/x-mixed-replace JPEG stream
+
+// Writes a long-lived response straight to the request's socket instead of
+// going through httpd_resp_send_chunk(). The body is not chunk-encoded: it is
+// delimited by closing the connection, so the handler must return ESP_FAIL
+// when it is done to have the server close the session.
+typedef struct
+{
+    int fd;
+    size_t bytes; // Body bytes written so far
+    char part[96];
+} stream_writer_t;
+
+// Sends the status line, headers and the optional start of the body in one write.
+esp_err_t stream_writer_begin(stream_writer_t *writer, httpd_req_t *req, const char *content_type, const char *body, size_t body_len);
+
+// Same, for a session socket kept from an earlier request, when the response
+// is only produced later by another task.
+esp_err_t stream_writer_begin_fd(stream_writer_t *writer, int fd, const char *content_type, const char *body, size_t body_len);
+
+// Writes buf_count buffers with as few socket sends as possible.
+esp_err_t stream_writer_send(stream_writer_t *writer, const void *const *bufs, const size_t *lens, int buf_count);
+
+// Sends one multipart/x-mixed-replace JPEG part followed by the boundary.
+// timestamp, in microseconds, goes out as the part's X-Timestamp header in
+// seconds, so a client can tell how old a frame is when it arrives.
+esp_err_t stream_writer_send_jpeg(stream_writer_t *writer, const uint8_t *jpg, size_t len, int64_t timestamp, const char *boundary);
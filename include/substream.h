@@ -0,0 +1,47 @@
+#pragma once
+
+#include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#include <stdint.h>
+
+#include "frame_ring.h"
+
+#define SUBSTREAM_WIDTH 320          // Narrowest the substream may get; picks 1/2, 1/4 or 1/8 of the main stream
+#define SUBSTREAM_QUALITY_DEFAULT 60 // JPEG quality of the re-encoded frames, 1-100
+#define SUBSTREAM_MAX_CLIENTS 4
+#define SUBSTREAM_RING_SLOTS 3
+#define SUBSTREAM_SLOT_SIZE (48 * 1024) // A re-encoded frame that does not fit is dropped
+
+#define SUBSTREAM_TASK_CORE 0
+#define SUBSTREAM_TASK_PRIORITY 4
+#define SUBSTREAM_TASK_STACK 6144
+
+// Low resolution copy of the main stream for live views on slow links. A
+// task on the second core follows the frame broadcast, decodes each JPEG at
+// reduced scale and encodes it again into a ring of its own. It only holds
+// a broadcast subscription, and only does any work, while a substream client
+// is attached; frames published while it is busy are skipped.
+typedef struct
+{
+    uint32_t frames;    // Frames re-encoded
+    uint32_t errors;    // Frames that failed to decode or did not fit a slot
+    uint32_t decode_us; // Time spent on the last frame
+    uint32_t encode_us;
+    uint64_t decode_us_total; // On every frame re-encoded
+    uint64_t encode_us_total;
+    uint16_t width;
+    uint16_t height;
+} substream_stats_t;
+
+esp_err_t substream_start();
+
+// Same contract as frame_broadcast_subscribe() and friends, for the substream.
+int substream_subscribe();
+void substream_unsubscribe(int sub);
+frame_slot_t *substream_acquire(int sub, uint32_t last_seq, TickType_t timeout);
+void substream_release(frame_slot_t *frame);
+
+void substream_get_stats(substream_stats_t *stats);
+
+// Sets sub_quality. Returns -1 for an unknown name or a value out of range.
+int substream_set(const char *name, int value);
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <esp_err.h>
+#include <esp_http_server.h>
+#include <stdint.h>
+
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 0 // Build with -DTRACE_ENABLED=1 for /trace; off, the TRACE_ macros compile to nothing
+#endif
+
+#define TRACE_EVENTS_PER_CORE 8192 // 16 bytes each, in PSRAM, allocated by the first /trace
+#define TRACE_DEFAULT_MS 1000
+#define TRACE_MAX_MS 10000
+
+// Begin/end events around the hot calls, for finding where the time of a
+// frame or an audio block goes. Each core has its own event buffer; a task
+// claims a slot in the buffer of the core it runs on with one atomic add,
+// so recording takes no lock. Events are only kept while /trace is
+// recording, and once a buffer is full further events on that core are
+// counted as dropped. name must be a string literal.
+#if TRACE_ENABLED
+
+#define TRACE_BEGIN(name) trace_record(name, 'B')
+#define TRACE_END(name) trace_record(name, 'E')
+
+void trace_record(const char *name, char phase);
+
+#else
+
+#define TRACE_BEGIN(name) \
+    do                    \
+    {                     \
+    } while (0)
+#define TRACE_END(name) \
+    do                  \
+    {                   \
+    } while (0)
+
+#endif
+
+// Handler for /trace?ms=: records for that long, TRACE_DEFAULT_MS by
+// default, and answers with Chrome trace_event JSON for Perfetto or
+// chrome://tracing. The session is parked meanwhile and answered by a task
+// of its own, so the web server keeps serving (and can be traced). One
+// recording at a time; 501 when built without TRACE_ENABLED.
+esp_err_t trace_handler(httpd_req_t *req);
+
+// From the web server's close_fn, before the socket is closed: stops the
+// trace task writing to the session, waiting out a send in flight.
+void trace_session_closing(httpd_handle_t hd, int sockfd);
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <esp_err.h>
+#include <esp_http_server.h>
+#include <stdint.h>
+
+#define WS_MAX_CLIENTS 4
+#define WS_POLL_MS 10 // Longest audio and events wait for the task to wake without a new frame
+
+#define WS_TASK_CORE 0
+#define WS_TASK_PRIORITY 5
+#define WS_TASK_STACK 4096
+
+// First byte of every message
+typedef enum
+{
+    WS_MSG_HELLO = 0, // JSON: what the connection carries, and the audio format
+    WS_MSG_JPEG = 1,  // One JPEG frame; seq is the frame seq
+    WS_MSG_AUDIO = 2, // Encoded audio; seq is the position of the block's first sample
+    WS_MSG_EVENT = 3, // One event as the JSON /events sends; seq is the event seq
+} ws_msg_type_t;
+
+// Every message is one binary WebSocket frame holding this header, little
+// endian, followed by the payload.
+typedef struct __attribute__((packed))
+{
+    uint8_t type;
+    uint8_t reserved[3];
+    uint32_t seq;
+    int64_t timestamp; // esp_timer_get_time() when the frame was taken, the audio read or the event posted
+} ws_msg_header_t;
+
+// Video, audio and events over one WebSocket, as an alternative to holding
+// the stream, audio and /events connections open side by side. A single task
+// serves every client: it holds one broadcast subscription per video source
+// however many clients watch it, and writes each frame to the sockets
+// straight from the ring, answering pings and closes between messages. Like
+// the events task it sends with blocking writes, so a client that stops
+// reading holds the others up until the send timeout drops it.
+esp_err_t ws_mux_start();
+
+// Handler for /ws?video=main|sub|off&audio=pcm|ulaw|adpcm|off&events=1|0,
+// registered with is_websocket and handle_ws_control_frames set. Defaults are
+// video=main, audio=off, events=1. Messages from the client are ignored.
+esp_err_t ws_mux_handler(httpd_req_t *req);
+
+// From the web server's close_fn, before the socket is closed: stops the ws
+// task writing to the session, waiting out a send in flight.
+void ws_mux_session_closing(httpd_handle_t hd, int sockfd);
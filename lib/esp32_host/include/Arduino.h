@@ -0,0 +1,124 @@
+#pragma once
+
+#include <ctype.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_err.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define PULLUP 0x04
+#define INPUT_PULLUP 0x05
+#define PULLDOWN 0x08
+#define INPUT_PULLDOWN 0x09
+
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+#define ONLOW 0x04
+#define ONHIGH 0x05
+
+#define IRAM_ATTR
+#define ARDUINO_ISR_ATTR
+
+#define GPIO_PIN_COUNT 40
+#define digitalPinToInterrupt(p) (((p) < GPIO_PIN_COUNT) ? (p) : -1)
+
+#ifndef CORE_DEBUG_LEVEL
+#define CORE_DEBUG_LEVEL 0
+#endif
+
+#define ARDUHAL_LOG(level, letter, format, ...)                                                               \
+    do                                                                                                        \
+    {                                                                                                         \
+        if (CORE_DEBUG_LEVEL >= level)                                                                        \
+        {                                                                                                     \
+            printf("[%6u][" letter "][%s:%u] %s(): " format "\r\n", (unsigned)millis(), __FILE__, __LINE__, \
+                   __FUNCTION__, ##__VA_ARGS__);                                                              \
+        }                                                                                                     \
+    } while (0)
+
+#define log_e(format, ...) ARDUHAL_LOG(1, "E", format, ##__VA_ARGS__)
+#define log_w(format, ...) ARDUHAL_LOG(2, "W", format, ##__VA_ARGS__)
+#define log_i(format, ...) ARDUHAL_LOG(3, "I", format, ##__VA_ARGS__)
+#define log_d(format, ...) ARDUHAL_LOG(4, "D", format, ##__VA_ARGS__)
+#define log_v(format, ...) ARDUHAL_LOG(5, "V", format, ##__VA_ARGS__)
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+class IPAddress
+{
+public:
+    IPAddress();
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d);
+    bool fromString(const char *address);
+    const char *c_str() const { return text; }
+    uint8_t operator[](int i) const { return octets[i]; }
+
+private:
+    uint8_t octets[4];
+    char text[16];
+};
+
+// Serial is the process's stdout
+class HardwareSerial
+{
+public:
+    void begin(unsigned long baud);
+    void end() {}
+    void flush();
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+    size_t write(const uint8_t *buf, size_t len);
+    size_t print(const char *s);
+    size_t print(char c);
+    size_t print(int n) { return print((long)n); }
+    size_t print(unsigned int n) { return print((unsigned long)n); }
+    size_t print(long n);
+    size_t print(unsigned long n);
+    size_t print(double n, int digits = 2);
+    size_t print(const IPAddress &ip) { return print(ip.c_str()); }
+    size_t println() { return print("\r\n"); }
+    template <typename T>
+    size_t println(T value)
+    {
+        size_t n = print(value);
+        return n + println();
+    }
+};
+
+extern HardwareSerial Serial;
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+int digitalRead(uint8_t pin);
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode);
+void detachInterrupt(uint8_t pin);
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+char *itoa(int value, char *str, int base);
+char *ltoa(long value, char *str, int base);
+char *utoa(unsigned int value, char *str, int base);
+char *ultoa(unsigned long value, char *str, int base);
+
+void setup();
+void loop();
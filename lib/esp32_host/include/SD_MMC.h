@@ -0,0 +1,21 @@
+#pragma once
+
+#include <Arduino.h>
+
+// The card is whatever directory is at the mount point on the host, so the
+// firmware's absolute paths work unchanged: create it, or bind a scratch
+// directory there, before running with STORAGE_ENABLED. --sd-bytes makes it
+// as small as a real card.
+class SDMMCFS
+{
+public:
+    bool begin(const char *mountpoint = "/sdcard", bool mode1bit = false, bool format_if_mount_failed = false);
+    void end();
+    uint64_t totalBytes();
+    uint64_t usedBytes();
+
+private:
+    const char *mount = NULL;
+};
+
+extern SDMMCFS SD_MMC;
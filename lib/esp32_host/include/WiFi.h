@@ -0,0 +1,37 @@
+#pragma once
+
+#include <Arduino.h>
+
+typedef enum
+{
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_SCAN_COMPLETED = 2,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+// The host is already on its network: begin() connects at once and the
+// servers listen on every address of the machine, whatever config() says
+class WiFiClass
+{
+public:
+    bool config(IPAddress local_ip, IPAddress gateway, IPAddress subnet);
+    wl_status_t begin(const char *ssid, const char *passphrase = NULL);
+    bool setSleep(bool enabled) { return true; }
+    wl_status_t status() { return connected ? WL_CONNECTED : WL_DISCONNECTED; }
+    IPAddress localIP() { return ip; }
+    int8_t RSSI() { return connected ? -40 : 0; }
+
+private:
+    bool connected = false;
+    IPAddress ip;
+};
+
+extern WiFiClass WiFi;
+
+// The host clock is kept by the host
+void configTime(long gmt_offset_sec, int daylight_offset_sec, const char *server1,
+                const char *server2 = NULL, const char *server3 = NULL);
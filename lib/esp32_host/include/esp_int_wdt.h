@@ -0,0 +1,5 @@
+#pragma once
+
+#include "esp_err.h"
+
+// No watchdogs on the host
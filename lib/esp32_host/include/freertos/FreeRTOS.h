@@ -0,0 +1,51 @@
+#pragma once
+
+#include <pthread.h>
+#include <stdint.h>
+
+// FreeRTOS on pthreads: every task is a thread and the kernel objects are
+// built from mutexes and condition variables. Priorities and stack sizes are
+// accepted and ignored; the core a task is pinned to is kept only so that
+// xPortGetCoreID() answers as it would on the ESP32.
+
+#define configTICK_RATE_HZ 1000
+#define portNUM_PROCESSORS 2
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+#define errQUEUE_FULL 0
+#define errQUEUE_EMPTY 0
+
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define portTICK_PERIOD_MS (1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(((TickType_t)(ms) * configTICK_RATE_HZ) / 1000))
+#define tskNO_AFFINITY 0x7FFFFFFF
+
+// A critical section keeps the other core and the interrupts out on the
+// ESP32; here that is a recursive mutex, which the GPIO "interrupts" take too
+typedef struct
+{
+    pthread_mutex_t mutex;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED {PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP}
+
+void vPortCPUInitializeMutex(portMUX_TYPE *mux);
+
+#define portMUX_INITIALIZE(mux) vPortCPUInitializeMutex(mux)
+#define portENTER_CRITICAL(mux) pthread_mutex_lock(&(mux)->mutex)
+#define portEXIT_CRITICAL(mux) pthread_mutex_unlock(&(mux)->mutex)
+#define portENTER_CRITICAL_ISR(mux) portENTER_CRITICAL(mux)
+#define portEXIT_CRITICAL_ISR(mux) portEXIT_CRITICAL(mux)
+#define portYIELD_FROM_ISR(...) \
+    do                          \
+    {                           \
+    } while (0)
+
+BaseType_t xPortGetCoreID(void);
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "FreeRTOS.h"
+#include "queue.h"
+
+// As in FreeRTOS, a semaphore is a queue of empty items; a mutex is one
+// that starts full. There is no priority inheritance.
+typedef QueueHandle_t SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max_count, UBaseType_t initial_count);
+
+#define xSemaphoreCreateBinary() xSemaphoreCreateCounting(1, 0)
+#define xSemaphoreCreateMutex() xSemaphoreCreateCounting(1, 1)
+#define vSemaphoreDelete(sem) vQueueDelete(sem)
+#define xSemaphoreTake(sem, ticks) xQueueReceive(sem, NULL, ticks)
+#define xSemaphoreGive(sem) xQueueSend(sem, NULL, 0)
+#define xSemaphoreGiveFromISR(sem, woken) xQueueSendFromISR(sem, NULL, woken)
+#define uxSemaphoreGetCount(sem) uxQueueMessagesWaiting(sem)
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdint.h>
+
+// Where the native build gets what the board's hardware would provide. Set
+// from the command line before setup() runs:
+//
+//   --frames DIR      JPEG files handed out by esp_camera_fb_get() in name
+//                     order, looping (default ./frames)
+//   --fps N           Rate the "sensor" delivers them at; 0 hands them out as
+//                     fast as they are asked for (default 20)
+//   --audio FILE      16-bit mono PCM WAV read back by i2s_read() in real
+//                     time, looping; silence without one
+//   --pir FILE        File holding the GPIO 13 level, 0 or 1; polled every
+//                     10 ms and edges raise the pin's interrupt
+//   --port-offset N   Added to every listening port, so the servers need no root
+//                     (default 8000: 8080, 8081 and 8082)
+//   --sd-bytes N      Size of the SD card: the files under the mount point
+//                     are counted against it, in 32 kB clusters, so a small
+//                     card fills up without a disk image (default: the size
+//                     of the host filesystem holding the mount point)
+typedef struct
+{
+    const char *frames_dir;
+    uint32_t fps;
+    const char *audio_path;
+    const char *pir_path;
+    uint16_t port_offset;
+    uint64_t sd_bytes;
+} host_config_t;
+
+extern host_config_t host_config;
+
+// Socket sends since start, by the firmware and the web server alike: one per
+// write(), writev(), send() or sendmsg() call, whatever it carried. The program
+// prints it as "host: socket sends N" on SIGUSR1, for tools/bench.py.
+uint64_t host_socket_sends();
+
+// Drives an input pin as the outside world would, running its interrupt
+// handler on an edge that matches its mode
+void host_gpio_set(uint8_t pin, int level);
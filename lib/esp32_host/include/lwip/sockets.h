@@ -0,0 +1,27 @@
+#pragma once
+
+// lwIP's BSD socket layer is the host's own
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#define lwip_read read
+#define lwip_recv recv
+#define lwip_close close
+
+// Writes go through counters, so the benchmark can tell sends per frame
+ssize_t host_write(int fd, const void *buf, size_t len);
+ssize_t host_writev(int fd, const struct iovec *iov, int count);
+ssize_t host_send(int fd, const void *buf, size_t len, int flags);
+#define lwip_write host_write
+#define lwip_writev host_writev
+#define lwip_send host_send
+
+// Listening ports move up by --port-offset, so the servers need no root
+int host_bind(int fd, const struct sockaddr *addr, socklen_t len);
+#define bind(fd, addr, len) host_bind(fd, addr, len)
@@ -0,0 +1,387 @@
+#include <Arduino.h>
+#include <SD_MMC.h>
+#include <WiFi.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <host.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <unistd.h>
+
+#include "host_internal.h"
+
+#define GPIO_POLL_MS 10
+#define SD_CLUSTER 32768 // FAT32 on SDHC cards
+
+HardwareSerial Serial;
+WiFiClass WiFi;
+SDMMCFS SD_MMC;
+
+typedef struct
+{
+    uint8_t mode;
+    int level;
+    void (*handler)(void);
+    int edge; // RISING, FALLING or CHANGE
+} gpio_pin_t;
+
+static gpio_pin_t pins[GPIO_PIN_COUNT];
+static pthread_mutex_t pin_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// IPAddress
+
+IPAddress::IPAddress() : IPAddress(0, 0, 0, 0)
+{
+}
+
+IPAddress::IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : octets{a, b, c, d}
+{
+    snprintf(text, sizeof(text), "%u.%u.%u.%u", a, b, c, d);
+}
+
+bool IPAddress::fromString(const char *address)
+{
+    unsigned a, b, c, d;
+    char end;
+    if (sscanf(address, "%u.%u.%u.%u%c", &a, &b, &c, &d, &end) != 4 || a > 255 || b > 255 || c > 255 || d > 255)
+    {
+        return false;
+    }
+    *this = IPAddress(a, b, c, d);
+    return true;
+}
+
+// Serial
+
+void HardwareSerial::begin(unsigned long baud)
+{
+    setvbuf(stdout, NULL, _IOLBF, 0);
+}
+
+void HardwareSerial::flush()
+{
+    fflush(stdout);
+}
+
+size_t HardwareSerial::printf(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int n = vprintf(format, args);
+    va_end(args);
+    return n < 0 ? 0 : n;
+}
+
+size_t HardwareSerial::write(const uint8_t *buf, size_t len)
+{
+    return fwrite(buf, 1, len, stdout);
+}
+
+size_t HardwareSerial::print(const char *s)
+{
+    return fputs(s, stdout) < 0 ? 0 : strlen(s);
+}
+
+size_t HardwareSerial::print(char c)
+{
+    return putchar(c) == EOF ? 0 : 1;
+}
+
+size_t HardwareSerial::print(long n)
+{
+    return printf("%ld", n);
+}
+
+size_t HardwareSerial::print(unsigned long n)
+{
+    return printf("%lu", n);
+}
+
+size_t HardwareSerial::print(double n, int digits)
+{
+    return printf("%.*f", digits, n);
+}
+
+// GPIO
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    if (pin >= GPIO_PIN_COUNT)
+    {
+        return;
+    }
+    pthread_mutex_lock(&pin_lock);
+    pins[pin].mode = mode;
+    pthread_mutex_unlock(&pin_lock);
+}
+
+void digitalWrite(uint8_t pin, uint8_t level)
+{
+    if (pin >= GPIO_PIN_COUNT)
+    {
+        return;
+    }
+    pthread_mutex_lock(&pin_lock);
+    if (pins[pin].mode == OUTPUT)
+    {
+        pins[pin].level = level ? HIGH : LOW;
+    }
+    pthread_mutex_unlock(&pin_lock);
+}
+
+int digitalRead(uint8_t pin)
+{
+    if (pin >= GPIO_PIN_COUNT)
+    {
+        return LOW;
+    }
+    pthread_mutex_lock(&pin_lock);
+    int level = pins[pin].level;
+    pthread_mutex_unlock(&pin_lock);
+    return level;
+}
+
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode)
+{
+    if (pin >= GPIO_PIN_COUNT)
+    {
+        return;
+    }
+    pthread_mutex_lock(&pin_lock);
+    pins[pin].handler = handler;
+    pins[pin].edge = mode;
+    pthread_mutex_unlock(&pin_lock);
+}
+
+void detachInterrupt(uint8_t pin)
+{
+    attachInterrupt(pin, NULL, 0);
+}
+
+void host_gpio_set(uint8_t pin, int level)
+{
+    void (*handler)(void) = NULL;
+
+    if (pin >= GPIO_PIN_COUNT)
+    {
+        return;
+    }
+    level = level ? HIGH : LOW;
+    pthread_mutex_lock(&pin_lock);
+    gpio_pin_t *p = &pins[pin];
+    if (level != p->level)
+    {
+        int edge = level ? RISING : FALLING;
+        if (p->handler && (p->edge == CHANGE || p->edge == edge))
+        {
+            handler = p->handler;
+        }
+        p->level = level;
+    }
+    pthread_mutex_unlock(&pin_lock);
+
+    // Outside the lock: the handler reads the pin, as an ISR would
+    if (handler)
+    {
+        handler();
+    }
+}
+
+// The PIR on GPIO 13, from a file holding its level
+static void gpio_poll_loop(void *arg)
+{
+    char level = '0';
+
+    while (true)
+    {
+        FILE *f = fopen(host_config.pir_path, "r");
+        if (f)
+        {
+            int c = fgetc(f);
+            fclose(f);
+            if (c == '0' || c == '1')
+            {
+                level = c;
+            }
+        }
+        host_gpio_set(13, level == '1');
+        vTaskDelay(pdMS_TO_TICKS(GPIO_POLL_MS));
+    }
+}
+
+void host_gpio_start()
+{
+    if (host_config.pir_path)
+    {
+        xTaskCreatePinnedToCore(gpio_poll_loop, "gpio", 2048, NULL, 10, NULL, 0);
+    }
+}
+
+// Time
+
+unsigned long millis()
+{
+    return esp_timer_get_time() / 1000;
+}
+
+unsigned long micros()
+{
+    return esp_timer_get_time();
+}
+
+void delay(uint32_t ms)
+{
+    vTaskDelay(pdMS_TO_TICKS(ms));
+}
+
+void delayMicroseconds(uint32_t us)
+{
+    usleep(us);
+}
+
+void yield()
+{
+    sched_yield();
+}
+
+// Number formatting
+
+char *ultoa(unsigned long value, char *str, int base)
+{
+    char digits[sizeof(long) * 8 + 1];
+    int n = 0;
+
+    do
+    {
+        int d = value % base;
+        digits[n++] = d < 10 ? '0' + d : 'a' + d - 10;
+        value /= base;
+    } while (value);
+    for (int i = 0; i < n; i++)
+    {
+        str[i] = digits[n - 1 - i];
+    }
+    str[n] = '\0';
+    return str;
+}
+
+char *ltoa(long value, char *str, int base)
+{
+    if (value < 0 && base == 10)
+    {
+        str[0] = '-';
+        ultoa(-(unsigned long)value, str + 1, base);
+        return str;
+    }
+    return ultoa((unsigned long)value, str, base);
+}
+
+char *itoa(int value, char *str, int base)
+{
+    return ltoa(value, str, base);
+}
+
+char *utoa(unsigned int value, char *str, int base)
+{
+    return ultoa(value, str, base);
+}
+
+// WiFi
+
+bool WiFiClass::config(IPAddress local_ip, IPAddress gateway, IPAddress subnet)
+{
+    ip = local_ip;
+    return true;
+}
+
+wl_status_t WiFiClass::begin(const char *ssid, const char *passphrase)
+{
+    connected = true;
+    return WL_CONNECTED;
+}
+
+void configTime(long gmt_offset_sec, int daylight_offset_sec, const char *server1, const char *server2,
+                const char *server3)
+{
+}
+
+// SD card
+
+bool SDMMCFS::begin(const char *mountpoint, bool mode1bit, bool format_if_mount_failed)
+{
+    struct stat st;
+    if (stat(mountpoint, &st) != 0 || !S_ISDIR(st.st_mode) || access(mountpoint, W_OK) != 0)
+    {
+        fprintf(stderr, "host: no writable directory at %s for the SD card\n", mountpoint);
+        return false;
+    }
+    mount = mountpoint;
+    return true;
+}
+
+void SDMMCFS::end()
+{
+    mount = NULL;
+}
+
+// Bytes the files under dir take in whole clusters, as on a card of sd_bytes
+static uint64_t cluster_bytes(int dir)
+{
+    uint64_t total = 0;
+    DIR *d = fdopendir(dir);
+    struct dirent *e;
+
+    if (!d)
+    {
+        close(dir);
+        return 0;
+    }
+    while ((e = readdir(d)) != NULL)
+    {
+        struct stat st;
+        if (!strcmp(e->d_name, ".") || !strcmp(e->d_name, "..") || fstatat(dirfd(d), e->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0)
+        {
+            continue;
+        }
+        if (S_ISDIR(st.st_mode))
+        {
+            int sub = openat(dirfd(d), e->d_name, O_RDONLY | O_DIRECTORY);
+            total += SD_CLUSTER + ((sub >= 0) ? cluster_bytes(sub) : 0);
+        }
+        else
+        {
+            total += ((uint64_t)st.st_size + SD_CLUSTER - 1) / SD_CLUSTER * SD_CLUSTER;
+        }
+    }
+    closedir(d);
+    return total;
+}
+
+uint64_t SDMMCFS::totalBytes()
+{
+    if (host_config.sd_bytes)
+    {
+        return mount ? host_config.sd_bytes : 0;
+    }
+    struct statvfs st;
+    if (!mount || statvfs(mount, &st) != 0)
+    {
+        return 0;
+    }
+    return (uint64_t)st.f_blocks * st.f_frsize;
+}
+
+uint64_t SDMMCFS::usedBytes()
+{
+    if (host_config.sd_bytes)
+    {
+        int dir = mount ? open(mount, O_RDONLY | O_DIRECTORY) : -1;
+        return (dir >= 0) ? cluster_bytes(dir) : 0;
+    }
+    struct statvfs st;
+    if (!mount || statvfs(mount, &st) != 0)
+    {
+        return 0;
+    }
+    return (uint64_t)(st.f_blocks - st.f_bavail) * st.f_frsize;
+}
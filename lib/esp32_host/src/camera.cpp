@@ -0,0 +1,439 @@
+#include <dirent.h>
+#include <esp_camera.h>
+#include <esp_timer.h>
+#include <host.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "host_internal.h"
+
+#define CAMERA_FB_TIMEOUT_MS 4000 // FB_GET_TIMEOUT in the driver
+#define CAMERA_MAX_FB 4
+#define SENSOR_REGS 0x400 // Banked OV2640 registers are addressed as 0x1xx
+
+typedef struct
+{
+    uint8_t *data;
+    size_t len;
+    uint16_t width;
+    uint16_t height;
+} jpeg_file_t;
+
+typedef struct
+{
+    camera_fb_t fb;
+    bool in_use;
+} fb_slot_t;
+
+static jpeg_file_t *files = NULL;
+static size_t file_count = 0;
+static size_t next_file = 0;
+
+static fb_slot_t slots[CAMERA_MAX_FB];
+static size_t slot_count = 0;
+static camera_grab_mode_t grab_mode;
+static int64_t next_due = 0;
+static pthread_mutex_t fb_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t grab_lock = PTHREAD_MUTEX_INITIALIZER; // Schedule and file order, held while waiting for a frame
+static pthread_cond_t fb_free;
+
+static sensor_t sensor;
+static uint8_t regs[SENSOR_REGS];
+
+// Width and height from the first start-of-frame marker
+static bool jpeg_size(const uint8_t *p, size_t len, uint16_t *width, uint16_t *height)
+{
+    size_t i = 2;
+
+    if (len < 4 || p[0] != 0xff || p[1] != 0xd8)
+    {
+        return false;
+    }
+    while (i + 9 < len)
+    {
+        if (p[i] != 0xff)
+        {
+            return false;
+        }
+        uint8_t marker = p[i + 1];
+        size_t segment = (p[i + 2] << 8) | p[i + 3];
+        if (marker >= 0xc0 && marker <= 0xcf && marker != 0xc4 && marker != 0xc8 && marker != 0xcc)
+        {
+            *height = (p[i + 5] << 8) | p[i + 6];
+            *width = (p[i + 7] << 8) | p[i + 8];
+            return true;
+        }
+        i += 2 + segment;
+    }
+    return false;
+}
+
+static bool is_jpeg_name(const char *name)
+{
+    const char *dot = strrchr(name, '.');
+    return dot && (strcasecmp(dot, ".jpg") == 0 || strcasecmp(dot, ".jpeg") == 0);
+}
+
+static int compare_names(const void *a, const void *b)
+{
+    return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+static bool load_file(const char *path, jpeg_file_t *file)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f)
+    {
+        return false;
+    }
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    file->data = (uint8_t *)malloc(len > 0 ? len : 1);
+    bool ok = file->data && len > 0 && fread(file->data, 1, len, f) == (size_t)len;
+    fclose(f);
+    file->len = len;
+    if (ok && !jpeg_size(file->data, file->len, &file->width, &file->height))
+    {
+        fprintf(stderr, "host: %s is not a baseline or progressive JPEG\n", path);
+        ok = false;
+    }
+    if (!ok)
+    {
+        free(file->data);
+    }
+    return ok;
+}
+
+static esp_err_t load_frames(const char *dir_path)
+{
+    DIR *dir = opendir(dir_path);
+    if (!dir)
+    {
+        fprintf(stderr, "host: cannot open the frame directory %s\n", dir_path);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    char **names = NULL;
+    size_t count = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        if (is_jpeg_name(entry->d_name))
+        {
+            names = (char **)realloc(names, (count + 1) * sizeof(char *));
+            names[count++] = strdup(entry->d_name);
+        }
+    }
+    closedir(dir);
+    qsort(names, count, sizeof(char *), compare_names);
+
+    files = (jpeg_file_t *)calloc(count ? count : 1, sizeof(jpeg_file_t));
+    for (size_t i = 0; i < count; i++)
+    {
+        char path[1024];
+        snprintf(path, sizeof(path), "%s/%s", dir_path, names[i]);
+        if (load_file(path, &files[file_count]))
+        {
+            file_count++;
+        }
+        free(names[i]);
+    }
+    free(names);
+
+    if (!file_count)
+    {
+        fprintf(stderr, "host: no JPEG files in %s\n", dir_path);
+        return ESP_ERR_NOT_FOUND;
+    }
+    printf("host: camera has %zu frames from %s, %ux%u first, at %u fps\n", file_count, dir_path, files[0].width,
+           files[0].height, host_config.fps);
+    return ESP_OK;
+}
+
+// Sensor: every setting is kept in status and reported back
+
+#define SENSOR_SETTER(name, field)                   \
+    static int set_##name(sensor_t *s, int value)    \
+    {                                                \
+        s->status.field = value;                     \
+        return 0;                                    \
+    }
+
+SENSOR_SETTER(contrast, contrast)
+SENSOR_SETTER(brightness, brightness)
+SENSOR_SETTER(saturation, saturation)
+SENSOR_SETTER(sharpness, sharpness)
+SENSOR_SETTER(denoise, denoise)
+SENSOR_SETTER(colorbar, colorbar)
+SENSOR_SETTER(whitebal, awb)
+SENSOR_SETTER(gain_ctrl, agc)
+SENSOR_SETTER(exposure_ctrl, aec)
+SENSOR_SETTER(hmirror, hmirror)
+SENSOR_SETTER(vflip, vflip)
+SENSOR_SETTER(aec2, aec2)
+SENSOR_SETTER(awb_gain, awb_gain)
+SENSOR_SETTER(agc_gain, agc_gain)
+SENSOR_SETTER(aec_value, aec_value)
+SENSOR_SETTER(special_effect, special_effect)
+SENSOR_SETTER(wb_mode, wb_mode)
+SENSOR_SETTER(ae_level, ae_level)
+SENSOR_SETTER(dcw, dcw)
+SENSOR_SETTER(bpc, bpc)
+SENSOR_SETTER(wpc, wpc)
+SENSOR_SETTER(raw_gma, raw_gma)
+SENSOR_SETTER(lenc, lenc)
+
+static int set_pixformat(sensor_t *s, pixformat_t pixformat)
+{
+    if (pixformat != PIXFORMAT_JPEG)
+    {
+        return -1; // The frames are JPEG files
+    }
+    s->pixformat = pixformat;
+    return 0;
+}
+
+static int set_framesize(sensor_t *s, framesize_t framesize)
+{
+    if (framesize >= FRAMESIZE_INVALID)
+    {
+        return -1;
+    }
+    s->status.framesize = framesize;
+    return 0;
+}
+
+static int set_quality(sensor_t *s, int quality)
+{
+    if (quality < 0 || quality > 63)
+    {
+        return -1;
+    }
+    s->status.quality = quality;
+    return 0;
+}
+
+static int set_gainceiling(sensor_t *s, gainceiling_t gainceiling)
+{
+    s->status.gainceiling = gainceiling;
+    return 0;
+}
+
+static int get_reg(sensor_t *s, int reg, int mask)
+{
+    if (reg < 0 || reg >= SENSOR_REGS)
+    {
+        return -1;
+    }
+    return regs[reg] & mask;
+}
+
+static int set_reg(sensor_t *s, int reg, int mask, int value)
+{
+    if (reg < 0 || reg >= SENSOR_REGS)
+    {
+        return -1;
+    }
+    regs[reg] = (regs[reg] & ~mask) | (value & mask);
+    return 0;
+}
+
+static int set_res_raw(sensor_t *s, int startX, int startY, int endX, int endY, int offsetX, int offsetY,
+                       int totalX, int totalY, int outputX, int outputY, bool scale, bool binning)
+{
+    s->status.scale = scale;
+    s->status.binning = binning;
+    return 0;
+}
+
+static int set_pll(sensor_t *s, int bypass, int mul, int sys, int root, int pre, int seld5, int pclken, int pclk)
+{
+    return 0;
+}
+
+static int set_xclk(sensor_t *s, int timer, int xclk)
+{
+    s->xclk_freq_hz = xclk * 1000000;
+    return 0;
+}
+
+static void sensor_init(const camera_config_t *config)
+{
+    memset(&sensor, 0, sizeof(sensor));
+    sensor.id.PID = OV2640_PID;
+    sensor.slv_addr = 0x30;
+    sensor.pixformat = config->pixel_format;
+    sensor.xclk_freq_hz = config->xclk_freq_hz;
+    sensor.status.framesize = config->frame_size;
+    sensor.status.quality = config->jpeg_quality;
+    sensor.status.awb = 1;
+    sensor.status.awb_gain = 1;
+    sensor.status.aec = 1;
+    sensor.status.agc = 1;
+    sensor.status.bpc = 0;
+    sensor.status.wpc = 1;
+    sensor.status.raw_gma = 1;
+    sensor.status.lenc = 1;
+    sensor.status.dcw = 1;
+
+    sensor.set_pixformat = set_pixformat;
+    sensor.set_framesize = set_framesize;
+    sensor.set_contrast = set_contrast;
+    sensor.set_brightness = set_brightness;
+    sensor.set_saturation = set_saturation;
+    sensor.set_sharpness = set_sharpness;
+    sensor.set_denoise = set_denoise;
+    sensor.set_gainceiling = set_gainceiling;
+    sensor.set_quality = set_quality;
+    sensor.set_colorbar = set_colorbar;
+    sensor.set_whitebal = set_whitebal;
+    sensor.set_gain_ctrl = set_gain_ctrl;
+    sensor.set_exposure_ctrl = set_exposure_ctrl;
+    sensor.set_hmirror = set_hmirror;
+    sensor.set_vflip = set_vflip;
+    sensor.set_aec2 = set_aec2;
+    sensor.set_awb_gain = set_awb_gain;
+    sensor.set_agc_gain = set_agc_gain;
+    sensor.set_aec_value = set_aec_value;
+    sensor.set_special_effect = set_special_effect;
+    sensor.set_wb_mode = set_wb_mode;
+    sensor.set_ae_level = set_ae_level;
+    sensor.set_dcw = set_dcw;
+    sensor.set_bpc = set_bpc;
+    sensor.set_wpc = set_wpc;
+    sensor.set_raw_gma = set_raw_gma;
+    sensor.set_lenc = set_lenc;
+    sensor.get_reg = get_reg;
+    sensor.set_reg = set_reg;
+    sensor.set_res_raw = set_res_raw;
+    sensor.set_pll = set_pll;
+    sensor.set_xclk = set_xclk;
+}
+
+esp_err_t esp_camera_init(const camera_config_t *config)
+{
+    if (config->pixel_format != PIXFORMAT_JPEG)
+    {
+        fprintf(stderr, "host: the camera only delivers JPEG\n");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    esp_err_t res = load_frames(host_config.frames_dir);
+    if (res != ESP_OK)
+    {
+        return res;
+    }
+    slot_count = config->fb_count < 1 ? 1 : (config->fb_count > CAMERA_MAX_FB ? CAMERA_MAX_FB : config->fb_count);
+    grab_mode = config->grab_mode;
+    host_cond_init(&fb_free);
+    sensor_init(config);
+    return ESP_OK;
+}
+
+esp_err_t esp_camera_deinit()
+{
+    return ESP_OK;
+}
+
+// Waits until the sensor would have the next frame ready. When frames are
+// taken late, CAMERA_GRAB_LATEST starts the schedule over from now, since
+// the driver keeps overwriting its buffers; CAMERA_GRAB_WHEN_EMPTY keeps
+// the schedule, handing the backlog out at once as the queued frames would be.
+static void wait_for_frame()
+{
+    if (!host_config.fps)
+    {
+        return;
+    }
+    int64_t interval = 1000000 / host_config.fps;
+    int64_t now = esp_timer_get_time();
+    if (next_due == 0 || (grab_mode == CAMERA_GRAB_LATEST && now > next_due + interval))
+    {
+        next_due = now;
+    }
+    if (next_due > now)
+    {
+        usleep(next_due - now);
+    }
+    next_due += interval;
+}
+
+camera_fb_t *esp_camera_fb_get()
+{
+    struct timespec deadline;
+    fb_slot_t *slot = NULL;
+
+    if (!file_count)
+    {
+        return NULL;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += CAMERA_FB_TIMEOUT_MS / 1000;
+
+    pthread_mutex_lock(&fb_lock);
+    while (!slot)
+    {
+        for (size_t i = 0; i < slot_count && !slot; i++)
+        {
+            if (!slots[i].in_use)
+            {
+                slot = &slots[i];
+            }
+        }
+        if (!slot && pthread_cond_timedwait(&fb_free, &fb_lock, &deadline) != 0)
+        {
+            break;
+        }
+    }
+    if (slot)
+    {
+        slot->in_use = true;
+    }
+    pthread_mutex_unlock(&fb_lock);
+
+    if (!slot)
+    {
+        fprintf(stderr, "host: esp_camera_fb_get() timed out, every frame buffer is taken\n");
+        return NULL;
+    }
+
+    pthread_mutex_lock(&grab_lock);
+    wait_for_frame();
+    const jpeg_file_t *file = &files[next_file];
+    next_file = (next_file + 1) % file_count;
+    pthread_mutex_unlock(&grab_lock);
+
+    int64_t now = esp_timer_get_time();
+    slot->fb.buf = file->data;
+    slot->fb.len = file->len;
+    slot->fb.width = file->width;
+    slot->fb.height = file->height;
+    slot->fb.format = PIXFORMAT_JPEG;
+    slot->fb.timestamp.tv_sec = now / 1000000;
+    slot->fb.timestamp.tv_usec = now % 1000000;
+    return &slot->fb;
+}
+
+void esp_camera_fb_return(camera_fb_t *fb)
+{
+    pthread_mutex_lock(&fb_lock);
+    for (size_t i = 0; i < slot_count; i++)
+    {
+        if (&slots[i].fb == fb)
+        {
+            slots[i].in_use = false;
+        }
+    }
+    pthread_cond_signal(&fb_free);
+    pthread_mutex_unlock(&fb_lock);
+}
+
+sensor_t *esp_camera_sensor_get()
+{
+    return file_count ? &sensor : NULL;
+}
@@ -0,0 +1,397 @@
+#include <errno.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "host_internal.h"
+
+#define TASK_NAME_LEN 16 // configMAX_TASK_NAME_LEN
+#define TASK_HOST_STACK (1024 * 1024) // x86-64 and glibc need far more than the Xtensa depth asked for
+#define TASK_STACK_PAINT 0xa5
+
+struct tskTaskControlBlock
+{
+    pthread_t thread;
+    char name[TASK_NAME_LEN];
+    int core;
+    uint32_t stack_depth; // As asked for, in bytes like ESP-IDF
+    uint8_t *stack;       // Lowest address of the painted host stack; NULL for adopted threads
+    TaskFunction_t code;
+    void *arg;
+    pthread_mutex_t lock;
+    pthread_cond_t notified;
+    uint32_t notify_value;
+};
+
+struct QueueDefinition
+{
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    uint8_t *items; // NULL for a semaphore, which only counts
+    UBaseType_t item_size;
+    UBaseType_t length;
+    UBaseType_t count;
+    UBaseType_t head;
+};
+
+static thread_local TaskHandle_t current_task = NULL;
+
+void host_cond_init(pthread_cond_t *cond)
+{
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+// Waits on cond until it is signalled or the deadline passes; a deadline of
+// NULL waits for ever. Returns false on timeout.
+static bool cond_wait(pthread_cond_t *cond, pthread_mutex_t *lock, const struct timespec *deadline)
+{
+    if (!deadline)
+    {
+        pthread_cond_wait(cond, lock);
+        return true;
+    }
+    return pthread_cond_timedwait(cond, lock, deadline) != ETIMEDOUT;
+}
+
+// The deadline ticks from now, or NULL for portMAX_DELAY
+static const struct timespec *deadline_after(TickType_t ticks, struct timespec *ts)
+{
+    if (ticks == portMAX_DELAY)
+    {
+        return NULL;
+    }
+    uint64_t ms = (uint64_t)ticks * portTICK_PERIOD_MS;
+    clock_gettime(CLOCK_MONOTONIC, ts);
+    ts->tv_sec += ms / 1000;
+    ts->tv_nsec += (ms % 1000) * 1000000;
+    if (ts->tv_nsec >= 1000000000)
+    {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000;
+    }
+    return ts;
+}
+
+void vPortCPUInitializeMutex(portMUX_TYPE *mux)
+{
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&mux->mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+static TaskHandle_t task_alloc(const char *name, int core)
+{
+    TaskHandle_t task = (TaskHandle_t)calloc(1, sizeof(struct tskTaskControlBlock));
+    if (!task)
+    {
+        return NULL;
+    }
+    snprintf(task->name, sizeof(task->name), "%s", name);
+    task->core = (core == 1) ? 1 : 0;
+    pthread_mutex_init(&task->lock, NULL);
+    host_cond_init(&task->notified);
+    return task;
+}
+
+void host_task_adopt(const char *name, int core)
+{
+    current_task = task_alloc(name, core);
+    current_task->thread = pthread_self();
+    pthread_setname_np(pthread_self(), current_task->name);
+}
+
+static void *task_main(void *arg)
+{
+    TaskHandle_t task = (TaskHandle_t)arg;
+    current_task = task;
+    pthread_setname_np(pthread_self(), task->name);
+    task->code(task->arg);
+    // A FreeRTOS task must not return; treat it as deleting itself
+    fprintf(stderr, "host: task %s returned\n", task->name);
+    return NULL;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char *name, uint32_t stack_depth, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *created, BaseType_t core_id)
+{
+    TaskHandle_t task = task_alloc(name, core_id);
+    if (!task)
+    {
+        return pdFAIL;
+    }
+    task->code = code;
+    task->arg = arg;
+    task->stack_depth = stack_depth;
+
+    // Painted like FreeRTOS does, so uxTaskGetStackHighWaterMark() can tell how deep it went
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    if (posix_memalign((void **)&task->stack, 4096, TASK_HOST_STACK) != 0)
+    {
+        pthread_attr_destroy(&attr);
+        free(task);
+        return pdFAIL;
+    }
+    memset(task->stack, TASK_STACK_PAINT, TASK_HOST_STACK);
+    pthread_attr_setstack(&attr, task->stack, TASK_HOST_STACK);
+    if (pthread_create(&task->thread, &attr, task_main, task) != 0)
+    {
+        pthread_attr_destroy(&attr);
+        free(task->stack);
+        free(task);
+        return pdFAIL;
+    }
+    pthread_attr_destroy(&attr);
+    pthread_detach(task->thread);
+    if (created)
+    {
+        *created = task;
+    }
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    if (task && task != current_task)
+    {
+        fprintf(stderr, "host: vTaskDelete() of another task is not supported\n");
+        abort();
+    }
+    pthread_exit(NULL);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    uint64_t ms = (uint64_t)ticks * portTICK_PERIOD_MS;
+    struct timespec ts = {(time_t)(ms / 1000), (long)(ms % 1000) * 1000000};
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR)
+    {
+    }
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(esp_timer_get_time() / (1000 * portTICK_PERIOD_MS));
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return current_task;
+}
+
+// The host stack grows down from stack + TASK_HOST_STACK. What the task used
+// is taken from the configured depth, so the result is only a rough guide to
+// the board, where frames differ in size.
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task)
+{
+    task = task ? task : current_task;
+    if (!task || !task->stack)
+    {
+        return 0;
+    }
+    size_t untouched = 0;
+    while (untouched < TASK_HOST_STACK && task->stack[untouched] == TASK_STACK_PAINT)
+    {
+        untouched++;
+    }
+    size_t used = TASK_HOST_STACK - untouched;
+    return (used < task->stack_depth) ? task->stack_depth - used : 0;
+}
+
+char *pcTaskGetName(TaskHandle_t task)
+{
+    task = task ? task : current_task;
+    return task ? task->name : (char *)"unknown";
+}
+
+BaseType_t xPortGetCoreID(void)
+{
+    return current_task ? current_task->core : 0;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    pthread_mutex_lock(&task->lock);
+    task->notify_value++;
+    pthread_cond_signal(&task->notified);
+    pthread_mutex_unlock(&task->lock);
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken)
+{
+    xTaskNotifyGive(task);
+    if (woken)
+    {
+        *woken = pdTRUE;
+    }
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks)
+{
+    TaskHandle_t task = current_task;
+    struct timespec ts;
+    const struct timespec *deadline = deadline_after(ticks, &ts);
+
+    pthread_mutex_lock(&task->lock);
+    while (task->notify_value == 0 && ticks != 0)
+    {
+        if (!cond_wait(&task->notified, &task->lock, deadline))
+        {
+            break;
+        }
+    }
+    uint32_t value = task->notify_value;
+    if (value)
+    {
+        task->notify_value = clear_on_exit ? 0 : value - 1;
+    }
+    pthread_mutex_unlock(&task->lock);
+    return value;
+}
+
+static QueueHandle_t queue_alloc(UBaseType_t length, UBaseType_t item_size)
+{
+    QueueHandle_t queue = (QueueHandle_t)calloc(1, sizeof(struct QueueDefinition));
+    if (!queue)
+    {
+        return NULL;
+    }
+    if (item_size)
+    {
+        queue->items = (uint8_t *)malloc((size_t)length * item_size);
+        if (!queue->items)
+        {
+            free(queue);
+            return NULL;
+        }
+    }
+    queue->item_size = item_size;
+    queue->length = length;
+    pthread_mutex_init(&queue->lock, NULL);
+    host_cond_init(&queue->not_empty);
+    host_cond_init(&queue->not_full);
+    return queue;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    return length ? queue_alloc(length, item_size) : NULL;
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max_count, UBaseType_t initial_count)
+{
+    if (!max_count || initial_count > max_count)
+    {
+        return NULL;
+    }
+    QueueHandle_t queue = queue_alloc(max_count, 0);
+    if (queue)
+    {
+        queue->count = initial_count;
+    }
+    return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    if (!queue)
+    {
+        return;
+    }
+    pthread_mutex_destroy(&queue->lock);
+    pthread_cond_destroy(&queue->not_empty);
+    pthread_cond_destroy(&queue->not_full);
+    free(queue->items);
+    free(queue);
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks)
+{
+    struct timespec ts;
+    const struct timespec *deadline = deadline_after(ticks, &ts);
+    BaseType_t res = pdPASS;
+
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == queue->length)
+    {
+        if (ticks == 0 || !cond_wait(&queue->not_full, &queue->lock, deadline))
+        {
+            res = errQUEUE_FULL;
+            break;
+        }
+    }
+    if (res == pdPASS)
+    {
+        if (queue->items)
+        {
+            UBaseType_t tail = (queue->head + queue->count) % queue->length;
+            memcpy(queue->items + (size_t)tail * queue->item_size, item, queue->item_size);
+        }
+        queue->count++;
+        pthread_cond_signal(&queue->not_empty);
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return res;
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void *item, BaseType_t *woken)
+{
+    BaseType_t res = xQueueSend(queue, item, 0);
+    if (woken && res == pdPASS)
+    {
+        *woken = pdTRUE;
+    }
+    return res;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks)
+{
+    struct timespec ts;
+    const struct timespec *deadline = deadline_after(ticks, &ts);
+    BaseType_t res = pdPASS;
+
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == 0)
+    {
+        if (ticks == 0 || !cond_wait(&queue->not_empty, &queue->lock, deadline))
+        {
+            res = errQUEUE_EMPTY;
+            break;
+        }
+    }
+    if (res == pdPASS)
+    {
+        if (queue->items)
+        {
+            memcpy(item, queue->items + (size_t)queue->head * queue->item_size, queue->item_size);
+            queue->head = (queue->head + 1) % queue->length;
+        }
+        queue->count--;
+        pthread_cond_signal(&queue->not_full);
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return res;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    pthread_mutex_lock(&queue->lock);
+    UBaseType_t count = queue->count;
+    pthread_mutex_unlock(&queue->lock);
+    return count;
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <pthread.h>
+
+// Shared between the shim's own files
+
+// A condition variable timed against CLOCK_MONOTONIC
+void host_cond_init(pthread_cond_t *cond);
+
+// Makes the calling thread a task, for the thread that runs setup() and loop()
+void host_task_adopt(const char *name, int core);
+
+// Counts one socket send for host_socket_sends()
+void host_count_send();
+
+// Starts polling host_config.pir_path, if set
+void host_gpio_start();
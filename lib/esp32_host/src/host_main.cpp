@@ -0,0 +1,111 @@
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <getopt.h>
+#include <host.h>
+#include <signal.h>
+#include <time.h>
+
+#include "host_internal.h"
+
+host_config_t host_config = {"frames", 20, NULL, NULL, 8000, 0};
+
+// pio test links its own main() against the firmware sources
+#ifndef UNIT_TEST
+
+static volatile sig_atomic_t report_sends;
+
+static void on_sigusr1(int sig)
+{
+    report_sends = 1;
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [--frames DIR] [--fps N] [--audio FILE] [--pir FILE] [--port-offset N] [--sd-bytes N]\n"
+            "  --frames DIR      JPEG files the camera hands out, in name order (default frames)\n"
+            "  --fps N           Camera frame rate, 0 for as fast as asked (default 20)\n"
+            "  --audio FILE      16-bit mono PCM WAV the microphone plays back (default silence)\n"
+            "  --pir FILE        File holding the GPIO 13 level, 0 or 1 (default low)\n"
+            "  --port-offset N   Added to every server port (default 8000)\n"
+            "  --sd-bytes N      SD card size, counting the files under its mount point (default the host's)\n",
+            name);
+}
+
+static bool parse_args(int argc, char **argv)
+{
+    static const struct option options[] = {
+        {"frames", required_argument, NULL, 'f'},
+        {"fps", required_argument, NULL, 'r'},
+        {"audio", required_argument, NULL, 'a'},
+        {"pir", required_argument, NULL, 'p'},
+        {"port-offset", required_argument, NULL, 'o'},
+        {"sd-bytes", required_argument, NULL, 's'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}};
+    int c;
+
+    while ((c = getopt_long(argc, argv, "f:r:a:p:o:s:h", options, NULL)) != -1)
+    {
+        switch (c)
+        {
+        case 'f':
+            host_config.frames_dir = optarg;
+            break;
+        case 'r':
+            host_config.fps = atoi(optarg);
+            break;
+        case 'a':
+            host_config.audio_path = optarg;
+            break;
+        case 'p':
+            host_config.pir_path = optarg;
+            break;
+        case 'o':
+            host_config.port_offset = atoi(optarg);
+            break;
+        case 's':
+            host_config.sd_bytes = strtoull(optarg, NULL, 10);
+            break;
+        default:
+            return false;
+        }
+    }
+    return optind == argc;
+}
+
+// The Arduino core's app_main and loopTask, as one thread. loop() is left to
+// sleep a tick between calls so an empty one does not spin a host core.
+int main(int argc, char **argv)
+{
+    if (!parse_args(argc, argv))
+    {
+        usage(argv[0]);
+        return 2;
+    }
+    // A client that goes away fails the send instead of killing the process
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGUSR1, on_sigusr1);
+
+    host_task_adopt("loopTask", 1);
+    host_gpio_start();
+    setup();
+
+    // Lets a client on the same host turn X-Timestamp and friends into its own clock
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    int64_t origin = (int64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000 - esp_timer_get_time();
+    Serial.printf("host: esp_timer starts at CLOCK_MONOTONIC %lld.%06lld\n", (long long)(origin / 1000000), (long long)(origin % 1000000));
+    while (true)
+    {
+        loop();
+        delay(1);
+        if (report_sends)
+        {
+            report_sends = 0;
+            Serial.printf("host: socket sends %llu\n", (unsigned long long)host_socket_sends());
+        }
+    }
+}
+
+#endif
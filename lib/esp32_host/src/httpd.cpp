@@ -0,0 +1,1083 @@
+#include <errno.h>
+#include <esp_http_server.h>
+#include <freertos/task.h>
+#include <host.h>
+#include <lwip/sockets.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "host_internal.h"
+
+#define HTTPD_RESP_HDR_MAX 1024 // Status line and headers of one response
+#define HTTPD_WS_KEY_MAX 64
+#define HTTPD_WS_CONTROL_MAX 125
+
+static const char *_WS_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+typedef struct
+{
+    int fd; // -1 when free
+    void *ctx;
+    httpd_free_ctx_fn_t free_ctx;
+    bool ignore_ctx_changes;
+    bool closing;          // httpd_sess_trigger_close() was called for it
+    bool ws;               // Upgraded; every read from now on is a websocket frame for ws_handler
+    httpd_uri_t ws_handler;
+} httpd_session_t;
+
+typedef struct
+{
+    const char *field;
+    const char *value;
+} httpd_resp_hdr_t;
+
+typedef struct
+{
+    httpd_config_t config;
+    int listen_fd;
+    int wake[2]; // httpd_sess_trigger_close() interrupts select() through this pipe
+    httpd_uri_t *handlers;
+    size_t handler_count;
+    httpd_session_t *sessions;
+    httpd_resp_hdr_t *resp_hdrs;
+    pthread_mutex_t lock; // handlers and the closing flags
+} httpd_data_t;
+
+// The request being served, behind req->aux
+typedef struct
+{
+    httpd_data_t *hd;
+    httpd_session_t *sess;
+    char headers[HTTPD_MAX_REQ_HDR_LEN + 1]; // Request line and header lines, NUL terminated
+    const char *pending;                     // Body bytes read along with the headers
+    size_t pending_len;
+    size_t remaining; // Body bytes the handler has not taken
+    const char *status;
+    const char *content_type;
+    size_t resp_hdr_count;
+    bool chunked; // Headers of a chunked response are out
+
+    // The websocket frame being served; the first two bytes are read before the handler runs
+    uint8_t ws_head[2];
+    bool ws_header_done; // Length and mask read too
+    uint64_t ws_len;
+    uint8_t ws_mask[4];
+    bool ws_payload_done;
+} httpd_req_aux_t;
+
+static const struct
+{
+    const char *status;
+    const char *message;
+} http_errors[HTTPD_ERR_CODE_MAX] = {
+    {"500 Internal Server Error", "Server has encountered an unexpected error"},
+    {"501 Method Not Implemented", "Request method is not supported by server"},
+    {"505 Version Not Supported", "HTTP version not supported by server"},
+    {"400 Bad Request", "Bad request syntax"},
+    {"401 Unauthorized", "No permission -- see authorization schemes"},
+    {"403 Forbidden", "Request forbidden -- authorization will not help"},
+    {"404 Not Found", "Nothing matches the given URI"},
+    {"405 Method Not Allowed", "Specified method is invalid for this resource"},
+    {"408 Request Timeout", "Server closed this connection"},
+    {"411 Length Required", "Chunked encoding not supported"},
+    {"414 URI Too Long", "URI is too long"},
+    {"431 Request Header Fields Too Large", "Header fields are too long"},
+};
+
+static const struct
+{
+    const char *name;
+    httpd_method_t method;
+} http_methods[] = {
+    {"DELETE", HTTP_DELETE}, {"GET", HTTP_GET}, {"HEAD", HTTP_HEAD}, {"POST", HTTP_POST}, {"PUT", HTTP_PUT}, {"OPTIONS", HTTP_OPTIONS},
+};
+
+static httpd_req_aux_t *aux_of(httpd_req_t *r)
+{
+    return (httpd_req_aux_t *)r->aux;
+}
+
+// Sends every byte or fails, in one system call when the socket takes it all
+static esp_err_t send_all(int fd, struct iovec *iov, int count)
+{
+    while (count > 0)
+    {
+        struct msghdr msg = {};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = count;
+        host_count_send();
+        ssize_t sent = sendmsg(fd, &msg, MSG_NOSIGNAL);
+        if (sent < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return ESP_ERR_HTTPD_RESP_SEND;
+        }
+        while (count > 0 && (size_t)sent >= iov->iov_len)
+        {
+            sent -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0)
+        {
+            iov->iov_base = (char *)iov->iov_base + sent;
+            iov->iov_len -= sent;
+        }
+    }
+    return ESP_OK;
+}
+
+// Status line and headers; content_len < 0 for a chunked response
+static int format_headers(httpd_req_t *r, char *buf, size_t size, ssize_t content_len)
+{
+    httpd_req_aux_t *aux = aux_of(r);
+    int len;
+
+    if (content_len >= 0)
+    {
+        len = snprintf(buf, size, "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %zd\r\n", aux->status,
+                       aux->content_type, content_len);
+    }
+    else
+    {
+        len = snprintf(buf, size, "HTTP/1.1 %s\r\nContent-Type: %s\r\nTransfer-Encoding: chunked\r\n", aux->status,
+                       aux->content_type);
+    }
+    for (size_t i = 0; i < aux->resp_hdr_count && len >= 0 && (size_t)len < size; i++)
+    {
+        const httpd_resp_hdr_t *h = &aux->hd->resp_hdrs[i];
+        len += snprintf(buf + len, size - len, "%s: %s\r\n", h->field, h->value);
+    }
+    if (len >= 0 && (size_t)len < size)
+    {
+        len += snprintf(buf + len, size - len, "\r\n");
+    }
+    return (len >= 0 && (size_t)len < size) ? len : -1;
+}
+
+// Request line and headers
+
+static const char *find_header(httpd_req_aux_t *aux, const char *field, size_t *len)
+{
+    size_t field_len = strlen(field);
+    const char *line = strstr(aux->headers, "\r\n");
+
+    while (line && line[2])
+    {
+        line += 2;
+        const char *end = strstr(line, "\r\n");
+        size_t line_len = end ? (size_t)(end - line) : strlen(line);
+        if (line_len > field_len && line[field_len] == ':' && strncasecmp(line, field, field_len) == 0)
+        {
+            const char *value = line + field_len + 1;
+            while (*value == ' ' || *value == '\t')
+            {
+                value++;
+            }
+            *len = line + line_len - value;
+            return value;
+        }
+        line = end;
+    }
+    return NULL;
+}
+
+size_t httpd_req_get_hdr_value_len(httpd_req_t *r, const char *field)
+{
+    size_t len = 0;
+    return find_header(aux_of(r), field, &len) ? len : 0;
+}
+
+esp_err_t httpd_req_get_hdr_value_str(httpd_req_t *r, const char *field, char *val, size_t val_size)
+{
+    size_t len = 0;
+    const char *value = find_header(aux_of(r), field, &len);
+
+    if (!value)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (val_size == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    size_t copy = len < val_size - 1 ? len : val_size - 1;
+    memcpy(val, value, copy);
+    val[copy] = '\0';
+    return copy < len ? ESP_ERR_HTTPD_RESULT_TRUNC : ESP_OK;
+}
+
+size_t httpd_req_get_url_query_len(httpd_req_t *r)
+{
+    const char *query = strchr(r->uri, '?');
+    return query ? strlen(query + 1) : 0;
+}
+
+esp_err_t httpd_req_get_url_query_str(httpd_req_t *r, char *buf, size_t buf_len)
+{
+    const char *query = strchr(r->uri, '?');
+
+    if (!query)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (buf_len == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    query++;
+    size_t len = strlen(query);
+    size_t copy = len < buf_len - 1 ? len : buf_len - 1;
+    memcpy(buf, query, copy);
+    buf[copy] = '\0';
+    return copy < len ? ESP_ERR_HTTPD_RESULT_TRUNC : ESP_OK;
+}
+
+esp_err_t httpd_query_key_value(const char *qry, const char *key, char *val, size_t val_size)
+{
+    const char *p = qry;
+    size_t key_len = strlen(key);
+
+    if (!qry || !key || !val || !val_size)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    while (*p)
+    {
+        const char *eq = strchr(p, '=');
+        if (!eq)
+        {
+            break;
+        }
+        if ((size_t)(eq - p) != key_len || strncasecmp(p, key, key_len) != 0)
+        {
+            p = strchr(eq, '&');
+            if (!p)
+            {
+                break;
+            }
+            p++;
+            continue;
+        }
+        const char *value = eq + 1;
+        size_t len = strcspn(value, "&");
+        size_t copy = len < val_size - 1 ? len : val_size - 1;
+        memcpy(val, value, copy);
+        val[copy] = '\0';
+        return copy < len ? ESP_ERR_HTTPD_RESULT_TRUNC : ESP_OK;
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+int httpd_req_to_sockfd(httpd_req_t *r)
+{
+    return (r && r->aux) ? aux_of(r)->sess->fd : -1;
+}
+
+int httpd_socket_recv(httpd_handle_t hd, int sockfd, char *buf, size_t buf_len, int flags)
+{
+    ssize_t n;
+
+    do
+    {
+        n = recv(sockfd, buf, buf_len, flags);
+    } while (n < 0 && errno == EINTR);
+    return n < 0 ? HTTPD_SOCK_ERR_FAIL : n;
+}
+
+int httpd_req_recv(httpd_req_t *r, char *buf, size_t buf_len)
+{
+    httpd_req_aux_t *aux = aux_of(r);
+
+    if (aux->remaining == 0)
+    {
+        return 0;
+    }
+    if (buf_len > aux->remaining)
+    {
+        buf_len = aux->remaining;
+    }
+    if (aux->pending_len)
+    {
+        size_t n = buf_len < aux->pending_len ? buf_len : aux->pending_len;
+        memcpy(buf, aux->pending, n);
+        aux->pending += n;
+        aux->pending_len -= n;
+        aux->remaining -= n;
+        return n;
+    }
+    while (true)
+    {
+        ssize_t n = recv(aux->sess->fd, buf, buf_len, 0);
+        if (n > 0)
+        {
+            aux->remaining -= n;
+            return n;
+        }
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            return HTTPD_SOCK_ERR_TIMEOUT;
+        }
+        return HTTPD_SOCK_ERR_FAIL;
+    }
+}
+
+// Responses
+
+esp_err_t httpd_resp_set_status(httpd_req_t *r, const char *status)
+{
+    aux_of(r)->status = status;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_type(httpd_req_t *r, const char *type)
+{
+    aux_of(r)->content_type = type;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_hdr(httpd_req_t *r, const char *field, const char *value)
+{
+    httpd_req_aux_t *aux = aux_of(r);
+    if (aux->resp_hdr_count >= aux->hd->config.max_resp_headers)
+    {
+        return ESP_ERR_HTTPD_RESP_HDR;
+    }
+    aux->hd->resp_hdrs[aux->resp_hdr_count].field = field;
+    aux->hd->resp_hdrs[aux->resp_hdr_count].value = value;
+    aux->resp_hdr_count++;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_send(httpd_req_t *r, const char *buf, ssize_t buf_len)
+{
+    char header[HTTPD_RESP_HDR_MAX];
+
+    if (buf_len == HTTPD_RESP_USE_STRLEN)
+    {
+        buf_len = buf ? strlen(buf) : 0;
+    }
+    if (!buf)
+    {
+        buf_len = 0;
+    }
+    int len = format_headers(r, header, sizeof(header), buf_len);
+    if (len < 0)
+    {
+        return ESP_ERR_HTTPD_RESP_HDR;
+    }
+    struct iovec iov[] = {{header, (size_t)len}, {(void *)buf, (size_t)buf_len}};
+    return send_all(aux_of(r)->sess->fd, iov, buf_len ? 2 : 1);
+}
+
+esp_err_t httpd_resp_send_chunk(httpd_req_t *r, const char *buf, ssize_t buf_len)
+{
+    httpd_req_aux_t *aux = aux_of(r);
+    char header[HTTPD_RESP_HDR_MAX];
+    char size[12];
+    int header_len = 0;
+
+    if (buf_len == HTTPD_RESP_USE_STRLEN)
+    {
+        buf_len = buf ? strlen(buf) : 0;
+    }
+    if (!buf)
+    {
+        buf_len = 0;
+    }
+    if (!aux->chunked)
+    {
+        header_len = format_headers(r, header, sizeof(header), -1);
+        if (header_len < 0)
+        {
+            return ESP_ERR_HTTPD_RESP_HDR;
+        }
+        aux->chunked = true;
+    }
+    // An empty chunk ends the body
+    int size_len = snprintf(size, sizeof(size), "%zx\r\n", buf_len);
+    struct iovec iov[] = {{header, (size_t)header_len}, {size, (size_t)size_len}, {(void *)buf, (size_t)buf_len}, {(void *)"\r\n", 2}};
+    return send_all(aux->sess->fd, header_len ? iov : iov + 1, header_len ? 4 : 3);
+}
+
+esp_err_t httpd_resp_send_err(httpd_req_t *req, httpd_err_code_t error, const char *msg)
+{
+    if (error < 0 || error >= HTTPD_ERR_CODE_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    httpd_resp_set_status(req, http_errors[error].status);
+    httpd_resp_set_type(req, HTTPD_TYPE_TEXT);
+    return httpd_resp_sendstr(req, msg ? msg : http_errors[error].message);
+}
+
+// Websockets
+
+static esp_err_t recv_exact(int fd, void *buf, size_t len)
+{
+    size_t got = 0;
+
+    while (got < len)
+    {
+        ssize_t n = recv(fd, (char *)buf + got, len - got, 0);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            return ESP_FAIL;
+        }
+        got += n;
+    }
+    return ESP_OK;
+}
+
+static uint32_t rotl(uint32_t x, int n)
+{
+    return (x << n) | (x >> (32 - n));
+}
+
+// Only ever hashes a handshake key, so the whole message fits a small buffer
+static void sha1(const uint8_t *data, size_t len, uint8_t out[20])
+{
+    uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    uint8_t msg[256] = {};
+    size_t padded = ((len + 8) / 64 + 1) * 64;
+
+    memcpy(msg, data, len);
+    msg[len] = 0x80;
+    for (int i = 0; i < 8; i++)
+    {
+        msg[padded - 1 - i] = (uint64_t)len * 8 >> (i * 8);
+    }
+    for (size_t block = 0; block < padded; block += 64)
+    {
+        uint32_t w[80];
+        for (int i = 0; i < 16; i++)
+        {
+            const uint8_t *p = msg + block + i * 4;
+            w[i] = (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+        }
+        for (int i = 16; i < 80; i++)
+        {
+            w[i] = rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        }
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i = 0; i < 80; i++)
+        {
+            uint32_t f, k;
+            if (i < 20)
+            {
+                f = (b & c) | (~b & d);
+                k = 0x5A827999;
+            }
+            else if (i < 40)
+            {
+                f = b ^ c ^ d;
+                k = 0x6ED9EBA1;
+            }
+            else if (i < 60)
+            {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8F1BBCDC;
+            }
+            else
+            {
+                f = b ^ c ^ d;
+                k = 0xCA62C1D6;
+            }
+            uint32_t t = rotl(a, 5) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = rotl(b, 30);
+            b = a;
+            a = t;
+        }
+        h[0] += a;
+        h[1] += b;
+        h[2] += c;
+        h[3] += d;
+        h[4] += e;
+    }
+    for (int i = 0; i < 20; i++)
+    {
+        out[i] = h[i / 4] >> (24 - (i % 4) * 8);
+    }
+}
+
+static void base64(const uint8_t *in, size_t len, char *out)
+{
+    static const char digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    for (size_t i = 0; i < len; i += 3)
+    {
+        uint32_t v = in[i] << 16 | (i + 1 < len ? in[i + 1] << 8 : 0) | (i + 2 < len ? in[i + 2] : 0);
+        *out++ = digits[v >> 18];
+        *out++ = digits[(v >> 12) & 0x3f];
+        *out++ = i + 1 < len ? digits[(v >> 6) & 0x3f] : '=';
+        *out++ = i + 2 < len ? digits[v & 0x3f] : '=';
+    }
+    *out = '\0';
+}
+
+// Answers the upgrade request with 101 Switching Protocols
+static esp_err_t ws_handshake(httpd_req_t *r)
+{
+    char upgrade[16];
+    char key[HTTPD_WS_KEY_MAX];
+    char keyed[HTTPD_WS_KEY_MAX + 40];
+    uint8_t digest[20];
+    char accept[32];
+    char response[160];
+
+    if (httpd_req_get_hdr_value_str(r, "Upgrade", upgrade, sizeof(upgrade)) != ESP_OK || strcasecmp(upgrade, "websocket") != 0 ||
+        httpd_req_get_hdr_value_str(r, "Sec-WebSocket-Key", key, sizeof(key)) != ESP_OK)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    int len = snprintf(keyed, sizeof(keyed), "%s%s", key, _WS_GUID);
+    sha1((const uint8_t *)keyed, len, digest);
+    base64(digest, sizeof(digest), accept);
+    len = snprintf(response, sizeof(response),
+                   "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Accept: %s\r\n\r\n", accept);
+    struct iovec iov[] = {{response, (size_t)len}};
+    return send_all(aux_of(r)->sess->fd, iov, 1);
+}
+
+esp_err_t httpd_ws_recv_frame(httpd_req_t *req, httpd_ws_frame_t *pkt, size_t max_len)
+{
+    httpd_req_aux_t *aux = aux_of(req);
+    int fd = aux->sess->fd;
+
+    if (!aux->sess->ws || !pkt)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!aux->ws_header_done)
+    {
+        uint8_t ext[8];
+        uint8_t len = aux->ws_head[1] & 0x7f;
+        aux->ws_len = len;
+        if (len == 126 || len == 127)
+        {
+            size_t ext_len = len == 126 ? 2 : 8;
+            if (recv_exact(fd, ext, ext_len) != ESP_OK)
+            {
+                return ESP_FAIL;
+            }
+            aux->ws_len = 0;
+            for (size_t i = 0; i < ext_len; i++)
+            {
+                aux->ws_len = aux->ws_len << 8 | ext[i];
+            }
+        }
+        // Client frames are always masked
+        if (!(aux->ws_head[1] & 0x80) || recv_exact(fd, aux->ws_mask, sizeof(aux->ws_mask)) != ESP_OK)
+        {
+            return ESP_FAIL;
+        }
+        aux->ws_header_done = true;
+    }
+    pkt->final = aux->ws_head[0] & 0x80;
+    pkt->fragmented = !pkt->final || (aux->ws_head[0] & 0x0f) == HTTPD_WS_TYPE_CONTINUE;
+    pkt->type = (httpd_ws_type_t)(aux->ws_head[0] & 0x0f);
+    pkt->len = aux->ws_len;
+    if (max_len == 0)
+    {
+        return ESP_OK;
+    }
+    if (aux->ws_payload_done || !pkt->payload || pkt->len > max_len)
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (recv_exact(fd, pkt->payload, pkt->len) != ESP_OK)
+    {
+        return ESP_FAIL;
+    }
+    for (size_t i = 0; i < pkt->len; i++)
+    {
+        pkt->payload[i] ^= aux->ws_mask[i % 4];
+    }
+    aux->ws_payload_done = true;
+    return ESP_OK;
+}
+
+httpd_ws_client_info_t httpd_ws_get_fd_info(httpd_handle_t handle, int fd)
+{
+    httpd_data_t *hd = (httpd_data_t *)handle;
+    httpd_ws_client_info_t info = HTTPD_WS_CLIENT_INVALID;
+
+    pthread_mutex_lock(&hd->lock);
+    for (int i = 0; i < hd->config.max_open_sockets; i++)
+    {
+        if (hd->sessions[i].fd == fd)
+        {
+            info = hd->sessions[i].ws ? HTTPD_WS_CLIENT_WEBSOCKET : HTTPD_WS_CLIENT_HTTP;
+        }
+    }
+    pthread_mutex_unlock(&hd->lock);
+    return info;
+}
+
+// Sessions
+
+static void free_ctx(httpd_session_t *sess)
+{
+    if (sess->ctx)
+    {
+        if (sess->free_ctx)
+        {
+            sess->free_ctx(sess->ctx);
+        }
+        else
+        {
+            free(sess->ctx);
+        }
+        sess->ctx = NULL;
+    }
+}
+
+// In httpd_sess_delete()'s order: the socket is closed, by close_fn when
+// there is one, and only then is free_ctx called. By that time another task
+// may have been handed the same descriptor number by accept().
+static void close_session(httpd_data_t *hd, httpd_session_t *sess)
+{
+    if (hd->config.close_fn)
+    {
+        hd->config.close_fn(hd, sess->fd);
+    }
+    else
+    {
+        close(sess->fd);
+    }
+    free_ctx(sess);
+    pthread_mutex_lock(&hd->lock);
+    sess->fd = -1;
+    sess->free_ctx = NULL;
+    sess->ignore_ctx_changes = false;
+    sess->closing = false;
+    sess->ws = false;
+    pthread_mutex_unlock(&hd->lock);
+}
+
+esp_err_t httpd_sess_trigger_close(httpd_handle_t handle, int sockfd)
+{
+    httpd_data_t *hd = (httpd_data_t *)handle;
+    esp_err_t res = ESP_ERR_NOT_FOUND;
+
+    pthread_mutex_lock(&hd->lock);
+    for (int i = 0; i < hd->config.max_open_sockets; i++)
+    {
+        if (hd->sessions[i].fd == sockfd)
+        {
+            hd->sessions[i].closing = true;
+            res = ESP_OK;
+        }
+    }
+    pthread_mutex_unlock(&hd->lock);
+    if (res == ESP_OK)
+    {
+        char c = 0;
+        write(hd->wake[1], &c, 1);
+    }
+    return res;
+}
+
+static void accept_session(httpd_data_t *hd)
+{
+    int fd = accept(hd->listen_fd, NULL, NULL);
+    if (fd < 0)
+    {
+        return;
+    }
+    pthread_mutex_lock(&hd->lock);
+    httpd_session_t *sess = NULL;
+    for (int i = 0; i < hd->config.max_open_sockets && !sess; i++)
+    {
+        if (hd->sessions[i].fd < 0)
+        {
+            sess = &hd->sessions[i];
+            sess->fd = fd;
+        }
+    }
+    pthread_mutex_unlock(&hd->lock);
+    if (!sess)
+    {
+        // No lru_purge_enable: the newcomer is turned away
+        close(fd);
+        return;
+    }
+
+    struct timeval recv_timeout = {hd->config.recv_wait_timeout, 0};
+    struct timeval send_timeout = {hd->config.send_wait_timeout, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &recv_timeout, sizeof(recv_timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &send_timeout, sizeof(send_timeout));
+}
+
+// Reads up to the blank line after the headers. Returns the header length,
+// 0 when the client closed or timed out, -1 when the headers do not fit.
+static int read_headers(httpd_req_aux_t *aux, size_t *total)
+{
+    size_t len = 0;
+
+    while (len < HTTPD_MAX_REQ_HDR_LEN)
+    {
+        ssize_t n = recv(aux->sess->fd, aux->headers + len, HTTPD_MAX_REQ_HDR_LEN - len, 0);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            return 0;
+        }
+        len += n;
+        aux->headers[len] = '\0';
+        char *end = strstr(aux->headers, "\r\n\r\n");
+        if (end)
+        {
+            *total = len;
+            return end + 4 - aux->headers;
+        }
+    }
+    return -1;
+}
+
+static bool find_handler(httpd_data_t *hd, const char *uri, int method, httpd_uri_t *found, bool *uri_known)
+{
+    size_t path_len = strcspn(uri, "?");
+    bool match = false;
+
+    *uri_known = false;
+    pthread_mutex_lock(&hd->lock);
+    for (size_t i = 0; i < hd->handler_count && !match; i++)
+    {
+        const httpd_uri_t *h = &hd->handlers[i];
+        if (strlen(h->uri) == path_len && strncmp(h->uri, uri, path_len) == 0)
+        {
+            *uri_known = true;
+            if ((int)h->method == method)
+            {
+                *found = *h;
+                match = true;
+            }
+        }
+    }
+    pthread_mutex_unlock(&hd->lock);
+    return match;
+}
+
+// Runs a handler with the session's context and keeps what it leaves there
+static esp_err_t call_handler(httpd_session_t *sess, httpd_req_t *req, const httpd_uri_t *handler)
+{
+    req->user_ctx = handler->user_ctx;
+    req->sess_ctx = sess->ctx;
+    req->free_ctx = sess->free_ctx;
+    req->ignore_sess_ctx_changes = sess->ignore_ctx_changes;
+    esp_err_t res = handler->handler(req);
+
+    if (!req->ignore_sess_ctx_changes && sess->ctx != req->sess_ctx)
+    {
+        free_ctx(sess);
+    }
+    sess->ctx = req->sess_ctx;
+    sess->free_ctx = req->free_ctx;
+    sess->ignore_ctx_changes = req->ignore_sess_ctx_changes;
+    return res;
+}
+
+// Serves one request of the session. Anything but ESP_OK closes it.
+static esp_err_t serve_request(httpd_data_t *hd, httpd_session_t *sess)
+{
+    httpd_req_aux_t aux = {};
+    httpd_req_t req = {};
+    size_t total = 0;
+    char method[16];
+    int uri_start = 0;
+    int uri_end = 0;
+
+    aux.hd = hd;
+    aux.sess = sess;
+    aux.status = HTTPD_200;
+    aux.content_type = HTTPD_TYPE_TEXT;
+    req.handle = hd;
+    req.aux = &aux;
+
+    int header_len = read_headers(&aux, &total);
+    if (header_len == 0)
+    {
+        return ESP_FAIL;
+    }
+    if (header_len < 0)
+    {
+        httpd_resp_send_err(&req, HTTPD_431_REQ_HDR_FIELDS_TOO_LARGE, NULL);
+        return ESP_FAIL;
+    }
+    aux.pending = aux.headers + header_len;
+    aux.pending_len = total - header_len;
+    aux.headers[header_len - 2] = '\0';
+
+    if (sscanf(aux.headers, "%15s %n%*s%n HTTP/1.", method, &uri_start, &uri_end) < 1 || uri_end <= uri_start)
+    {
+        httpd_resp_send_err(&req, HTTPD_400_BAD_REQUEST, NULL);
+        return ESP_FAIL;
+    }
+    req.method = -1;
+    for (size_t i = 0; i < sizeof(http_methods) / sizeof(http_methods[0]); i++)
+    {
+        if (strcmp(method, http_methods[i].name) == 0)
+        {
+            req.method = http_methods[i].method;
+        }
+    }
+    if (req.method < 0)
+    {
+        httpd_resp_send_err(&req, HTTPD_501_METHOD_NOT_IMPLEMENTED, NULL);
+        return ESP_FAIL;
+    }
+    if (uri_end - uri_start > HTTPD_MAX_URI_LEN)
+    {
+        httpd_resp_send_err(&req, HTTPD_414_URI_TOO_LONG, NULL);
+        return ESP_FAIL;
+    }
+    memcpy((char *)req.uri, aux.headers + uri_start, uri_end - uri_start);
+
+    char length[16];
+    if (httpd_req_get_hdr_value_str(&req, "Content-Length", length, sizeof(length)) == ESP_OK)
+    {
+        req.content_len = strtoul(length, NULL, 10);
+    }
+    aux.remaining = req.content_len;
+
+    httpd_uri_t handler;
+    bool uri_known;
+    if (!find_handler(hd, req.uri, req.method, &handler, &uri_known))
+    {
+        httpd_resp_send_err(&req, uri_known ? HTTPD_405_METHOD_NOT_ALLOWED : HTTPD_404_NOT_FOUND, NULL);
+        return ESP_FAIL;
+    }
+
+    if (handler.is_websocket)
+    {
+        // As in ESP-IDF, a plain GET without the upgrade headers goes to the handler as is
+        esp_err_t res = ws_handshake(&req);
+        if (res == ESP_OK)
+        {
+            pthread_mutex_lock(&hd->lock);
+            sess->ws = true;
+            sess->ws_handler = handler;
+            pthread_mutex_unlock(&hd->lock);
+            return call_handler(sess, &req, &handler) == ESP_OK ? ESP_OK : ESP_FAIL;
+        }
+        if (res != ESP_ERR_NOT_FOUND)
+        {
+            return ESP_FAIL;
+        }
+    }
+
+    if (call_handler(sess, &req, &handler) != ESP_OK)
+    {
+        return ESP_FAIL;
+    }
+
+    // Whatever body the handler left is read and dropped
+    char discard[256];
+    while (aux.remaining)
+    {
+        if (httpd_req_recv(&req, discard, sizeof(discard)) <= 0)
+        {
+            return ESP_FAIL;
+        }
+    }
+    return ESP_OK;
+}
+
+// Serves one frame of an upgraded session. Anything but ESP_OK closes it.
+static esp_err_t serve_ws_frame(httpd_data_t *hd, httpd_session_t *sess)
+{
+    httpd_req_aux_t aux = {};
+    httpd_req_t req = {};
+    httpd_ws_frame_t frame = {};
+
+    aux.hd = hd;
+    aux.sess = sess;
+    aux.status = HTTPD_200;
+    aux.content_type = HTTPD_TYPE_TEXT;
+    req.handle = hd;
+    req.aux = &aux;
+    req.method = 0; // ESP-IDF leaves it zeroed for frames, so handlers can tell them from the handshake
+
+    if (recv_exact(sess->fd, aux.ws_head, sizeof(aux.ws_head)) != ESP_OK)
+    {
+        return ESP_FAIL;
+    }
+
+    httpd_ws_type_t type = (httpd_ws_type_t)(aux.ws_head[0] & 0x0f);
+    if (type >= HTTPD_WS_TYPE_CLOSE && !sess->ws_handler.handle_ws_control_frames)
+    {
+        uint8_t payload[HTTPD_WS_CONTROL_MAX];
+        frame.payload = payload;
+        if (httpd_ws_recv_frame(&req, &frame, sizeof(payload)) != ESP_OK)
+        {
+            return ESP_FAIL;
+        }
+        if (type == HTTPD_WS_TYPE_PONG)
+        {
+            return ESP_OK;
+        }
+        // A ping gets its payload back in a pong, a close is echoed and ends the session
+        uint8_t head[2] = {(uint8_t)(0x80 | (type == HTTPD_WS_TYPE_PING ? HTTPD_WS_TYPE_PONG : HTTPD_WS_TYPE_CLOSE)), (uint8_t)frame.len};
+        struct iovec iov[] = {{head, sizeof(head)}, {payload, frame.len}};
+        esp_err_t res = send_all(sess->fd, iov, frame.len ? 2 : 1);
+        return type == HTTPD_WS_TYPE_CLOSE ? ESP_FAIL : res;
+    }
+
+    // As on the ESP32, a payload the handler leaves unread is taken for the next frame's header
+    return call_handler(sess, &req, &sess->ws_handler);
+}
+
+static void httpd_loop(void *arg)
+{
+    httpd_data_t *hd = (httpd_data_t *)arg;
+
+    while (true)
+    {
+        fd_set fds;
+        FD_ZERO(&fds);
+        FD_SET(hd->listen_fd, &fds);
+        FD_SET(hd->wake[0], &fds);
+        int max_fd = hd->listen_fd > hd->wake[0] ? hd->listen_fd : hd->wake[0];
+
+        pthread_mutex_lock(&hd->lock);
+        for (int i = 0; i < hd->config.max_open_sockets; i++)
+        {
+            httpd_session_t *sess = &hd->sessions[i];
+            if (sess->fd >= 0 && !sess->closing)
+            {
+                FD_SET(sess->fd, &fds);
+                max_fd = sess->fd > max_fd ? sess->fd : max_fd;
+            }
+        }
+        pthread_mutex_unlock(&hd->lock);
+
+        if (select(max_fd + 1, &fds, NULL, NULL, NULL) < 0)
+        {
+            continue;
+        }
+
+        if (FD_ISSET(hd->wake[0], &fds))
+        {
+            char drain[16];
+            read(hd->wake[0], drain, sizeof(drain));
+        }
+        for (int i = 0; i < hd->config.max_open_sockets; i++)
+        {
+            httpd_session_t *sess = &hd->sessions[i];
+            pthread_mutex_lock(&hd->lock);
+            bool closing = sess->fd >= 0 && sess->closing;
+            pthread_mutex_unlock(&hd->lock);
+            if (closing)
+            {
+                close_session(hd, sess);
+            }
+            else if (sess->fd >= 0 && FD_ISSET(sess->fd, &fds) &&
+                     (sess->ws ? serve_ws_frame(hd, sess) : serve_request(hd, sess)) != ESP_OK)
+            {
+                close_session(hd, sess);
+            }
+        }
+        if (FD_ISSET(hd->listen_fd, &fds))
+        {
+            accept_session(hd);
+        }
+    }
+}
+
+esp_err_t httpd_start(httpd_handle_t *handle, const httpd_config_t *config)
+{
+    unsigned port = config->server_port + host_config.port_offset;
+    if (port > 65535)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    httpd_data_t *hd = (httpd_data_t *)calloc(1, sizeof(httpd_data_t));
+    if (!hd)
+    {
+        return ESP_ERR_HTTPD_ALLOC_MEM;
+    }
+    hd->config = *config;
+    hd->handlers = (httpd_uri_t *)calloc(config->max_uri_handlers, sizeof(httpd_uri_t));
+    hd->sessions = (httpd_session_t *)calloc(config->max_open_sockets, sizeof(httpd_session_t));
+    hd->resp_hdrs = (httpd_resp_hdr_t *)calloc(config->max_resp_headers ? config->max_resp_headers : 1, sizeof(httpd_resp_hdr_t));
+    if (!hd->handlers || !hd->sessions || !hd->resp_hdrs)
+    {
+        return ESP_ERR_HTTPD_ALLOC_MEM;
+    }
+    for (int i = 0; i < config->max_open_sockets; i++)
+    {
+        hd->sessions[i].fd = -1;
+    }
+    pthread_mutex_init(&hd->lock, NULL);
+
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(config->server_port); // bind() adds the offset
+    int enable = 1;
+    hd->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (hd->listen_fd < 0 || setsockopt(hd->listen_fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable)) != 0 ||
+        bind(hd->listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(hd->listen_fd, config->backlog_conn) != 0 ||
+        pipe(hd->wake) != 0)
+    {
+        fprintf(stderr, "host: cannot listen on port %u: %s\n", port, strerror(errno));
+        return ESP_FAIL;
+    }
+
+    if (xTaskCreatePinnedToCore(httpd_loop, "httpd", config->stack_size, hd, config->task_priority, NULL,
+                                config->core_id) != pdPASS)
+    {
+        return ESP_ERR_HTTPD_TASK;
+    }
+    printf("host: httpd port %u is on %u\n", config->server_port, port);
+    *handle = hd;
+    return ESP_OK;
+}
+
+esp_err_t httpd_register_uri_handler(httpd_handle_t handle, const httpd_uri_t *uri_handler)
+{
+    httpd_data_t *hd = (httpd_data_t *)handle;
+    esp_err_t res = ESP_OK;
+
+    pthread_mutex_lock(&hd->lock);
+    for (size_t i = 0; i < hd->handler_count && res == ESP_OK; i++)
+    {
+        if (hd->handlers[i].method == uri_handler->method && strcmp(hd->handlers[i].uri, uri_handler->uri) == 0)
+        {
+            res = ESP_ERR_HTTPD_HANDLER_EXISTS;
+        }
+    }
+    if (res == ESP_OK && hd->handler_count >= hd->config.max_uri_handlers)
+    {
+        res = ESP_ERR_HTTPD_HANDLERS_FULL;
+    }
+    if (res == ESP_OK)
+    {
+        httpd_uri_t *h = &hd->handlers[hd->handler_count++];
+        *h = *uri_handler;
+        h->uri = strdup(uri_handler->uri);
+    }
+    pthread_mutex_unlock(&hd->lock);
+    return res;
+}
@@ -0,0 +1,282 @@
+#include <driver/i2s.h>
+#include <esp_timer.h>
+#include <freertos/queue.h>
+#include <host.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+typedef struct
+{
+    bool installed;
+    bool running;
+    i2s_config_t config;
+    QueueHandle_t events;
+    int64_t started;   // esp_timer_get_time() of the last i2s_start()
+    uint64_t consumed; // Samples taken or dropped since then
+    int16_t *samples;  // The WAV file's data, NULL for silence
+    size_t sample_count;
+    size_t position; // Next sample of the file
+    pthread_mutex_t lock;
+} i2s_host_t;
+
+static i2s_host_t ports[I2S_NUM_MAX] = {
+    {false, false, {}, NULL, 0, 0, NULL, 0, 0, PTHREAD_MUTEX_INITIALIZER},
+    {false, false, {}, NULL, 0, 0, NULL, 0, 0, PTHREAD_MUTEX_INITIALIZER},
+};
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t get_u16(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+// Reads the samples of a 16-bit mono PCM WAV file
+static esp_err_t load_wav(const char *path, i2s_host_t *i2s)
+{
+    FILE *f = fopen(path, "rb");
+    uint8_t header[12];
+    uint8_t chunk[8];
+    bool format_ok = false;
+    uint32_t rate = 0;
+
+    if (!f)
+    {
+        fprintf(stderr, "host: cannot open the audio file %s\n", path);
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (fread(header, 1, sizeof(header), f) != sizeof(header) || memcmp(header, "RIFF", 4) || memcmp(header + 8, "WAVE", 4))
+    {
+        fprintf(stderr, "host: %s is not a WAV file\n", path);
+        fclose(f);
+        return ESP_ERR_INVALID_ARG;
+    }
+    while (fread(chunk, 1, sizeof(chunk), f) == sizeof(chunk))
+    {
+        uint32_t size = get_u32(chunk + 4);
+        if (memcmp(chunk, "fmt ", 4) == 0)
+        {
+            uint8_t fmt[16];
+            if (size < sizeof(fmt) || fread(fmt, 1, sizeof(fmt), f) != sizeof(fmt))
+            {
+                break;
+            }
+            format_ok = get_u16(fmt) == 1 && get_u16(fmt + 2) == 1 && get_u16(fmt + 14) == 16;
+            rate = get_u32(fmt + 4);
+            fseek(f, size - sizeof(fmt) + (size & 1), SEEK_CUR);
+        }
+        else if (memcmp(chunk, "data", 4) == 0 && format_ok)
+        {
+            i2s->samples = (int16_t *)malloc(size ? size : 1);
+            i2s->sample_count = fread(i2s->samples, 1, size, f) / sizeof(int16_t);
+            break;
+        }
+        else
+        {
+            fseek(f, size + (size & 1), SEEK_CUR);
+        }
+    }
+    fclose(f);
+
+    if (!format_ok || !i2s->sample_count)
+    {
+        fprintf(stderr, "host: %s is not 16-bit mono PCM with samples\n", path);
+        free(i2s->samples);
+        i2s->samples = NULL;
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if (rate != i2s->config.sample_rate)
+    {
+        fprintf(stderr, "host: %s is %u Hz, played back as %u Hz\n", path, rate, i2s->config.sample_rate);
+    }
+    printf("host: microphone plays %s, %zu samples\n", path, i2s->sample_count);
+    return ESP_OK;
+}
+
+esp_err_t i2s_driver_install(i2s_port_t port, const i2s_config_t *config, int queue_size, void *i2s_queue)
+{
+    if (port >= I2S_NUM_MAX || !(config->mode & I2S_MODE_RX))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (config->bits_per_sample != I2S_BITS_PER_SAMPLE_16BIT ||
+        (config->channel_format != I2S_CHANNEL_FMT_ONLY_LEFT && config->channel_format != I2S_CHANNEL_FMT_ONLY_RIGHT))
+    {
+        fprintf(stderr, "host: only mono 16-bit I2S reception is simulated\n");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    i2s_host_t *i2s = &ports[port];
+    if (i2s->installed)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    i2s->config = *config;
+    if (host_config.audio_path)
+    {
+        esp_err_t res = load_wav(host_config.audio_path, i2s);
+        if (res != ESP_OK)
+        {
+            return res;
+        }
+    }
+    if (i2s_queue && queue_size > 0)
+    {
+        i2s->events = xQueueCreate(queue_size, sizeof(i2s_event_t));
+        *(QueueHandle_t *)i2s_queue = i2s->events;
+    }
+    i2s->installed = true;
+    i2s_start(port);
+    return ESP_OK;
+}
+
+esp_err_t i2s_driver_uninstall(i2s_port_t port)
+{
+    if (port >= I2S_NUM_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    i2s_host_t *i2s = &ports[port];
+    pthread_mutex_lock(&i2s->lock);
+    i2s->installed = false;
+    i2s->running = false;
+    free(i2s->samples);
+    i2s->samples = NULL;
+    pthread_mutex_unlock(&i2s->lock);
+    return ESP_OK;
+}
+
+esp_err_t i2s_set_pin(i2s_port_t port, const i2s_pin_config_t *pins)
+{
+    return port < I2S_NUM_MAX ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t i2s_start(i2s_port_t port)
+{
+    if (port >= I2S_NUM_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    i2s_host_t *i2s = &ports[port];
+    pthread_mutex_lock(&i2s->lock);
+    i2s->running = true;
+    i2s->started = esp_timer_get_time();
+    i2s->consumed = 0;
+    pthread_mutex_unlock(&i2s->lock);
+    return ESP_OK;
+}
+
+esp_err_t i2s_stop(i2s_port_t port)
+{
+    if (port >= I2S_NUM_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&ports[port].lock);
+    ports[port].running = false;
+    pthread_mutex_unlock(&ports[port].lock);
+    return ESP_OK;
+}
+
+esp_err_t i2s_zero_dma_buffer(i2s_port_t port)
+{
+    return port < I2S_NUM_MAX ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+// Samples in the DMA buffers filled since i2s_start(); a buffer only counts
+// once it is complete, as the driver only hands out whole ones
+static uint64_t samples_ready(const i2s_host_t *i2s, int64_t now)
+{
+    uint64_t produced = (uint64_t)(now - i2s->started) * i2s->config.sample_rate / 1000000;
+    return produced - produced % i2s->config.dma_buf_len;
+}
+
+static void copy_samples(i2s_host_t *i2s, int16_t *out, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (i2s->samples)
+        {
+            out[i] = i2s->samples[i2s->position];
+            i2s->position = (i2s->position + 1) % i2s->sample_count;
+        }
+        else
+        {
+            out[i] = 0;
+        }
+    }
+}
+
+esp_err_t i2s_read(i2s_port_t port, void *dest, size_t size, size_t *bytes_read, TickType_t ticks_to_wait)
+{
+    if (port >= I2S_NUM_MAX || !ports[port].installed)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    i2s_host_t *i2s = &ports[port];
+    int16_t *out = (int16_t *)dest;
+    size_t wanted = size / sizeof(int16_t);
+    size_t got = 0;
+    int64_t deadline = esp_timer_get_time() + (int64_t)ticks_to_wait * portTICK_PERIOD_MS * 1000;
+    esp_err_t res = ESP_OK;
+
+    pthread_mutex_lock(&i2s->lock);
+    while (got < wanted)
+    {
+        int64_t now = esp_timer_get_time();
+        int64_t wait = 1000;
+        if (i2s->running)
+        {
+            uint64_t ready = samples_ready(i2s, now);
+            uint64_t capacity = (uint64_t)i2s->config.dma_buf_count * i2s->config.dma_buf_len;
+            // The reader fell behind: the oldest buffers are overwritten
+            while (ready - i2s->consumed > capacity)
+            {
+                i2s->consumed += i2s->config.dma_buf_len;
+                i2s->position = i2s->samples ? (i2s->position + i2s->config.dma_buf_len) % i2s->sample_count : 0;
+                i2s_event_t event = {I2S_EVENT_RX_Q_OVF, 0};
+                if (i2s->events)
+                {
+                    xQueueSend(i2s->events, &event, 0);
+                }
+            }
+            size_t take = ready - i2s->consumed;
+            take = take < wanted - got ? take : wanted - got;
+            copy_samples(i2s, out + got, take);
+            i2s->consumed += take;
+            got += take;
+            // Until the next buffer is complete
+            uint64_t next = ready + i2s->config.dma_buf_len;
+            wait = i2s->started + (int64_t)(next * 1000000 / i2s->config.sample_rate) - now;
+        }
+        if (got == wanted)
+        {
+            break;
+        }
+        if (ticks_to_wait != portMAX_DELAY && now >= deadline)
+        {
+            res = ESP_ERR_TIMEOUT;
+            break;
+        }
+        if (ticks_to_wait != portMAX_DELAY && now + wait > deadline)
+        {
+            wait = deadline - now;
+        }
+        pthread_mutex_unlock(&i2s->lock);
+        usleep(wait > 0 ? wait : 1);
+        pthread_mutex_lock(&i2s->lock);
+    }
+    pthread_mutex_unlock(&i2s->lock);
+
+    if (bytes_read)
+    {
+        *bytes_read = got * sizeof(int16_t);
+    }
+    return res;
+}
@@ -0,0 +1,168 @@
+#include <img_converters.h>
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <jpeglib.h>
+
+#define JPEG_OUT_CHUNK 1024 // Output handed to the callback at a time
+
+typedef struct
+{
+    struct jpeg_error_mgr mgr;
+    jmp_buf escape;
+} jpeg_error_t;
+
+typedef struct
+{
+    struct jpeg_destination_mgr mgr;
+    JOCTET buf[JPEG_OUT_CHUNK];
+    jpg_out_cb cb;
+    void *arg;
+    size_t index;
+    bool failed;
+} jpeg_cb_dest_t;
+
+static void error_exit(j_common_ptr cinfo)
+{
+    longjmp(((jpeg_error_t *)cinfo->err)->escape, 1);
+}
+
+static void dest_init(j_compress_ptr cinfo)
+{
+    jpeg_cb_dest_t *dest = (jpeg_cb_dest_t *)cinfo->dest;
+    dest->mgr.next_output_byte = dest->buf;
+    dest->mgr.free_in_buffer = sizeof(dest->buf);
+}
+
+static void dest_put(jpeg_cb_dest_t *dest, size_t len)
+{
+    if (!dest->failed && len && dest->cb(dest->arg, dest->index, dest->buf, len) != len)
+    {
+        dest->failed = true;
+    }
+    dest->index += len;
+}
+
+static boolean dest_empty(j_compress_ptr cinfo)
+{
+    jpeg_cb_dest_t *dest = (jpeg_cb_dest_t *)cinfo->dest;
+    dest_put(dest, sizeof(dest->buf));
+    dest->mgr.next_output_byte = dest->buf;
+    dest->mgr.free_in_buffer = sizeof(dest->buf);
+    return TRUE;
+}
+
+static void dest_term(j_compress_ptr cinfo)
+{
+    jpeg_cb_dest_t *dest = (jpeg_cb_dest_t *)cinfo->dest;
+    dest_put(dest, sizeof(dest->buf) - dest->mgr.free_in_buffer);
+}
+
+bool fmt2jpg_cb(uint8_t *src, size_t src_len, uint16_t width, uint16_t height, pixformat_t format, uint8_t quality,
+                jpg_out_cb cb, void *arg)
+{
+    struct jpeg_compress_struct cinfo;
+    jpeg_error_t err;
+    jpeg_cb_dest_t dest;
+    int components = (format == PIXFORMAT_RGB888) ? 3 : 1;
+
+    if ((format != PIXFORMAT_RGB888 && format != PIXFORMAT_GRAYSCALE) || src_len < (size_t)width * height * components)
+    {
+        return false;
+    }
+    JSAMPLE *row = (JSAMPLE *)malloc((size_t)width * components);
+    if (!row)
+    {
+        return false;
+    }
+
+    cinfo.err = jpeg_std_error(&err.mgr);
+    err.mgr.error_exit = error_exit;
+    if (setjmp(err.escape))
+    {
+        jpeg_destroy_compress(&cinfo);
+        free(row);
+        return false;
+    }
+    jpeg_create_compress(&cinfo);
+    dest.mgr.init_destination = dest_init;
+    dest.mgr.empty_output_buffer = dest_empty;
+    dest.mgr.term_destination = dest_term;
+    dest.cb = cb;
+    dest.arg = arg;
+    dest.index = 0;
+    dest.failed = false;
+    cinfo.dest = &dest.mgr;
+
+    cinfo.image_width = width;
+    cinfo.image_height = height;
+    cinfo.input_components = components;
+    cinfo.in_color_space = (components == 3) ? JCS_RGB : JCS_GRAYSCALE;
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, quality, TRUE);
+    jpeg_start_compress(&cinfo, TRUE);
+    while (cinfo.next_scanline < cinfo.image_height)
+    {
+        const uint8_t *in = src + (size_t)cinfo.next_scanline * width * components;
+        if (components == 3)
+        {
+            for (size_t x = 0; x < width; x++)
+            {
+                row[x * 3] = in[x * 3 + 2];
+                row[x * 3 + 1] = in[x * 3 + 1];
+                row[x * 3 + 2] = in[x * 3];
+            }
+        }
+        else
+        {
+            memcpy(row, in, width);
+        }
+        jpeg_write_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+    free(row);
+    return !dest.failed;
+}
+
+bool jpg2rgb888(const uint8_t *src, size_t src_len, uint8_t *out, jpg_scale_t scale)
+{
+    struct jpeg_decompress_struct cinfo;
+    jpeg_error_t err;
+
+    cinfo.err = jpeg_std_error(&err.mgr);
+    err.mgr.error_exit = error_exit;
+    if (setjmp(err.escape))
+    {
+        jpeg_destroy_decompress(&cinfo);
+        return false;
+    }
+    jpeg_create_decompress(&cinfo);
+    jpeg_mem_src(&cinfo, src, src_len);
+    if (jpeg_read_header(&cinfo, TRUE) != JPEG_HEADER_OK)
+    {
+        jpeg_destroy_decompress(&cinfo);
+        return false;
+    }
+    cinfo.scale_num = 1;
+    cinfo.scale_denom = 1 << scale;
+    cinfo.out_color_space = JCS_RGB;
+    jpeg_start_decompress(&cinfo);
+    while (cinfo.output_scanline < cinfo.output_height)
+    {
+        uint8_t *line = out + (size_t)cinfo.output_scanline * cinfo.output_width * 3;
+        jpeg_read_scanlines(&cinfo, &line, 1);
+        // RGB to the driver's blue-first order
+        for (size_t x = 0; x < cinfo.output_width; x++)
+        {
+            uint8_t r = line[x * 3];
+            line[x * 3] = line[x * 3 + 2];
+            line[x * 3 + 2] = r;
+        }
+    }
+    jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    return true;
+}
@@ -0,0 +1,63 @@
+#include <atomic>
+#include <errno.h>
+#include <host.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "host_internal.h"
+
+static std::atomic<uint64_t> socket_sends(0);
+
+void host_count_send()
+{
+    socket_sends.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t host_socket_sends()
+{
+    return socket_sends.load(std::memory_order_relaxed);
+}
+
+ssize_t host_write(int fd, const void *buf, size_t len)
+{
+    host_count_send();
+    return write(fd, buf, len);
+}
+
+ssize_t host_writev(int fd, const struct iovec *iov, int count)
+{
+    host_count_send();
+    return writev(fd, iov, count);
+}
+
+ssize_t host_send(int fd, const void *buf, size_t len, int flags)
+{
+    host_count_send();
+    return send(fd, buf, len, flags);
+}
+
+// Not through lwip/sockets.h, whose bind is this function
+int host_bind(int fd, const struct sockaddr *addr, socklen_t len)
+{
+    if (addr->sa_family != AF_INET || len < sizeof(struct sockaddr_in))
+    {
+        return bind(fd, addr, len);
+    }
+    struct sockaddr_in moved;
+    memcpy(&moved, addr, sizeof(moved));
+    unsigned port = ntohs(moved.sin_port);
+    if (port)
+    {
+        port += host_config.port_offset;
+        if (port > 65535)
+        {
+            errno = EINVAL;
+            return -1;
+        }
+        moved.sin_port = htons(port);
+    }
+    return bind(fd, (struct sockaddr *)&moved, sizeof(moved));
+}
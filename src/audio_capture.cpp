@@ -0,0 +1,258 @@
+#include <Arduino.h>
+#include <driver/i2s.h>
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include "audio_capture.h"
+#include "audio_config.h"
+#include "audio_dsp.h"
+#include "audio_level.h"
+#include "metrics.h"
+#include "trace.h"
+
+#define RING_MASK (AUDIO_RING_SAMPLES - 1)
+
+typedef struct
+{
+    bool active;
+    SemaphoreHandle_t ready; // Given by the capture task after every block
+    audio_listener_t *owner;
+} listener_slot_t;
+
+static int16_t *ring = NULL;
+static int16_t block[AUDIO_BLOCK_SAMPLES];
+static uint32_t write_pos = 0; // Absolute position of the next sample; only the capture task writes it
+
+static listener_slot_t listeners[AUDIO_MAX_LISTENERS];
+static uint8_t listener_count = 0;
+static audio_capture_stats_t stats;
+
+static portMUX_TYPE listener_lock = portMUX_INITIALIZER_UNLOCKED;
+static SemaphoreHandle_t capture_wake = NULL;
+static QueueHandle_t events = NULL;
+static TaskHandle_t capture_task = NULL;
+
+static inline uint32_t load_write_pos()
+{
+    return __atomic_load_n(&write_pos, __ATOMIC_ACQUIRE);
+}
+
+static void audio_capture_loop(void *arg)
+{
+    bool running = true;
+
+    while (true)
+    {
+        if (listener_count == 0 && !audio_level_detecting())
+        {
+            if (running)
+            {
+                i2s_stop(I2S_PORT);
+                running = false;
+            }
+            // Time out now and then, sound detection may have been switched back on
+            xSemaphoreTake(capture_wake, pdMS_TO_TICKS(1000));
+            continue;
+        }
+        if (!running)
+        {
+            // Do not hand out whatever was left in the DMA buffers when we stopped
+            i2s_zero_dma_buffer(I2S_PORT);
+            i2s_start(I2S_PORT);
+            running = true;
+        }
+
+        size_t bytesRead = 0;
+        TRACE_BEGIN("i2s_read");
+        esp_err_t res = i2s_read(I2S_PORT, block, AUDIO_BLOCK_SAMPLES * sizeof(int16_t), &bytesRead, portMAX_DELAY);
+        TRACE_END("i2s_read");
+        size_t samples = bytesRead / sizeof(int16_t);
+        metrics_add(&metrics.audio_bytes, bytesRead);
+        i2s_event_t event;
+        while (events && xQueueReceive(events, &event, 0) == pdTRUE)
+        {
+            if (event.type == I2S_EVENT_RX_Q_OVF)
+            {
+                metrics_add(&metrics.i2s_overruns, 1);
+            }
+        }
+        if (res != ESP_OK || samples == 0)
+        {
+            stats.read_errors++;
+            continue;
+        }
+
+        audio_dsp_filter(block, samples);
+        audio_level_update(block, samples);
+        audio_dsp_gain(block, samples);
+
+        // Single producer: fill the ring first, then publish the new end
+        uint32_t pos = write_pos;
+        for (size_t i = 0; i < samples; i++)
+        {
+            ring[(pos + i) & RING_MASK] = block[i];
+        }
+        __atomic_store_n(&write_pos, pos + samples, __ATOMIC_RELEASE);
+        stats.blocks++;
+
+        for (int i = 0; i < AUDIO_MAX_LISTENERS; i++)
+        {
+            if (listeners[i].active)
+            {
+                xSemaphoreGive(listeners[i].ready);
+            }
+        }
+    }
+}
+
+esp_err_t audio_capture_start(QueueHandle_t i2s_events)
+{
+    if (capture_task)
+    {
+        return ESP_OK;
+    }
+    events = i2s_events;
+    ring = (int16_t *)heap_caps_malloc(AUDIO_RING_SAMPLES * sizeof(int16_t), MALLOC_CAP_SPIRAM);
+    if (!ring)
+    {
+        ring = (int16_t *)heap_caps_malloc(AUDIO_RING_SAMPLES * sizeof(int16_t), MALLOC_CAP_8BIT);
+    }
+    capture_wake = xSemaphoreCreateBinary();
+    if (!ring || !capture_wake)
+    {
+        Serial.println("Audio capture: out of memory");
+        return ESP_ERR_NO_MEM;
+    }
+    for (int i = 0; i < AUDIO_MAX_LISTENERS; i++)
+    {
+        listeners[i].ready = xSemaphoreCreateBinary();
+        if (!listeners[i].ready)
+        {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    audio_dsp_init();
+    if (xTaskCreatePinnedToCore(audio_capture_loop, "audio", AUDIO_TASK_STACK, NULL, AUDIO_TASK_PRIORITY, &capture_task, AUDIO_TASK_CORE) != pdPASS)
+    {
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+esp_err_t audio_listener_attach(audio_listener_t *listener)
+{
+    memset(listener, 0, sizeof(*listener));
+    listener->id = -1;
+
+    // No microphone: audio_capture_start() failed or was never called
+    if (!capture_task)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    portENTER_CRITICAL(&listener_lock);
+    for (int i = 0; i < AUDIO_MAX_LISTENERS; i++)
+    {
+        if (!listeners[i].active)
+        {
+            listeners[i].active = true;
+            listeners[i].owner = listener;
+            listener_count++;
+            listener->id = i;
+            break;
+        }
+    }
+    stats.listeners = listener_count;
+    portEXIT_CRITICAL(&listener_lock);
+
+    if (listener->id < 0)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    listener->cursor = load_write_pos();
+    xSemaphoreTake(listeners[listener->id].ready, 0);
+    xSemaphoreGive(capture_wake);
+    return ESP_OK;
+}
+
+void audio_listener_detach(audio_listener_t *listener)
+{
+    if (listener->id < 0)
+    {
+        return;
+    }
+    portENTER_CRITICAL(&listener_lock);
+    listeners[listener->id].active = false;
+    listener_count--;
+    stats.listeners = listener_count;
+    stats.overruns += listener->overruns;
+    stats.underruns += listener->underruns;
+    portEXIT_CRITICAL(&listener_lock);
+    listener->id = -1;
+}
+
+size_t audio_listener_available(const audio_listener_t *listener)
+{
+    return load_write_pos() - listener->cursor;
+}
+
+size_t audio_listener_read(audio_listener_t *listener, int16_t *out, size_t max_samples, TickType_t timeout)
+{
+    uint32_t end = load_write_pos();
+
+    if (end == listener->cursor)
+    {
+        if (xSemaphoreTake(listeners[listener->id].ready, timeout) != pdTRUE)
+        {
+            listener->underruns++;
+            return 0;
+        }
+        end = load_write_pos();
+    }
+
+    // Keep one block of headroom: that is the part the capture task may be overwriting right now
+    if (end - listener->cursor > AUDIO_RING_SAMPLES - AUDIO_BLOCK_SAMPLES)
+    {
+        listener->overruns++;
+        listener->cursor = end;
+        return 0;
+    }
+
+    size_t samples = end - listener->cursor;
+    if (samples > max_samples)
+    {
+        samples = max_samples;
+    }
+    for (size_t i = 0; i < samples; i++)
+    {
+        out[i] = ring[(listener->cursor + i) & RING_MASK];
+    }
+
+    // The writer may have lapped us while copying; drop the copy if so
+    if (load_write_pos() - listener->cursor > AUDIO_RING_SAMPLES - AUDIO_BLOCK_SAMPLES)
+    {
+        listener->overruns++;
+        listener->cursor = load_write_pos();
+        return 0;
+    }
+    listener->cursor += samples;
+    return samples;
+}
+
+void audio_capture_get_stats(audio_capture_stats_t *out)
+{
+    portENTER_CRITICAL(&listener_lock);
+    *out = stats;
+    for (int i = 0; i < AUDIO_MAX_LISTENERS; i++)
+    {
+        // Detached listeners were folded into stats already
+        if (listeners[i].active)
+        {
+            out->overruns += listeners[i].owner->overruns;
+            out->underruns += listeners[i].owner->underruns;
+        }
+    }
+    portEXIT_CRITICAL(&listener_lock);
+}
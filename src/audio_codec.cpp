@@ -0,0 +1,201 @@
+#include <string.h>
+
+#include "audio_codec.h"
+
+static const int8_t adpcm_index_table[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8};
+
+static const int16_t adpcm_step_table[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+    19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+    130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+    337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+    5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767};
+
+// G.711 mu-law
+uint8_t ulaw_encode_sample(int16_t sample)
+{
+    const int bias = 0x84;
+    const int clip = 32635;
+
+    int pcm = sample;
+    uint8_t sign = 0;
+    if (pcm < 0)
+    {
+        pcm = -pcm;
+        sign = 0x80;
+    }
+    if (pcm > clip)
+    {
+        pcm = clip;
+    }
+    pcm += bias;
+
+    uint8_t exponent = 7;
+    for (int mask = 0x4000; !(pcm & mask) && exponent > 0; mask >>= 1)
+    {
+        exponent--;
+    }
+    uint8_t mantissa = (pcm >> (exponent + 3)) & 0x0f;
+    return ~(sign | (exponent << 4) | mantissa);
+}
+
+static uint8_t adpcm_encode_sample(audio_encoder_t *encoder, int16_t sample)
+{
+    int step = adpcm_step_table[encoder->step_index];
+    int diff = sample - encoder->predictor;
+    uint8_t nibble = 0;
+
+    if (diff < 0)
+    {
+        nibble = 8;
+        diff = -diff;
+    }
+
+    // Reconstruct exactly like the decoder will, so both predictors stay in step
+    int delta = step >> 3;
+    if (diff >= step)
+    {
+        nibble |= 4;
+        diff -= step;
+        delta += step;
+    }
+    step >>= 1;
+    if (diff >= step)
+    {
+        nibble |= 2;
+        diff -= step;
+        delta += step;
+    }
+    step >>= 1;
+    if (diff >= step)
+    {
+        nibble |= 1;
+        delta += step;
+    }
+
+    encoder->predictor += (nibble & 8) ? -delta : delta;
+    if (encoder->predictor > INT16_MAX)
+    {
+        encoder->predictor = INT16_MAX;
+    }
+    else if (encoder->predictor < INT16_MIN)
+    {
+        encoder->predictor = INT16_MIN;
+    }
+
+    int index = encoder->step_index + adpcm_index_table[nibble];
+    encoder->step_index = (index < 0) ? 0 : (index > 88) ? 88 : index;
+    return nibble;
+}
+
+// One mono IMA-ADPCM block as laid out in WAV files: the first sample and
+// step index in a 4 byte header, then two samples per byte, low nibble first.
+static void adpcm_encode_block(audio_encoder_t *encoder, const int16_t *in, uint8_t *out)
+{
+    encoder->predictor = in[0];
+    out[0] = in[0] & 0xff;
+    out[1] = (in[0] >> 8) & 0xff;
+    out[2] = encoder->step_index;
+    out[3] = 0;
+    out += 4;
+
+    for (int i = 1; i < ADPCM_SAMPLES_PER_BLOCK; i += 2)
+    {
+        uint8_t low = adpcm_encode_sample(encoder, in[i]);
+        uint8_t high = adpcm_encode_sample(encoder, in[i + 1]);
+        *out++ = low | (high << 4);
+    }
+}
+
+static size_t encode_pcm(audio_encoder_t *encoder, const int16_t *in, size_t samples, uint8_t *out)
+{
+    memcpy(out, in, samples * sizeof(int16_t));
+    return samples * sizeof(int16_t);
+}
+
+static size_t encode_ulaw(audio_encoder_t *encoder, const int16_t *in, size_t samples, uint8_t *out)
+{
+    for (size_t i = 0; i < samples; i++)
+    {
+        out[i] = ulaw_encode_sample(in[i]);
+    }
+    return samples;
+}
+
+static size_t encode_adpcm(audio_encoder_t *encoder, const int16_t *in, size_t samples, uint8_t *out)
+{
+    size_t written = 0;
+
+    while (samples > 0)
+    {
+        // Encode straight from the input when a whole block is available and nothing is pending
+        if (encoder->pending_count == 0 && samples >= ADPCM_SAMPLES_PER_BLOCK)
+        {
+            adpcm_encode_block(encoder, in, out + written);
+            written += ADPCM_BLOCK_ALIGN;
+            in += ADPCM_SAMPLES_PER_BLOCK;
+            samples -= ADPCM_SAMPLES_PER_BLOCK;
+            continue;
+        }
+
+        size_t take = ADPCM_SAMPLES_PER_BLOCK - encoder->pending_count;
+        if (take > samples)
+        {
+            take = samples;
+        }
+        memcpy(&encoder->pending[encoder->pending_count], in, take * sizeof(int16_t));
+        encoder->pending_count += take;
+        in += take;
+        samples -= take;
+
+        if (encoder->pending_count == ADPCM_SAMPLES_PER_BLOCK)
+        {
+            adpcm_encode_block(encoder, encoder->pending, out + written);
+            written += ADPCM_BLOCK_ALIGN;
+            encoder->pending_count = 0;
+        }
+    }
+    return written;
+}
+
+const audio_codec_t audio_codec_pcm = {"pcm", WAVE_FORMAT_PCM, 16, 2, 1, encode_pcm};
+const audio_codec_t audio_codec_ulaw = {"ulaw", WAVE_FORMAT_MULAW, 8, 1, 1, encode_ulaw};
+const audio_codec_t audio_codec_adpcm = {"adpcm", WAVE_FORMAT_IMA_ADPCM, 4, ADPCM_BLOCK_ALIGN, ADPCM_SAMPLES_PER_BLOCK, encode_adpcm};
+
+static const audio_codec_t *const codecs[] = {&audio_codec_pcm, &audio_codec_ulaw, &audio_codec_adpcm};
+
+const audio_codec_t *audio_codec_find(const char *name)
+{
+    for (size_t i = 0; i < sizeof(codecs) / sizeof(codecs[0]); i++)
+    {
+        if (!strcmp(codecs[i]->name, name))
+        {
+            return codecs[i];
+        }
+    }
+    return NULL;
+}
+
+void audio_encoder_init(audio_encoder_t *encoder, const audio_codec_t *codec)
+{
+    memset(encoder, 0, sizeof(*encoder));
+    encoder->codec = codec;
+}
+
+size_t audio_encoder_max_output(const audio_encoder_t *encoder, size_t samples)
+{
+    const audio_codec_t *codec = encoder->codec;
+    size_t blocks = (samples + encoder->pending_count) / codec->samples_per_block;
+    return blocks * codec->block_align;
+}
+
+size_t audio_encoder_encode(audio_encoder_t *encoder, const int16_t *in, size_t samples, uint8_t *out)
+{
+    return encoder->codec->encode(encoder, in, samples, out);
+}
@@ -0,0 +1,271 @@
+#include <freertos/FreeRTOS.h>
+#include <math.h>
+#include <string.h>
+
+#include "audio_config.h"
+#include "audio_dsp.h"
+
+#define GAIN_ONE 4096       // Q12 unity gain
+#define GATE_HOLD_BLOCKS 6  // Keep the gate open this many blocks after the level drops, about 200 ms
+#define AGC_ATTACK_SHIFT 1  // Gain moves 1/2 of the way down per block when too loud
+#define AGC_RELEASE_SHIFT 5 // and 1/32 of the way up when too quiet
+
+typedef struct
+{
+    // Q14 biquad coefficients, a0 normalised to one
+    int32_t b0, b1, b2, a1, a2;
+    int32_t agc_target_level; // Linear amplitude
+    int32_t agc_max_gain;     // Q12
+    int64_t gate_level_sq;    // Squared linear amplitude, compared with the block's mean square
+} dsp_coefficients_t;
+
+typedef struct
+{
+    int32_t dc;             // Q16 running estimate of the DC offset
+    int32_t x1, x2, y1, y2; // Biquad history
+    int32_t residue;        // Bits shifted out of the last biquad output, fed back into the next
+    int32_t agc_gain;       // Q12
+    int32_t gate_gain;      // Q12, either ramping to unity or to zero
+    uint8_t gate_hold;
+} dsp_state_t;
+
+static audio_dsp_params_t params = {
+    .dc_block = true,
+    .highpass = true,
+    .highpass_hz = 120,
+    .agc = true,
+    .agc_target = 20,
+    .agc_max_gain = 30,
+    .gate = true,
+    .gate_threshold = 55};
+
+static portMUX_TYPE params_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t params_version = 1;
+
+// Only touched by the audio capture task
+static audio_dsp_params_t active;
+static uint32_t active_version = 0;
+static dsp_coefficients_t coeffs;
+static dsp_state_t state;
+
+static int32_t db_to_level(int db)
+{
+    return (int32_t)(32767.0f * powf(10.0f, -db / 20.0f));
+}
+
+static void compute_coefficients(const audio_dsp_params_t *p)
+{
+    // RBJ cookbook high-pass, Q = 1/sqrt(2)
+    float w0 = 2.0f * (float)M_PI * p->highpass_hz / SAMPLE_RATE;
+    float alpha = sinf(w0) / (2.0f * 0.70710678f);
+    float cosw = cosf(w0);
+    float a0 = 1.0f + alpha;
+
+    coeffs.b0 = lrintf((1.0f + cosw) / 2.0f / a0 * 16384.0f);
+    coeffs.b1 = -2 * coeffs.b0; // Exact, or rounding leaves the filter a DC gain
+    coeffs.b2 = coeffs.b0;
+    coeffs.a1 = lrintf(-2.0f * cosw / a0 * 16384.0f);
+    coeffs.a2 = lrintf((1.0f - alpha) / a0 * 16384.0f);
+
+    coeffs.agc_target_level = db_to_level(p->agc_target);
+    coeffs.agc_max_gain = (int32_t)(GAIN_ONE * powf(10.0f, p->agc_max_gain / 20.0f));
+    int64_t gate = db_to_level(p->gate_threshold);
+    coeffs.gate_level_sq = gate * gate;
+}
+
+static inline int16_t saturate(int64_t value)
+{
+    return (value > INT16_MAX) ? INT16_MAX : (value < INT16_MIN) ? INT16_MIN : value;
+}
+
+static void dc_block(int16_t *samples, size_t count)
+{
+    int32_t dc = state.dc;
+    for (size_t i = 0; i < count; i++)
+    {
+        // One-pole tracker, corner around SAMPLE_RATE / (2 pi 512) = 5 Hz at 16 kHz
+        dc += (((int32_t)samples[i] << 16) - dc) >> 9;
+        samples[i] = saturate(samples[i] - (dc >> 16));
+    }
+    state.dc = dc;
+}
+
+static void highpass(int16_t *samples, size_t count)
+{
+    int32_t x1 = state.x1, x2 = state.x2, y1 = state.y1, y2 = state.y2;
+    int32_t residue = state.residue;
+    for (size_t i = 0; i < count; i++)
+    {
+        int32_t x0 = samples[i];
+        // Error feedback: with the poles this close to z = 1, plain truncation
+        // would be amplified into a DC offset of a few hundred LSB
+        int64_t acc = (int64_t)coeffs.b0 * x0 + (int64_t)coeffs.b1 * x1 + (int64_t)coeffs.b2 * x2 - (int64_t)coeffs.a1 * y1 - (int64_t)coeffs.a2 * y2 + residue;
+        int32_t y0 = (int32_t)(acc >> 14);
+        residue = (int32_t)(acc - ((int64_t)y0 << 14));
+        x2 = x1;
+        x1 = x0;
+        y2 = y1;
+        y1 = y0;
+        samples[i] = saturate(y0);
+    }
+    state.x1 = x1;
+    state.x2 = x2;
+    state.y1 = y1;
+    state.y2 = y2;
+    state.residue = residue;
+}
+
+static int64_t mean_square(const int16_t *samples, size_t count)
+{
+    int64_t sum = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        sum += (int32_t)samples[i] * samples[i];
+    }
+    return sum / count;
+}
+
+// Ramps from the previous gain to the new one across the block to avoid zipper noise.
+static void apply_gain(int16_t *samples, size_t count, int32_t from, int32_t to)
+{
+    int32_t step = (to - from) / (int32_t)count;
+    int32_t gain = from;
+    for (size_t i = 0; i < count; i++)
+    {
+        gain += step;
+        // Up to 40 dB of gain in Q12 takes the product past 32 bits
+        samples[i] = saturate(((int64_t)samples[i] * gain) >> 12);
+    }
+}
+
+static void refresh_params()
+{
+    portENTER_CRITICAL(&params_lock);
+    bool changed = active_version != params_version;
+    if (changed)
+    {
+        active = params;
+        active_version = params_version;
+    }
+    portEXIT_CRITICAL(&params_lock);
+
+    if (changed)
+    {
+        compute_coefficients(&active);
+    }
+}
+
+void audio_dsp_init()
+{
+    memset(&state, 0, sizeof(state));
+    state.agc_gain = GAIN_ONE;
+    state.gate_gain = GAIN_ONE;
+    refresh_params();
+}
+
+void audio_dsp_filter(int16_t *samples, size_t count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    refresh_params();
+
+    if (active.dc_block)
+    {
+        dc_block(samples, count);
+    }
+    if (active.highpass)
+    {
+        highpass(samples, count);
+    }
+}
+
+void audio_dsp_gain(int16_t *samples, size_t count)
+{
+    if (count == 0 || (!active.agc && !active.gate))
+    {
+        return;
+    }
+
+    int64_t level_sq = mean_square(samples, count);
+
+    int32_t gate_gain = GAIN_ONE;
+    if (active.gate)
+    {
+        if (level_sq >= coeffs.gate_level_sq)
+        {
+            state.gate_hold = GATE_HOLD_BLOCKS;
+        }
+        else if (state.gate_hold > 0)
+        {
+            state.gate_hold--;
+        }
+        gate_gain = state.gate_hold ? GAIN_ONE : 0;
+    }
+
+    int32_t agc_gain = GAIN_ONE;
+    if (active.agc)
+    {
+        agc_gain = state.agc_gain;
+        // Hold the gain through silence so the noise floor is not pumped up
+        if (gate_gain && level_sq > 0)
+        {
+            int32_t level = (int32_t)sqrtf((float)level_sq);
+            int32_t desired = (int32_t)(((int64_t)coeffs.agc_target_level << 12) / (level ? level : 1));
+            desired = (desired > coeffs.agc_max_gain) ? coeffs.agc_max_gain : desired;
+            int shift = (desired < agc_gain) ? AGC_ATTACK_SHIFT : AGC_RELEASE_SHIFT;
+            agc_gain += (desired - agc_gain) >> shift;
+        }
+    }
+
+    int32_t from = ((int64_t)state.agc_gain * state.gate_gain) >> 12;
+    int32_t to = ((int64_t)agc_gain * gate_gain) >> 12;
+    state.agc_gain = agc_gain;
+    state.gate_gain = gate_gain;
+    if (from != GAIN_ONE || to != GAIN_ONE)
+    {
+        apply_gain(samples, count, from, to);
+    }
+}
+
+int audio_dsp_set(const char *name, int value)
+{
+    audio_dsp_params_t p;
+
+    portENTER_CRITICAL(&params_lock);
+    p = params;
+    portEXIT_CRITICAL(&params_lock);
+
+    if (!strcmp(name, "audio_dc"))
+        p.dc_block = value;
+    else if (!strcmp(name, "audio_hpf"))
+        p.highpass = value;
+    else if (!strcmp(name, "audio_hpf_hz") && value >= 20 && value <= 2000)
+        p.highpass_hz = value;
+    else if (!strcmp(name, "audio_agc"))
+        p.agc = value;
+    else if (!strcmp(name, "audio_agc_target") && value >= 3 && value <= 40)
+        p.agc_target = value;
+    else if (!strcmp(name, "audio_agc_max_gain") && value >= 0 && value <= 40)
+        p.agc_max_gain = value;
+    else if (!strcmp(name, "audio_gate"))
+        p.gate = value;
+    else if (!strcmp(name, "audio_gate_threshold") && value >= 20 && value <= 90)
+        p.gate_threshold = value;
+    else
+        return -1;
+
+    portENTER_CRITICAL(&params_lock);
+    params = p;
+    params_version++;
+    portEXIT_CRITICAL(&params_lock);
+    return 0;
+}
+
+void audio_dsp_get_params(audio_dsp_params_t *out)
+{
+    portENTER_CRITICAL(&params_lock);
+    *out = params;
+    portEXIT_CRITICAL(&params_lock);
+}
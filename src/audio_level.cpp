@@ -0,0 +1,151 @@
+#include <Arduino.h>
+#include <esp_http_server.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <math.h>
+#include <string.h>
+
+#include "audio_config.h"
+#include "audio_level.h"
+#include "events.h"
+
+#define VOICE_MARGIN_DB 6        // Voice must be this far above the noise floor
+#define VOICE_MAX_ZCR_PERCENT 25 // and cross zero on fewer than this share of samples
+#define VOICE_HANGOVER_BLOCKS 8  // Keep the voice flag through short pauses between words
+#define NOISE_FLOOR_RISE 64      // The floor creeps up 1/64 of the difference per block, and drops at once
+
+static audio_level_t level = {.dbfs = -96, .noise_floor = -96};
+static portMUX_TYPE level_lock = portMUX_INITIALIZER_UNLOCKED;
+static volatile int sound_threshold = SOUND_THRESHOLD_DEFAULT;
+
+// Only touched by the audio capture task
+static int32_t noise_floor_q8 = -96 * 256;
+static uint8_t voice_hangover = 0;
+static int64_t sound_below_since = 0;
+static bool sound = false;
+
+static int16_t level_to_dbfs(uint32_t rms)
+{
+    if (rms == 0)
+    {
+        return -96;
+    }
+    return (int16_t)lrintf(20.0f * log10f(rms / 32768.0f));
+}
+
+void audio_level_update(const int16_t *samples, size_t count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    int64_t sum = 0;
+    int32_t peak = 0;
+    uint32_t crossings = 0;
+    int16_t prev = samples[0];
+    for (size_t i = 0; i < count; i++)
+    {
+        int32_t s = samples[i];
+        sum += s * s;
+        int32_t a = s < 0 ? -s : s;
+        peak = a > peak ? a : peak;
+        crossings += (s ^ prev) < 0;
+        prev = s;
+    }
+    uint32_t rms = (uint32_t)sqrtf((float)(sum / (int64_t)count));
+    int16_t dbfs = level_to_dbfs(rms);
+    int64_t now = esp_timer_get_time();
+
+    int32_t db_q8 = dbfs * 256;
+    noise_floor_q8 = (db_q8 < noise_floor_q8) ? db_q8 : noise_floor_q8 + (db_q8 - noise_floor_q8) / NOISE_FLOOR_RISE;
+    int16_t noiseFloor = noise_floor_q8 >> 8;
+
+    if (dbfs > noiseFloor + VOICE_MARGIN_DB && crossings * 100 < count * VOICE_MAX_ZCR_PERCENT)
+    {
+        voice_hangover = VOICE_HANGOVER_BLOCKS;
+    }
+    else if (voice_hangover > 0)
+    {
+        voice_hangover--;
+    }
+
+    int threshold = sound_threshold;
+    if (threshold == 0)
+    {
+        sound = false;
+    }
+    else if (!sound && dbfs >= -threshold)
+    {
+        sound = true;
+        sound_below_since = 0;
+        events_post(EVENT_SOUND, true, dbfs);
+    }
+    else if (sound && dbfs < -threshold - SOUND_HYSTERESIS_DB)
+    {
+        if (sound_below_since == 0)
+        {
+            sound_below_since = now;
+        }
+        else if (now - sound_below_since >= SOUND_HOLD_MS * 1000LL)
+        {
+            sound = false;
+            events_post(EVENT_SOUND, false, dbfs);
+        }
+    }
+    else if (sound)
+    {
+        sound_below_since = 0;
+    }
+
+    portENTER_CRITICAL(&level_lock);
+    level.rms = rms;
+    level.peak = peak > INT16_MAX ? INT16_MAX : peak;
+    level.dbfs = dbfs;
+    level.noise_floor = noiseFloor;
+    level.zero_crossings = crossings;
+    level.voice = voice_hangover > 0;
+    level.sound = sound;
+    level.timestamp = now;
+    portEXIT_CRITICAL(&level_lock);
+}
+
+bool audio_level_detecting()
+{
+    return sound_threshold != 0;
+}
+
+void audio_level_get(audio_level_t *out)
+{
+    portENTER_CRITICAL(&level_lock);
+    *out = level;
+    portEXIT_CRITICAL(&level_lock);
+}
+
+int audio_level_set(const char *name, int value)
+{
+    if (!strcmp(name, "audio_sound_threshold") && value >= 0 && value <= 90)
+    {
+        sound_threshold = value;
+        return 0;
+    }
+    return -1;
+}
+
+esp_err_t audio_level_handler(httpd_req_t *req)
+{
+    audio_level_t l;
+    char json[224];
+
+    audio_level_get(&l);
+    int64_t age = l.timestamp ? (esp_timer_get_time() - l.timestamp) / 1000 : -1;
+    int len = snprintf(json, sizeof(json),
+                       "{\"rms\":%u,\"peak\":%u,\"dbfs\":%d,\"noise_floor\":%d,\"zcr\":%u,\"voice\":%s,\"sound\":%s,\"threshold\":%d,\"age_ms\":%lld}",
+                       l.rms, l.peak, l.dbfs, l.noise_floor, l.zero_crossings, l.voice ? "true" : "false",
+                       l.sound ? "true" : "false", -sound_threshold, (long long)age);
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    return httpd_resp_send(req, json, len);
+}
@@ -0,0 +1,488 @@
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <fcntl.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "avi_writer.h"
+#include "jpeg_dc.h"
+
+#define AVIF_HASINDEX 0x10
+#define AVIIF_KEYFRAME 0x10
+#define INDEX_GROW 1024
+
+#define FOURCC(a, b, c, d) ((uint32_t)(a) | ((uint32_t)(b) << 8) | ((uint32_t)(c) << 16) | ((uint32_t)(d) << 24))
+#define CKID_VIDEO FOURCC('0', '0', 'd', 'c')
+#define CKID_AUDIO FOURCC('0', '1', 'w', 'b')
+
+typedef struct
+{
+    avi_writer_t *writer;
+    const uint8_t *data;
+    size_t len;
+    uint64_t offset;
+} flush_job_t;
+
+static QueueHandle_t flush_queue = NULL;
+static TaskHandle_t flush_task = NULL;
+
+static void flush_loop(void *arg)
+{
+    flush_job_t job;
+
+    while (true)
+    {
+        xQueueReceive(flush_queue, &job, portMAX_DELAY);
+        ssize_t written = pwrite(job.writer->fd, job.data, job.len, job.offset);
+        if (written != (ssize_t)job.len)
+        {
+            job.writer->error = ESP_FAIL;
+        }
+        else
+        {
+            job.writer->flushed = job.offset + job.len;
+        }
+        xSemaphoreGive(job.writer->flush_idle);
+    }
+}
+
+static void wait_idle(avi_writer_t *writer)
+{
+    xSemaphoreTake(writer->flush_idle, portMAX_DELAY);
+    xSemaphoreGive(writer->flush_idle);
+}
+
+// Hands the active buffer to the flush task and switches to the other one,
+// which is free again once the previous flush has finished.
+static void submit_buffer(avi_writer_t *writer)
+{
+    flush_job_t job = {writer, writer->buffers[writer->active], writer->fill, writer->buffer_offset};
+
+    xSemaphoreTake(writer->flush_idle, portMAX_DELAY);
+    xQueueSend(flush_queue, &job, portMAX_DELAY);
+    writer->buffer_offset += writer->fill;
+    writer->active ^= 1;
+    writer->fill = 0;
+}
+
+static void append(avi_writer_t *writer, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    while (len > 0)
+    {
+        size_t n = AVI_BUFFER_SIZE - writer->fill;
+        n = (len < n) ? len : n;
+        memcpy(writer->buffers[writer->active] + writer->fill, p, n);
+        writer->fill += n;
+        p += n;
+        len -= n;
+        if (writer->fill == AVI_BUFFER_SIZE)
+        {
+            submit_buffer(writer);
+        }
+    }
+}
+
+static inline uint64_t write_position(avi_writer_t *writer)
+{
+    return writer->buffer_offset + writer->fill;
+}
+
+static inline uint8_t *put_u16(uint8_t *p, uint16_t value)
+{
+    p[0] = value;
+    p[1] = value >> 8;
+    return p + 2;
+}
+
+static inline uint8_t *put_u32(uint8_t *p, uint32_t value)
+{
+    p[0] = value;
+    p[1] = value >> 8;
+    p[2] = value >> 16;
+    p[3] = value >> 24;
+    return p + 4;
+}
+
+static inline uint8_t *put_fourcc(uint8_t *p, const char *fourcc)
+{
+    memcpy(p, fourcc, 4);
+    return p + 4;
+}
+
+// Lays out RIFF/hdrl/JUNK and the movi list header in writer->header.
+// movi_end is the file offset just after the last chunk counted in frames;
+// file_end includes the index when there is one.
+static void build_header(avi_writer_t *writer, uint32_t frames, uint32_t audioSamples, uint64_t moviEnd, uint64_t fileEnd, bool indexed)
+{
+    uint8_t *h = writer->header;
+    uint32_t usPerFrame = 66666;
+    if (writer->frames > 1 && writer->last_timestamp > writer->first_timestamp)
+    {
+        usPerFrame = (writer->last_timestamp - writer->first_timestamp) / (writer->frames - 1);
+        usPerFrame = usPerFrame ? usPerFrame : 1;
+    }
+    writer->us_per_frame = usPerFrame;
+    uint32_t streams = writer->audio_rate ? 2 : 1;
+    uint32_t hdrlSize = 4 + 64 + 12 + 64 + 48 + (writer->audio_rate ? 12 + 64 + 26 : 0);
+
+    memset(h, 0, AVI_HEADER_SIZE);
+    uint8_t *p = put_fourcc(h, "RIFF");
+    p = put_u32(p, fileEnd - 8);
+    p = put_fourcc(p, "AVI ");
+
+    p = put_fourcc(p, "LIST");
+    p = put_u32(p, hdrlSize);
+    p = put_fourcc(p, "hdrl");
+
+    p = put_fourcc(p, "avih");
+    p = put_u32(p, 56);
+    p = put_u32(p, usPerFrame);
+    p = put_u32(p, (uint64_t)writer->max_frame * 1000000 / usPerFrame); // dwMaxBytesPerSec
+    p = put_u32(p, 0);                                                     // dwPaddingGranularity
+    p = put_u32(p, indexed ? AVIF_HASINDEX : 0);
+    p = put_u32(p, frames);
+    p = put_u32(p, 0); // dwInitialFrames
+    p = put_u32(p, streams);
+    p = put_u32(p, writer->max_frame + 8);
+    p = put_u32(p, writer->width);
+    p = put_u32(p, writer->height);
+    p += 16; // dwReserved
+
+    p = put_fourcc(p, "LIST");
+    p = put_u32(p, 4 + 64 + 48);
+    p = put_fourcc(p, "strl");
+
+    p = put_fourcc(p, "strh");
+    p = put_u32(p, 56);
+    p = put_fourcc(p, "vids");
+    p = put_fourcc(p, "MJPG");
+    p = put_u32(p, 0); // dwFlags
+    p = put_u32(p, 0); // wPriority, wLanguage
+    p = put_u32(p, 0); // dwInitialFrames
+    p = put_u32(p, usPerFrame);
+    p = put_u32(p, 1000000);
+    p = put_u32(p, 0); // dwStart
+    p = put_u32(p, frames);
+    p = put_u32(p, writer->max_frame + 8);
+    p = put_u32(p, 0xFFFFFFFF); // dwQuality: default
+    p = put_u32(p, 0);          // dwSampleSize: varies
+    p = put_u16(p, 0);
+    p = put_u16(p, 0);
+    p = put_u16(p, writer->width);
+    p = put_u16(p, writer->height);
+
+    p = put_fourcc(p, "strf");
+    p = put_u32(p, 40);
+    p = put_u32(p, 40);
+    p = put_u32(p, writer->width);
+    p = put_u32(p, writer->height);
+    p = put_u16(p, 1);  // biPlanes
+    p = put_u16(p, 24); // biBitCount
+    p = put_fourcc(p, "MJPG");
+    p = put_u32(p, (uint32_t)writer->width * writer->height * 3);
+    p += 16; // Resolution and palette
+
+    if (writer->audio_rate)
+    {
+        p = put_fourcc(p, "LIST");
+        p = put_u32(p, 4 + 64 + 26);
+        p = put_fourcc(p, "strl");
+
+        p = put_fourcc(p, "strh");
+        p = put_u32(p, 56);
+        p = put_fourcc(p, "auds");
+        p = put_u32(p, 1); // PCM
+        p += 12;
+        p = put_u32(p, 1); // dwScale: one sample
+        p = put_u32(p, writer->audio_rate);
+        p = put_u32(p, 0);
+        p = put_u32(p, audioSamples);
+        p = put_u32(p, writer->audio_rate * 2);
+        p = put_u32(p, 0xFFFFFFFF);
+        p = put_u32(p, 2); // dwSampleSize
+        p += 8;
+
+        p = put_fourcc(p, "strf");
+        p = put_u32(p, 18);
+        p = put_u16(p, 1); // WAVE_FORMAT_PCM
+        p = put_u16(p, 1);
+        p = put_u32(p, writer->audio_rate);
+        p = put_u32(p, writer->audio_rate * 2);
+        p = put_u16(p, 2);
+        p = put_u16(p, 16);
+        p = put_u16(p, 0);
+    }
+
+    // Pad so that the movi list ends the sector
+    p = put_fourcc(p, "JUNK");
+    p = put_u32(p, h + AVI_HEADER_SIZE - 12 - (p + 4));
+    p = h + AVI_HEADER_SIZE - 12;
+    p = put_fourcc(p, "LIST");
+    p = put_u32(p, moviEnd - AVI_MOVI_OFFSET);
+    put_fourcc(p, "movi");
+}
+
+// Puts the header in place: into the first buffer while that is still in
+// memory, else straight over the first sector of the file.
+static esp_err_t store_header(avi_writer_t *writer)
+{
+    if (writer->buffer_offset == 0)
+    {
+        memcpy(writer->buffers[writer->active], writer->header, AVI_HEADER_SIZE);
+        return ESP_OK;
+    }
+    wait_idle(writer);
+    if (pwrite(writer->fd, writer->header, AVI_HEADER_SIZE, 0) != AVI_HEADER_SIZE)
+    {
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+// Rewrites the headers to cover the chunks that are completely on the card.
+static void checkpoint(avi_writer_t *writer)
+{
+    if (writer->buffer_offset == 0)
+    {
+        return; // Nothing written yet
+    }
+    wait_idle(writer);
+
+    uint64_t flushed = writer->flushed;
+    uint32_t frames = writer->frames;
+    uint32_t audioSamples = writer->audio_samples;
+    uint32_t count = writer->index_count;
+    while (count > 0)
+    {
+        const avi_index_entry_t *e = &writer->index[count - 1];
+        if (AVI_MOVI_OFFSET + e->offset + 8 + e->size <= flushed)
+        {
+            break;
+        }
+        if (e->ckid == CKID_VIDEO)
+            frames--;
+        else
+            audioSamples -= e->size / 2;
+        count--;
+    }
+    uint64_t moviEnd = AVI_HEADER_SIZE;
+    if (count > 0)
+    {
+        const avi_index_entry_t *e = &writer->index[count - 1];
+        moviEnd = AVI_MOVI_OFFSET + e->offset + 8 + ((e->size + 1) & ~1);
+    }
+
+    build_header(writer, frames, audioSamples, moviEnd, moviEnd, false);
+    if (store_header(writer) == ESP_OK)
+    {
+        fsync(writer->fd);
+    }
+}
+
+static esp_err_t add_chunk(avi_writer_t *writer, uint32_t ckid, const void *data, size_t len)
+{
+    uint8_t header[8];
+    static const uint8_t pad = 0;
+
+    if (writer->error != ESP_OK)
+    {
+        return writer->error;
+    }
+    if (write_position(writer) + len + 8 + (uint64_t)(writer->index_count + 1) * 16 > AVI_MAX_BYTES)
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (writer->index_count == writer->index_capacity)
+    {
+        uint32_t capacity = writer->index_capacity + INDEX_GROW;
+        void *index = heap_caps_realloc(writer->index, capacity * sizeof(avi_index_entry_t), MALLOC_CAP_SPIRAM);
+        if (!index)
+        {
+            return ESP_ERR_NO_MEM;
+        }
+        writer->index = (avi_index_entry_t *)index;
+        writer->index_capacity = capacity;
+    }
+
+    avi_index_entry_t *e = &writer->index[writer->index_count++];
+    e->ckid = ckid;
+    e->flags = AVIIF_KEYFRAME;
+    e->offset = write_position(writer) - AVI_MOVI_OFFSET;
+    e->size = len;
+
+    put_u32(put_u32(header, ckid), len);
+    append(writer, header, sizeof(header));
+    append(writer, data, len);
+    if (len & 1)
+    {
+        append(writer, &pad, 1);
+    }
+    return writer->error;
+}
+
+esp_err_t avi_writer_open(avi_writer_t *writer, const char *path, uint32_t audio_rate)
+{
+    memset(writer, 0, sizeof(*writer));
+    writer->fd = -1;
+    writer->audio_rate = audio_rate;
+
+    // Keyed on the task: a queue made before a failed task start is kept for the next try
+    if (!flush_task)
+    {
+        if (!flush_queue)
+        {
+            flush_queue = xQueueCreate(1, sizeof(flush_job_t));
+        }
+        if (!flush_queue ||
+            xTaskCreatePinnedToCore(flush_loop, "avi_flush", AVI_FLUSH_TASK_STACK, NULL, AVI_FLUSH_TASK_PRIORITY, &flush_task, AVI_FLUSH_TASK_CORE) != pdPASS)
+        {
+            return ESP_FAIL;
+        }
+    }
+
+    for (int i = 0; i < 2; i++)
+    {
+        // Internal DMA capable memory lets the SD driver skip its bounce buffer
+        writer->buffers[i] = (uint8_t *)heap_caps_malloc(AVI_BUFFER_SIZE, MALLOC_CAP_DMA);
+        if (!writer->buffers[i])
+        {
+            writer->buffers[i] = (uint8_t *)heap_caps_malloc(AVI_BUFFER_SIZE, MALLOC_CAP_SPIRAM);
+        }
+    }
+    writer->flush_idle = xSemaphoreCreateBinary();
+    if (!writer->buffers[0] || !writer->buffers[1] || !writer->flush_idle)
+    {
+        avi_writer_close(writer);
+        return ESP_ERR_NO_MEM;
+    }
+    xSemaphoreGive(writer->flush_idle);
+
+    strncpy(writer->path, path, sizeof(writer->path) - 1);
+    writer->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0664);
+    if (writer->fd < 0)
+    {
+        avi_writer_close(writer);
+        return ESP_FAIL;
+    }
+    // Writing the last byte makes FAT allocate the whole cluster chain now
+    static const uint8_t zero = 0;
+    pwrite(writer->fd, &zero, 1, AVI_PREALLOCATE_BYTES - 1);
+
+    // Header space; filled in for real at the first checkpoint or at close
+    build_header(writer, 0, 0, AVI_HEADER_SIZE, AVI_HEADER_SIZE, false);
+    append(writer, writer->header, AVI_HEADER_SIZE);
+    return ESP_OK;
+}
+
+esp_err_t avi_writer_add_frame(avi_writer_t *writer, const uint8_t *jpg, size_t len, int64_t timestamp)
+{
+    if (writer->frames == 0)
+    {
+        if (jpeg_dc_size(jpg, len, &writer->width, &writer->height) != ESP_OK)
+        {
+            return ESP_ERR_INVALID_ARG;
+        }
+        writer->first_timestamp = timestamp;
+    }
+    if (writer->frames >= AVI_MAX_FRAMES)
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    esp_err_t res = add_chunk(writer, CKID_VIDEO, jpg, len);
+    if (res != ESP_OK)
+    {
+        return res;
+    }
+    writer->frames++;
+    writer->last_timestamp = timestamp;
+    writer->max_frame = (len > writer->max_frame) ? len : writer->max_frame;
+
+    if (writer->frames % AVI_CHECKPOINT_FRAMES == 0)
+    {
+        checkpoint(writer);
+    }
+    return ESP_OK;
+}
+
+esp_err_t avi_writer_add_audio(avi_writer_t *writer, const int16_t *samples, size_t count)
+{
+    if (!writer->audio_rate)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    esp_err_t res = add_chunk(writer, CKID_AUDIO, samples, count * sizeof(int16_t));
+    if (res == ESP_OK)
+    {
+        writer->audio_samples += count;
+    }
+    return res;
+}
+
+esp_err_t avi_writer_close(avi_writer_t *writer)
+{
+    esp_err_t res = writer->error;
+
+    if (writer->fd >= 0)
+    {
+        uint64_t fileEnd;
+        if (res == ESP_OK)
+        {
+            uint8_t header[8];
+            uint64_t moviEnd = write_position(writer);
+            put_u32(put_u32(header, FOURCC('i', 'd', 'x', '1')), writer->index_count * sizeof(avi_index_entry_t));
+            append(writer, header, sizeof(header));
+            append(writer, writer->index, writer->index_count * sizeof(avi_index_entry_t));
+            fileEnd = write_position(writer);
+
+            build_header(writer, writer->frames, writer->audio_samples, moviEnd, fileEnd, true);
+            if (store_header(writer) != ESP_OK)
+            {
+                writer->error = ESP_FAIL;
+            }
+            if (writer->fill > 0)
+            {
+                submit_buffer(writer);
+            }
+            wait_idle(writer);
+            res = writer->error;
+            writer->index_offset = moviEnd + 8;
+            writer->size = fileEnd;
+        }
+        else
+        {
+            wait_idle(writer);
+            fileEnd = writer->flushed;
+        }
+        if (close(writer->fd) != 0)
+        {
+            res = ESP_FAIL;
+        }
+        writer->fd = -1;
+        // Give back what was preallocated beyond the end. The FAT VFS has
+        // truncate() but no ftruncate().
+        if (truncate(writer->path, fileEnd) != 0)
+        {
+            res = ESP_FAIL;
+        }
+    }
+
+    for (int i = 0; i < 2; i++)
+    {
+        heap_caps_free(writer->buffers[i]);
+        writer->buffers[i] = NULL;
+    }
+    heap_caps_free(writer->index);
+    writer->index = NULL;
+    if (writer->flush_idle)
+    {
+        vSemaphoreDelete(writer->flush_idle);
+        writer->flush_idle = NULL;
+    }
+    return res;
+}
@@ -0,0 +1,270 @@
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include <fcntl.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "catalog.h"
+#include "record_config.h"
+
+#define FENCE_GROW 256
+
+static SemaphoreHandle_t catalog_lock = NULL;
+static bool loaded = false;
+static uint32_t count = 0;
+static int64_t *fence = NULL; // Start of every CATALOG_FENCE_STRIDE-th record
+static uint32_t fence_count = 0;
+static uint32_t fence_capacity = 0;
+
+static bool read_start(int fd, uint32_t i, int64_t *ms)
+{
+    return pread(fd, ms, sizeof(*ms), (off_t)i * sizeof(catalog_entry_t)) == sizeof(*ms);
+}
+
+static bool fence_push(int64_t ms)
+{
+    if (fence_count == fence_capacity)
+    {
+        uint32_t capacity = fence_capacity + FENCE_GROW;
+        void *grown = heap_caps_realloc(fence, capacity * sizeof(int64_t), MALLOC_CAP_SPIRAM);
+        if (!grown)
+        {
+            return false;
+        }
+        fence = (int64_t *)grown;
+        fence_capacity = capacity;
+    }
+    fence[fence_count++] = ms;
+    return true;
+}
+
+// Reads the fence from the file on first use. Caller holds the lock.
+static void load()
+{
+    struct stat st;
+
+    if (loaded)
+    {
+        return;
+    }
+    loaded = true;
+    if (stat(CATALOG_PATH, &st) != 0)
+    {
+        return; // No clips yet
+    }
+    count = st.st_size / sizeof(catalog_entry_t);
+    if (st.st_size % sizeof(catalog_entry_t))
+    {
+        // An append cut short by a reset
+        truncate(CATALOG_PATH, (off_t)count * sizeof(catalog_entry_t));
+    }
+
+    int fd = open(CATALOG_PATH, O_RDONLY);
+    if (fd < 0)
+    {
+        count = 0;
+        return;
+    }
+    for (uint32_t i = 0; i < count; i += CATALOG_FENCE_STRIDE)
+    {
+        int64_t ms;
+        if (!read_start(fd, i, &ms) || !fence_push(ms))
+        {
+            count = i;
+            break;
+        }
+    }
+    close(fd);
+    Serial.printf("Catalog: %u clips\r\n", count);
+}
+
+esp_err_t catalog_init()
+{
+    if (!catalog_lock)
+    {
+        catalog_lock = xSemaphoreCreateMutex();
+    }
+    return catalog_lock ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+esp_err_t catalog_add(const catalog_entry_t *entry)
+{
+    esp_err_t res = ESP_FAIL;
+
+    if (entry->start_ms < 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(catalog_lock, portMAX_DELAY);
+    load();
+    if (count % CATALOG_FENCE_STRIDE == 0 && !fence_push(entry->start_ms))
+    {
+        res = ESP_ERR_NO_MEM;
+    }
+    else
+    {
+        int fd = open(CATALOG_PATH, O_WRONLY | O_CREAT | O_APPEND, 0664);
+        if (fd >= 0)
+        {
+            if (write(fd, entry, sizeof(*entry)) == sizeof(*entry))
+            {
+                count++;
+                res = ESP_OK;
+            }
+            close(fd);
+        }
+        if (res != ESP_OK && count % CATALOG_FENCE_STRIDE == 0)
+        {
+            fence_count--;
+        }
+    }
+    xSemaphoreGive(catalog_lock);
+    if (res != ESP_OK)
+    {
+        Serial.printf("Catalog: cannot add %s\r\n", entry->name);
+    }
+    return res;
+}
+
+uint32_t catalog_count()
+{
+    xSemaphoreTake(catalog_lock, portMAX_DELAY);
+    load();
+    uint32_t n = count;
+    xSemaphoreGive(catalog_lock);
+    return n;
+}
+
+// Caller holds the lock
+static uint32_t upper_bound(int64_t ms)
+{
+    uint32_t lo = 0;
+    uint32_t hi;
+
+    // Fence entries at or before ms
+    hi = fence_count;
+    while (lo < hi)
+    {
+        uint32_t mid = (lo + hi) / 2;
+        if (fence[mid] <= ms)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    if (lo > 0)
+    {
+        // The answer lies in the block after the last fence entry at or before ms
+        uint32_t block = (lo - 1) * CATALOG_FENCE_STRIDE;
+        lo = block + 1;
+        hi = (block + CATALOG_FENCE_STRIDE < count) ? block + CATALOG_FENCE_STRIDE : count;
+        int fd = open(CATALOG_PATH, O_RDONLY);
+        while (fd >= 0 && lo < hi)
+        {
+            uint32_t mid = (lo + hi) / 2;
+            int64_t start;
+            if (!read_start(fd, mid, &start))
+            {
+                hi = mid;
+                break;
+            }
+            if (start <= ms)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        else
+        {
+            lo = block + 1; // Unreadable: settle for the fence entry
+        }
+    }
+    return lo;
+}
+
+uint32_t catalog_upper_bound(int64_t ms)
+{
+    xSemaphoreTake(catalog_lock, portMAX_DELAY);
+    load();
+    uint32_t i = upper_bound(ms);
+    xSemaphoreGive(catalog_lock);
+    return i;
+}
+
+esp_err_t catalog_mark_deleted(const char *name, int64_t start_ms)
+{
+    catalog_entry_t entry;
+    esp_err_t res = ESP_ERR_NOT_FOUND;
+
+    if (start_ms < 0)
+    {
+        return res;
+    }
+    xSemaphoreTake(catalog_lock, portMAX_DELAY);
+    load();
+    uint32_t i = upper_bound(start_ms);
+    int fd = open(CATALOG_PATH, O_RDWR);
+    // Clips that started in the same ms come just before i, in recording order
+    while (fd >= 0 && i > 0 && pread(fd, &entry, sizeof(entry), (off_t)(i - 1) * sizeof(entry)) == sizeof(entry) &&
+           entry.start_ms == start_ms)
+    {
+        i--;
+        if (strncmp(entry.name, name, sizeof(entry.name)) == 0)
+        {
+            entry.flags |= CATALOG_DELETED;
+            off_t pos = (off_t)i * sizeof(entry) + offsetof(catalog_entry_t, flags);
+            res = (pwrite(fd, &entry.flags, sizeof(entry.flags), pos) == sizeof(entry.flags)) ? ESP_OK : ESP_FAIL;
+            break;
+        }
+    }
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    xSemaphoreGive(catalog_lock);
+    return res;
+}
+
+uint32_t catalog_read(uint32_t first, catalog_entry_t *entries, uint32_t max)
+{
+    uint32_t n = 0;
+
+    xSemaphoreTake(catalog_lock, portMAX_DELAY);
+    load();
+    if (first < count)
+    {
+        n = (count - first < max) ? count - first : max;
+        int fd = open(CATALOG_PATH, O_RDONLY);
+        ssize_t len = (fd >= 0) ? pread(fd, entries, n * sizeof(catalog_entry_t), (off_t)first * sizeof(catalog_entry_t)) : -1;
+        n = (len > 0) ? len / sizeof(catalog_entry_t) : 0;
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+    }
+    xSemaphoreGive(catalog_lock);
+    return n;
+}
+
+int64_t catalog_wall_ms(int64_t timestamp)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    if (tv.tv_sec < VALID_TIME)
+    {
+        return -1;
+    }
+    int64_t wallUs = (int64_t)tv.tv_sec * 1000000 + tv.tv_usec - (esp_timer_get_time() - timestamp);
+    return wallUs / 1000;
+}
@@ -0,0 +1,168 @@
+#include <esp_heap_caps.h>
+#include <string.h>
+
+#include "clip_ring.h"
+
+static inline clip_frame_t *frame_at(clip_ring_t *ring, uint32_t id)
+{
+    return &ring->frames[id % ring->max_frames];
+}
+
+static inline bool evictable(clip_ring_t *ring, uint32_t id)
+{
+    return id != ring->next && (!ring->pinning || (int32_t)(id - ring->pin) < 0);
+}
+
+// Caller holds the lock
+static void evict_oldest(clip_ring_t *ring)
+{
+    ring->bytes -= frame_at(ring, ring->first)->len;
+    ring->first++;
+    if (ring->first == ring->next)
+    {
+        ring->head = 0;
+    }
+}
+
+// Finds len contiguous free bytes, or returns false. Caller holds the lock.
+static bool find_space(clip_ring_t *ring, size_t len, size_t *offset)
+{
+    if (ring->first == ring->next)
+    {
+        *offset = 0;
+        return len <= ring->size;
+    }
+    size_t tail = frame_at(ring, ring->first)->offset;
+    if (ring->head > tail)
+    {
+        // Free space is [head, size) and [0, tail)
+        if (ring->size - ring->head >= len)
+        {
+            *offset = ring->head;
+            return true;
+        }
+        if (tail >= len)
+        {
+            *offset = 0;
+            return true;
+        }
+        return false;
+    }
+    // Wrapped: free space is [head, tail); head == tail means full
+    if (tail - ring->head >= len)
+    {
+        *offset = ring->head;
+        return true;
+    }
+    return false;
+}
+
+esp_err_t clip_ring_init(clip_ring_t *ring, size_t budget, uint16_t max_frames)
+{
+    memset(ring, 0, sizeof(*ring));
+    portMUX_INITIALIZE(&ring->lock);
+    ring->buf = (uint8_t *)heap_caps_malloc(budget, MALLOC_CAP_SPIRAM);
+    ring->frames = (clip_frame_t *)heap_caps_malloc(max_frames * sizeof(clip_frame_t), MALLOC_CAP_8BIT);
+    if (!ring->buf || !ring->frames)
+    {
+        heap_caps_free(ring->buf);
+        heap_caps_free(ring->frames);
+        ring->buf = NULL;
+        ring->frames = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    ring->size = budget;
+    ring->max_frames = max_frames;
+    return ESP_OK;
+}
+
+esp_err_t clip_ring_push(clip_ring_t *ring, const uint8_t *jpg, size_t len, int64_t timestamp, int64_t max_age_us)
+{
+    size_t offset = 0;
+    bool found = false;
+
+    portENTER_CRITICAL(&ring->lock);
+    ring->pushed++;
+    while (ring->first != ring->next && evictable(ring, ring->first) && timestamp - frame_at(ring, ring->first)->timestamp > max_age_us)
+    {
+        evict_oldest(ring);
+        ring->evicted_age++;
+    }
+    // A frame larger than half the budget would flush the whole pre-roll for one frame
+    while (len <= ring->size / 2 &&
+           !(found = (ring->next - ring->first < ring->max_frames) && find_space(ring, len, &offset)) &&
+           evictable(ring, ring->first))
+    {
+        evict_oldest(ring);
+        ring->evicted_budget++;
+    }
+    if (!found)
+    {
+        ring->dropped++;
+    }
+    portEXIT_CRITICAL(&ring->lock);
+
+    if (!found)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    // The space is ours: it is not part of any stored frame and the consumer
+    // only reads frames before next
+    memcpy(ring->buf + offset, jpg, len);
+
+    portENTER_CRITICAL(&ring->lock);
+    clip_frame_t *frame = frame_at(ring, ring->next);
+    frame->offset = offset;
+    frame->len = len;
+    frame->timestamp = timestamp;
+    ring->head = offset + len;
+    ring->bytes += len;
+    ring->next++;
+    portEXIT_CRITICAL(&ring->lock);
+    return ESP_OK;
+}
+
+uint32_t clip_ring_pin(clip_ring_t *ring, int64_t since)
+{
+    portENTER_CRITICAL(&ring->lock);
+    uint32_t id = ring->first;
+    while (id != ring->next && frame_at(ring, id)->timestamp < since)
+    {
+        id++;
+    }
+    ring->pinning = true;
+    ring->pin = id;
+    portEXIT_CRITICAL(&ring->lock);
+    return id;
+}
+
+void clip_ring_advance(clip_ring_t *ring, uint32_t id)
+{
+    portENTER_CRITICAL(&ring->lock);
+    ring->pin = id;
+    portEXIT_CRITICAL(&ring->lock);
+}
+
+void clip_ring_unpin(clip_ring_t *ring)
+{
+    portENTER_CRITICAL(&ring->lock);
+    ring->pinning = false;
+    portEXIT_CRITICAL(&ring->lock);
+}
+
+bool clip_ring_get(clip_ring_t *ring, uint32_t id, clip_frame_t *frame, const uint8_t **data)
+{
+    bool found = false;
+
+    portENTER_CRITICAL(&ring->lock);
+    // Unsigned distance, so this also holds across id wrap-around
+    if (id - ring->first < ring->next - ring->first)
+    {
+        *frame = *frame_at(ring, id);
+        *data = ring->buf + frame->offset;
+        found = true;
+    }
+    portEXIT_CRITICAL(&ring->lock);
+    return found;
+}
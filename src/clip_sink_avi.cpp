@@ -0,0 +1,77 @@
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "catalog.h"
+#include "clip_sink.h"
+#include "retention.h"
+
+static esp_err_t avi_open(clip_sink_t *sink, const char *clip_name, int64_t timestamp)
+{
+    clip_avi_sink_t *state = (clip_avi_sink_t *)sink->ctx;
+
+    snprintf(state->path, sizeof(state->path), "%s/%s.avi", state->dir, clip_name);
+    strncpy(state->name, clip_name, sizeof(state->name) - 1);
+    state->start_ms = catalog_wall_ms(timestamp);
+    bool tracked = retention_running() && retention_open(state->name, state->start_ms) == ESP_OK;
+    state->open = avi_writer_open(&state->avi, state->path, 0) == ESP_OK;
+    if (!state->open && tracked)
+    {
+        struct stat st;
+        retention_close(stat(state->path, &st) == 0 ? st.st_size : 0);
+    }
+    return state->open ? ESP_OK : ESP_FAIL;
+}
+
+static esp_err_t avi_write(clip_sink_t *sink, const uint8_t *jpg, size_t len, int64_t timestamp)
+{
+    clip_avi_sink_t *state = (clip_avi_sink_t *)sink->ctx;
+
+    return avi_writer_add_frame(&state->avi, jpg, len, timestamp);
+}
+
+static esp_err_t avi_close(clip_sink_t *sink)
+{
+    clip_avi_sink_t *state = (clip_avi_sink_t *)sink->ctx;
+
+    if (!state->open)
+    {
+        return ESP_OK;
+    }
+    state->open = false;
+    esp_err_t res = avi_writer_close(&state->avi);
+
+    // Listed before retention runs, so a clip it reclaims right away is marked deleted too
+    if (res == ESP_OK && state->avi.frames > 0 && state->start_ms >= 0)
+    {
+        catalog_entry_t entry = {};
+        const avi_writer_t *avi = &state->avi;
+        entry.start_ms = state->start_ms;
+        entry.duration_ms = (uint64_t)avi->frames * avi->us_per_frame / 1000;
+        entry.frames = avi->frames;
+        entry.bytes = avi->size;
+        entry.index_offset = avi->index_offset;
+        entry.us_per_frame = avi->us_per_frame;
+        strcpy(entry.name, state->name);
+        catalog_add(&entry); // The clip itself is fine either way
+    }
+
+    // Whatever made it to the card has to be reclaimed eventually, even a clip cut short
+    struct stat st;
+    if (retention_running())
+    {
+        retention_close(stat(state->path, &st) == 0 ? st.st_size : 0);
+    }
+    return res;
+}
+
+void clip_avi_sink_init(clip_sink_t *sink, clip_avi_sink_t *state, const char *dir)
+{
+    memset(state, 0, sizeof(*state));
+    strncpy(state->dir, dir, sizeof(state->dir) - 1);
+    sink->name = "avi";
+    sink->open = avi_open;
+    sink->write = avi_write;
+    sink->close = avi_close;
+    sink->ctx = state;
+}
@@ -0,0 +1,52 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "clip_sink.h"
+
+static esp_err_t file_open(clip_sink_t *sink, const char *clip_name, int64_t timestamp)
+{
+    clip_file_sink_t *state = (clip_file_sink_t *)sink->ctx;
+
+    snprintf(state->path, sizeof(state->path), "%s/%s.mjpg", state->dir, clip_name);
+    state->file = fopen(state->path, "wb");
+    state->frames = 0;
+    state->bytes = 0;
+    return state->file ? ESP_OK : ESP_FAIL;
+}
+
+static esp_err_t file_write(clip_sink_t *sink, const uint8_t *jpg, size_t len, int64_t timestamp)
+{
+    clip_file_sink_t *state = (clip_file_sink_t *)sink->ctx;
+
+    if (fwrite(jpg, 1, len, state->file) != len)
+    {
+        return ESP_FAIL;
+    }
+    state->frames++;
+    state->bytes += len;
+    return ESP_OK;
+}
+
+static esp_err_t file_close(clip_sink_t *sink)
+{
+    clip_file_sink_t *state = (clip_file_sink_t *)sink->ctx;
+
+    if (!state->file)
+    {
+        return ESP_OK;
+    }
+    int res = fclose(state->file);
+    state->file = NULL;
+    return res == 0 ? ESP_OK : ESP_FAIL;
+}
+
+void clip_file_sink_init(clip_sink_t *sink, clip_file_sink_t *state, const char *dir)
+{
+    memset(state, 0, sizeof(*state));
+    strncpy(state->dir, dir, sizeof(state->dir) - 1);
+    sink->name = "mjpg";
+    sink->open = file_open;
+    sink->write = file_write;
+    sink->close = file_close;
+    sink->ctx = state;
+}
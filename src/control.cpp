@@ -0,0 +1,501 @@
+#include <Arduino.h>
+#include <esp_camera.h>
+#include <esp_http_server.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "audio_dsp.h"
+#include "audio_level.h"
+#include "control.h"
+#include "motion_detect.h"
+#include "substream.h"
+
+static char status_json[STATUS_JSON_MAX];
+static int status_len = 0;
+static volatile uint32_t status_generation = 1; // Bumped by every change
+static uint32_t status_built = 0;              // Generation status_json was built at
+
+typedef int (*control_setter_t)(sensor_t *s, const char *name, int val);
+
+typedef struct
+{
+    const char *name;
+    control_setter_t set;
+} control_t;
+
+typedef struct
+{
+    const control_t *control;
+    int value;
+    int result;
+} control_setting_t;
+
+// Sensor settings whose setter takes the value as it is
+#define SENSOR_CONTROLS(X)                \
+    X(ae_level, set_ae_level)             \
+    X(aec, set_exposure_ctrl)             \
+    X(aec2, set_aec2)                     \
+    X(aec_value, set_aec_value)           \
+    X(agc, set_gain_ctrl)                 \
+    X(agc_gain, set_agc_gain)             \
+    X(awb, set_whitebal)                  \
+    X(awb_gain, set_awb_gain)             \
+    X(bpc, set_bpc)                       \
+    X(brightness, set_brightness)         \
+    X(colorbar, set_colorbar)             \
+    X(contrast, set_contrast)             \
+    X(dcw, set_dcw)                       \
+    X(hmirror, set_hmirror)               \
+    X(lenc, set_lenc)                     \
+    X(quality, set_quality)               \
+    X(raw_gma, set_raw_gma)               \
+    X(saturation, set_saturation)         \
+    X(special_effect, set_special_effect) \
+    X(vflip, set_vflip)                   \
+    X(wb_mode, set_wb_mode)               \
+    X(wpc, set_wpc)
+
+#define SENSOR_SETTER(name, setter)                                 \
+    static int set_##name(sensor_t *s, const char *, int val)       \
+    {                                                               \
+        return s->setter(s, val);                                   \
+    }
+SENSOR_CONTROLS(SENSOR_SETTER)
+
+static int set_framesize(sensor_t *s, const char *, int val)
+{
+    if (s->pixformat != PIXFORMAT_JPEG)
+    {
+        return 0;
+    }
+    return s->set_framesize(s, (framesize_t)val);
+}
+
+static int set_gainceiling(sensor_t *s, const char *, int val)
+{
+    return s->set_gainceiling(s, (gainceiling_t)val);
+}
+
+// Module settings; the module checks the range itself
+static int set_audio_dsp(sensor_t *, const char *name, int val)
+{
+    return audio_dsp_set(name, val);
+}
+
+static int set_audio_level(sensor_t *, const char *name, int val)
+{
+    return audio_level_set(name, val);
+}
+
+static int set_motion(sensor_t *, const char *name, int val)
+{
+    return motion_detect_set(name, val);
+}
+
+static int set_substream(sensor_t *, const char *name, int val)
+{
+    return substream_set(name, val);
+}
+
+// Sorted by name for the binary search in find_control(); the static_assert below keeps it that way
+static constexpr control_t controls[] = {
+    {"ae_level", set_ae_level},
+    {"aec", set_aec},
+    {"aec2", set_aec2},
+    {"aec_value", set_aec_value},
+    {"agc", set_agc},
+    {"agc_gain", set_agc_gain},
+    {"audio_agc", set_audio_dsp},
+    {"audio_agc_max_gain", set_audio_dsp},
+    {"audio_agc_target", set_audio_dsp},
+    {"audio_dc", set_audio_dsp},
+    {"audio_gate", set_audio_dsp},
+    {"audio_gate_threshold", set_audio_dsp},
+    {"audio_hpf", set_audio_dsp},
+    {"audio_hpf_hz", set_audio_dsp},
+    {"audio_sound_threshold", set_audio_level},
+    {"awb", set_awb},
+    {"awb_gain", set_awb_gain},
+    {"bpc", set_bpc},
+    {"brightness", set_brightness},
+    {"colorbar", set_colorbar},
+    {"contrast", set_contrast},
+    {"dcw", set_dcw},
+    {"framesize", set_framesize},
+    {"gainceiling", set_gainceiling},
+    {"hmirror", set_hmirror},
+    {"lenc", set_lenc},
+    {"motion_detect", set_motion},
+    {"motion_min_blocks", set_motion},
+    {"motion_threshold", set_motion},
+    {"quality", set_quality},
+    {"raw_gma", set_raw_gma},
+    {"saturation", set_saturation},
+    {"special_effect", set_special_effect},
+    {"sub_quality", set_substream},
+    {"vflip", set_vflip},
+    {"wb_mode", set_wb_mode},
+    {"wpc", set_wpc},
+};
+#define CONTROL_COUNT (sizeof(controls) / sizeof(controls[0]))
+
+static constexpr int name_compare(const char *a, const char *b)
+{
+    return (*a != *b || !*a) ? (unsigned char)*a - (unsigned char)*b : name_compare(a + 1, b + 1);
+}
+
+static constexpr bool controls_sorted(size_t i = 1)
+{
+    return i >= CONTROL_COUNT || (name_compare(controls[i - 1].name, controls[i].name) < 0 && controls_sorted(i + 1));
+}
+static_assert(controls_sorted(), "controls[] must be sorted by name, without duplicates");
+
+// Looks up len bytes of name, which need not be terminated
+static const control_t *find_control(const char *name, size_t len)
+{
+    size_t lo = 0, hi = CONTROL_COUNT;
+    while (lo < hi)
+    {
+        size_t mid = (lo + hi) / 2;
+        int cmp = strncmp(controls[mid].name, name, len);
+        if (cmp == 0 && controls[mid].name[len])
+        {
+            cmp = 1; // Table entry is longer
+        }
+        if (cmp == 0)
+        {
+            return &controls[mid];
+        }
+        if (cmp < 0)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return NULL;
+}
+
+int control_set(sensor_t *sensor, const char *name, int value)
+{
+    const control_t *control = find_control(name, strlen(name));
+    if (!control)
+    {
+        return -2;
+    }
+    return control->set(sensor, control->name, value);
+}
+
+static bool parse_int(const char *p, const char **end, int *value)
+{
+    char *stop;
+    long v = strtol(p, &stop, 10);
+    if (stop == p)
+    {
+        return false;
+    }
+    *end = stop;
+    *value = (int)v;
+    return true;
+}
+
+// Adds one name/value pair; *error is set if the name is unknown or the list full
+static bool add_setting(control_setting_t *settings, int *count, const char *name, size_t len, int value, const char **error)
+{
+    if (*count >= CONTROL_MAX_SETTINGS)
+    {
+        *error = "too many settings";
+        return false;
+    }
+    const control_t *control = find_control(name, len);
+    if (!control)
+    {
+        *error = "unknown setting";
+        return false;
+    }
+    settings[*count].control = control;
+    settings[*count].value = value;
+    settings[*count].result = 0;
+    (*count)++;
+    return true;
+}
+
+// name=value pairs separated by '&'; the legacy var=<name>&val=<value> form is one pair
+static bool parse_query(char *query, control_setting_t *settings, int *count, const char **error)
+{
+    char name[32];
+    char value[16];
+    const char *end;
+    int v;
+
+    if (httpd_query_key_value(query, "var", name, sizeof(name)) == ESP_OK)
+    {
+        if (httpd_query_key_value(query, "val", value, sizeof(value)) != ESP_OK || !parse_int(value, &end, &v))
+        {
+            *error = "missing or bad val";
+            return false;
+        }
+        return add_setting(settings, count, name, strlen(name), v, error);
+    }
+
+    for (char *p = query; *p;)
+    {
+        char *amp = strchr(p, '&');
+        char *next = amp ? amp + 1 : p + strlen(p);
+        char *eq = (char *)memchr(p, '=', next - p);
+        if (!eq || !parse_int(eq + 1, &end, &v) || (*end && *end != '&'))
+        {
+            *error = "expected name=integer";
+            return false;
+        }
+        if (!add_setting(settings, count, p, eq - p, v, error))
+        {
+            return false;
+        }
+        p = next;
+    }
+    return true;
+}
+
+static const char *skip_space(const char *p)
+{
+    while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')
+    {
+        p++;
+    }
+    return p;
+}
+
+// A flat JSON object of integers and booleans
+static bool parse_json(const char *body, control_setting_t *settings, int *count, const char **error)
+{
+    const char *p = skip_space(body);
+    *error = "expected a JSON object of integers";
+    if (*p++ != '{')
+    {
+        return false;
+    }
+    p = skip_space(p);
+    if (*p == '}')
+    {
+        return true;
+    }
+    while (true)
+    {
+        if (*p++ != '"')
+        {
+            return false;
+        }
+        const char *name = p;
+        while (*p && *p != '"')
+        {
+            p++;
+        }
+        if (!*p)
+        {
+            return false;
+        }
+        size_t len = p - name;
+        p = skip_space(p + 1);
+        if (*p++ != ':')
+        {
+            return false;
+        }
+        p = skip_space(p);
+
+        int value;
+        if (!strncmp(p, "true", 4))
+        {
+            value = 1;
+            p += 4;
+        }
+        else if (!strncmp(p, "false", 5))
+        {
+            value = 0;
+            p += 5;
+        }
+        else if (!parse_int(p, &p, &value))
+        {
+            return false;
+        }
+        if (!add_setting(settings, count, name, len, value, error))
+        {
+            return false;
+        }
+
+        p = skip_space(p);
+        if (*p == ',')
+        {
+            p = skip_space(p + 1);
+            continue;
+        }
+        if (*p == '}' && !*skip_space(p + 1))
+        {
+            return true;
+        }
+        *error = "expected a JSON object of integers";
+        return false;
+    }
+}
+
+static int answer_error(char *json, const char *error)
+{
+    snprintf(json, CONTROL_ANSWER_MAX, "{\"error\":\"%s\"}", error);
+    return 400;
+}
+
+// Reads the whole body into a terminated buffer of CONTROL_BODY_MAX + 1
+static bool read_body(httpd_req_t *req, char *body)
+{
+    if (req->content_len > CONTROL_BODY_MAX)
+    {
+        return false;
+    }
+    size_t received = 0;
+    while (received < req->content_len)
+    {
+        int n = httpd_req_recv(req, body + received, req->content_len - received);
+        if (n == HTTPD_SOCK_ERR_TIMEOUT)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            return false;
+        }
+        received += n;
+    }
+    body[received] = 0;
+    return true;
+}
+
+int control_apply(sensor_t *sensor, char *query, const char *body, char *json)
+{
+    control_setting_t settings[CONTROL_MAX_SETTINGS];
+    int count = 0;
+    const char *error = NULL;
+
+    if (!(body ? parse_json(body, settings, &count, &error) : parse_query(query, settings, &count, &error)))
+    {
+        return answer_error(json, error);
+    }
+
+    // Everything is known to exist, so apply it all in one go
+    int failed = 0;
+    for (int i = 0; i < count; i++)
+    {
+        settings[i].result = settings[i].control->set(sensor, settings[i].control->name, settings[i].value);
+        log_i("%s = %d: %d", settings[i].control->name, settings[i].value, settings[i].result);
+        failed += settings[i].result < 0;
+    }
+    control_changed();
+
+    int len = snprintf(json, CONTROL_ANSWER_MAX, "{\"applied\":%d,\"failed\":%d,\"results\":{", count - failed, failed);
+    for (int i = 0; i < count; i++)
+    {
+        len += snprintf(json + len, CONTROL_ANSWER_MAX - len, "%s\"%s\":%d", i ? "," : "", settings[i].control->name,
+                        settings[i].result);
+    }
+    snprintf(json + len, CONTROL_ANSWER_MAX - len, "}}");
+    return failed ? 500 : 200;
+}
+
+esp_err_t control_handler(httpd_req_t *req)
+{
+    char *json = (char *)malloc(CONTROL_ANSWER_MAX);
+    int status;
+
+    if (!json)
+    {
+        return httpd_resp_send_500(req);
+    }
+    if (req->method == HTTP_POST)
+    {
+        char *body = (char *)malloc(CONTROL_BODY_MAX + 1);
+        if (!body)
+        {
+            free(json);
+            return httpd_resp_send_500(req);
+        }
+        status = read_body(req, body) ? control_apply(esp_camera_sensor_get(), NULL, body, json)
+                                      : answer_error(json, "body missing or too large");
+        free(body);
+    }
+    else
+    {
+        char query[512];
+        status = (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK)
+                     ? control_apply(esp_camera_sensor_get(), query, NULL, json)
+                     : answer_error(json, "missing or too long query");
+    }
+
+    httpd_resp_set_status(req, status == 200 ? "200 OK" : status == 400 ? "400 Bad Request" : "500 Internal Server Error");
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    esp_err_t res = httpd_resp_sendstr(req, json);
+    free(json);
+    return res;
+}
+
+void control_changed()
+{
+    status_generation++;
+}
+
+static int print_reg(char *p, size_t size, sensor_t *s, int reg, int mask)
+{
+    return snprintf(p, size, ",\"0x%x\":%d", reg, s->get_reg(s, reg, mask));
+}
+
+static int build_status(sensor_t *s)
+{
+    const camera_status_t *st = &s->status;
+    int len = snprintf(status_json, sizeof(status_json),
+                       "{\"xclk\":%d,\"pixformat\":%d,\"framesize\":%u,\"quality\":%u,"
+                       "\"brightness\":%d,\"contrast\":%d,\"saturation\":%d,\"sharpness\":%d,\"denoise\":%u,"
+                       "\"special_effect\":%u,\"wb_mode\":%u,\"awb\":%u,\"awb_gain\":%u,"
+                       "\"aec\":%u,\"aec2\":%u,\"ae_level\":%d,\"aec_value\":%u,"
+                       "\"agc\":%u,\"agc_gain\":%u,\"gainceiling\":%u,"
+                       "\"bpc\":%u,\"wpc\":%u,\"raw_gma\":%u,\"lenc\":%u,"
+                       "\"hmirror\":%u,\"vflip\":%u,\"dcw\":%u,\"colorbar\":%u,"
+                       "\"scale\":%u,\"binning\":%u,\"led_intensity\":-1",
+                       s->xclk_freq_hz / 1000000, s->pixformat, st->framesize, st->quality,
+                       st->brightness, st->contrast, st->saturation, st->sharpness, st->denoise,
+                       st->special_effect, st->wb_mode, st->awb, st->awb_gain,
+                       st->aec, st->aec2, st->ae_level, st->aec_value,
+                       st->agc, st->agc_gain, st->gainceiling,
+                       st->bpc, st->wpc, st->raw_gma, st->lenc,
+                       st->hmirror, st->vflip, st->dcw, st->colorbar,
+                       st->scale, st->binning);
+    if (s->id.PID == OV2640_PID)
+    {
+        len += print_reg(status_json + len, sizeof(status_json) - len, s, 0xd3, 0xff);
+        len += print_reg(status_json + len, sizeof(status_json) - len, s, 0x111, 0xff);
+        len += print_reg(status_json + len, sizeof(status_json) - len, s, 0x132, 0xff);
+    }
+    len += snprintf(status_json + len, sizeof(status_json) - len, "}");
+    return len < (int)sizeof(status_json) ? len : sizeof(status_json) - 1;
+}
+
+// Only ever runs on the web server's task, so the cache needs no lock
+esp_err_t status_handler(httpd_req_t *req)
+{
+    sensor_t *s = esp_camera_sensor_get();
+    if (!s)
+    {
+        return httpd_resp_send_500(req);
+    }
+    uint32_t generation = status_generation;
+    if (status_built != generation)
+    {
+        status_len = build_status(s);
+        status_built = generation;
+    }
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    return httpd_resp_send(req, status_json, status_len);
+}
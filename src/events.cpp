@@ -0,0 +1,475 @@
+#include <Arduino.h>
+#include <esp_http_server.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include "events.h"
+#include "metrics.h"
+#include "stream_writer.h"
+
+#define EVENT_LOG_MASK (EVENT_LOG_SIZE - 1)
+#define EVENTS_BATCH 8
+#define EVENT_JSON_MAX 160 // Longest event_to_json() output, with room to spare
+#define POLL_JSON_SIZE (64 + EVENTS_POLL_MAX * EVENT_JSON_MAX)
+
+#define EVENTS_TASK_CORE 0
+#define EVENTS_TASK_PRIORITY 2
+#define EVENTS_TASK_STACK 3072
+
+// One /events connection. The slot stays taken until httpd has closed the
+// session and called events_client_closed(), so a late free_ctx can never
+// release a slot that was already handed to a new client.
+typedef struct
+{
+    bool active;
+    bool closing;     // Close requested or under way, free_ctx not called yet; also set while a handler sets the slot up
+    bool sending;     // The events task is writing to the socket, without clients_lock
+    bool long_poll;   // Waiting for one JSON response rather than streaming
+    int64_t deadline; // Long poll only: answer with an empty list at this time
+    httpd_handle_t hd;
+    stream_writer_t writer;
+    uint32_t last_seq;
+} sse_client_t;
+
+static event_t event_log[EVENT_LOG_SIZE];
+static uint32_t event_seq = 0;
+static portMUX_TYPE event_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static sse_client_t clients[EVENTS_MAX_CLIENTS];
+static SemaphoreHandle_t clients_lock = NULL; // Guards the slots' flags; never held across a send
+static SemaphoreHandle_t events_wake = NULL;
+static TaskHandle_t events_task = NULL;
+
+static const char *_SSE_CONTENT_TYPE = "text/event-stream";
+static const char *_SSE_PREAMBLE = "retry: 2000\n\n";
+static const char *_SSE_KEEPALIVE = ": keepalive\n\n";
+static const char *_JSON_CONTENT_TYPE = "application/json";
+
+// Long-poll response body, only used by the events task
+static char poll_json[POLL_JSON_SIZE];
+
+const char *event_type_name(event_type_t type)
+{
+    switch (type)
+    {
+    case EVENT_SOUND:
+        return "sound";
+    case EVENT_MOTION:
+        return "motion";
+    case EVENT_VISION:
+        return "vision";
+    }
+    return "unknown";
+}
+
+int event_to_json(const event_t *event, char *buf, size_t len)
+{
+    int64_t latency = (esp_timer_get_time() - event->timestamp) / 1000;
+    return snprintf(buf, len, "{\"seq\":%u,\"type\":\"%s\",\"active\":%s,\"ts\":%lld,\"latency_ms\":%lld,\"value\":%d}",
+                    event->seq, event_type_name(event->type), event->active ? "true" : "false",
+                    (long long)(event->timestamp / 1000), (long long)latency, event->value);
+}
+
+// Caller holds event_lock
+static inline IRAM_ATTR void append_event(event_type_t type, bool active, int32_t value, int64_t timestamp)
+{
+    event_t *event = &event_log[++event_seq & EVENT_LOG_MASK];
+    event->seq = event_seq;
+    event->type = type;
+    event->active = active;
+    event->timestamp = timestamp;
+    event->value = value;
+}
+
+void events_post(event_type_t type, bool active, int32_t value)
+{
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&event_lock);
+    append_event(type, active, value, now);
+    portEXIT_CRITICAL(&event_lock);
+
+    if (events_wake)
+    {
+        xSemaphoreGive(events_wake);
+    }
+}
+
+void IRAM_ATTR events_post_from_isr(event_type_t type, bool active, int32_t value)
+{
+    BaseType_t woken = pdFALSE;
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL_ISR(&event_lock);
+    append_event(type, active, value, now);
+    portEXIT_CRITICAL_ISR(&event_lock);
+
+    if (events_wake)
+    {
+        xSemaphoreGiveFromISR(events_wake, &woken);
+    }
+    if (woken)
+    {
+        portYIELD_FROM_ISR();
+    }
+}
+
+size_t events_read(uint32_t since, event_t *out, size_t max)
+{
+    size_t count = 0;
+
+    portENTER_CRITICAL(&event_lock);
+    uint32_t oldest = (event_seq > EVENT_LOG_SIZE) ? event_seq - EVENT_LOG_SIZE + 1 : 1;
+    uint32_t seq = (since + 1 > oldest) ? since + 1 : oldest;
+    for (; seq <= event_seq && count < max; seq++)
+    {
+        out[count++] = event_log[seq & EVENT_LOG_MASK];
+    }
+    portEXIT_CRITICAL(&event_lock);
+    return count;
+}
+
+uint32_t events_latest_seq()
+{
+    portENTER_CRITICAL(&event_lock);
+    uint32_t seq = event_seq;
+    portEXIT_CRITICAL(&event_lock);
+    return seq;
+}
+
+// {"last":<seq>,"events":[...]}, where last is what to pass as since next time
+static int poll_to_json(const event_t *events, size_t count, uint32_t last, char *buf, size_t len)
+{
+    int n = snprintf(buf, len, "{\"last\":%u,\"events\":[", last);
+    for (size_t i = 0; i < count && n + EVENT_JSON_MAX < (int)len; i++)
+    {
+        n += snprintf(buf + n, len - n, i ? "," : "");
+        n += event_to_json(&events[i], buf + n, len - n);
+    }
+    n += snprintf(buf + n, len - n, "]}");
+    return n;
+}
+
+// Called by clients_lock holders only.
+static void client_drop(sse_client_t *client)
+{
+    client->closing = true;
+    httpd_sess_trigger_close(client->hd, client->writer.fd);
+}
+
+static esp_err_t client_send_events(sse_client_t *client)
+{
+    event_t batch[EVENTS_BATCH];
+    char message[64 + EVENT_JSON_MAX];
+
+    size_t count;
+    while ((count = events_read(client->last_seq, batch, EVENTS_BATCH)) > 0)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            int len = snprintf(message, sizeof(message), "id: %u\nevent: %s\ndata: ", batch[i].seq, event_type_name(batch[i].type));
+            len += event_to_json(&batch[i], message + len, sizeof(message) - len - 2);
+            message[len++] = '\n';
+            message[len++] = '\n';
+
+            const void *bufs[] = {message};
+            size_t lens[] = {(size_t)len};
+            if (stream_writer_send(&client->writer, bufs, lens, 1) != ESP_OK)
+            {
+                return ESP_FAIL;
+            }
+            client->last_seq = batch[i].seq;
+        }
+    }
+    return ESP_OK;
+}
+
+// Answers a long poll with whatever is in events; the caller closes the session afterwards.
+static esp_err_t client_answer_poll(sse_client_t *client, const event_t *events, size_t count)
+{
+    uint32_t last = count ? events[count - 1].seq : client->last_seq;
+    int len = poll_to_json(events, count, last, poll_json, sizeof(poll_json));
+    return stream_writer_begin_fd(&client->writer, client->writer.fd, _JSON_CONTENT_TYPE, poll_json, len);
+}
+
+static void events_loop(void *arg)
+{
+    event_t batch[EVENTS_POLL_MAX];
+    int64_t nextKeepalive = esp_timer_get_time() + EVENTS_KEEPALIVE_MS * 1000LL;
+    int64_t nextWake = nextKeepalive;
+
+    while (true)
+    {
+        int64_t wait = nextWake - esp_timer_get_time();
+        xSemaphoreTake(events_wake, wait > 0 ? pdMS_TO_TICKS(wait / 1000) + 1 : 0);
+
+        int64_t now = esp_timer_get_time();
+        bool keepalive = now >= nextKeepalive;
+        if (keepalive)
+        {
+            nextKeepalive = now + EVENTS_KEEPALIVE_MS * 1000LL;
+            metrics_fold(); // Keeps the counters' cells from wrapping twice between scrapes
+        }
+        nextWake = nextKeepalive;
+
+        for (int i = 0; i < EVENTS_MAX_CLIENTS; i++)
+        {
+            sse_client_t *client = &clients[i];
+
+            // Only the flags are read and set under the lock; a send that
+            // blocks on one peer must not hold up httpd closing another
+            xSemaphoreTake(clients_lock, portMAX_DELAY);
+            bool ready = client->active && !client->closing;
+            client->sending = ready;
+            xSemaphoreGive(clients_lock);
+            if (!ready)
+            {
+                continue;
+            }
+
+            bool drop = false;
+            if (client->long_poll)
+            {
+                size_t count = events_read(client->last_seq, batch, EVENTS_POLL_MAX);
+                if (count > 0 || now >= client->deadline)
+                {
+                    client_answer_poll(client, batch, count);
+                    drop = true;
+                }
+                else if (client->deadline < nextWake)
+                {
+                    nextWake = client->deadline;
+                }
+            }
+            else
+            {
+                esp_err_t res = client_send_events(client);
+                if (res == ESP_OK && keepalive)
+                {
+                    // Quiet period: a comment line both keeps proxies from timing out and finds dead peers
+                    const void *bufs[] = {_SSE_KEEPALIVE};
+                    size_t lens[] = {strlen(_SSE_KEEPALIVE)};
+                    res = stream_writer_send(&client->writer, bufs, lens, 1);
+                }
+                if (res != ESP_OK)
+                {
+                    Serial.println("Events: client gone");
+                    drop = true;
+                }
+            }
+
+            xSemaphoreTake(clients_lock, portMAX_DELAY);
+            client->sending = false;
+            // Already closing when httpd went first; its session may be gone by now
+            if (drop && !client->closing)
+            {
+                client_drop(client);
+            }
+            xSemaphoreGive(clients_lock);
+        }
+    }
+}
+
+void events_session_closing(httpd_handle_t hd, int sockfd)
+{
+    if (!clients_lock)
+    {
+        return;
+    }
+    xSemaphoreTake(clients_lock, portMAX_DELAY);
+    for (int i = 0; i < EVENTS_MAX_CLIENTS; i++)
+    {
+        sse_client_t *client = &clients[i];
+        if (!client->active || client->hd != hd || client->writer.fd != sockfd)
+        {
+            continue;
+        }
+        // The socket is shut down, so a send in flight fails right away
+        client->closing = true;
+        while (client->sending)
+        {
+            xSemaphoreGive(clients_lock);
+            vTaskDelay(1);
+            xSemaphoreTake(clients_lock, portMAX_DELAY);
+        }
+    }
+    xSemaphoreGive(clients_lock);
+}
+
+// The socket is closed by now and events_session_closing() has stopped the sends
+static void events_client_closed(void *ctx)
+{
+    sse_client_t *client = (sse_client_t *)ctx;
+
+    xSemaphoreTake(clients_lock, portMAX_DELAY);
+    client->active = false;
+    client->closing = false;
+    xSemaphoreGive(clients_lock);
+}
+
+esp_err_t events_start()
+{
+    if (events_task)
+    {
+        return ESP_OK;
+    }
+    clients_lock = xSemaphoreCreateMutex();
+    events_wake = xSemaphoreCreateBinary();
+    if (!clients_lock || !events_wake)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    if (xTaskCreatePinnedToCore(events_loop, "events", EVENTS_TASK_STACK, NULL, EVENTS_TASK_PRIORITY, &events_task, EVENTS_TASK_CORE) != pdPASS)
+    {
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+// Reserves a free slot. It stays invisible to the events task until park_client().
+static sse_client_t *claim_client()
+{
+    sse_client_t *client = NULL;
+
+    xSemaphoreTake(clients_lock, portMAX_DELAY);
+    for (int i = 0; i < EVENTS_MAX_CLIENTS; i++)
+    {
+        if (!clients[i].active && !clients[i].closing)
+        {
+            client = &clients[i];
+            client->closing = true; // Reserved
+            break;
+        }
+    }
+    xSemaphoreGive(clients_lock);
+    return client;
+}
+
+static void release_client(sse_client_t *client)
+{
+    xSemaphoreTake(clients_lock, portMAX_DELAY);
+    client->closing = false;
+    xSemaphoreGive(clients_lock);
+}
+
+// Hands the session over to the events task. httpd keeps the socket open
+// after the handler returns; events_session_closing() tells us when it goes away.
+static void park_client(sse_client_t *client, httpd_req_t *req)
+{
+    xSemaphoreTake(clients_lock, portMAX_DELAY);
+    client->hd = req->handle;
+    client->active = true;
+    client->closing = false;
+    req->sess_ctx = client;
+    req->free_ctx = events_client_closed;
+    xSemaphoreGive(clients_lock);
+    xSemaphoreGive(events_wake);
+}
+
+// Long-poll variant of /events. Answers right away when there is something
+// to report, otherwise parks the session for the events task to answer.
+static esp_err_t events_poll(httpd_req_t *req, uint32_t since, uint32_t timeout)
+{
+    event_t batch[EVENTS_POLL_MAX];
+
+    if (since > events_latest_seq())
+    {
+        since = 0; // The client saw a previous boot's numbering; replay what we have
+    }
+    size_t count = events_read(since, batch, EVENTS_POLL_MAX);
+    if (count > 0 || timeout == 0)
+    {
+        char *json = (char *)malloc(POLL_JSON_SIZE);
+        if (!json)
+        {
+            return httpd_resp_send_500(req);
+        }
+        int len = poll_to_json(batch, count, count ? batch[count - 1].seq : since, json, POLL_JSON_SIZE);
+        httpd_resp_set_type(req, _JSON_CONTENT_TYPE);
+        httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+        httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+        esp_err_t res = httpd_resp_send(req, json, len);
+        free(json);
+        return res;
+    }
+
+    sse_client_t *client = claim_client();
+    if (!client)
+    {
+        Serial.println("Events: too many clients");
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        return httpd_resp_send(req, NULL, 0);
+    }
+    client->writer.fd = httpd_req_to_sockfd(req);
+    client->long_poll = true;
+    client->deadline = esp_timer_get_time() + timeout * 1000LL;
+    client->last_seq = since;
+    park_client(client, req);
+    return ESP_OK;
+}
+
+esp_err_t events_handler(httpd_req_t *req)
+{
+    char query[64];
+    char value[16];
+    char lastEventId[16];
+
+    if (!events_task)
+    {
+        return httpd_resp_send_500(req);
+    }
+
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK)
+    {
+        bool longPoll = false;
+        uint32_t since = events_latest_seq();
+        uint32_t timeout = EVENTS_POLL_TIMEOUT_MS;
+        if (httpd_query_key_value(query, "since", value, sizeof(value)) == ESP_OK)
+        {
+            since = strtoul(value, NULL, 10);
+            longPoll = true;
+        }
+        if (httpd_query_key_value(query, "timeout", value, sizeof(value)) == ESP_OK)
+        {
+            timeout = strtoul(value, NULL, 10);
+            timeout = (timeout > EVENTS_POLL_MAX_TIMEOUT_MS) ? EVENTS_POLL_MAX_TIMEOUT_MS : timeout;
+            longPoll = true;
+        }
+        if (longPoll)
+        {
+            return events_poll(req, since, timeout);
+        }
+    }
+
+    sse_client_t *client = claim_client();
+    if (!client)
+    {
+        Serial.println("Events: too many clients");
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        return httpd_resp_send(req, NULL, 0);
+    }
+
+    // The slot is not active yet, so the events task leaves the socket alone while we write to it
+    esp_err_t res = stream_writer_begin(&client->writer, req, _SSE_CONTENT_TYPE, _SSE_PREAMBLE, strlen(_SSE_PREAMBLE));
+    if (res != ESP_OK)
+    {
+        release_client(client);
+        Serial.println("Events: failed to send HTTP response header");
+        return ESP_FAIL;
+    }
+
+    // A reconnecting EventSource resumes after the last event it saw
+    client->last_seq = events_latest_seq();
+    if (httpd_req_get_hdr_value_str(req, "Last-Event-ID", lastEventId, sizeof(lastEventId)) == ESP_OK)
+    {
+        uint32_t seq = strtoul(lastEventId, NULL, 10);
+        client->last_seq = (seq > client->last_seq) ? 0 : seq;
+    }
+    client->long_poll = false;
+    park_client(client, req);
+
+    Serial.println("Events: client connected");
+    return ESP_OK;
+}
@@ -0,0 +1,229 @@
+#include <Arduino.h>
+#include <esp_camera.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include "frame_broadcast.h"
+#include "metrics.h"
+#include "stream_config.h"
+#include "trace.h"
+
+typedef struct
+{
+    bool active;
+    SemaphoreHandle_t ready; // Given by the capture task for every new frame
+} subscriber_t;
+
+static frame_ring_t ring;
+
+// Viewers first, then the internal consumers
+static subscriber_t subscribers[FRAME_SUBSCRIBERS];
+static uint8_t subscriber_count = 0;
+
+static portMUX_TYPE subscriber_lock = portMUX_INITIALIZER_UNLOCKED;
+static SemaphoreHandle_t capture_wake = NULL;
+static TaskHandle_t capture_task = NULL;
+
+static void notify_subscribers()
+{
+    for (int i = 0; i < FRAME_SUBSCRIBERS; i++)
+    {
+        if (subscribers[i].active)
+        {
+            xSemaphoreGive(subscribers[i].ready);
+        }
+    }
+}
+
+static void capture_loop(void *arg)
+{
+    while (true)
+    {
+        if (subscriber_count == 0)
+        {
+            xSemaphoreTake(capture_wake, portMAX_DELAY);
+            continue;
+        }
+
+        int64_t waitStart = esp_timer_get_time();
+        TRACE_BEGIN("fb_get");
+        camera_fb_t *fb = esp_camera_fb_get();
+        TRACE_END("fb_get");
+        metrics_observe(&metrics.capture_wait, esp_timer_get_time() - waitStart);
+        if (!fb)
+        {
+            Serial.println("Capture: failed to acquire frame");
+            metrics_add(&metrics.capture_failures, 1);
+            delay(10);
+            continue;
+        }
+        if (fb->format != PIXFORMAT_JPEG)
+        {
+            Serial.println("Capture: Non-JPEG frame returned by camera module");
+            metrics_add(&metrics.capture_failures, 1);
+            esp_camera_fb_return(fb);
+            continue;
+        }
+        metrics_add(&metrics.capture_frames, 1);
+
+        // Copy out and return the driver buffer right away; a slow consumer
+        // only ever pins ring slots, never one of the driver's fb_count buffers
+        int64_t timestamp = esp_timer_get_time();
+        TRACE_BEGIN("frame_copy");
+        frame_slot_t *slot = frame_ring_begin_write(&ring, fb->len);
+        if (slot)
+        {
+            memcpy(slot->buf, fb->buf, fb->len);
+            slot->len = fb->len;
+        }
+        TRACE_END("frame_copy");
+        size_t width = fb->width;
+        size_t height = fb->height;
+        esp_camera_fb_return(fb);
+
+        if (slot)
+        {
+            frame_ring_commit(&ring, slot, width, height, timestamp);
+            notify_subscribers();
+        }
+    }
+}
+
+esp_err_t frame_broadcast_start()
+{
+    if (capture_task)
+    {
+        return ESP_OK;
+    }
+    esp_err_t res = frame_ring_init(&ring, FRAME_RING_SLOTS, FRAME_SLOT_SIZE);
+    if (res != ESP_OK)
+    {
+        Serial.println("Capture: failed to allocate frame ring");
+        return res;
+    }
+    capture_wake = xSemaphoreCreateBinary();
+    if (!capture_wake)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    for (int i = 0; i < FRAME_SUBSCRIBERS; i++)
+    {
+        subscribers[i].ready = xSemaphoreCreateBinary();
+        if (!subscribers[i].ready)
+        {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    if (xTaskCreatePinnedToCore(capture_loop, "capture", CAPTURE_TASK_STACK, NULL, CAPTURE_TASK_PRIORITY, &capture_task, CAPTURE_TASK_CORE) != pdPASS)
+    {
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+static int subscribe(int first, int end)
+{
+    int sub = -1;
+
+    portENTER_CRITICAL(&subscriber_lock);
+    for (int i = first; i < end; i++)
+    {
+        if (!subscribers[i].active)
+        {
+            subscribers[i].active = true;
+            subscriber_count++;
+            sub = i;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&subscriber_lock);
+
+    if (sub >= 0)
+    {
+        // Drop a wakeup left over from the previous owner of this slot
+        xSemaphoreTake(subscribers[sub].ready, 0);
+        xSemaphoreGive(capture_wake);
+    }
+    return sub;
+}
+
+int frame_broadcast_subscribe()
+{
+    return subscribe(0, STREAM_MAX_CLIENTS);
+}
+
+int frame_broadcast_subscribe_internal()
+{
+    return subscribe(STREAM_MAX_CLIENTS, FRAME_SUBSCRIBERS);
+}
+
+void frame_broadcast_unsubscribe(int sub)
+{
+    if (sub < 0 || sub >= FRAME_SUBSCRIBERS)
+    {
+        return;
+    }
+    portENTER_CRITICAL(&subscriber_lock);
+    if (subscribers[sub].active)
+    {
+        subscribers[sub].active = false;
+        subscriber_count--;
+    }
+    portEXIT_CRITICAL(&subscriber_lock);
+}
+
+frame_slot_t *frame_broadcast_acquire(int sub, uint32_t last_seq, TickType_t timeout)
+{
+    while (true)
+    {
+        frame_slot_t *frame = frame_ring_acquire(&ring, last_seq);
+        if (frame)
+        {
+            return frame;
+        }
+        if (xSemaphoreTake(subscribers[sub].ready, timeout) != pdTRUE)
+        {
+            return NULL;
+        }
+    }
+}
+
+frame_slot_t *frame_broadcast_latest(int64_t max_age_us, TickType_t timeout)
+{
+    frame_slot_t *frame = frame_ring_acquire_latest(&ring);
+    if (frame && esp_timer_get_time() - frame->timestamp <= max_age_us)
+    {
+        return frame;
+    }
+    // Anything committed after this seq is newer than the stale frame, or is the first one
+    uint32_t lastSeq = frame ? frame->seq : ring.seq;
+    frame_ring_release(&ring, frame);
+
+    int sub = frame_broadcast_subscribe_internal();
+    if (sub >= 0)
+    {
+        frame = frame_broadcast_acquire(sub, lastSeq, timeout);
+        frame_broadcast_unsubscribe(sub);
+        return frame;
+    }
+
+    // Every internal slot is taken, so the capture task is running anyway
+    TickType_t start = xTaskGetTickCount();
+    while (!(frame = frame_ring_acquire(&ring, lastSeq)) && xTaskGetTickCount() - start < timeout)
+    {
+        delay(5);
+    }
+    return frame;
+}
+
+void frame_broadcast_release(frame_slot_t *frame)
+{
+    frame_ring_release(&ring, frame);
+}
+
+frame_ring_t *frame_broadcast_ring()
+{
+    return &ring;
+}
@@ -0,0 +1,148 @@
+#include <esp_heap_caps.h>
+#include <string.h>
+
+#include "frame_ring.h"
+
+esp_err_t frame_ring_init(frame_ring_t *ring, uint8_t slot_count, size_t slot_size)
+{
+    memset(ring, 0, sizeof(*ring));
+    portMUX_INITIALIZE(&ring->lock);
+    ring->slots = (frame_slot_t *)heap_caps_calloc(slot_count, sizeof(frame_slot_t), MALLOC_CAP_8BIT);
+    if (!ring->slots)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    ring->slot_count = slot_count;
+
+    for (int i = 0; i < slot_count; i++)
+    {
+        frame_slot_t *slot = &ring->slots[i];
+        slot->buf = (uint8_t *)heap_caps_malloc(slot_size, MALLOC_CAP_SPIRAM);
+        if (!slot->buf)
+        {
+            // Leave the ring empty, not holding buffers it cannot use
+            while (--i >= 0)
+            {
+                heap_caps_free(ring->slots[i].buf);
+            }
+            heap_caps_free(ring->slots);
+            ring->slots = NULL;
+            ring->slot_count = 0;
+            return ESP_ERR_NO_MEM;
+        }
+        slot->capacity = slot_size;
+    }
+    return ESP_OK;
+}
+
+frame_slot_t *frame_ring_begin_write(frame_ring_t *ring, size_t len)
+{
+    frame_slot_t *slot = NULL;
+
+    // Prefer the oldest free slot so consumers that just let go of a frame
+    // are not racing the producer on the same buffer
+    portENTER_CRITICAL(&ring->lock);
+    for (int i = 0; i < ring->slot_count; i++)
+    {
+        frame_slot_t *candidate = &ring->slots[i];
+        if (candidate->refs == 0 && (!slot || candidate->seq < slot->seq))
+        {
+            slot = candidate;
+        }
+    }
+    if (slot)
+    {
+        slot->refs = 1;
+    }
+    else
+    {
+        ring->dropped++;
+    }
+    portEXIT_CRITICAL(&ring->lock);
+
+    if (slot && slot->capacity < len)
+    {
+        uint8_t *buf = (uint8_t *)heap_caps_realloc(slot->buf, len, MALLOC_CAP_SPIRAM);
+        if (!buf)
+        {
+            frame_ring_abort(ring, slot);
+            portENTER_CRITICAL(&ring->lock);
+            ring->dropped++;
+            portEXIT_CRITICAL(&ring->lock);
+            return NULL;
+        }
+        slot->buf = buf;
+        slot->capacity = len;
+    }
+    return slot;
+}
+
+void frame_ring_commit(frame_ring_t *ring, frame_slot_t *slot, size_t width, size_t height, int64_t timestamp)
+{
+    slot->width = width;
+    slot->height = height;
+    slot->timestamp = timestamp;
+    slot->consumed = false;
+
+    portENTER_CRITICAL(&ring->lock);
+    slot->seq = ++ring->seq;
+    frame_slot_t *previous = ring->latest;
+    ring->latest = slot;
+    if (previous)
+    {
+        if (!previous->consumed)
+        {
+            ring->overruns++;
+        }
+        previous->refs--;
+    }
+    portEXIT_CRITICAL(&ring->lock);
+}
+
+void frame_ring_abort(frame_ring_t *ring, frame_slot_t *slot)
+{
+    portENTER_CRITICAL(&ring->lock);
+    slot->refs--;
+    portEXIT_CRITICAL(&ring->lock);
+}
+
+frame_slot_t *frame_ring_acquire(frame_ring_t *ring, uint32_t last_seq)
+{
+    frame_slot_t *slot = NULL;
+
+    portENTER_CRITICAL(&ring->lock);
+    if (ring->latest && ring->latest->seq != last_seq)
+    {
+        slot = ring->latest;
+        slot->refs++;
+        slot->consumed = true;
+    }
+    portEXIT_CRITICAL(&ring->lock);
+    return slot;
+}
+
+frame_slot_t *frame_ring_acquire_latest(frame_ring_t *ring)
+{
+    frame_slot_t *slot = NULL;
+
+    portENTER_CRITICAL(&ring->lock);
+    if (ring->latest)
+    {
+        slot = ring->latest;
+        slot->refs++;
+        slot->consumed = true;
+    }
+    portEXIT_CRITICAL(&ring->lock);
+    return slot;
+}
+
+void frame_ring_release(frame_ring_t *ring, frame_slot_t *slot)
+{
+    if (!slot)
+    {
+        return;
+    }
+    portENTER_CRITICAL(&ring->lock);
+    slot->refs--;
+    portEXIT_CRITICAL(&ring->lock);
+}
@@ -0,0 +1,493 @@
+#include <string.h>
+
+#include "jpeg_dc.h"
+
+#define MARKER_SOF0 0xC0
+#define MARKER_SOF1 0xC1
+#define MARKER_SOF2 0xC2
+#define MARKER_DHT 0xC4
+#define MARKER_RST0 0xD0
+#define MARKER_RST7 0xD7
+#define MARKER_SOI 0xD8
+#define MARKER_EOI 0xD9
+#define MARKER_SOS 0xDA
+#define MARKER_DQT 0xDB
+#define MARKER_DRI 0xDD
+
+typedef struct
+{
+    uint8_t id;
+    uint8_t h, v; // Sampling factors
+    uint8_t quant;
+    uint8_t dc_table, ac_table;
+    int32_t pred; // DC predictor
+} component_t;
+
+// MSB-first bit buffer over the entropy-coded segment. Byte stuffing is
+// removed on the fly; at a marker it stops consuming input and feeds zeros.
+typedef struct
+{
+    const uint8_t *p;
+    const uint8_t *end;
+    uint32_t bits;
+    int count;
+    bool marker;
+} bit_reader_t;
+
+static inline uint16_t get_u16(const uint8_t *p)
+{
+    return (p[0] << 8) | p[1];
+}
+
+static inline void fill(bit_reader_t *br)
+{
+    while (br->count <= 24)
+    {
+        uint32_t byte = 0;
+        if (!br->marker && br->p < br->end)
+        {
+            byte = *br->p++;
+            if (byte == 0xFF)
+            {
+                if (br->p < br->end && *br->p == 0x00)
+                {
+                    br->p++;
+                }
+                else
+                {
+                    br->marker = true;
+                    br->p--;
+                    byte = 0;
+                }
+            }
+        }
+        br->bits |= byte << (24 - br->count);
+        br->count += 8;
+    }
+}
+
+static inline void consume(bit_reader_t *br, int n)
+{
+    br->bits <<= n;
+    br->count -= n;
+}
+
+static inline int32_t get_bits(bit_reader_t *br, int n)
+{
+    fill(br);
+    int32_t value = br->bits >> (32 - n);
+    consume(br, n);
+    return value;
+}
+
+// Turns an n bit magnitude category value into a signed coefficient (F.2.2.1)
+static inline int32_t extend(int32_t value, int n)
+{
+    return (value < (1 << (n - 1))) ? value - (1 << n) + 1 : value;
+}
+
+static int decode_symbol(bit_reader_t *br, const jpeg_huffman_t *table)
+{
+    fill(br);
+    uint32_t look = br->bits >> (32 - JPEG_DC_LOOKUP_BITS);
+    int len = table->lookup_len[look];
+    if (len)
+    {
+        consume(br, len);
+        return table->lookup_val[look];
+    }
+
+    uint32_t code16 = br->bits >> 16;
+    for (len = JPEG_DC_LOOKUP_BITS + 1; len <= 16; len++)
+    {
+        int32_t code = code16 >> (16 - len);
+        if (code <= table->maxcode[len])
+        {
+            consume(br, len);
+            return table->values[code + table->valoffset[len]];
+        }
+    }
+    return -1;
+}
+
+static esp_err_t build_table(jpeg_huffman_t *table, const uint8_t *counts, const uint8_t *values, int total)
+{
+    memset(table->lookup_len, 0, sizeof(table->lookup_len));
+    memset(table->lookup_skip, 0, sizeof(table->lookup_skip));
+    memcpy(table->values, values, total);
+
+    int32_t code = 0;
+    int k = 0;
+    for (int len = 1; len <= 16; len++)
+    {
+        table->valoffset[len] = k - code;
+        for (int i = 0; i < counts[len - 1]; i++, code++, k++)
+        {
+            if (code >= (1 << len))
+            {
+                return ESP_ERR_INVALID_ARG;
+            }
+            if (len <= JPEG_DC_LOOKUP_BITS)
+            {
+                int shift = JPEG_DC_LOOKUP_BITS - len;
+                int skip = len + (values[k] & 0x0F);
+                for (int j = 0; j < (1 << shift); j++)
+                {
+                    table->lookup_len[(code << shift) | j] = len;
+                    table->lookup_val[(code << shift) | j] = values[k];
+                    table->lookup_skip[(code << shift) | j] = (skip <= JPEG_DC_LOOKUP_BITS) ? skip : 0;
+                }
+            }
+        }
+        table->maxcode[len] = counts[len - 1] ? code - 1 : -1;
+        code <<= 1;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t parse_dht(jpeg_dc_decoder_t *decoder, const uint8_t *seg, size_t len)
+{
+    while (len >= 17)
+    {
+        int tc = seg[0] >> 4;
+        int th = seg[0] & 0x0F;
+        int total = 0;
+        for (int i = 1; i <= 16; i++)
+        {
+            total += seg[i];
+        }
+        if (tc > 1 || th > 1 || total > 256 || len < 17 + (size_t)total)
+        {
+            return ESP_ERR_NOT_SUPPORTED;
+        }
+        jpeg_huffman_t *table = tc ? &decoder->ac_tables[th] : &decoder->dc_tables[th];
+        esp_err_t res = build_table(table, seg + 1, seg + 17, total);
+        if (res != ESP_OK)
+        {
+            return res;
+        }
+        seg += 17 + total;
+        len -= 17 + total;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t parse_dqt(jpeg_dc_decoder_t *decoder, const uint8_t *seg, size_t len)
+{
+    while (len >= 65)
+    {
+        int pq = seg[0] >> 4;
+        int tq = seg[0] & 0x03;
+        size_t size = 1 + (pq ? 128 : 64);
+        if (len < size)
+        {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        decoder->quant[tq] = pq ? get_u16(seg + 1) : seg[1];
+        seg += size;
+        len -= size;
+    }
+    return ESP_OK;
+}
+
+// Decodes one block, leaving its DC coefficient in comp->pred.
+static esp_err_t decode_block(bit_reader_t *br, jpeg_dc_decoder_t *decoder, component_t *comp)
+{
+    int s = decode_symbol(br, &decoder->dc_tables[comp->dc_table]);
+    if (s < 0 || s > 11)
+    {
+        return ESP_FAIL;
+    }
+    if (s)
+    {
+        comp->pred += extend(get_bits(br, s), s);
+    }
+
+    const jpeg_huffman_t *ac = &decoder->ac_tables[comp->ac_table];
+    for (int k = 1; k < 64;)
+    {
+        // Most AC codes and their coefficient bits fit in one lookup and are dropped in a single step
+        fill(br);
+        uint32_t look = br->bits >> (32 - JPEG_DC_LOOKUP_BITS);
+        int skip = ac->lookup_skip[look];
+        int rs = ac->lookup_val[look];
+        if (skip && (rs & 0x0F))
+        {
+            consume(br, skip);
+            k += (rs >> 4) + 1;
+            continue;
+        }
+        rs = decode_symbol(br, ac);
+        if (rs < 0)
+        {
+            return ESP_FAIL;
+        }
+        int r = rs >> 4;
+        s = rs & 0x0F;
+        if (s)
+        {
+            fill(br);
+            consume(br, s);
+            k += r + 1;
+        }
+        else if (r == 15)
+        {
+            k += 16;
+        }
+        else
+        {
+            break; // End of block
+        }
+    }
+    return ESP_OK;
+}
+
+static void restart(bit_reader_t *br, component_t *comps, int count)
+{
+    // Skip whatever is left of the segment and the RSTn marker itself
+    const uint8_t *p = br->p;
+    while (p + 1 < br->end && !(p[0] == 0xFF && p[1] >= MARKER_RST0 && p[1] <= MARKER_RST7))
+    {
+        p++;
+    }
+    br->p = (p + 1 < br->end) ? p + 2 : br->end;
+    br->bits = 0;
+    br->count = 0;
+    br->marker = false;
+    for (int i = 0; i < count; i++)
+    {
+        comps[i].pred = 0;
+    }
+}
+
+esp_err_t jpeg_dc_decode(jpeg_dc_decoder_t *decoder, const uint8_t *jpg, size_t len,
+                         uint8_t *out, size_t out_size, uint16_t *width, uint16_t *height)
+{
+    component_t comps[JPEG_DC_MAX_COMPONENTS];
+    int compCount = 0;
+    uint16_t imageWidth = 0, imageHeight = 0;
+    uint16_t restartInterval = 0;
+
+    if (len < 4 || jpg[0] != 0xFF || jpg[1] != MARKER_SOI)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const uint8_t *p = jpg + 2;
+    const uint8_t *end = jpg + len;
+    bool scanFound = false;
+    while (!scanFound)
+    {
+        if (p + 4 > end || p[0] != 0xFF)
+        {
+            return ESP_ERR_INVALID_ARG;
+        }
+        uint8_t marker = p[1];
+        if (marker == 0xFF)
+        {
+            p++; // Fill byte
+            continue;
+        }
+        p += 2;
+        if (marker == MARKER_SOI || (marker >= MARKER_RST0 && marker <= MARKER_RST7))
+        {
+            continue;
+        }
+        if (marker == MARKER_EOI)
+        {
+            return ESP_ERR_INVALID_ARG;
+        }
+
+        size_t segLen = get_u16(p);
+        if (segLen < 2 || p + segLen > end)
+        {
+            return ESP_ERR_INVALID_ARG;
+        }
+        const uint8_t *seg = p + 2;
+        segLen -= 2;
+        p += segLen + 2;
+
+        esp_err_t res = ESP_OK;
+        switch (marker)
+        {
+        case MARKER_DQT:
+            res = parse_dqt(decoder, seg, segLen);
+            break;
+        case MARKER_DHT:
+            res = parse_dht(decoder, seg, segLen);
+            break;
+        case MARKER_DRI:
+            restartInterval = segLen >= 2 ? get_u16(seg) : 0;
+            break;
+        case MARKER_SOF0:
+        case MARKER_SOF1:
+            if (segLen < 6)
+            {
+                return ESP_ERR_INVALID_ARG;
+            }
+            compCount = seg[5];
+            if (seg[0] != 8 || compCount < 1 || compCount > JPEG_DC_MAX_COMPONENTS || segLen < 6 + 3 * (size_t)compCount)
+            {
+                return ESP_ERR_NOT_SUPPORTED;
+            }
+            imageHeight = get_u16(seg + 1);
+            imageWidth = get_u16(seg + 3);
+            if (imageWidth == 0 || imageHeight == 0)
+            {
+                return ESP_ERR_INVALID_ARG; // A height of 0 would leave it to a DNL marker, which no camera sends
+            }
+            for (int i = 0; i < compCount; i++)
+            {
+                const uint8_t *c = seg + 6 + 3 * i;
+                comps[i].id = c[0];
+                comps[i].h = c[1] >> 4;
+                comps[i].v = c[1] & 0x0F;
+                comps[i].quant = c[2] & 0x03;
+                comps[i].pred = 0;
+                if (comps[i].h < 1 || comps[i].h > 2 || comps[i].v < 1 || comps[i].v > 2)
+                {
+                    return ESP_ERR_NOT_SUPPORTED;
+                }
+            }
+            break;
+        case MARKER_SOS:
+            if (compCount == 0 || segLen < 1 || seg[0] != compCount || segLen < 1 + 2 * (size_t)compCount)
+            {
+                // Only single-scan images are handled: all components interleaved in one scan
+                return ESP_ERR_NOT_SUPPORTED;
+            }
+            for (int i = 0; i < compCount; i++)
+            {
+                const uint8_t *c = seg + 1 + 2 * i;
+                if (c[0] != comps[i].id || (c[1] >> 4) > 1 || (c[1] & 0x0F) > 1)
+                {
+                    return ESP_ERR_NOT_SUPPORTED;
+                }
+                comps[i].dc_table = c[1] >> 4;
+                comps[i].ac_table = c[1] & 0x0F;
+            }
+            scanFound = true; // Entropy-coded data starts right after the SOS segment
+            break;
+        default:
+            if (marker >= MARKER_SOF2 && marker <= 0xCF && marker != MARKER_DHT && marker != 0xC8 && marker != 0xCC)
+            {
+                return ESP_ERR_NOT_SUPPORTED; // Progressive, lossless or arithmetic coded
+            }
+            break;
+        }
+        if (res != ESP_OK)
+        {
+            return res;
+        }
+    }
+
+    // A lone component is coded one block per MCU whatever its sampling factors
+    if (compCount == 1)
+    {
+        comps[0].h = comps[0].v = 1;
+    }
+    int hmax = 1, vmax = 1;
+    for (int i = 0; i < compCount; i++)
+    {
+        hmax = comps[i].h > hmax ? comps[i].h : hmax;
+        vmax = comps[i].v > vmax ? comps[i].v : vmax;
+    }
+    if (comps[0].h != hmax || comps[0].v != vmax)
+    {
+        return ESP_ERR_NOT_SUPPORTED; // Luma is expected at full resolution
+    }
+
+    int blocksX = (imageWidth + 7) / 8;
+    int blocksY = (imageHeight + 7) / 8;
+    int mcusX = (imageWidth + 8 * hmax - 1) / (8 * hmax);
+    int mcusY = (imageHeight + 8 * vmax - 1) / (8 * vmax);
+    if ((size_t)blocksX * blocksY > out_size)
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    // DC is eight times the block mean, level shifted by 128
+    int32_t dcScale = decoder->quant[comps[0].quant];
+
+    bit_reader_t br = {.p = p, .end = end, .bits = 0, .count = 0, .marker = false};
+    int mcusLeft = restartInterval;
+    for (int my = 0; my < mcusY; my++)
+    {
+        for (int mx = 0; mx < mcusX; mx++)
+        {
+            if (restartInterval)
+            {
+                if (mcusLeft == 0)
+                {
+                    restart(&br, comps, compCount);
+                    mcusLeft = restartInterval;
+                }
+                mcusLeft--;
+            }
+            for (int c = 0; c < compCount; c++)
+            {
+                component_t *comp = &comps[c];
+                for (int by = 0; by < comp->v; by++)
+                {
+                    for (int bx = 0; bx < comp->h; bx++)
+                    {
+                        if (decode_block(&br, decoder, comp) != ESP_OK)
+                        {
+                            return ESP_FAIL;
+                        }
+                        if (c != 0)
+                        {
+                            continue;
+                        }
+                        int x = mx * comp->h + bx;
+                        int y = my * comp->v + by;
+                        if (x < blocksX && y < blocksY)
+                        {
+                            int32_t value = ((comp->pred * dcScale) >> 3) + 128;
+                            out[y * blocksX + x] = value < 0 ? 0 : value > 255 ? 255 : value;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    *width = blocksX;
+    *height = blocksY;
+    return ESP_OK;
+}
+
+esp_err_t jpeg_dc_size(const uint8_t *jpg, size_t len, uint16_t *width, uint16_t *height)
+{
+    if (len < 4 || jpg[0] != 0xFF || jpg[1] != MARKER_SOI)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const uint8_t *p = jpg + 2;
+    const uint8_t *end = jpg + len;
+    while (p + 4 <= end && p[0] == 0xFF)
+    {
+        uint8_t marker = p[1];
+        if (marker == 0xFF || marker == MARKER_SOI)
+        {
+            p += (marker == 0xFF) ? 1 : 2;
+            continue;
+        }
+        if (marker == MARKER_SOS || marker == MARKER_EOI)
+        {
+            break;
+        }
+        size_t segLen = get_u16(p + 2);
+        if (marker >= MARKER_SOF0 && marker <= 0xCF && marker != MARKER_DHT && marker != 0xC8 && marker != 0xCC)
+        {
+            if (segLen < 7 || p + 2 + segLen > end)
+            {
+                break;
+            }
+            *height = get_u16(p + 5);
+            *width = get_u16(p + 7);
+            return ESP_OK;
+        }
+        p += 2 + segLen;
+    }
+    return ESP_ERR_NOT_FOUND;
+}
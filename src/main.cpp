@@ -5,7 +5,20 @@
 
 #include "wifi_config.h"
 #include "esp32_cam_pins.h"
+#include "audio_capture.h"
 #include "audio_config.h"
+#include "catalog.h"
+#include "events.h"
+#include "frame_broadcast.h"
+#include "motion_detect.h"
+#include "pir.h"
+#include "playback.h"
+#include "record_config.h"
+#include "recorder.h"
+#include "retention.h"
+#include "storage.h"
+#include "substream.h"
+#include "ws_mux.h"
 
 #define CAMERA_MODEL_AI_THINKER
 
@@ -14,6 +27,7 @@ esp_err_t mic_i2s_init();
 void wifi_setup();
 void start_camera_server(uint16_t, uint16_t, uint16_t);
 
+QueueHandle_t i2sEvents = NULL;
 IPAddress ip;
 IPAddress gateway;
 IPAddress subnet;
@@ -24,8 +38,31 @@ void setup()
   pinMode(LED_PIN, OUTPUT);
   pinMode(GPIO_13, INPUT);
   wifi_setup();
+  configTime(0, 0, NTP_SERVER);
   camera_init();
-  mic_i2s_init();
+  frame_broadcast_start();
+  motion_detect_start();
+  substream_start();
+  events_start();
+  ws_mux_start();
+  pir_start();
+#if STORAGE_ENABLED
+  static clip_sink_t clipSink;
+  static clip_avi_sink_t clipAvi;
+  if (storage_mount() == ESP_OK)
+  {
+    catalog_init();
+    retention_start();
+    clip_avi_sink_init(&clipSink, &clipAvi, CLIP_DIR);
+    recorder_start(&clipSink);
+    playback_start();
+  }
+#else
+  if (mic_i2s_init() == ESP_OK)
+  {
+    audio_capture_start(i2sEvents);
+  }
+#endif
   start_camera_server(80, STREAM_PORT, AUDIO_PORT);
 }
 
@@ -82,7 +119,8 @@ esp_err_t mic_i2s_init()
       .dma_buf_count = DMA_BUF_COUNT,
       .dma_buf_len = DMA_BUF_LEN,
       .use_apll = false};
-  res = i2s_driver_install(I2S_PORT, &i2sConfig, 0, NULL);
+  // The event queue is only read for I2S_EVENT_RX_Q_OVF, to count dropped DMA buffers
+  res = i2s_driver_install(I2S_PORT, &i2sConfig, DMA_BUF_COUNT * 2, &i2sEvents);
   if (res == ESP_OK)
   {
     i2s_pin_config_t pinConfig = {
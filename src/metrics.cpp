@@ -0,0 +1,336 @@
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <esp_http_server.h>
+#include <esp_timer.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "audio_capture.h"
+#include "frame_broadcast.h"
+#include "metrics.h"
+#include "stream_pool.h"
+#include "substream.h"
+
+#define METRICS_PREFIX "esp32cam_"
+
+typedef struct
+{
+    bool claimed; // By a client, under slot_lock
+    bool active;  // Set last, once the rest is ready for the renderer
+    const char *stream;
+    int64_t started;
+    metrics_counter_t frames;
+    metrics_counter_t bytes;
+    metrics_histogram_t send;
+} stream_slot_t;
+
+typedef struct
+{
+    httpd_req_t *req;
+    char buf[METRICS_CHUNK_SIZE];
+    size_t len;
+    esp_err_t res;
+} metrics_writer_t;
+
+metrics_t metrics = {};
+
+static const uint32_t bucket_us[METRICS_BUCKETS] = {1000, 2000, 5000, 10000, 20000, 50000, 100000, 200000, 500000, 1000000};
+
+static stream_slot_t stream_slots[METRICS_STREAM_SLOTS];
+static portMUX_TYPE slot_lock = portMUX_INITIALIZER_UNLOCKED;
+static portMUX_TYPE fold_lock = portMUX_INITIALIZER_UNLOCKED; // Between folds and slot resets, never the hot path
+
+void metrics_observe(metrics_histogram_t *histogram, uint32_t us)
+{
+    int i = 0;
+    while (i < METRICS_BUCKETS && us > bucket_us[i])
+    {
+        i++;
+    }
+    metrics_add(&histogram->buckets[i], 1);
+    metrics_add(&histogram->sum_us, us);
+}
+
+int metrics_stream_open(const char *stream)
+{
+    int slot = -1;
+
+    portENTER_CRITICAL(&slot_lock);
+    for (int i = 0; i < METRICS_STREAM_SLOTS; i++)
+    {
+        if (!stream_slots[i].claimed)
+        {
+            stream_slots[i].claimed = true;
+            slot = i;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&slot_lock);
+
+    if (slot >= 0)
+    {
+        stream_slot_t *s = &stream_slots[slot];
+        // A fold of the previous client's counters may still be under way
+        portENTER_CRITICAL(&fold_lock);
+        memset(&s->frames, 0, sizeof(s->frames));
+        memset(&s->bytes, 0, sizeof(s->bytes));
+        memset(&s->send, 0, sizeof(s->send));
+        portEXIT_CRITICAL(&fold_lock);
+        s->stream = stream;
+        s->started = esp_timer_get_time();
+        portENTER_CRITICAL(&slot_lock);
+        s->active = true;
+        portEXIT_CRITICAL(&slot_lock);
+    }
+    return slot;
+}
+
+void metrics_stream_sent(int slot, size_t bytes, uint32_t us)
+{
+    metrics_add(&metrics.stream_frames, 1);
+    metrics_add(&metrics.stream_bytes, bytes);
+    if (slot < 0)
+    {
+        return;
+    }
+    metrics_add(&stream_slots[slot].frames, 1);
+    metrics_add(&stream_slots[slot].bytes, bytes);
+    metrics_observe(&stream_slots[slot].send, us);
+}
+
+void metrics_stream_close(int slot)
+{
+    if (slot < 0)
+    {
+        return;
+    }
+    portENTER_CRITICAL(&slot_lock);
+    stream_slots[slot].active = false;
+    stream_slots[slot].claimed = false;
+    portEXIT_CRITICAL(&slot_lock);
+}
+
+// Folds the per-core cells into the 64-bit total
+static uint64_t fold(metrics_counter_t *counter)
+{
+    uint32_t sum = 0;
+    portENTER_CRITICAL(&fold_lock);
+    for (int i = 0; i < METRICS_CORES; i++)
+    {
+        sum += __atomic_load_n(&counter->cells[i], __ATOMIC_RELAXED);
+    }
+    counter->total += (uint32_t)(sum - counter->seen);
+    counter->seen = sum;
+    uint64_t total = counter->total;
+    portEXIT_CRITICAL(&fold_lock);
+    return total;
+}
+
+static void fold_histogram(metrics_histogram_t *histogram)
+{
+    for (int i = 0; i <= METRICS_BUCKETS; i++)
+    {
+        fold(&histogram->buckets[i]);
+    }
+    fold(&histogram->sum_us);
+}
+
+void metrics_fold()
+{
+    fold(&metrics.capture_frames);
+    fold(&metrics.capture_failures);
+    fold_histogram(&metrics.capture_wait);
+    fold(&metrics.stream_frames);
+    fold(&metrics.stream_bytes);
+    fold(&metrics.audio_bytes);
+    fold(&metrics.i2s_overruns);
+    for (int i = 0; i < METRICS_STREAM_SLOTS; i++)
+    {
+        stream_slot_t *s = &stream_slots[i];
+        if (s->active)
+        {
+            fold(&s->frames);
+            fold(&s->bytes);
+            fold_histogram(&s->send);
+        }
+    }
+}
+
+static void flush(metrics_writer_t *w)
+{
+    if (w->res == ESP_OK && w->len)
+    {
+        w->res = httpd_resp_send_chunk(w->req, w->buf, w->len);
+    }
+    w->len = 0;
+}
+
+static void emit(metrics_writer_t *w, const char *format, ...)
+{
+    va_list args;
+
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+        va_start(args, format);
+        int n = vsnprintf(w->buf + w->len, sizeof(w->buf) - w->len, format, args);
+        va_end(args);
+        if (n >= 0 && (size_t)n < sizeof(w->buf) - w->len)
+        {
+            w->len += n;
+            return;
+        }
+        // Did not fit behind what is already there; send that and retry on an empty buffer
+        flush(w);
+    }
+}
+
+static void emit_header(metrics_writer_t *w, const char *name, const char *type, const char *help)
+{
+    emit(w, "# HELP " METRICS_PREFIX "%s %s\n# TYPE " METRICS_PREFIX "%s %s\n", name, help, name, type);
+}
+
+static void emit_counter(metrics_writer_t *w, const char *name, const char *help, metrics_counter_t *counter)
+{
+    emit_header(w, name, "counter", help);
+    emit(w, METRICS_PREFIX "%s %llu\n", name, (unsigned long long)fold(counter));
+}
+
+// A value kept elsewhere; type is "counter" for the cumulative ones
+static void emit_value(metrics_writer_t *w, const char *name, const char *type, const char *help, uint64_t value)
+{
+    emit_header(w, name, type, help);
+    emit(w, METRICS_PREFIX "%s %llu\n", name, (unsigned long long)value);
+}
+
+// labels is empty or a list such as client="0",stream="main" without braces
+static void emit_histogram(metrics_writer_t *w, const char *name, const char *labels, metrics_histogram_t *h)
+{
+    const char *sep = labels[0] ? "," : "";
+    uint64_t count = 0;
+
+    for (int i = 0; i <= METRICS_BUCKETS; i++)
+    {
+        count += fold(&h->buckets[i]);
+        if (i < METRICS_BUCKETS)
+        {
+            emit(w, METRICS_PREFIX "%s_bucket{%s%sle=\"%u.%06u\"} %llu\n", name, labels, sep,
+                 bucket_us[i] / 1000000, bucket_us[i] % 1000000, (unsigned long long)count);
+        }
+        else
+        {
+            emit(w, METRICS_PREFIX "%s_bucket{%s%sle=\"+Inf\"} %llu\n", name, labels, sep, (unsigned long long)count);
+        }
+    }
+    const char *open = labels[0] ? "{" : "";
+    const char *close = labels[0] ? "}" : "";
+    uint64_t sum = fold(&h->sum_us);
+    emit(w, METRICS_PREFIX "%s_sum%s%s%s %llu.%06llu\n", name, open, labels, close,
+         (unsigned long long)(sum / 1000000), (unsigned long long)(sum % 1000000));
+    emit(w, METRICS_PREFIX "%s_count%s%s%s %llu\n", name, open, labels, close, (unsigned long long)count);
+}
+
+static void emit_streams(metrics_writer_t *w)
+{
+    char labels[48];
+    int64_t now = esp_timer_get_time();
+
+    emit_counter(w, "stream_frames_total", "Frames sent to stream clients.", &metrics.stream_frames);
+    emit_counter(w, "stream_bytes_total", "Bytes sent to stream clients.", &metrics.stream_bytes);
+
+    emit_header(w, "stream_client_frames_total", "counter", "Frames sent to a connected stream client.");
+    emit_header(w, "stream_client_bytes_total", "counter", "Bytes sent to a connected stream client.");
+    emit_header(w, "stream_client_fps", "gauge", "Frames per second a connected stream client got since it connected.");
+    emit_header(w, "stream_client_send_seconds", "histogram", "Time taken to write one frame to a stream client's socket.");
+    for (int i = 0; i < METRICS_STREAM_SLOTS; i++)
+    {
+        stream_slot_t *s = &stream_slots[i];
+        if (!s->active)
+        {
+            continue;
+        }
+        snprintf(labels, sizeof(labels), "client=\"%d\",stream=\"%s\"", i, s->stream);
+        uint64_t frames = fold(&s->frames);
+        int64_t elapsed = now - s->started;
+        uint32_t centiFps = elapsed > 0 ? frames * 100000000ULL / elapsed : 0;
+        emit(w, METRICS_PREFIX "stream_client_frames_total{%s} %llu\n", labels, (unsigned long long)frames);
+        emit(w, METRICS_PREFIX "stream_client_bytes_total{%s} %llu\n", labels, (unsigned long long)fold(&s->bytes));
+        emit(w, METRICS_PREFIX "stream_client_fps{%s} %u.%02u\n", labels, centiFps / 100, centiFps % 100);
+        emit_histogram(w, "stream_client_send_seconds", labels, &s->send);
+    }
+}
+
+static void emit_system(metrics_writer_t *w)
+{
+    emit_value(w, "uptime_seconds", "gauge", "Time since boot.", esp_timer_get_time() / 1000000);
+    emit_value(w, "heap_free_bytes", "gauge", "Free internal heap.", heap_caps_get_free_size(MALLOC_CAP_INTERNAL));
+    emit_value(w, "heap_min_free_bytes", "gauge", "Lowest free internal heap since boot.", heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL));
+    emit_value(w, "heap_largest_free_block_bytes", "gauge", "Largest allocatable internal block.", heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL));
+    emit_value(w, "psram_free_bytes", "gauge", "Free PSRAM.", heap_caps_get_free_size(MALLOC_CAP_SPIRAM));
+    emit_value(w, "psram_min_free_bytes", "gauge", "Lowest free PSRAM since boot.", heap_caps_get_minimum_free_size(MALLOC_CAP_SPIRAM));
+    emit_value(w, "stream_workers_busy", "gauge", "Stream pool workers serving a client.", stream_pool_busy());
+
+    emit_header(w, "stream_worker_stack_free_bytes", "gauge", "Least stack a stream pool worker has had to spare.");
+    for (int i = 0; i < STREAM_WORKERS; i++)
+    {
+        int free = stream_pool_stack_free(i);
+        if (free >= 0)
+        {
+            emit(w, METRICS_PREFIX "stream_worker_stack_free_bytes{worker=\"%d\"} %d\n", i, free);
+        }
+    }
+}
+
+esp_err_t metrics_handler(httpd_req_t *req)
+{
+    metrics_writer_t w;
+    audio_capture_stats_t audio;
+    substream_stats_t sub;
+
+    w.req = req;
+    w.len = 0;
+    w.res = ESP_OK;
+    httpd_resp_set_type(req, "text/plain; version=0.0.4");
+
+    emit_counter(&w, "capture_frames_total", "Frames taken from the camera driver.", &metrics.capture_frames);
+    emit_counter(&w, "capture_failures_total", "Grabs that returned no frame or a non-JPEG one.", &metrics.capture_failures);
+    emit_header(&w, "capture_wait_seconds", "histogram", "Time spent waiting in esp_camera_fb_get().");
+    emit_histogram(&w, "capture_wait_seconds", "", &metrics.capture_wait);
+
+    frame_ring_t *ring = frame_broadcast_ring();
+    emit_value(&w, "frame_ring_dropped_total", "counter", "Frames dropped because no ring slot was free.", ring->dropped);
+    emit_value(&w, "frame_ring_overruns_total", "counter", "Frames replaced before any consumer took them.", ring->overruns);
+
+    emit_streams(&w);
+
+    substream_get_stats(&sub);
+    emit_value(&w, "substream_frames_total", "counter", "Frames re-encoded for the substream.", sub.frames);
+    emit_value(&w, "substream_errors_total", "counter", "Substream frames that failed to decode or did not fit a slot.", sub.errors);
+    emit(&w, "# HELP " METRICS_PREFIX "substream_frame_seconds Decode and encode time of the last substream frame.\n"
+             "# TYPE " METRICS_PREFIX "substream_frame_seconds gauge\n"
+             METRICS_PREFIX "substream_frame_seconds{step=\"decode\"} %u.%06u\n"
+             METRICS_PREFIX "substream_frame_seconds{step=\"encode\"} %u.%06u\n",
+         sub.decode_us / 1000000, sub.decode_us % 1000000, sub.encode_us / 1000000, sub.encode_us % 1000000);
+    emit(&w, "# HELP " METRICS_PREFIX "substream_step_seconds_total Decode and encode time of all substream frames.\n"
+             "# TYPE " METRICS_PREFIX "substream_step_seconds_total counter\n"
+             METRICS_PREFIX "substream_step_seconds_total{step=\"decode\"} %llu.%06llu\n"
+             METRICS_PREFIX "substream_step_seconds_total{step=\"encode\"} %llu.%06llu\n",
+         (unsigned long long)(sub.decode_us_total / 1000000), (unsigned long long)(sub.decode_us_total % 1000000),
+         (unsigned long long)(sub.encode_us_total / 1000000), (unsigned long long)(sub.encode_us_total % 1000000));
+
+    audio_capture_get_stats(&audio);
+    emit_counter(&w, "audio_bytes_total", "Bytes read from I2S.", &metrics.audio_bytes);
+    emit_counter(&w, "audio_i2s_overruns_total", "DMA buffers the I2S driver dropped because reads fell behind.", &metrics.i2s_overruns);
+    emit_value(&w, "audio_read_errors_total", "counter", "Failed or empty i2s_read() calls.", audio.read_errors);
+    emit_value(&w, "audio_listener_overruns_total", "counter", "Times an audio listener fell a full ring behind.", audio.overruns);
+    emit_value(&w, "audio_listeners", "gauge", "Attached audio listeners.", audio.listeners);
+
+    emit_system(&w);
+
+    flush(&w);
+    if (w.res != ESP_OK)
+    {
+        return ESP_FAIL;
+    }
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
@@ -0,0 +1,253 @@
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <string.h>
+
+#include "events.h"
+#include "frame_broadcast.h"
+#include "jpeg_dc.h"
+#include "motion_detect.h"
+#include "stream_config.h"
+
+static motion_state_t state = {.enabled = true};
+static portMUX_TYPE state_lock = portMUX_INITIALIZER_UNLOCKED;
+static volatile int threshold = MOTION_THRESHOLD_DEFAULT;
+static volatile int min_blocks = MOTION_MIN_BLOCKS_DEFAULT;
+static TaskHandle_t motion_task = NULL;
+
+// Only touched by the motion task
+static jpeg_dc_decoder_t *decoder = NULL;
+static uint8_t *luma = NULL;
+static uint16_t *background = NULL; // Q8 running average of luma
+static uint16_t bg_width = 0, bg_height = 0;
+static uint32_t warmup = MOTION_WARMUP_FRAMES;
+static bool event_active = false;
+
+static void reset_background(uint16_t width, uint16_t height)
+{
+    bg_width = width;
+    bg_height = height;
+    for (size_t i = 0; i < (size_t)width * height; i++)
+    {
+        background[i] = luma[i] << 8;
+    }
+    warmup = MOTION_WARMUP_FRAMES;
+}
+
+// Compares luma with the background and folds it in. Returns the number of
+// changed blocks; *weight receives the summed excess over the threshold.
+static uint32_t compare(size_t count, int thresh, uint32_t *weight)
+{
+    // Auto exposure shifts every block at once; take the global offset out first
+    int64_t sum = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        sum += ((int32_t)luma[i] << 8) - background[i];
+    }
+    int32_t offset = sum / (int64_t)count;
+
+    uint32_t changed = 0;
+    uint32_t excess = 0;
+    int32_t limit = thresh << 8;
+    for (size_t i = 0; i < count; i++)
+    {
+        int32_t cur = (int32_t)luma[i] << 8;
+        int32_t diff = cur - offset - background[i];
+        int32_t mag = diff < 0 ? -diff : diff;
+        if (mag > limit)
+        {
+            changed++;
+            excess += (mag - limit) >> 8;
+        }
+        background[i] += (cur - background[i]) >> MOTION_LEARN_SHIFT;
+    }
+    *weight = excess;
+    return changed;
+}
+
+// Folds one decoded frame into the background, the state and the event log
+static void update(esp_err_t res, uint16_t width, uint16_t height, int64_t timestamp, uint32_t skipped, int64_t start)
+{
+    if (res != ESP_OK)
+    {
+        portENTER_CRITICAL(&state_lock);
+        state.errors++;
+        state.skipped += skipped;
+        portEXIT_CRITICAL(&state_lock);
+        return;
+    }
+
+    size_t count = (size_t)width * height;
+    uint32_t changed = 0, weight = 0;
+    if (width != bg_width || height != bg_height)
+    {
+        reset_background(width, height);
+    }
+    else
+    {
+        changed = compare(count, threshold, &weight);
+    }
+    if (warmup > 0)
+    {
+        warmup--;
+        changed = weight = 0;
+    }
+    bool motion = changed >= (uint32_t)min_blocks;
+    uint32_t score = (changed + weight / 16) * 1000 / count;
+    score = score > 1000 ? 1000 : score;
+
+    portENTER_CRITICAL(&state_lock);
+    state.motion = motion;
+    state.changed_blocks = changed;
+    state.total_blocks = count;
+    state.score = score;
+    state.frames++;
+    state.skipped += skipped;
+    state.decode_us = esp_timer_get_time() - start;
+    state.timestamp = timestamp;
+    if (motion)
+    {
+        state.last_motion = timestamp;
+    }
+    int64_t lastMotion = state.last_motion;
+    portEXIT_CRITICAL(&state_lock);
+
+    if (motion && !event_active)
+    {
+        event_active = true;
+        events_post(EVENT_VISION, true, score);
+    }
+    else if (!motion && event_active && timestamp - lastMotion >= MOTION_HOLD_MS * 1000LL)
+    {
+        event_active = false;
+        events_post(EVENT_VISION, false, score);
+    }
+}
+
+static void motion_loop(void *arg)
+{
+    int sub = -1;
+    uint32_t lastSeq = 0;
+
+    while (true)
+    {
+        if (!state.enabled)
+        {
+            if (sub >= 0)
+            {
+                // Let the capture task idle when nobody else needs frames
+                frame_broadcast_unsubscribe(sub);
+                sub = -1;
+            }
+            if (event_active)
+            {
+                event_active = false;
+                events_post(EVENT_VISION, false, 0);
+            }
+            vTaskDelay(pdMS_TO_TICKS(1000));
+            continue;
+        }
+        if (sub < 0)
+        {
+            sub = frame_broadcast_subscribe_internal();
+            if (sub < 0)
+            {
+                vTaskDelay(pdMS_TO_TICKS(1000));
+                continue;
+            }
+            bg_width = 0;
+            lastSeq = 0;
+        }
+
+        frame_slot_t *frame = frame_broadcast_acquire(sub, lastSeq, pdMS_TO_TICKS(FRAME_WAIT_TIMEOUT_MS));
+        if (!frame)
+        {
+            continue;
+        }
+        uint32_t skipped = (lastSeq && frame->seq > lastSeq + 1) ? frame->seq - lastSeq - 1 : 0;
+        lastSeq = frame->seq;
+        int64_t timestamp = frame->timestamp;
+        int64_t start = esp_timer_get_time();
+
+        uint16_t width, height;
+        esp_err_t res = jpeg_dc_decode(decoder, frame->buf, frame->len, luma, MOTION_MAX_BLOCKS, &width, &height);
+        frame_broadcast_release(frame);
+        update(res, width, height, timestamp, skipped, start);
+    }
+}
+
+static esp_err_t alloc_buffers()
+{
+    if (!decoder)
+    {
+        decoder = (jpeg_dc_decoder_t *)heap_caps_malloc(sizeof(jpeg_dc_decoder_t), MALLOC_CAP_8BIT);
+    }
+    if (!luma)
+    {
+        luma = (uint8_t *)heap_caps_malloc(MOTION_MAX_BLOCKS, MALLOC_CAP_SPIRAM);
+    }
+    if (!background)
+    {
+        background = (uint16_t *)heap_caps_malloc(MOTION_MAX_BLOCKS * sizeof(uint16_t), MALLOC_CAP_SPIRAM);
+    }
+    if (!decoder || !luma || !background)
+    {
+        Serial.println("Motion: out of memory");
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+esp_err_t motion_detect_start()
+{
+    if (motion_task)
+    {
+        return ESP_OK;
+    }
+    esp_err_t res = alloc_buffers();
+    if (res != ESP_OK)
+    {
+        return res;
+    }
+    if (xTaskCreatePinnedToCore(motion_loop, "motion", MOTION_TASK_STACK, NULL, MOTION_TASK_PRIORITY, &motion_task, MOTION_TASK_CORE) != pdPASS)
+    {
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+esp_err_t motion_detect_feed(const uint8_t *jpg, size_t len, int64_t timestamp)
+{
+    esp_err_t res = alloc_buffers();
+    if (res != ESP_OK)
+    {
+        return res;
+    }
+    int64_t start = esp_timer_get_time();
+    uint16_t width, height;
+    res = jpeg_dc_decode(decoder, jpg, len, luma, MOTION_MAX_BLOCKS, &width, &height);
+    update(res, width, height, timestamp, 0, start);
+    return res;
+}
+
+void motion_detect_get(motion_state_t *out)
+{
+    portENTER_CRITICAL(&state_lock);
+    *out = state;
+    portEXIT_CRITICAL(&state_lock);
+}
+
+int motion_detect_set(const char *name, int value)
+{
+    if (!strcmp(name, "motion_detect"))
+        state.enabled = value;
+    else if (!strcmp(name, "motion_threshold") && value >= 1 && value <= 255)
+        threshold = value;
+    else if (!strcmp(name, "motion_min_blocks") && value >= 1 && value <= MOTION_MAX_BLOCKS)
+        min_blocks = value;
+    else
+        return -1;
+    return 0;
+}
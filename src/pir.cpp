@@ -0,0 +1,37 @@
+#include <Arduino.h>
+
+#include "esp32_cam_pins.h"
+#include "events.h"
+#include "pir.h"
+
+static volatile bool level = false;
+static volatile uint32_t edges = 0;
+
+static void IRAM_ATTR pir_isr()
+{
+    bool now = digitalRead(GPIO_13);
+    if (now == level)
+    {
+        return; // Contact bounce, the level is back where it was
+    }
+    level = now;
+    edges++;
+    events_post_from_isr(EVENT_MOTION, now, 0);
+}
+
+esp_err_t pir_start()
+{
+    level = digitalRead(GPIO_13);
+    attachInterrupt(digitalPinToInterrupt(GPIO_13), pir_isr, CHANGE);
+    return ESP_OK;
+}
+
+bool pir_state()
+{
+    return level;
+}
+
+uint32_t pir_edges()
+{
+    return edges;
+}
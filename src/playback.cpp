@@ -0,0 +1,602 @@
+#include <Arduino.h>
+#include <ctype.h>
+#include <esp_heap_caps.h>
+#include <esp_http_server.h>
+#include <esp_timer.h>
+#include <fcntl.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "avi_writer.h"
+#include "catalog.h"
+#include "playback.h"
+#include "record_config.h"
+#include "recorder.h"
+#include "retention.h"
+#include "stream_writer.h"
+
+#define LIST_BATCH 8
+#define CLIP_ENTRY_JSON_MAX 128
+
+typedef enum
+{
+    PLAYBACK_FILE,  // Bytes [pos, end) of the file
+    PLAYBACK_MJPEG, // Frames from idx1 entry pos on, as multipart JPEG
+} playback_mode_t;
+
+// One download or playback. Like an /events client, the slot stays taken
+// until httpd has closed the session and called playback_client_closed().
+typedef struct
+{
+    bool active;
+    bool closing; // Close requested or under way, free_ctx not called yet; also set while a handler sets the slot up
+    bool sending; // The playback task is reading the file or writing the socket, without clients_lock
+    playback_mode_t mode;
+    httpd_handle_t hd;
+    stream_writer_t writer;
+    int file;
+    uint32_t pos;
+    uint32_t end;
+    uint32_t index_offset; // MJPEG only
+    uint32_t us_per_frame;
+    int64_t due;           // MJPEG only: when to send the next frame
+} playback_t;
+
+static playback_t clients[PLAYBACK_MAX_CLIENTS];
+static SemaphoreHandle_t clients_lock = NULL; // Guards the slots' flags; never held across a send
+static SemaphoreHandle_t playback_wake = NULL;
+static TaskHandle_t playback_task = NULL;
+
+// Only used by the playback task
+static uint8_t *block = NULL;
+static uint8_t *frame = NULL;
+static size_t frame_size = 0;
+
+static const char *_MJPEG_CONTENT_TYPE = "multipart/x-mixed-replace;boundary=" PART_BOUNDARY;
+static const char *_MJPEG_BOUNDARY = "\r\n--" PART_BOUNDARY "\r\n";
+static const char *_FILE_RESPONSE = "HTTP/1.1 %s\r\n"
+                                    "Content-Type: video/x-msvideo\r\n"
+                                    "Content-Length: %u\r\n"
+                                    "%s"
+                                    "Accept-Ranges: bytes\r\n"
+                                    "Access-Control-Allow-Origin: *\r\n"
+                                    "Connection: close\r\n"
+                                    "\r\n";
+
+// Called by clients_lock holders only.
+static void client_drop(playback_t *client)
+{
+    client->closing = true;
+    close(client->file);
+    client->file = -1;
+    httpd_sess_trigger_close(client->hd, client->writer.fd);
+}
+
+static esp_err_t send_block(playback_t *client)
+{
+    uint32_t len = client->end - client->pos;
+    len = (len < PLAYBACK_BUFFER_SIZE) ? len : PLAYBACK_BUFFER_SIZE;
+    if (pread(client->file, block, len, client->pos) != (ssize_t)len)
+    {
+        return ESP_FAIL;
+    }
+    const void *bufs[] = {block};
+    size_t lens[] = {len};
+    client->pos += len;
+    return stream_writer_send(&client->writer, bufs, lens, 1);
+}
+
+static esp_err_t send_frame(playback_t *client)
+{
+    avi_index_entry_t entry;
+
+    // Clips are recorded without audio, so idx1 entry n is frame n
+    if (pread(client->file, &entry, sizeof(entry), client->index_offset + client->pos * sizeof(entry)) != sizeof(entry) ||
+        memcmp(&entry.ckid, "00dc", 4) != 0)
+    {
+        return ESP_FAIL;
+    }
+    client->pos++;
+
+    if (entry.size > frame_size)
+    {
+        uint8_t *grown = (uint8_t *)heap_caps_realloc(frame, entry.size, MALLOC_CAP_SPIRAM);
+        if (!grown)
+        {
+            return ESP_ERR_NO_MEM;
+        }
+        frame = grown;
+        frame_size = entry.size;
+    }
+    if (pread(client->file, frame, entry.size, AVI_MOVI_OFFSET + entry.offset + 8) != (ssize_t)entry.size)
+    {
+        return ESP_FAIL;
+    }
+    client->due += client->us_per_frame;
+    // Position in the clip, not the time the frame was taken
+    return stream_writer_send_jpeg(&client->writer, frame, entry.size, (int64_t)(client->pos - 1) * client->us_per_frame, _MJPEG_BOUNDARY);
+}
+
+// Sends one block or frame per client per round, so clients share the card
+// and the network fairly. Sleeps only while every client waits for its next frame.
+static void playback_loop(void *arg)
+{
+    while (true)
+    {
+        int64_t now = esp_timer_get_time();
+        int64_t nextDue = INT64_MAX;
+        bool busy = false;
+
+        for (int i = 0; i < PLAYBACK_MAX_CLIENTS; i++)
+        {
+            playback_t *client = &clients[i];
+
+            // As on the events task, a send that blocks must not hold up httpd
+            xSemaphoreTake(clients_lock, portMAX_DELAY);
+            bool ready = client->active && !client->closing;
+            client->sending = ready;
+            xSemaphoreGive(clients_lock);
+            if (!ready)
+            {
+                continue;
+            }
+
+            esp_err_t res = ESP_OK;
+            if (client->mode == PLAYBACK_FILE)
+            {
+                res = send_block(client);
+                busy = true;
+            }
+            else if (now >= client->due)
+            {
+                res = send_frame(client);
+            }
+
+            xSemaphoreTake(clients_lock, portMAX_DELAY);
+            client->sending = false;
+            // Skipped when httpd started closing the session during the send; its close hook is waiting for us
+            if (!client->closing)
+            {
+                if (res != ESP_OK || client->pos >= client->end)
+                {
+                    client_drop(client);
+                }
+                else if (client->mode == PLAYBACK_MJPEG && client->due < nextDue)
+                {
+                    nextDue = client->due;
+                }
+            }
+            xSemaphoreGive(clients_lock);
+        }
+
+        if (!busy)
+        {
+            int64_t wait = nextDue - esp_timer_get_time();
+            xSemaphoreTake(playback_wake, (nextDue == INT64_MAX) ? portMAX_DELAY : (wait > 0 ? pdMS_TO_TICKS(wait / 1000) : 0));
+        }
+    }
+}
+
+void playback_session_closing(httpd_handle_t hd, int sockfd)
+{
+    if (!clients_lock)
+    {
+        return;
+    }
+    xSemaphoreTake(clients_lock, portMAX_DELAY);
+    for (int i = 0; i < PLAYBACK_MAX_CLIENTS; i++)
+    {
+        playback_t *client = &clients[i];
+        if (!client->active || client->hd != hd || client->writer.fd != sockfd)
+        {
+            continue;
+        }
+        // A file read in flight just finishes; a send fails on the shut down socket
+        client->closing = true;
+        while (client->sending)
+        {
+            xSemaphoreGive(clients_lock);
+            vTaskDelay(1);
+            xSemaphoreTake(clients_lock, portMAX_DELAY);
+        }
+    }
+    xSemaphoreGive(clients_lock);
+}
+
+// playback_session_closing() has stopped the task, so the file can go
+static void playback_client_closed(void *ctx)
+{
+    playback_t *client = (playback_t *)ctx;
+
+    xSemaphoreTake(clients_lock, portMAX_DELAY);
+    if (client->file >= 0)
+    {
+        close(client->file);
+        client->file = -1;
+    }
+    client->active = false;
+    client->closing = false;
+    xSemaphoreGive(clients_lock);
+}
+
+esp_err_t playback_start()
+{
+    if (playback_task)
+    {
+        return ESP_OK;
+    }
+    for (int i = 0; i < PLAYBACK_MAX_CLIENTS; i++)
+    {
+        clients[i].file = -1;
+    }
+    clients_lock = xSemaphoreCreateMutex();
+    playback_wake = xSemaphoreCreateBinary();
+    block = (uint8_t *)heap_caps_malloc(PLAYBACK_BUFFER_SIZE, MALLOC_CAP_DMA);
+    if (!clients_lock || !playback_wake || !block)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    if (xTaskCreatePinnedToCore(playback_loop, "playback", PLAYBACK_TASK_STACK, NULL, PLAYBACK_TASK_PRIORITY, &playback_task, RECORD_TASK_CORE) != pdPASS)
+    {
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+// Reserves a free slot. It stays invisible to the playback task until park_client().
+static playback_t *claim_client()
+{
+    playback_t *client = NULL;
+
+    xSemaphoreTake(clients_lock, portMAX_DELAY);
+    for (int i = 0; i < PLAYBACK_MAX_CLIENTS; i++)
+    {
+        if (!clients[i].active && !clients[i].closing)
+        {
+            client = &clients[i];
+            client->closing = true; // Reserved
+            break;
+        }
+    }
+    xSemaphoreGive(clients_lock);
+    return client;
+}
+
+static void release_client(playback_t *client)
+{
+    xSemaphoreTake(clients_lock, portMAX_DELAY);
+    if (client->file >= 0)
+    {
+        close(client->file);
+        client->file = -1;
+    }
+    client->closing = false;
+    xSemaphoreGive(clients_lock);
+}
+
+// Hands the session over to the playback task.
+static void park_client(playback_t *client, httpd_req_t *req)
+{
+    xSemaphoreTake(clients_lock, portMAX_DELAY);
+    client->hd = req->handle;
+    client->active = true;
+    client->closing = false;
+    req->sess_ctx = client;
+    req->free_ctx = playback_client_closed;
+    xSemaphoreGive(clients_lock);
+    xSemaphoreGive(playback_wake);
+}
+
+static esp_err_t send_status(httpd_req_t *req, const char *status, const char *message)
+{
+    httpd_resp_set_status(req, status);
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    return httpd_resp_sendstr(req, message);
+}
+
+// Clip names come from the recorder: digits, letters and '-' only. Anything
+// else, like a path, is refused.
+static bool valid_name(const char *name)
+{
+    if (!*name)
+    {
+        return false;
+    }
+    for (const char *c = name; *c; c++)
+    {
+        if (!isalnum((unsigned char)*c) && *c != '-')
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Parses a single "bytes=first-last", "bytes=first-" or "bytes=-suffix" range
+// into [start, end). Returns false when it cannot be satisfied.
+// Reads the digits at p up to the end of the string or to stop, whichever
+// comes first, and nothing else
+static bool parse_position(const char *p, char stop, unsigned long *value, const char **rest)
+{
+    char *after;
+
+    if (*p < '0' || *p > '9')
+    {
+        return false;
+    }
+    *value = strtoul(p, &after, 10);
+    *rest = after;
+    return *after == stop || *after == 0;
+}
+
+// One range of a Range header. False for anything malformed and for a range
+// that does not overlap the file, which every range misses when it is empty.
+static bool parse_range(const char *range, uint32_t size, uint32_t *start, uint32_t *end)
+{
+    unsigned long first, last;
+    const char *rest;
+
+    if (strncmp(range, "bytes=", 6) != 0 || size == 0)
+    {
+        return false;
+    }
+    const char *p = range + 6;
+    if (*p == '-')
+    {
+        if (!parse_position(p + 1, 0, &last, &rest) || last == 0)
+        {
+            return false;
+        }
+        *start = (last < size) ? size - last : 0;
+        *end = size;
+        return true;
+    }
+    if (!parse_position(p, '-', &first, &rest) || *rest != '-' || first >= size)
+    {
+        return false;
+    }
+    last = size - 1;
+    if (rest[1] && !parse_position(rest + 1, 0, &last, &rest))
+    {
+        return false;
+    }
+    if (last < first)
+    {
+        return false;
+    }
+    *start = first;
+    *end = (last < size - 1) ? last + 1 : size;
+    return true;
+}
+
+static esp_err_t send_file(httpd_req_t *req, const char *name)
+{
+    char path[64];
+    char range[64];
+    char contentRange[64] = "";
+    char head[320];
+    struct stat st;
+    recorder_stats_t stats;
+
+    recorder_get_stats(&stats);
+    if (stats.recording && strcmp(stats.clip, name) == 0)
+    {
+        return send_status(req, "409 Conflict", "Clip is still being recorded");
+    }
+    snprintf(path, sizeof(path), "%s/%s.avi", CLIP_DIR, name);
+    if (stat(path, &st) != 0)
+    {
+        return send_status(req, "404 Not Found", "No such clip");
+    }
+
+    uint32_t size = st.st_size;
+    uint32_t start = 0;
+    uint32_t end = size;
+    const char *status = "200 OK";
+    if (httpd_req_get_hdr_value_str(req, "Range", range, sizeof(range)) == ESP_OK && !strchr(range, ','))
+    {
+        if (!parse_range(range, size, &start, &end))
+        {
+            snprintf(contentRange, sizeof(contentRange), "bytes */%u", size);
+            httpd_resp_set_hdr(req, "Content-Range", contentRange);
+            return send_status(req, "416 Range Not Satisfiable", "");
+        }
+        status = "206 Partial Content";
+        snprintf(contentRange, sizeof(contentRange), "Content-Range: bytes %u-%u/%u\r\n", start, end - 1, size);
+    }
+
+    playback_t *client = claim_client();
+    if (!client)
+    {
+        return send_status(req, "503 Service Unavailable", "Too many downloads");
+    }
+    client->file = open(path, O_RDONLY);
+    if (client->file < 0)
+    {
+        release_client(client);
+        return httpd_resp_send_500(req);
+    }
+
+    int len = snprintf(head, sizeof(head), _FILE_RESPONSE, status, end - start, contentRange);
+    const void *bufs[] = {head};
+    size_t lens[] = {(size_t)len};
+    client->writer.fd = httpd_req_to_sockfd(req);
+    client->writer.bytes = 0;
+    if (stream_writer_send(&client->writer, bufs, lens, 1) != ESP_OK)
+    {
+        release_client(client);
+        return ESP_FAIL;
+    }
+    if (start == end)
+    {
+        release_client(client);
+        return ESP_FAIL; // Nothing more to send; have httpd close the connection
+    }
+    client->mode = PLAYBACK_FILE;
+    client->pos = start;
+    client->end = end;
+    park_client(client, req);
+    return ESP_OK;
+}
+
+static esp_err_t play_at(httpd_req_t *req, int64_t ms)
+{
+    catalog_entry_t entry;
+    char path[64];
+
+    uint32_t i = catalog_upper_bound(ms);
+    if (i == 0 || catalog_read(i - 1, &entry, 1) != 1 || ms >= entry.start_ms + entry.duration_ms)
+    {
+        return send_status(req, "404 Not Found", "Nothing recorded at that time");
+    }
+    if (entry.flags & CATALOG_DELETED)
+    {
+        return send_status(req, "404 Not Found", "Clip was deleted");
+    }
+
+    playback_t *client = claim_client();
+    if (!client)
+    {
+        return send_status(req, "503 Service Unavailable", "Too many downloads");
+    }
+    snprintf(path, sizeof(path), "%s/%s.avi", CLIP_DIR, entry.name);
+    client->file = open(path, O_RDONLY);
+    if (client->file < 0)
+    {
+        release_client(client);
+        return send_status(req, "404 Not Found", "Clip was deleted");
+    }
+
+    // Every MJPEG frame is a keyframe, so playback starts right at the frame recorded at ms
+    esp_err_t res = stream_writer_begin(&client->writer, req, _MJPEG_CONTENT_TYPE, _MJPEG_BOUNDARY, strlen(_MJPEG_BOUNDARY));
+    if (res != ESP_OK)
+    {
+        release_client(client);
+        return ESP_FAIL;
+    }
+    client->mode = PLAYBACK_MJPEG;
+    client->pos = (ms - entry.start_ms) * 1000 / entry.us_per_frame;
+    client->pos = (client->pos < entry.frames) ? client->pos : entry.frames - 1;
+    client->end = entry.frames;
+    client->index_offset = entry.index_offset;
+    client->us_per_frame = entry.us_per_frame;
+    client->due = esp_timer_get_time();
+    park_client(client, req);
+    return ESP_OK;
+}
+
+esp_err_t recording_clip_handler(httpd_req_t *req)
+{
+    char query[64];
+    char name[sizeof(((catalog_entry_t *)0)->name)];
+    char value[24];
+
+    if (!playback_task)
+    {
+        return send_status(req, "503 Service Unavailable", "Recordings need STORAGE_ENABLED and an SD card");
+    }
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) != ESP_OK)
+    {
+        return send_status(req, "400 Bad Request", "Give name or t");
+    }
+    if (httpd_query_key_value(query, "name", name, sizeof(name)) == ESP_OK)
+    {
+        if (!valid_name(name))
+        {
+            return send_status(req, "400 Bad Request", "Bad clip name");
+        }
+        return send_file(req, name);
+    }
+    if (httpd_query_key_value(query, "t", value, sizeof(value)) == ESP_OK)
+    {
+        return play_at(req, strtoll(value, NULL, 10) * 1000);
+    }
+    return send_status(req, "400 Bad Request", "Give name or t");
+}
+
+esp_err_t recordings_handler(httpd_req_t *req)
+{
+    char query[64];
+    char value[24];
+    char json[LIST_BATCH * CLIP_ENTRY_JSON_MAX];
+    catalog_entry_t entries[LIST_BATCH];
+    int64_t from = 0;
+    int64_t to = INT64_MAX;
+
+    if (!playback_task)
+    {
+        return send_status(req, "503 Service Unavailable", "Recordings need STORAGE_ENABLED and an SD card");
+    }
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK)
+    {
+        if (httpd_query_key_value(query, "from", value, sizeof(value)) == ESP_OK)
+        {
+            from = strtoll(value, NULL, 10) * 1000;
+        }
+        if (httpd_query_key_value(query, "to", value, sizeof(value)) == ESP_OK)
+        {
+            to = strtoll(value, NULL, 10) * 1000;
+        }
+    }
+
+    // Clips older than the oldest stored one are gone
+    int64_t oldest = retention_oldest_ms();
+    from = (oldest > from) ? oldest : from;
+
+    // Start with the clip that may still be running at from
+    uint32_t first = catalog_upper_bound(from);
+    if (first > 0 && catalog_read(first - 1, entries, 1) == 1 && entries[0].start_ms + entries[0].duration_ms > from)
+    {
+        first--;
+    }
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    int len = snprintf(json, sizeof(json), "{\"total\":%u,\"clips\":[", catalog_count());
+
+    uint32_t listed = 0;
+    bool more = false;
+    bool done = false;
+    while (!done)
+    {
+        uint32_t n = catalog_read(first, entries, LIST_BATCH);
+        done = n == 0;
+        for (uint32_t i = 0; i < n && !done; i++)
+        {
+            const catalog_entry_t *e = &entries[i];
+            if (e->start_ms > to)
+            {
+                done = true;
+                break;
+            }
+            if (e->flags & CATALOG_DELETED)
+            {
+                continue;
+            }
+            if (listed == RECORDINGS_LIST_MAX)
+            {
+                more = done = true;
+                break;
+            }
+            len += snprintf(json + len, sizeof(json) - len,
+                            "%s{\"name\":\"%s\",\"start_ms\":%lld,\"duration_ms\":%u,\"frames\":%u,\"bytes\":%u}",
+                            listed ? "," : "", e->name, (long long)e->start_ms, e->duration_ms, e->frames, e->bytes);
+            listed++;
+        }
+        first += n;
+        // An empty chunk would end the response before the closing bracket
+        if (len > 0 && httpd_resp_send_chunk(req, json, len) != ESP_OK)
+        {
+            return ESP_FAIL;
+        }
+        len = 0;
+    }
+
+    len = snprintf(json, sizeof(json), "],\"more\":%s}", more ? "true" : "false");
+    httpd_resp_send_chunk(req, json, len);
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
@@ -0,0 +1,313 @@
+#include <Arduino.h>
+#include <esp_http_server.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <time.h>
+
+#include "clip_ring.h"
+#include "events.h"
+#include "frame_broadcast.h"
+#include "record_config.h"
+#include "recorder.h"
+#include "retention.h"
+#include "stream_config.h"
+
+static clip_ring_t ring;
+static clip_sink_t *sink = NULL;
+static recorder_stats_t stats;
+
+static portMUX_TYPE record_lock = portMUX_INITIALIZER_UNLOCKED;
+static bool trigger_pending = false;
+static int64_t trigger_time = 0;
+static int64_t record_until = 0; // End of the post-roll, moved on by every trigger
+
+static SemaphoreHandle_t writer_wake = NULL;
+static TaskHandle_t record_task = NULL;
+static TaskHandle_t writer_task = NULL;
+
+// Wall-clock name of the moment timestamp, or the uptime when the clock is not set.
+static void clip_name(int64_t timestamp, char *buf, size_t len)
+{
+    time_t now = time(NULL);
+    if (now < VALID_TIME)
+    {
+        snprintf(buf, len, "up%08lld", (long long)(timestamp / 1000000));
+        return;
+    }
+    time_t at = now - (time_t)((esp_timer_get_time() - timestamp) / 1000000);
+    struct tm tm;
+    gmtime_r(&at, &tm);
+    strftime(buf, len, "%Y%m%d-%H%M%S", &tm);
+}
+
+void recorder_trigger(int64_t timestamp)
+{
+    portENTER_CRITICAL(&record_lock);
+    if (!stats.recording && !trigger_pending)
+    {
+        trigger_pending = true;
+        trigger_time = timestamp;
+    }
+    if (timestamp + POSTROLL_MS * 1000LL > record_until)
+    {
+        record_until = timestamp + POSTROLL_MS * 1000LL;
+    }
+    stats.triggers++;
+    portEXIT_CRITICAL(&record_lock);
+
+    if (writer_wake)
+    {
+        xSemaphoreGive(writer_wake);
+    }
+}
+
+// Closes the clip and releases its frames. Callers ending a clip normally
+// clear recording themselves, together with the decision to stop.
+static void finish_clip(bool failed)
+{
+    if (sink->close(sink) != ESP_OK)
+    {
+        failed = true;
+    }
+    clip_ring_unpin(&ring);
+
+    portENTER_CRITICAL(&record_lock);
+    stats.recording = false;
+    if (failed)
+    {
+        stats.clip_errors++;
+    }
+    portEXIT_CRITICAL(&record_lock);
+    Serial.printf("Recorder: clip %s %s\r\n", stats.clip, failed ? "failed" : "done");
+}
+
+// Drains pinned frames into the sink. Runs below the ingest task so a slow
+// card only delays the clip.
+static void writer_loop(void *arg)
+{
+    uint32_t cursor = 0;
+
+    while (true)
+    {
+        xSemaphoreTake(writer_wake, pdMS_TO_TICKS(FRAME_WAIT_TIMEOUT_MS));
+
+        portENTER_CRITICAL(&record_lock);
+        bool start = trigger_pending;
+        int64_t since = trigger_time - PREROLL_MS * 1000LL;
+        if (start)
+        {
+            trigger_pending = false;
+            stats.recording = true;
+        }
+        bool recording = stats.recording;
+        portEXIT_CRITICAL(&record_lock);
+
+        if (start)
+        {
+            char name[sizeof(stats.clip)];
+            cursor = clip_ring_pin(&ring, since);
+            clip_name(since, name, sizeof(name));
+
+            portENTER_CRITICAL(&record_lock);
+            strcpy(stats.clip, name);
+            stats.clips++;
+            portEXIT_CRITICAL(&record_lock);
+
+            if (sink->open(sink, name, since) != ESP_OK)
+            {
+                Serial.printf("Recorder: cannot open clip %s\r\n", name);
+                finish_clip(true);
+                continue;
+            }
+        }
+        if (!recording)
+        {
+            continue;
+        }
+
+        clip_frame_t frame;
+        const uint8_t *data;
+        bool done = false;
+        while (clip_ring_get(&ring, cursor, &frame, &data))
+        {
+            // Deciding and clearing recording together means a trigger arriving
+            // now either extends this clip or starts the next one, never neither
+            portENTER_CRITICAL(&record_lock);
+            done = frame.timestamp > record_until;
+            if (done)
+            {
+                stats.recording = false;
+            }
+            portEXIT_CRITICAL(&record_lock);
+            if (done)
+            {
+                break;
+            }
+            if (sink->write(sink, data, frame.len, frame.timestamp) != ESP_OK)
+            {
+                break;
+            }
+            portENTER_CRITICAL(&record_lock);
+            stats.frames_written++;
+            stats.bytes_written += frame.len;
+            portEXIT_CRITICAL(&record_lock);
+            clip_ring_advance(&ring, ++cursor);
+        }
+
+        if (done)
+        {
+            finish_clip(false);
+        }
+        else if (clip_ring_get(&ring, cursor, &frame, &data))
+        {
+            Serial.println("Recorder: write failed");
+            finish_clip(true);
+        }
+        else
+        {
+            // Caught up. Also end the clip if the camera stopped delivering frames.
+            portENTER_CRITICAL(&record_lock);
+            bool stalled = esp_timer_get_time() > record_until + FRAME_WAIT_TIMEOUT_MS * 1000LL;
+            if (stalled)
+            {
+                stats.recording = false;
+            }
+            portEXIT_CRITICAL(&record_lock);
+            if (stalled)
+            {
+                finish_clip(false);
+            }
+        }
+    }
+}
+
+static void record_loop(void *arg)
+{
+    event_t events[8];
+    uint32_t eventSeq = events_latest_seq();
+    uint32_t lastSeq = 0;
+    int sub = -1;
+
+    while (true)
+    {
+        if (sub < 0)
+        {
+            sub = frame_broadcast_subscribe_internal();
+            if (sub < 0)
+            {
+                vTaskDelay(pdMS_TO_TICKS(1000));
+                continue;
+            }
+        }
+        frame_slot_t *frame = frame_broadcast_acquire(sub, lastSeq, pdMS_TO_TICKS(1000));
+
+        // PIR edges trigger at the time of the edge, so the pre-roll lines up with it
+        size_t count;
+        while ((count = events_read(eventSeq, events, 8)) > 0)
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                if (events[i].type == EVENT_MOTION)
+                {
+                    recorder_trigger(events[i].timestamp);
+                }
+            }
+            eventSeq = events[count - 1].seq;
+        }
+
+        if (!frame)
+        {
+            continue;
+        }
+        lastSeq = frame->seq;
+        clip_ring_push(&ring, frame->buf, frame->len, frame->timestamp, PREROLL_MS * 1000LL);
+        frame_broadcast_release(frame);
+
+        if (stats.recording)
+        {
+            xSemaphoreGive(writer_wake);
+        }
+    }
+}
+
+esp_err_t recorder_start(clip_sink_t *clipSink)
+{
+    if (record_task)
+    {
+        return ESP_OK;
+    }
+    sink = clipSink;
+    writer_wake = xSemaphoreCreateBinary();
+    if (!writer_wake || clip_ring_init(&ring, PREROLL_BUDGET_BYTES, PREROLL_MAX_FRAMES) != ESP_OK)
+    {
+        Serial.println("Recorder: out of memory");
+        return ESP_ERR_NO_MEM;
+    }
+    if (xTaskCreatePinnedToCore(record_loop, "record", RECORD_TASK_STACK, NULL, RECORD_TASK_PRIORITY, &record_task, RECORD_TASK_CORE) != pdPASS ||
+        xTaskCreatePinnedToCore(writer_loop, "record_wr", RECORD_WRITER_STACK, NULL, RECORD_WRITER_PRIORITY, &writer_task, RECORD_TASK_CORE) != pdPASS)
+    {
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+bool recorder_running()
+{
+    return record_task != NULL;
+}
+
+void recorder_get_stats(recorder_stats_t *out)
+{
+    portENTER_CRITICAL(&record_lock);
+    *out = stats;
+    out->recording = stats.recording || trigger_pending;
+    portEXIT_CRITICAL(&record_lock);
+
+    portENTER_CRITICAL(&ring.lock);
+    out->ring_frames = ring.next - ring.first;
+    out->ring_bytes = ring.bytes;
+    out->ring_budget = ring.size;
+    out->pushed = ring.pushed;
+    out->dropped = ring.dropped;
+    out->evicted_budget = ring.evicted_budget;
+    out->evicted_age = ring.evicted_age;
+    portEXIT_CRITICAL(&ring.lock);
+}
+
+esp_err_t record_handler(httpd_req_t *req)
+{
+    recorder_stats_t s;
+    retention_stats_t r;
+    char query[32];
+    char json[544];
+
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    if (!record_task)
+    {
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        return httpd_resp_sendstr(req, "Recording needs STORAGE_ENABLED and an SD card");
+    }
+
+    bool statusOnly = httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK && strstr(query, "status");
+    if (!statusOnly)
+    {
+        recorder_trigger(esp_timer_get_time());
+    }
+
+    recorder_get_stats(&s);
+    retention_get_stats(&r);
+    int len = snprintf(json, sizeof(json),
+                       "{\"recording\":%s,\"clip\":\"%s\",\"clips\":%u,\"clip_errors\":%u,\"triggers\":%u,"
+                       "\"frames_written\":%u,\"bytes_written\":%llu,\"ring_frames\":%u,\"ring_bytes\":%u,"
+                       "\"ring_budget\":%u,\"pushed\":%u,\"dropped\":%u,\"evicted_budget\":%u,\"evicted_age\":%u,"
+                       "\"stored_clips\":%u,\"stored_bytes\":%llu,\"reclaimed\":%u,\"over_quota\":%u}",
+                       s.recording ? "true" : "false", s.clip, s.clips, s.clip_errors, s.triggers,
+                       s.frames_written, (unsigned long long)s.bytes_written, s.ring_frames, s.ring_bytes,
+                       s.ring_budget, s.pushed, s.dropped, s.evicted_budget, s.evicted_age,
+                       r.clips, (unsigned long long)r.bytes, r.reclaimed, r.over_quota);
+
+    httpd_resp_set_type(req, "application/json");
+    return httpd_resp_send(req, json, len);
+}
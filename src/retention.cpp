@@ -0,0 +1,463 @@
+#include <Arduino.h>
+#include <errno.h>
+#include <esp_heap_caps.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "avi_writer.h"
+#include "catalog.h"
+#include "record_config.h"
+#include "retention.h"
+#include "storage.h"
+
+#define RECORD_ADD 1
+#define RECORD_DEL 2
+#define DAY_MS 86400000LL
+#define REPLAY_BATCH 32
+
+typedef struct
+{
+    uint32_t seq; // 0 for a slot never written
+    uint32_t id;
+    uint32_t bytes;
+    uint8_t type;
+    uint8_t reserved[3];
+    int64_t start_ms;
+    char name[16];
+    uint32_t crc; // Of everything before it
+    uint32_t reserved2;
+} journal_record_t;
+
+typedef enum
+{
+    CLIP_UNKNOWN,
+    CLIP_STORED,
+    CLIP_DELETED,
+} clip_state_t;
+
+typedef struct
+{
+    char name[16];
+    int64_t start_ms;
+    uint32_t bytes;
+    uint32_t seq; // Of its latest ADD record
+    clip_state_t state;
+} retention_clip_t;
+
+static int journal = -1;
+static uint32_t next_seq = 1;
+static uint32_t *slot_id = NULL;       // Id of the clip whose ADD record is in each slot, 0 for none
+static retention_clip_t *clips = NULL; // Indexed by id % RETENTION_MAX_CLIPS
+static uint32_t first_id = 1;          // Oldest stored clip, or next_id when there is none
+static uint32_t next_id = 1;
+static uint32_t open_id = 0;           // Clip being written, 0 for none
+
+// Per-day quota, for the latest day only: earlier days do not grow any more
+static int64_t current_day = -1;
+static uint64_t day_bytes = 0;
+static uint32_t day_cursor = 0; // Oldest clip that may still belong to current_day
+
+static retention_stats_t stats;
+static int64_t oldest_ms = -1;
+static portMUX_TYPE stats_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static uint32_t crc32(const uint8_t *p, size_t len)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    while (len--)
+    {
+        crc ^= *p++;
+        for (int k = 0; k < 8; k++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
+
+static inline retention_clip_t *clip_at(uint32_t id)
+{
+    return &clips[id % RETENTION_MAX_CLIPS];
+}
+
+static inline bool stored(uint32_t id)
+{
+    return id >= first_id && id < next_id && clip_at(id)->state == CLIP_STORED;
+}
+
+static inline int64_t day_of(int64_t ms)
+{
+    return ms < 0 ? -1 : ms / DAY_MS;
+}
+
+static esp_err_t write_record(uint8_t type, uint32_t id)
+{
+    journal_record_t record = {};
+    retention_clip_t *clip = clip_at(id);
+    uint32_t slot = next_seq % RETENTION_JOURNAL_SLOTS;
+
+    // A newer ADD supersedes the clip's earlier one, which then needs no carrying
+    if (type == RECORD_ADD && clip->seq && slot_id[clip->seq % RETENTION_JOURNAL_SLOTS] == id)
+    {
+        slot_id[clip->seq % RETENTION_JOURNAL_SLOTS] = 0;
+    }
+    if (type == RECORD_ADD)
+    {
+        clip->seq = next_seq;
+    }
+
+    record.seq = next_seq;
+    record.id = id;
+    record.type = type;
+    record.bytes = clip->bytes;
+    record.start_ms = clip->start_ms;
+    memcpy(record.name, clip->name, sizeof(record.name));
+    record.crc = crc32((const uint8_t *)&record, offsetof(journal_record_t, crc));
+
+    next_seq++;
+    slot_id[slot] = (type == RECORD_ADD) ? id : 0;
+    portENTER_CRITICAL(&stats_lock);
+    stats.journal_seq = record.seq;
+    portEXIT_CRITICAL(&stats_lock);
+    if (pwrite(journal, &record, sizeof(record), (off_t)slot * sizeof(record)) != sizeof(record) || fsync(journal) != 0)
+    {
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+// Appends a record at the next slot. An ADD record of a still stored clip in
+// the way is written again first, so it is never lost.
+static esp_err_t journal_append(uint8_t type, uint32_t id)
+{
+    uint32_t owner;
+    while ((owner = slot_id[next_seq % RETENTION_JOURNAL_SLOTS]) != 0 && stored(owner))
+    {
+        if (write_record(RECORD_ADD, owner) != ESP_OK)
+        {
+            return ESP_FAIL;
+        }
+    }
+    return write_record(type, id);
+}
+
+static void update_oldest()
+{
+    while (first_id < next_id && clip_at(first_id)->state != CLIP_STORED)
+    {
+        first_id++;
+    }
+    portENTER_CRITICAL(&stats_lock);
+    oldest_ms = (first_id < next_id) ? clip_at(first_id)->start_ms : -1;
+    portEXIT_CRITICAL(&stats_lock);
+}
+
+// Deletes the file first: a reset before the DEL record is written then only
+// leaves a record of a missing file, never a file nobody knows about.
+static void reclaim(uint32_t id)
+{
+    retention_clip_t *clip = clip_at(id);
+    char path[64];
+
+    snprintf(path, sizeof(path), "%s/%s.avi", CLIP_DIR, clip->name);
+    if (unlink(path) != 0 && errno != ENOENT)
+    {
+        Serial.printf("Retention: cannot delete %s\r\n", path);
+    }
+    clip->state = CLIP_DELETED;
+    if (journal_append(RECORD_DEL, id) != ESP_OK)
+    {
+        Serial.println("Retention: journal write failed");
+    }
+    // Quota reclaims come from the middle of the catalog, where no oldest-clip cut-off can hide them
+    catalog_mark_deleted(clip->name, clip->start_ms);
+
+    portENTER_CRITICAL(&stats_lock);
+    stats.clips--;
+    stats.bytes -= clip->bytes;
+    portEXIT_CRITICAL(&stats_lock);
+    update_oldest();
+}
+
+static void reclaim_space()
+{
+    uint64_t free = storage_free_bytes();
+    if (free >= RETENTION_FREE_LOW)
+    {
+        return;
+    }
+    while (free < RETENTION_FREE_HIGH && first_id < next_id && first_id != open_id)
+    {
+        free += clip_at(first_id)->bytes;
+        reclaim(first_id);
+        portENTER_CRITICAL(&stats_lock);
+        stats.reclaimed++;
+        portEXIT_CRITICAL(&stats_lock);
+    }
+}
+
+// Two passes over the ring: the first finds the highest seq and id, the
+// second applies the ADD and DEL records, in any order, of ids in the window
+// below that id. Returns the number of valid records.
+static uint32_t replay()
+{
+    journal_record_t batch[REPLAY_BATCH];
+    uint32_t maxSeq = 0;
+    uint32_t maxId = 0;
+    uint32_t valid = 0;
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        for (uint32_t slot = 0; slot < RETENTION_JOURNAL_SLOTS; slot += REPLAY_BATCH)
+        {
+            ssize_t len = pread(journal, batch, sizeof(batch), (off_t)slot * sizeof(journal_record_t));
+            for (uint32_t i = 0; len > 0 && i < len / sizeof(journal_record_t); i++)
+            {
+                const journal_record_t *r = &batch[i];
+                if (r->seq == 0 || r->seq % RETENTION_JOURNAL_SLOTS != slot + i ||
+                    r->crc != crc32((const uint8_t *)r, offsetof(journal_record_t, crc)))
+                {
+                    continue;
+                }
+                if (pass == 0)
+                {
+                    maxSeq = (r->seq > maxSeq) ? r->seq : maxSeq;
+                    maxId = (r->id > maxId) ? r->id : maxId;
+                    valid++;
+                    continue;
+                }
+                if (r->id + RETENTION_MAX_CLIPS <= maxId)
+                {
+                    continue; // Too old to be stored
+                }
+                retention_clip_t *clip = clip_at(r->id);
+                if (r->type == RECORD_DEL)
+                {
+                    clip->state = CLIP_DELETED;
+                }
+                else if (clip->state == CLIP_UNKNOWN || (clip->state == CLIP_STORED && (int32_t)(r->seq - clip->seq) > 0))
+                {
+                    // The latest ADD of a clip holds its final size
+                    if (clip->state == CLIP_STORED)
+                    {
+                        slot_id[clip->seq % RETENTION_JOURNAL_SLOTS] = 0;
+                    }
+                    memcpy(clip->name, r->name, sizeof(clip->name));
+                    clip->name[sizeof(clip->name) - 1] = '\0';
+                    clip->start_ms = r->start_ms;
+                    clip->bytes = r->bytes;
+                    clip->seq = r->seq;
+                    clip->state = CLIP_STORED;
+                    slot_id[slot + i] = r->id;
+                }
+            }
+        }
+    }
+
+    next_seq = maxSeq + 1;
+    next_id = maxId + 1;
+    first_id = (next_id > RETENTION_MAX_CLIPS) ? next_id - RETENTION_MAX_CLIPS : 1;
+    return valid;
+}
+
+static esp_err_t open_journal()
+{
+    struct stat st;
+    static const uint8_t zero[512] = {};
+    const off_t size = (off_t)RETENTION_JOURNAL_SLOTS * sizeof(journal_record_t);
+
+    journal = open(RETENTION_JOURNAL_PATH, O_RDWR | O_CREAT, 0664);
+    if (journal < 0 || fstat(journal, &st) != 0)
+    {
+        return ESP_FAIL;
+    }
+    // Zero a new journal so stale card contents can never pass for records
+    for (off_t pos = st.st_size; pos < size; pos += sizeof(zero))
+    {
+        size_t len = (size - pos < (off_t)sizeof(zero)) ? size - pos : sizeof(zero);
+        if (pwrite(journal, zero, len, pos) != (ssize_t)len)
+        {
+            return ESP_FAIL;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t retention_start()
+{
+    if (clips)
+    {
+        return ESP_OK;
+    }
+    clips = (retention_clip_t *)heap_caps_calloc(RETENTION_MAX_CLIPS, sizeof(retention_clip_t), MALLOC_CAP_SPIRAM);
+    slot_id = (uint32_t *)heap_caps_calloc(RETENTION_JOURNAL_SLOTS, sizeof(uint32_t), MALLOC_CAP_SPIRAM);
+    if (!clips || !slot_id)
+    {
+        heap_caps_free(clips);
+        heap_caps_free(slot_id);
+        clips = NULL;
+        slot_id = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    if (open_journal() != ESP_OK)
+    {
+        Serial.println("Retention: cannot open the journal");
+        return ESP_FAIL;
+    }
+
+    uint32_t records = replay();
+    stats.journal_seq = next_seq - 1;
+    update_oldest();
+    for (uint32_t id = first_id; id < next_id; id++)
+    {
+        const retention_clip_t *clip = clip_at(id);
+        if (clip->state != CLIP_STORED)
+        {
+            continue;
+        }
+        stats.clips++;
+        stats.bytes += clip->bytes;
+        if (clip->start_ms >= 0 && day_of(clip->start_ms) != current_day)
+        {
+            current_day = day_of(clip->start_ms);
+            day_bytes = 0;
+            day_cursor = id;
+        }
+        if (clip->start_ms >= 0 && day_of(clip->start_ms) == current_day)
+        {
+            day_bytes += clip->bytes;
+        }
+    }
+    Serial.printf("Retention: %u records, %u clips, %llu MB\r\n", records, stats.clips, (unsigned long long)(stats.bytes >> 20));
+
+    reclaim_space();
+    return ESP_OK;
+}
+
+bool retention_running()
+{
+    return journal >= 0;
+}
+
+void retention_stop()
+{
+    if (journal >= 0)
+    {
+        close(journal);
+    }
+    heap_caps_free(clips);
+    heap_caps_free(slot_id);
+    journal = -1;
+    clips = NULL;
+    slot_id = NULL;
+    next_seq = 1;
+    first_id = 1;
+    next_id = 1;
+    open_id = 0;
+    current_day = -1;
+    day_bytes = 0;
+    day_cursor = 0;
+    portENTER_CRITICAL(&stats_lock);
+    memset(&stats, 0, sizeof(stats));
+    oldest_ms = -1;
+    portEXIT_CRITICAL(&stats_lock);
+}
+
+esp_err_t retention_open(const char *name, int64_t start_ms)
+{
+    if (journal < 0)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Keep the id window free for the new clip
+    while (next_id - first_id >= RETENTION_MAX_CLIPS)
+    {
+        reclaim(first_id);
+        portENTER_CRITICAL(&stats_lock);
+        stats.reclaimed++;
+        portEXIT_CRITICAL(&stats_lock);
+    }
+
+    uint32_t id = next_id++;
+    retention_clip_t *clip = clip_at(id);
+    memset(clip, 0, sizeof(*clip));
+    strncpy(clip->name, name, sizeof(clip->name) - 1);
+    clip->start_ms = start_ms;
+    clip->bytes = AVI_PREALLOCATE_BYTES;
+    clip->state = CLIP_STORED;
+    open_id = id;
+    esp_err_t res = journal_append(RECORD_ADD, id);
+
+    portENTER_CRITICAL(&stats_lock);
+    stats.clips++;
+    stats.bytes += clip->bytes;
+    portEXIT_CRITICAL(&stats_lock);
+    update_oldest();
+
+    // The new file takes its preallocation right away
+    reclaim_space();
+    return res;
+}
+
+esp_err_t retention_close(uint32_t bytes)
+{
+    if (!stored(open_id))
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    uint32_t id = open_id;
+    retention_clip_t *clip = clip_at(id);
+    open_id = 0;
+
+    portENTER_CRITICAL(&stats_lock);
+    stats.bytes += (int64_t)bytes - clip->bytes;
+    portEXIT_CRITICAL(&stats_lock);
+    clip->bytes = bytes;
+    esp_err_t res = journal_append(RECORD_ADD, id);
+
+    int64_t day = day_of(clip->start_ms);
+    if (day >= 0)
+    {
+        if (day != current_day)
+        {
+            current_day = day;
+            day_bytes = 0;
+            day_cursor = id;
+        }
+        day_bytes += bytes;
+        // The new clip itself always stays
+        while (day_bytes > RETENTION_DAY_QUOTA && day_cursor < id)
+        {
+            if (stored(day_cursor) && day_of(clip_at(day_cursor)->start_ms) == current_day)
+            {
+                day_bytes -= clip_at(day_cursor)->bytes;
+                reclaim(day_cursor);
+                portENTER_CRITICAL(&stats_lock);
+                stats.over_quota++;
+                portEXIT_CRITICAL(&stats_lock);
+            }
+            day_cursor++;
+        }
+    }
+
+    reclaim_space();
+    return res;
+}
+
+int64_t retention_oldest_ms()
+{
+    portENTER_CRITICAL(&stats_lock);
+    int64_t ms = oldest_ms;
+    portEXIT_CRITICAL(&stats_lock);
+    return ms;
+}
+
+void retention_get_stats(retention_stats_t *out)
+{
+    portENTER_CRITICAL(&stats_lock);
+    *out = stats;
+    portEXIT_CRITICAL(&stats_lock);
+}
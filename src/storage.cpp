@@ -0,0 +1,63 @@
+#include <Arduino.h>
+#include <sys/stat.h>
+
+#include "record_config.h"
+#include "storage.h"
+
+// pio test builds the card in against the host's SD_MMC, so the storage
+// modules can be tested without giving up the microphone in the program
+#if STORAGE_ENABLED || defined(UNIT_TEST)
+#define STORAGE_BUILT_IN 1
+#include <SD_MMC.h>
+#else
+#define STORAGE_BUILT_IN 0
+#endif
+
+static bool mounted = false;
+
+esp_err_t storage_mount()
+{
+#if STORAGE_BUILT_IN
+    // 1-bit mode: CLK 14, CMD 15, D0 2; leaves GPIO 4 (D1, the flash LED) and 12/13 alone
+    if (!SD_MMC.begin(STORAGE_MOUNT_POINT, true))
+    {
+        Serial.println("Storage: SD card mount failed");
+        return ESP_FAIL;
+    }
+    mkdir(CLIP_DIR, 0775);
+    mounted = true;
+    Serial.printf("Storage: %llu MB card, %llu MB used\r\n", (unsigned long long)(storage_total_bytes() >> 20),
+                  (unsigned long long)(storage_used_bytes() >> 20));
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+bool storage_mounted()
+{
+    return mounted;
+}
+
+uint64_t storage_total_bytes()
+{
+#if STORAGE_BUILT_IN
+    return mounted ? SD_MMC.totalBytes() : 0;
+#else
+    return 0;
+#endif
+}
+
+uint64_t storage_used_bytes()
+{
+#if STORAGE_BUILT_IN
+    return mounted ? SD_MMC.usedBytes() : 0;
+#else
+    return 0;
+#endif
+}
+
+uint64_t storage_free_bytes()
+{
+    return storage_total_bytes() - storage_used_bytes();
+}
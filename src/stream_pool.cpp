@@ -0,0 +1,493 @@
+#include <Arduino.h>
+#include <errno.h>
+#include <esp_heap_caps.h>
+#include <esp_http_server.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <lwip/sockets.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "stream_pool.h"
+
+#define STREAM_LISTEN_MAX 2
+#define STREAM_LISTEN_BACKLOG 4
+#define STREAM_ERROR_MAX 160
+
+// A worker task and the job it runs. The job comes first, so the
+// stream_job_t a run function is given leads back to its worker.
+typedef struct
+{
+    stream_job_t job;
+    stream_job_fn run;
+    httpd_handle_t hd;         // NULL for a connection taken on a legacy port
+    const stream_port_t *port; // Legacy port whose request head the worker still has to read, or NULL
+    TaskHandle_t task;
+    SemaphoreHandle_t start;   // Given when a job is handed over
+    bool busy;                 // From claim_worker() until the connection is closed
+    bool running;              // Job handed over and not finished
+    bool gone;                 // httpd is closing the session; no write may start
+    bool closed;               // httpd has closed it and called free_ctx
+    bool sending;              // A write to the socket is in flight; stream_pool_session_closing() waits for it
+} stream_worker_t;
+
+static stream_worker_t workers[STREAM_WORKERS];
+static SemaphoreHandle_t pool_lock = NULL; // Guards the workers' flags; never held across a send
+
+static const stream_port_t *listen_ports[STREAM_LISTEN_MAX];
+static int listen_fds[STREAM_LISTEN_MAX];
+static size_t listen_count = 0;
+static TaskHandle_t listener_task = NULL;
+
+static void worker_finish(stream_worker_t *worker)
+{
+    xSemaphoreTake(pool_lock, portMAX_DELAY);
+    worker->running = false;
+    if (!worker->hd)
+    {
+        lwip_close(worker->job.writer.fd);
+        worker->busy = false;
+    }
+    else if (worker->closed)
+    {
+        worker->busy = false;
+    }
+    else if (!worker->gone)
+    {
+        // Still ours while we hold the lock: the close hook takes it before closing. free_ctx frees the slot.
+        httpd_sess_trigger_close(worker->hd, worker->job.writer.fd);
+    }
+    xSemaphoreGive(pool_lock);
+}
+
+static bool read_legacy_head(stream_worker_t *worker);
+
+static void worker_loop(void *arg)
+{
+    stream_worker_t *worker = (stream_worker_t *)arg;
+
+    while (true)
+    {
+        xSemaphoreTake(worker->start, portMAX_DELAY);
+        if (!worker->port || read_legacy_head(worker))
+        {
+            worker->run(&worker->job);
+        }
+        worker_finish(worker);
+    }
+}
+
+void stream_pool_session_closing(httpd_handle_t hd, int sockfd)
+{
+    if (!pool_lock)
+    {
+        return;
+    }
+    xSemaphoreTake(pool_lock, portMAX_DELAY);
+    for (int i = 0; i < STREAM_WORKERS; i++)
+    {
+        stream_worker_t *worker = &workers[i];
+        if (!worker->busy || worker->hd != hd || worker->job.writer.fd != sockfd || worker->gone)
+        {
+            continue;
+        }
+        // No write starts after this; one in flight fails on the shut down socket
+        worker->gone = true;
+        while (worker->sending)
+        {
+            xSemaphoreGive(pool_lock);
+            vTaskDelay(1);
+            xSemaphoreTake(pool_lock, portMAX_DELAY);
+        }
+    }
+    xSemaphoreGive(pool_lock);
+}
+
+// The socket is closed by now; only the worker is left to release
+static void stream_pool_closed(void *ctx)
+{
+    stream_worker_t *worker = (stream_worker_t *)ctx;
+
+    xSemaphoreTake(pool_lock, portMAX_DELAY);
+    worker->gone = true;
+    worker->closed = true;
+    if (!worker->running)
+    {
+        worker->busy = false;
+    }
+    xSemaphoreGive(pool_lock);
+}
+
+// Marks a write as in flight unless httpd has closed the session
+static bool begin_send(stream_worker_t *worker)
+{
+    xSemaphoreTake(pool_lock, portMAX_DELAY);
+    bool ready = !worker->gone;
+    worker->sending = ready;
+    xSemaphoreGive(pool_lock);
+    return ready;
+}
+
+static void end_send(stream_worker_t *worker)
+{
+    xSemaphoreTake(pool_lock, portMAX_DELAY);
+    worker->sending = false;
+    xSemaphoreGive(pool_lock);
+}
+
+// Reserves an idle worker, creating its task the first time round
+static stream_worker_t *claim_worker()
+{
+    stream_worker_t *worker = NULL;
+    int index = 0;
+
+    xSemaphoreTake(pool_lock, portMAX_DELAY);
+    for (index = 0; index < STREAM_WORKERS; index++)
+    {
+        if (!workers[index].busy)
+        {
+            worker = &workers[index];
+            worker->busy = true;
+            worker->running = true;
+            worker->gone = false;
+            worker->closed = false;
+            worker->sending = false;
+            break;
+        }
+    }
+    xSemaphoreGive(pool_lock);
+
+    if (worker && !worker->task)
+    {
+        char name[16];
+        snprintf(name, sizeof(name), "stream%d", index);
+        size_t heapBefore = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+        worker->start = xSemaphoreCreateBinary();
+        if (!worker->start ||
+            xTaskCreatePinnedToCore(worker_loop, name, STREAM_WORKER_STACK, worker, STREAM_WORKER_PRIORITY, &worker->task,
+                                    index % portNUM_PROCESSORS) != pdPASS)
+        {
+            Serial.printf("Stream pool: cannot start worker %d\r\n", index);
+            if (worker->start)
+            {
+                vSemaphoreDelete(worker->start);
+            }
+            worker->start = NULL;
+            worker->task = NULL;
+            xSemaphoreTake(pool_lock, portMAX_DELAY);
+            worker->busy = false;
+            worker->running = false;
+            xSemaphoreGive(pool_lock);
+            return NULL;
+        }
+        // Measured rather than estimated; other tasks may allocate meanwhile, so read it off an idle board
+        Serial.printf("Stream pool: worker %d started, %d bytes of internal heap\r\n", index,
+                      (int)(heapBefore - heap_caps_get_free_size(MALLOC_CAP_INTERNAL)));
+    }
+    return worker;
+}
+
+static void hand_over(stream_worker_t *worker, const stream_route_t *route, httpd_handle_t hd, int fd, const char *query)
+{
+    worker->run = route->run;
+    worker->hd = hd;
+    worker->port = NULL;
+    worker->job.arg = route->arg;
+    worker->job.writer.fd = fd;
+    worker->job.writer.bytes = 0;
+    snprintf(worker->job.query, sizeof(worker->job.query), "%s", query);
+    xSemaphoreGive(worker->start);
+}
+
+esp_err_t stream_pool_handler(httpd_req_t *req)
+{
+    const stream_route_t *route = (const stream_route_t *)req->user_ctx;
+    char query[STREAM_QUERY_MAX] = "";
+
+    if (!pool_lock)
+    {
+        return httpd_resp_send_500(req);
+    }
+    stream_worker_t *worker = claim_worker();
+    if (!worker)
+    {
+        Serial.println("Stream pool: all workers busy");
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        return httpd_resp_send(req, NULL, 0);
+    }
+
+    // httpd keeps the socket open after the handler returns; stream_pool_session_closing() tells us when it goes away
+    httpd_req_get_url_query_str(req, query, sizeof(query));
+    req->sess_ctx = worker;
+    req->free_ctx = stream_pool_closed;
+    hand_over(worker, route, req->handle, httpd_req_to_sockfd(req), query);
+    return ESP_OK;
+}
+
+static int format_error(char *buf, size_t size, const char *status, const char *message)
+{
+    int len = snprintf(buf, size, "HTTP/1.1 %s\r\nContent-Type: text/plain\r\nContent-Length: %u\r\nConnection: close\r\n\r\n%s",
+                       status, (unsigned)strlen(message), message);
+    return (len < 0 || len >= (int)size) ? 0 : len;
+}
+
+static void answer(int fd, const char *status)
+{
+    char response[STREAM_ERROR_MAX];
+
+    int len = format_error(response, sizeof(response), status, "");
+    lwip_send(fd, response, len, 0);
+}
+
+// Reads the request head of a connection taken on a legacy port and picks
+// its route. Runs on the worker, so a slow client holds up only itself, for
+// at most STREAM_HEAD_TIMEOUT_MS. False when there is nothing to run; the
+// error, if any, has been answered and worker_finish() closes the socket.
+static bool read_legacy_head(stream_worker_t *worker)
+{
+    const stream_port_t *port = worker->port;
+    int fd = worker->job.writer.fd;
+    char head[STREAM_HEAD_MAX + 1];
+    size_t len = 0;
+
+    struct timeval timeout = {STREAM_HEAD_TIMEOUT_MS / 1000, (STREAM_HEAD_TIMEOUT_MS % 1000) * 1000};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    timeout = {STREAM_SEND_TIMEOUT_MS / 1000, (STREAM_SEND_TIMEOUT_MS % 1000) * 1000};
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    head[0] = '\0';
+    while (len < STREAM_HEAD_MAX && !strstr(head, "\r\n\r\n"))
+    {
+        ssize_t n = lwip_recv(fd, head + len, STREAM_HEAD_MAX - len, 0);
+        if (n <= 0)
+        {
+            return false;
+        }
+        len += n;
+        head[len] = '\0';
+    }
+
+    // Only the request line matters: GET <path>[?<query>] HTTP/1.x
+    if (strncmp(head, "GET ", 4) != 0)
+    {
+        answer(fd, "405 Method Not Allowed");
+        return false;
+    }
+    char *path = head + 4;
+    char *end = strpbrk(path, " \r\n");
+    if (!end)
+    {
+        answer(fd, "400 Bad Request");
+        return false;
+    }
+    *end = '\0';
+    char *query = strchr(path, '?');
+    if (query)
+    {
+        *query++ = '\0';
+    }
+
+    const stream_route_t *route = NULL;
+    for (size_t i = 0; i < port->route_count && !route; i++)
+    {
+        if (strcmp(path, port->routes[i].uri) == 0)
+        {
+            route = &port->routes[i];
+        }
+    }
+    if (!route)
+    {
+        answer(fd, "404 Not Found");
+        return false;
+    }
+
+    worker->run = route->run;
+    worker->job.arg = route->arg;
+    snprintf(worker->job.query, sizeof(worker->job.query), "%s", query ? query : "");
+    return true;
+}
+
+// Hands a connection accepted on a legacy port to a worker, which reads its
+// request head; the listener goes straight back to accepting.
+static void serve_legacy(const stream_port_t *port, int fd)
+{
+    stream_worker_t *worker = claim_worker();
+    if (!worker)
+    {
+        Serial.println("Stream pool: all workers busy");
+        answer(fd, "503 Service Unavailable");
+        lwip_close(fd);
+        return;
+    }
+    worker->hd = NULL;
+    worker->port = port;
+    worker->job.writer.fd = fd;
+    worker->job.writer.bytes = 0;
+    xSemaphoreGive(worker->start);
+}
+
+static void listener_loop(void *arg)
+{
+    while (true)
+    {
+        fd_set fds;
+        int maxFd = -1;
+
+        FD_ZERO(&fds);
+        for (size_t i = 0; i < listen_count; i++)
+        {
+            FD_SET(listen_fds[i], &fds);
+            maxFd = (listen_fds[i] > maxFd) ? listen_fds[i] : maxFd;
+        }
+        if (select(maxFd + 1, &fds, NULL, NULL, NULL) <= 0)
+        {
+            continue;
+        }
+        for (size_t i = 0; i < listen_count; i++)
+        {
+            if (FD_ISSET(listen_fds[i], &fds))
+            {
+                int fd = accept(listen_fds[i], NULL, NULL);
+                if (fd >= 0)
+                {
+                    serve_legacy(listen_ports[i], fd);
+                }
+            }
+        }
+    }
+}
+
+static int listen_on(uint16_t port)
+{
+    struct sockaddr_in addr = {};
+    int enable = 1;
+
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        return -1;
+    }
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable)) != 0 ||
+        bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, STREAM_LISTEN_BACKLOG) != 0)
+    {
+        lwip_close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+esp_err_t stream_pool_start(const stream_port_t *ports, size_t port_count)
+{
+    if (pool_lock)
+    {
+        return ESP_OK;
+    }
+    if (port_count > STREAM_LISTEN_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pool_lock = xSemaphoreCreateMutex();
+    if (!pool_lock)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Ports that do not open are left out; the web server has every route anyway
+    for (size_t i = 0; i < port_count; i++)
+    {
+        int fd = listen_on(ports[i].port);
+        if (fd < 0)
+        {
+            Serial.printf("Stream pool: cannot listen on port %d: %d\r\n", ports[i].port, errno);
+            continue;
+        }
+        Serial.printf("Stream pool: listening on port %d\r\n", ports[i].port);
+        listen_ports[listen_count] = &ports[i];
+        listen_fds[listen_count] = fd;
+        listen_count++;
+    }
+    if (listen_count &&
+        xTaskCreatePinnedToCore(listener_loop, "stream_listen", STREAM_LISTENER_STACK, NULL, STREAM_LISTENER_PRIORITY,
+                                &listener_task, STREAM_LISTENER_CORE) != pdPASS)
+    {
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+esp_err_t stream_job_begin(stream_job_t *job, const char *content_type, const char *body, size_t body_len)
+{
+    stream_worker_t *worker = (stream_worker_t *)job;
+    esp_err_t res = ESP_FAIL;
+
+    if (begin_send(worker))
+    {
+        res = stream_writer_begin_fd(&job->writer, job->writer.fd, content_type, body, body_len);
+        end_send(worker);
+    }
+    return res;
+}
+
+esp_err_t stream_job_error(stream_job_t *job, const char *status, const char *message)
+{
+    char response[STREAM_ERROR_MAX];
+
+    int len = format_error(response, sizeof(response), status, message);
+    const void *bufs[] = {response};
+    size_t lens[] = {(size_t)len};
+    return stream_job_send(job, bufs, lens, 1);
+}
+
+esp_err_t stream_job_send(stream_job_t *job, const void *const *bufs, const size_t *lens, int buf_count)
+{
+    stream_worker_t *worker = (stream_worker_t *)job;
+    esp_err_t res = ESP_FAIL;
+
+    if (begin_send(worker))
+    {
+        res = stream_writer_send(&job->writer, bufs, lens, buf_count);
+        end_send(worker);
+    }
+    return res;
+}
+
+esp_err_t stream_job_send_jpeg(stream_job_t *job, const uint8_t *jpg, size_t len, int64_t timestamp, const char *boundary)
+{
+    stream_worker_t *worker = (stream_worker_t *)job;
+    esp_err_t res = ESP_FAIL;
+
+    if (begin_send(worker))
+    {
+        res = stream_writer_send_jpeg(&job->writer, jpg, len, timestamp, boundary);
+        end_send(worker);
+    }
+    return res;
+}
+
+int stream_pool_busy()
+{
+    int busy = 0;
+
+    if (!pool_lock)
+    {
+        return 0;
+    }
+    xSemaphoreTake(pool_lock, portMAX_DELAY);
+    for (int i = 0; i < STREAM_WORKERS; i++)
+    {
+        busy += workers[i].running ? 1 : 0;
+    }
+    xSemaphoreGive(pool_lock);
+    return busy;
+}
+
+int stream_pool_stack_free(int worker)
+{
+    // Set once when the task is created and never cleared while it runs
+    TaskHandle_t task = workers[worker].task;
+    return task ? (int)uxTaskGetStackHighWaterMark(task) : -1;
+}
@@ -0,0 +1,103 @@
+#include <errno.h>
+#include <lwip/sockets.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "stream_writer.h"
+
+#define STREAM_WRITER_MAX_BUFS 4
+
+static const char *_STREAM_RESPONSE = "HTTP/1.1 200 OK\r\n"
+                                      "Content-Type: %s\r\n"
+                                      "Access-Control-Allow-Origin: *\r\n"
+                                      "Cache-Control: no-store\r\n"
+                                      "Connection: close\r\n"
+                                      "\r\n";
+static const char *_STREAM_PART = "Content-Type: image/jpeg\r\nContent-Length: %u\r\nX-Timestamp: %d.%06d\r\n\r\n";
+
+esp_err_t stream_writer_begin(stream_writer_t *writer, httpd_req_t *req, const char *content_type, const char *body, size_t body_len)
+{
+    return stream_writer_begin_fd(writer, httpd_req_to_sockfd(req), content_type, body, body_len);
+}
+
+esp_err_t stream_writer_begin_fd(stream_writer_t *writer, int fd, const char *content_type, const char *body, size_t body_len)
+{
+    char header[192];
+
+    writer->fd = fd;
+    writer->bytes = 0;
+    if (writer->fd < 0)
+    {
+        return ESP_FAIL;
+    }
+
+    int hlen = snprintf(header, sizeof(header), _STREAM_RESPONSE, content_type);
+    if (hlen < 0 || hlen >= (int)sizeof(header))
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    const void *bufs[] = {header, body};
+    size_t lens[] = {(size_t)hlen, body_len};
+    esp_err_t res = stream_writer_send(writer, bufs, lens, body_len ? 2 : 1);
+    writer->bytes = body_len; // Count body bytes only
+    return res;
+}
+
+esp_err_t stream_writer_send(stream_writer_t *writer, const void *const *bufs, const size_t *lens, int buf_count)
+{
+    struct iovec iov[STREAM_WRITER_MAX_BUFS];
+    int count = 0;
+
+    if (buf_count > STREAM_WRITER_MAX_BUFS)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int i = 0; i < buf_count; i++)
+    {
+        if (lens[i])
+        {
+            iov[count].iov_base = (void *)bufs[i];
+            iov[count].iov_len = lens[i];
+            count++;
+        }
+    }
+
+    // One writev per call in the common case; only a short write (socket
+    // buffer full) costs another round for the remainder
+    struct iovec *next = iov;
+    while (count > 0)
+    {
+        ssize_t sent = lwip_writev(writer->fd, next, count);
+        if (sent < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return ESP_FAIL;
+        }
+        writer->bytes += sent;
+        while (count > 0 && (size_t)sent >= next->iov_len)
+        {
+            sent -= next->iov_len;
+            next++;
+            count--;
+        }
+        if (count > 0)
+        {
+            next->iov_base = (uint8_t *)next->iov_base + sent;
+            next->iov_len -= sent;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t stream_writer_send_jpeg(stream_writer_t *writer, const uint8_t *jpg, size_t len, int64_t timestamp, const char *boundary)
+{
+    int hlen = snprintf(writer->part, sizeof(writer->part), _STREAM_PART, len, (int)(timestamp / 1000000), (int)(timestamp % 1000000));
+
+    const void *bufs[] = {writer->part, jpg, boundary};
+    size_t lens[] = {(size_t)hlen, len, strlen(boundary)};
+    return stream_writer_send(writer, bufs, lens, 3);
+}
@@ -0,0 +1,296 @@
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <img_converters.h>
+#include <string.h>
+
+#include "frame_broadcast.h"
+#include "stream_config.h"
+#include "substream.h"
+
+typedef struct
+{
+    bool active;
+    SemaphoreHandle_t ready; // Given by the substream task for every new frame
+} subscriber_t;
+
+typedef struct
+{
+    frame_slot_t *slot;
+    size_t len;
+} encode_target_t;
+
+static frame_ring_t ring;
+
+static subscriber_t subscribers[SUBSTREAM_MAX_CLIENTS];
+static uint8_t subscriber_count = 0;
+static portMUX_TYPE subscriber_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static substream_stats_t stats = {};
+static portMUX_TYPE stats_lock = portMUX_INITIALIZER_UNLOCKED;
+static volatile int quality = SUBSTREAM_QUALITY_DEFAULT;
+
+static SemaphoreHandle_t substream_wake = NULL;
+static TaskHandle_t substream_task = NULL;
+
+// Only touched by the substream task
+static uint8_t *rgb = NULL;
+static size_t rgb_size = 0;
+
+static void notify_subscribers()
+{
+    for (int i = 0; i < SUBSTREAM_MAX_CLIENTS; i++)
+    {
+        if (subscribers[i].active)
+        {
+            xSemaphoreGive(subscribers[i].ready);
+        }
+    }
+}
+
+// fmt2jpg_cb() output, straight into the ring slot
+static size_t encode_write(void *arg, size_t index, const void *data, size_t len)
+{
+    encode_target_t *target = (encode_target_t *)arg;
+    if (index + len > target->slot->capacity)
+    {
+        return 0;
+    }
+    memcpy(target->slot->buf + index, data, len);
+    target->len = index + len;
+    return len;
+}
+
+static bool reencode(const frame_slot_t *frame, uint32_t *decode_us, uint32_t *encode_us, uint16_t *out_width, uint16_t *out_height)
+{
+    // Largest reduction that still leaves SUBSTREAM_WIDTH, as one of the decoder's 1/2, 1/4, 1/8 steps
+    int shift = JPG_SCALE_8X;
+    while (shift > JPG_SCALE_2X && (frame->width >> shift) < SUBSTREAM_WIDTH)
+    {
+        shift--;
+    }
+    uint16_t width = frame->width >> shift;
+    uint16_t height = frame->height >> shift;
+
+    // The decoder rounds partial blocks at the right and bottom edges up
+    size_t need = (size_t)(width + 8) * (height + 8) * 3;
+    if (need > rgb_size)
+    {
+        uint8_t *grown = (uint8_t *)heap_caps_realloc(rgb, need, MALLOC_CAP_SPIRAM);
+        if (!grown)
+        {
+            return false;
+        }
+        rgb = grown;
+        rgb_size = need;
+    }
+
+    int64_t start = esp_timer_get_time();
+    if (!jpg2rgb888(frame->buf, frame->len, rgb, (jpg_scale_t)shift))
+    {
+        return false;
+    }
+    int64_t decoded = esp_timer_get_time();
+
+    encode_target_t target = {frame_ring_begin_write(&ring, SUBSTREAM_SLOT_SIZE), 0};
+    if (!target.slot)
+    {
+        return false;
+    }
+    if (!fmt2jpg_cb(rgb, (size_t)width * height * 3, width, height, PIXFORMAT_RGB888, quality, encode_write, &target))
+    {
+        frame_ring_abort(&ring, target.slot);
+        return false;
+    }
+    target.slot->len = target.len;
+    // Keep the capture time, so /sub clients pace and measure like main stream ones
+    frame_ring_commit(&ring, target.slot, width, height, frame->timestamp);
+
+    *decode_us = decoded - start;
+    *encode_us = esp_timer_get_time() - decoded;
+    *out_width = width;
+    *out_height = height;
+    return true;
+}
+
+static void substream_loop(void *arg)
+{
+    int sub = -1;
+    uint32_t lastSeq = 0;
+
+    while (true)
+    {
+        if (subscriber_count == 0)
+        {
+            if (sub >= 0)
+            {
+                // Let the capture task idle when nobody else needs frames
+                frame_broadcast_unsubscribe(sub);
+                sub = -1;
+            }
+            xSemaphoreTake(substream_wake, portMAX_DELAY);
+            continue;
+        }
+        if (sub < 0)
+        {
+            sub = frame_broadcast_subscribe_internal();
+            if (sub < 0)
+            {
+                vTaskDelay(pdMS_TO_TICKS(1000));
+                continue;
+            }
+            lastSeq = 0;
+        }
+
+        frame_slot_t *frame = frame_broadcast_acquire(sub, lastSeq, pdMS_TO_TICKS(FRAME_WAIT_TIMEOUT_MS));
+        if (!frame)
+        {
+            continue;
+        }
+        lastSeq = frame->seq;
+
+        uint32_t decodeUs = 0, encodeUs = 0;
+        uint16_t width = 0, height = 0;
+        bool ok = reencode(frame, &decodeUs, &encodeUs, &width, &height);
+        frame_broadcast_release(frame);
+
+        portENTER_CRITICAL(&stats_lock);
+        if (ok)
+        {
+            stats.frames++;
+            stats.decode_us = decodeUs;
+            stats.encode_us = encodeUs;
+            stats.decode_us_total += decodeUs;
+            stats.encode_us_total += encodeUs;
+            stats.width = width;
+            stats.height = height;
+        }
+        else
+        {
+            stats.errors++;
+        }
+        portEXIT_CRITICAL(&stats_lock);
+
+        if (ok)
+        {
+            notify_subscribers();
+        }
+    }
+}
+
+esp_err_t substream_start()
+{
+    if (substream_task)
+    {
+        return ESP_OK;
+    }
+    esp_err_t res = frame_ring_init(&ring, SUBSTREAM_RING_SLOTS, SUBSTREAM_SLOT_SIZE);
+    if (res != ESP_OK)
+    {
+        Serial.println("Substream: failed to allocate frame ring");
+        return res;
+    }
+    substream_wake = xSemaphoreCreateBinary();
+    if (!substream_wake)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    for (int i = 0; i < SUBSTREAM_MAX_CLIENTS; i++)
+    {
+        subscribers[i].ready = xSemaphoreCreateBinary();
+        if (!subscribers[i].ready)
+        {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    if (xTaskCreatePinnedToCore(substream_loop, "substream", SUBSTREAM_TASK_STACK, NULL, SUBSTREAM_TASK_PRIORITY, &substream_task, SUBSTREAM_TASK_CORE) != pdPASS)
+    {
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+int substream_subscribe()
+{
+    int sub = -1;
+
+    if (!substream_task)
+    {
+        return -1;
+    }
+    portENTER_CRITICAL(&subscriber_lock);
+    for (int i = 0; i < SUBSTREAM_MAX_CLIENTS; i++)
+    {
+        if (!subscribers[i].active)
+        {
+            subscribers[i].active = true;
+            subscriber_count++;
+            sub = i;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&subscriber_lock);
+
+    if (sub >= 0)
+    {
+        // Drop a wakeup left over from the previous owner of this slot
+        xSemaphoreTake(subscribers[sub].ready, 0);
+        xSemaphoreGive(substream_wake);
+    }
+    return sub;
+}
+
+void substream_unsubscribe(int sub)
+{
+    if (sub < 0 || sub >= SUBSTREAM_MAX_CLIENTS)
+    {
+        return;
+    }
+    portENTER_CRITICAL(&subscriber_lock);
+    if (subscribers[sub].active)
+    {
+        subscribers[sub].active = false;
+        subscriber_count--;
+    }
+    portEXIT_CRITICAL(&subscriber_lock);
+}
+
+frame_slot_t *substream_acquire(int sub, uint32_t last_seq, TickType_t timeout)
+{
+    while (true)
+    {
+        frame_slot_t *frame = frame_ring_acquire(&ring, last_seq);
+        if (frame)
+        {
+            return frame;
+        }
+        if (xSemaphoreTake(subscribers[sub].ready, timeout) != pdTRUE)
+        {
+            return NULL;
+        }
+    }
+}
+
+void substream_release(frame_slot_t *frame)
+{
+    frame_ring_release(&ring, frame);
+}
+
+void substream_get_stats(substream_stats_t *out)
+{
+    portENTER_CRITICAL(&stats_lock);
+    *out = stats;
+    portEXIT_CRITICAL(&stats_lock);
+}
+
+int substream_set(const char *name, int value)
+{
+    if (!strcmp(name, "sub_quality") && value >= 1 && value <= 100)
+        quality = value;
+    else
+        return -1;
+    return 0;
+}
@@ -0,0 +1,320 @@
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <esp_http_server.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <stdarg.h>
+#include <stdio.h>
+
+#include "stream_writer.h"
+#include "trace.h"
+
+#if TRACE_ENABLED
+
+#define TRACE_CORES 2
+#define TRACE_MAX_TASKS 24 // Distinct tasks named in one export
+#define TRACE_CHUNK_SIZE 1024
+#define TRACE_TASK_CORE 0
+#define TRACE_TASK_PRIORITY 2
+#define TRACE_TASK_STACK 4096
+
+typedef struct
+{
+    uint32_t timestamp; // Microseconds since the recording started
+    const char *name;
+    TaskHandle_t task;
+    char phase; // 'B' or 'E'
+} trace_event_t;
+
+typedef struct
+{
+    trace_event_t *events;
+    uint32_t next; // Slots claimed so far, may run past TRACE_EVENTS_PER_CORE
+    uint32_t dropped;
+} trace_buffer_t;
+
+// The /trace session, parked while recording the way /events parks its clients
+typedef struct
+{
+    httpd_handle_t hd;
+    stream_writer_t writer;
+    uint32_t ms;
+    uint32_t generation; // sess_ctx of the parked session, so a late free_ctx cannot clear a newer one
+    bool active;         // Parked and not closed yet
+    bool sending;        // The trace task is writing to it; trace_session_closing() waits for this to clear
+} trace_session_t;
+
+static trace_buffer_t buffers[TRACE_CORES];
+static volatile bool recording = false;
+static int64_t started = 0;
+static bool busy = false; // From a /trace request until its answer is sent
+
+static trace_session_t session;
+static SemaphoreHandle_t session_lock = NULL; // Guards the session's flags; never held across a send
+static SemaphoreHandle_t trace_wake = NULL;
+static TaskHandle_t trace_task = NULL;
+
+// Only touched by the trace task
+static char chunk[TRACE_CHUNK_SIZE];
+static size_t chunk_len = 0;
+static esp_err_t chunk_res = ESP_OK;
+
+void trace_record(const char *name, char phase)
+{
+    if (!recording)
+    {
+        return;
+    }
+    int64_t now = esp_timer_get_time();
+    trace_buffer_t *b = &buffers[xPortGetCoreID()];
+    uint32_t i = __atomic_fetch_add(&b->next, 1, __ATOMIC_RELAXED);
+    if (i >= TRACE_EVENTS_PER_CORE)
+    {
+        __atomic_fetch_add(&b->dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    trace_event_t *e = &b->events[i];
+    e->timestamp = now - started;
+    e->name = name;
+    e->task = xTaskGetCurrentTaskHandle();
+    e->phase = phase;
+}
+
+static void flush()
+{
+    if (chunk_res == ESP_OK && chunk_len)
+    {
+        const void *bufs[] = {chunk};
+        size_t lens[] = {chunk_len};
+        chunk_res = stream_writer_send(&session.writer, bufs, lens, 1);
+    }
+    chunk_len = 0;
+}
+
+static void emit(const char *format, ...)
+{
+    va_list args;
+
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+        va_start(args, format);
+        int n = vsnprintf(chunk + chunk_len, sizeof(chunk) - chunk_len, format, args);
+        va_end(args);
+        if (n >= 0 && (size_t)n < sizeof(chunk) - chunk_len)
+        {
+            chunk_len += n;
+            return;
+        }
+        flush();
+    }
+}
+
+static uint32_t event_count(int core)
+{
+    return buffers[core].next < TRACE_EVENTS_PER_CORE ? buffers[core].next : TRACE_EVENTS_PER_CORE;
+}
+
+// Names every task seen in the recording. Tasks in this firmware are never
+// deleted, so their names are still valid here.
+static void emit_task_names()
+{
+    TaskHandle_t tasks[TRACE_MAX_TASKS];
+    int count = 0;
+
+    for (int c = 0; c < TRACE_CORES; c++)
+    {
+        for (uint32_t i = 0; i < event_count(c) && count < TRACE_MAX_TASKS; i++)
+        {
+            TaskHandle_t task = buffers[c].events[i].task;
+            int j = 0;
+            while (j < count && tasks[j] != task)
+            {
+                j++;
+            }
+            if (j == count)
+            {
+                tasks[count++] = task;
+                emit(",{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                     (uint32_t)(uintptr_t)task, pcTaskGetName(task));
+            }
+        }
+    }
+}
+
+// Called with the session marked sending, without session_lock
+static void send_trace()
+{
+    chunk_len = 0;
+    chunk_res = stream_writer_begin_fd(&session.writer, session.writer.fd, "application/json", NULL, 0);
+
+    emit("{\"displayTimeUnit\":\"ms\",\"otherData\":{\"window_ms\":%u,\"dropped\":%u},\"traceEvents\":["
+         "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"esp32cam\"}}",
+         session.ms, buffers[0].dropped + buffers[1].dropped);
+    emit_task_names();
+    for (int c = 0; c < TRACE_CORES; c++)
+    {
+        for (uint32_t i = 0; i < event_count(c) && chunk_res == ESP_OK; i++)
+        {
+            const trace_event_t *e = &buffers[c].events[i];
+            emit(",{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%u,\"pid\":1,\"tid\":%u,\"args\":{\"core\":%d}}",
+                 e->name, e->phase, e->timestamp, (uint32_t)(uintptr_t)e->task, c);
+        }
+    }
+    emit("]}");
+    flush();
+}
+
+static void trace_loop(void *arg)
+{
+    while (true)
+    {
+        xSemaphoreTake(trace_wake, portMAX_DELAY);
+        vTaskDelay(pdMS_TO_TICKS(session.ms));
+        recording = false;
+        // Let a task that was between the recording check and its store finish
+        vTaskDelay(pdMS_TO_TICKS(2));
+
+        xSemaphoreTake(session_lock, portMAX_DELAY);
+        bool ready = session.active;
+        session.sending = ready;
+        xSemaphoreGive(session_lock);
+
+        if (ready)
+        {
+            send_trace();
+        }
+
+        xSemaphoreTake(session_lock, portMAX_DELAY);
+        session.sending = false;
+        // The body ends with the connection, unless httpd closed it during the send
+        if (ready && session.active)
+        {
+            httpd_sess_trigger_close(session.hd, session.writer.fd);
+        }
+        xSemaphoreGive(session_lock);
+        __atomic_store_n(&busy, false, __ATOMIC_RELEASE);
+    }
+}
+
+void trace_session_closing(httpd_handle_t hd, int sockfd)
+{
+    if (!session_lock)
+    {
+        return;
+    }
+    xSemaphoreTake(session_lock, portMAX_DELAY);
+    if (session.active && session.hd == hd && session.writer.fd == sockfd)
+    {
+        // The recording may go on, but its result is not sent
+        session.active = false;
+        while (session.sending)
+        {
+            xSemaphoreGive(session_lock);
+            vTaskDelay(1);
+            xSemaphoreTake(session_lock, portMAX_DELAY);
+        }
+    }
+    xSemaphoreGive(session_lock);
+}
+
+// Nothing to release: trace_session_closing() has already stopped the sends
+static void trace_session_closed(void *ctx)
+{
+    xSemaphoreTake(session_lock, portMAX_DELAY);
+    if ((uint32_t)(uintptr_t)ctx == session.generation)
+    {
+        session.active = false;
+    }
+    xSemaphoreGive(session_lock);
+}
+
+static esp_err_t trace_prepare()
+{
+    if (!trace_task)
+    {
+        session_lock = xSemaphoreCreateMutex();
+        trace_wake = xSemaphoreCreateBinary();
+        if (!session_lock || !trace_wake ||
+            xTaskCreatePinnedToCore(trace_loop, "trace", TRACE_TASK_STACK, NULL, TRACE_TASK_PRIORITY, &trace_task, TRACE_TASK_CORE) != pdPASS)
+        {
+            return ESP_FAIL;
+        }
+    }
+    for (int c = 0; c < TRACE_CORES; c++)
+    {
+        if (!buffers[c].events)
+        {
+            buffers[c].events = (trace_event_t *)heap_caps_malloc(TRACE_EVENTS_PER_CORE * sizeof(trace_event_t), MALLOC_CAP_SPIRAM);
+        }
+        if (!buffers[c].events)
+        {
+            return ESP_ERR_NO_MEM;
+        }
+        buffers[c].next = 0;
+        buffers[c].dropped = 0;
+    }
+    return ESP_OK;
+}
+
+// Starts the recording and parks the session; the trace task answers it
+// when the window is over, so the web server is not held up meanwhile and
+// the handlers on it can be traced too.
+esp_err_t trace_handler(httpd_req_t *req)
+{
+    char query[32] = "";
+    char value[16];
+    uint32_t ms = TRACE_DEFAULT_MS;
+
+    httpd_req_get_url_query_str(req, query, sizeof(query));
+    if (httpd_query_key_value(query, "ms", value, sizeof(value)) == ESP_OK)
+    {
+        ms = atoi(value);
+    }
+    if (ms < 1 || ms > TRACE_MAX_MS)
+    {
+        return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "ms out of range");
+    }
+
+    bool expected = false;
+    if (!__atomic_compare_exchange_n(&busy, &expected, true, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    {
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        return httpd_resp_sendstr(req, "A trace is already recording");
+    }
+    if (trace_prepare() != ESP_OK)
+    {
+        __atomic_store_n(&busy, false, __ATOMIC_RELEASE);
+        return httpd_resp_send_500(req);
+    }
+
+    xSemaphoreTake(session_lock, portMAX_DELAY);
+    session.hd = req->handle;
+    session.writer.fd = httpd_req_to_sockfd(req);
+    session.ms = ms;
+    session.generation++;
+    session.active = true;
+    req->sess_ctx = (void *)(uintptr_t)session.generation;
+    req->free_ctx = trace_session_closed;
+    xSemaphoreGive(session_lock);
+
+    started = esp_timer_get_time();
+    recording = true;
+    xSemaphoreGive(trace_wake);
+    return ESP_OK;
+}
+
+#else
+
+esp_err_t trace_handler(httpd_req_t *req)
+{
+    httpd_resp_set_status(req, "501 Not Implemented");
+    return httpd_resp_sendstr(req, "Tracing needs a build with TRACE_ENABLED=1");
+}
+
+void trace_session_closing(httpd_handle_t hd, int sockfd)
+{
+}
+
+#endif
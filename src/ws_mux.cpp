@@ -0,0 +1,655 @@
+#include <Arduino.h>
+#include <esp_http_server.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "audio_capture.h"
+#include "audio_codec.h"
+#include "audio_config.h"
+#include "events.h"
+#include "frame_broadcast.h"
+#include "metrics.h"
+#include "stream_writer.h"
+#include "substream.h"
+#include "trace.h"
+#include "ws_mux.h"
+
+#define WS_FRAME_HEADER_MAX 10 // Opcode byte and the longest length encoding; server frames are not masked
+#define WS_CONTROL_MAX 125     // Longest control frame payload the protocol allows
+#define WS_HELLO_MAX 192
+#define WS_EVENTS_BATCH 8
+#define WS_EVENT_JSON_MAX 160
+
+#define WS_FIN 0x80
+#define WS_OP_BINARY 0x2
+#define WS_OP_CLOSE 0x8
+#define WS_OP_PONG 0xa
+
+// A video source the task follows while at least one client watches it
+typedef struct
+{
+    const char *name; // ?video= value and /metrics label
+    int (*subscribe)();
+    void (*unsubscribe)(int sub);
+    frame_slot_t *(*acquire)(int sub, uint32_t last_seq, TickType_t timeout);
+    void (*release)(frame_slot_t *frame);
+    int sub;             // -1 while not subscribed
+    uint32_t seq;        // Of the last frame taken
+    frame_slot_t *frame; // Taken this round, NULL if nothing new
+} ws_source_t;
+
+// Kept off the task stack and only allocated for clients that asked for audio
+typedef struct
+{
+    audio_listener_t listener;
+    audio_encoder_t encoder;
+    int16_t samples[AUDIO_BLOCK_SAMPLES];
+    uint8_t encoded[AUDIO_BLOCK_SAMPLES * sizeof(int16_t)]; // Every codec's output fits in the size of its PCM input
+} ws_audio_t;
+
+// One /ws connection. As with /events, the slot stays taken until httpd has
+// closed the session and called ws_client_closed().
+typedef struct
+{
+    bool active;
+    bool closing; // Close requested or under way, free_ctx not called yet; also set while the handshake sets the slot up
+    bool sending; // The ws task is writing to it without clients_lock; ws_mux_session_closing() waits for this to clear
+    httpd_handle_t hd;
+    stream_writer_t writer;
+    ws_source_t *video; // NULL when the client did not ask for video
+    uint32_t video_seq;
+    int metrics_slot;
+    ws_audio_t *audio; // NULL when the client did not ask for audio
+    bool events;
+    uint32_t event_seq;
+    uint8_t control_op; // Pong or close the ws task still owes the client, 0 for none
+    uint8_t control_len;
+    uint8_t control[WS_CONTROL_MAX];
+} ws_client_t;
+
+static ws_source_t sources[] = {
+    {"main", frame_broadcast_subscribe_internal, frame_broadcast_unsubscribe, frame_broadcast_acquire, frame_broadcast_release, -1, 0, NULL},
+    {"sub", substream_subscribe, substream_unsubscribe, substream_acquire, substream_release, -1, 0, NULL},
+};
+#define WS_SOURCE_COUNT (sizeof(sources) / sizeof(sources[0]))
+
+static ws_client_t clients[WS_MAX_CLIENTS];
+static SemaphoreHandle_t clients_lock = NULL; // Guards the slots' flags and pending control frames; never held across a send
+static SemaphoreHandle_t ws_wake = NULL;
+static TaskHandle_t ws_task = NULL;
+
+// Only touched by the ws task
+static char event_json[WS_EVENT_JSON_MAX];
+static uint8_t control_payload[WS_CONTROL_MAX];
+
+// Writes one unmasked binary frame: the WebSocket header, the message header, then the payload
+static esp_err_t send_frame(ws_client_t *client, uint8_t opcode, const ws_msg_header_t *msg, const void *payload, size_t len)
+{
+    uint8_t header[WS_FRAME_HEADER_MAX + sizeof(ws_msg_header_t)];
+    size_t total = len + (msg ? sizeof(*msg) : 0);
+    size_t n = 0;
+
+    header[n++] = WS_FIN | opcode;
+    if (total < 126)
+    {
+        header[n++] = total;
+    }
+    else if (total < 65536)
+    {
+        header[n++] = 126;
+        header[n++] = total >> 8;
+        header[n++] = total;
+    }
+    else
+    {
+        header[n++] = 127;
+        for (int shift = 56; shift >= 0; shift -= 8)
+        {
+            header[n++] = (uint64_t)total >> shift;
+        }
+    }
+    if (msg)
+    {
+        memcpy(header + n, msg, sizeof(*msg));
+        n += sizeof(*msg);
+    }
+
+    const void *bufs[] = {header, payload};
+    size_t lens[] = {n, len};
+    return stream_writer_send(&client->writer, bufs, lens, 2);
+}
+
+static esp_err_t send_message(ws_client_t *client, ws_msg_type_t type, uint32_t seq, int64_t timestamp, const void *payload, size_t len)
+{
+    ws_msg_header_t msg = {};
+    msg.type = type;
+    msg.seq = seq;
+    msg.timestamp = timestamp;
+    return send_frame(client, WS_OP_BINARY, &msg, payload, len);
+}
+
+static esp_err_t client_send_video(ws_client_t *client)
+{
+    frame_slot_t *frame = client->video ? client->video->frame : NULL;
+    if (!frame || frame->seq == client->video_seq)
+    {
+        return ESP_OK;
+    }
+    int64_t started = esp_timer_get_time();
+    size_t sentBefore = client->writer.bytes;
+    TRACE_BEGIN("ws_video");
+    esp_err_t res = send_message(client, WS_MSG_JPEG, frame->seq, frame->timestamp, frame->buf, frame->len);
+    TRACE_END("ws_video");
+    if (res == ESP_OK)
+    {
+        metrics_stream_sent(client->metrics_slot, client->writer.bytes - sentBefore, esp_timer_get_time() - started);
+        client->video_seq = frame->seq;
+    }
+    return res;
+}
+
+// Sends whole blocks only, so every message is a full block whatever the codec
+static esp_err_t client_send_audio(ws_client_t *client)
+{
+    ws_audio_t *audio = client->audio;
+    if (!audio)
+    {
+        return ESP_OK;
+    }
+    while (audio_listener_available(&audio->listener) >= AUDIO_BLOCK_SAMPLES)
+    {
+        uint32_t position = audio->listener.cursor;
+        int64_t now = esp_timer_get_time();
+        size_t samples = audio_listener_read(&audio->listener, audio->samples, AUDIO_BLOCK_SAMPLES, 0);
+        size_t encodedLen = audio_encoder_encode(&audio->encoder, audio->samples, samples, audio->encoded);
+        if (encodedLen > 0)
+        {
+            esp_err_t res = send_message(client, WS_MSG_AUDIO, position, now, audio->encoded, encodedLen);
+            if (res != ESP_OK)
+            {
+                return res;
+            }
+        }
+    }
+    return ESP_OK;
+}
+
+static esp_err_t client_send_events(ws_client_t *client)
+{
+    event_t batch[WS_EVENTS_BATCH];
+    size_t count;
+
+    if (!client->events)
+    {
+        return ESP_OK;
+    }
+    while ((count = events_read(client->event_seq, batch, WS_EVENTS_BATCH)) > 0)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            int len = event_to_json(&batch[i], event_json, sizeof(event_json));
+            if (send_message(client, WS_MSG_EVENT, batch[i].seq, batch[i].timestamp, event_json, len) != ESP_OK)
+            {
+                return ESP_FAIL;
+            }
+            client->event_seq = batch[i].seq;
+        }
+    }
+    return ESP_OK;
+}
+
+// Called by clients_lock holders only.
+static void client_drop(ws_client_t *client)
+{
+    client->closing = true;
+    httpd_sess_trigger_close(client->hd, client->writer.fd);
+}
+
+// Subscribes to the sources some active client watches and lets go of the others
+static void update_sources()
+{
+    for (size_t s = 0; s < WS_SOURCE_COUNT; s++)
+    {
+        ws_source_t *source = &sources[s];
+        bool wanted = false;
+        xSemaphoreTake(clients_lock, portMAX_DELAY);
+        for (int i = 0; i < WS_MAX_CLIENTS; i++)
+        {
+            wanted |= clients[i].active && !clients[i].closing && clients[i].video == source;
+        }
+        xSemaphoreGive(clients_lock);
+
+        if (wanted && source->sub < 0)
+        {
+            source->sub = source->subscribe();
+        }
+        else if (!wanted && source->sub >= 0)
+        {
+            source->unsubscribe(source->sub);
+            source->sub = -1;
+        }
+    }
+}
+
+static bool any_client()
+{
+    bool any = false;
+    xSemaphoreTake(clients_lock, portMAX_DELAY);
+    for (int i = 0; i < WS_MAX_CLIENTS; i++)
+    {
+        any |= clients[i].active;
+    }
+    xSemaphoreGive(clients_lock);
+    return any;
+}
+
+// Waits for a frame from the first subscribed source, or WS_POLL_MS when
+// there is none, then takes whatever the other sources have as well
+static void take_frames()
+{
+    TickType_t wait = pdMS_TO_TICKS(WS_POLL_MS);
+    bool waited = false;
+
+    for (size_t s = 0; s < WS_SOURCE_COUNT; s++)
+    {
+        ws_source_t *source = &sources[s];
+        if (source->sub < 0)
+        {
+            continue;
+        }
+        source->frame = source->acquire(source->sub, source->seq, waited ? 0 : wait);
+        waited = true;
+        if (source->frame)
+        {
+            source->seq = source->frame->seq;
+        }
+    }
+    if (!waited)
+    {
+        // No video wanted; audio and events set the pace
+        xSemaphoreTake(ws_wake, wait);
+    }
+}
+
+static void release_frames()
+{
+    for (size_t s = 0; s < WS_SOURCE_COUNT; s++)
+    {
+        if (sources[s].frame)
+        {
+            sources[s].release(sources[s].frame);
+            sources[s].frame = NULL;
+        }
+    }
+}
+
+static void ws_loop(void *arg)
+{
+    while (true)
+    {
+        update_sources();
+        if (!any_client())
+        {
+            xSemaphoreTake(ws_wake, portMAX_DELAY);
+            continue;
+        }
+        take_frames();
+
+        for (int i = 0; i < WS_MAX_CLIENTS; i++)
+        {
+            ws_client_t *client = &clients[i];
+
+            // Marked as sending, the slot stays ours while we write without the lock
+            xSemaphoreTake(clients_lock, portMAX_DELAY);
+            bool ready = client->active && !client->closing;
+            uint8_t controlOp = ready ? client->control_op : 0;
+            size_t controlLen = client->control_len;
+            if (controlOp)
+            {
+                memcpy(control_payload, client->control, controlLen);
+                client->control_op = 0;
+            }
+            client->sending = ready;
+            xSemaphoreGive(clients_lock);
+            if (!ready)
+            {
+                continue;
+            }
+
+            // A pong or close goes out between two messages, never inside one
+            esp_err_t res = ESP_OK;
+            if (controlOp)
+            {
+                res = send_frame(client, controlOp, NULL, control_payload, controlLen);
+            }
+            if (controlOp != WS_OP_CLOSE)
+            {
+                // Events first: they are small, and the reason a viewer looks
+                if (res == ESP_OK)
+                {
+                    res = client_send_events(client);
+                }
+                if (res == ESP_OK)
+                {
+                    res = client_send_audio(client);
+                }
+                if (res == ESP_OK)
+                {
+                    res = client_send_video(client);
+                }
+            }
+
+            xSemaphoreTake(clients_lock, portMAX_DELAY);
+            client->sending = false;
+            // Skipped when httpd started closing the session during the send; its close hook is waiting for us
+            if (!client->closing && (res != ESP_OK || controlOp == WS_OP_CLOSE))
+            {
+                if (res != ESP_OK)
+                {
+                    Serial.println("WebSocket: client gone");
+                }
+                client_drop(client);
+            }
+            xSemaphoreGive(clients_lock);
+        }
+        release_frames();
+    }
+}
+
+static void release_client(ws_client_t *client);
+
+void ws_mux_session_closing(httpd_handle_t hd, int sockfd)
+{
+    if (!clients_lock)
+    {
+        return;
+    }
+    xSemaphoreTake(clients_lock, portMAX_DELAY);
+    for (int i = 0; i < WS_MAX_CLIENTS; i++)
+    {
+        ws_client_t *client = &clients[i];
+        if (!client->active || client->hd != hd || client->writer.fd != sockfd)
+        {
+            continue;
+        }
+        // The ws task sends nothing more, not even a close frame
+        client->closing = true;
+        while (client->sending)
+        {
+            xSemaphoreGive(clients_lock);
+            vTaskDelay(1);
+            xSemaphoreTake(clients_lock, portMAX_DELAY);
+        }
+    }
+    xSemaphoreGive(clients_lock);
+}
+
+static void ws_client_closed(void *ctx)
+{
+    ws_client_t *client = (ws_client_t *)ctx;
+
+    // Left reserved by ws_mux_session_closing(), so no new client takes the
+    // slot before its audio is let go
+    xSemaphoreTake(clients_lock, portMAX_DELAY);
+    client->closing = true;
+    client->active = false;
+    xSemaphoreGive(clients_lock);
+
+    metrics_stream_close(client->metrics_slot);
+    release_client(client);
+    xSemaphoreGive(ws_wake);
+}
+
+esp_err_t ws_mux_start()
+{
+    if (ws_task)
+    {
+        return ESP_OK;
+    }
+    clients_lock = xSemaphoreCreateMutex();
+    ws_wake = xSemaphoreCreateBinary();
+    if (!clients_lock || !ws_wake)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    if (xTaskCreatePinnedToCore(ws_loop, "ws", WS_TASK_STACK, NULL, WS_TASK_PRIORITY, &ws_task, WS_TASK_CORE) != pdPASS)
+    {
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+// Reserves a free slot. It stays invisible to the ws task until it is active.
+static ws_client_t *claim_client()
+{
+    ws_client_t *client = NULL;
+
+    xSemaphoreTake(clients_lock, portMAX_DELAY);
+    for (int i = 0; i < WS_MAX_CLIENTS; i++)
+    {
+        if (!clients[i].active && !clients[i].closing)
+        {
+            client = &clients[i];
+            client->closing = true; // Reserved
+            break;
+        }
+    }
+    xSemaphoreGive(clients_lock);
+    return client;
+}
+
+static void release_client(ws_client_t *client)
+{
+    if (client->audio)
+    {
+        audio_listener_detach(&client->audio->listener);
+        free(client->audio);
+        client->audio = NULL;
+    }
+    xSemaphoreTake(clients_lock, portMAX_DELAY);
+    client->closing = false;
+    xSemaphoreGive(clients_lock);
+}
+
+// Reads ?video=, ?audio= and ?events= into the reserved slot
+static esp_err_t client_setup(ws_client_t *client, httpd_req_t *req)
+{
+    char query[64] = "";
+    char value[8];
+
+    client->video = &sources[0];
+    client->video_seq = 0;
+    client->metrics_slot = -1;
+    client->audio = NULL;
+    client->events = true;
+    client->event_seq = events_latest_seq();
+    client->control_op = 0;
+
+    httpd_req_get_url_query_str(req, query, sizeof(query));
+    if (httpd_query_key_value(query, "video", value, sizeof(value)) == ESP_OK)
+    {
+        client->video = NULL;
+        for (size_t s = 0; s < WS_SOURCE_COUNT; s++)
+        {
+            if (!strcmp(value, sources[s].name))
+            {
+                client->video = &sources[s];
+            }
+        }
+        if (!client->video && strcmp(value, "off"))
+        {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    if (httpd_query_key_value(query, "events", value, sizeof(value)) == ESP_OK)
+    {
+        client->events = atoi(value) != 0;
+    }
+    if (httpd_query_key_value(query, "audio", value, sizeof(value)) == ESP_OK && strcmp(value, "off"))
+    {
+        const audio_codec_t *codec = audio_codec_find(value);
+        if (!codec)
+        {
+            return ESP_ERR_INVALID_ARG;
+        }
+        client->audio = (ws_audio_t *)malloc(sizeof(ws_audio_t));
+        if (!client->audio)
+        {
+            return ESP_ERR_NO_MEM;
+        }
+        audio_encoder_init(&client->audio->encoder, codec);
+        if (audio_listener_attach(&client->audio->listener) != ESP_OK)
+        {
+            free(client->audio);
+            client->audio = NULL;
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    if (client->video)
+    {
+        client->metrics_slot = metrics_stream_open("ws");
+    }
+    return ESP_OK;
+}
+
+static esp_err_t send_hello(ws_client_t *client)
+{
+    char hello[WS_HELLO_MAX];
+    int len;
+
+    if (client->audio)
+    {
+        const audio_codec_t *codec = client->audio->encoder.codec;
+        len = snprintf(hello, sizeof(hello),
+                       "{\"video\":\"%s\",\"events\":%s,\"audio\":{\"codec\":\"%s\",\"format_tag\":%u,\"sample_rate\":%u,"
+                       "\"bits_per_sample\":%u,\"block_align\":%u,\"samples_per_block\":%u}}",
+                       client->video ? client->video->name : "off", client->events ? "true" : "false", codec->name,
+                       codec->format_tag, SAMPLE_RATE, codec->bits_per_sample, codec->block_align, codec->samples_per_block);
+    }
+    else
+    {
+        len = snprintf(hello, sizeof(hello), "{\"video\":\"%s\",\"events\":%s,\"audio\":null}",
+                       client->video ? client->video->name : "off", client->events ? "true" : "false");
+    }
+    return send_message(client, WS_MSG_HELLO, 0, esp_timer_get_time(), hello, len);
+}
+
+// The handshake: httpd has already answered it when this is called, so
+// refusing the client only means closing the connection
+static esp_err_t ws_open(httpd_req_t *req)
+{
+    if (httpd_ws_get_fd_info(req->handle, httpd_req_to_sockfd(req)) != HTTPD_WS_CLIENT_WEBSOCKET)
+    {
+        // A plain GET reaches the handler too
+        return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "WebSocket upgrade expected");
+    }
+    if (!ws_task)
+    {
+        return ESP_FAIL;
+    }
+    ws_client_t *client = claim_client();
+    if (!client)
+    {
+        Serial.println("WebSocket: too many clients");
+        return ESP_FAIL;
+    }
+    client->hd = req->handle;
+    client->writer.fd = httpd_req_to_sockfd(req);
+    client->writer.bytes = 0;
+
+    esp_err_t res = client_setup(client, req);
+    if (res == ESP_OK)
+    {
+        // The slot is not active yet, so the ws task leaves the socket alone while we write to it
+        res = send_hello(client);
+    }
+    if (res != ESP_OK)
+    {
+        Serial.printf("WebSocket: failed to set up client: %s\r\n", esp_err_to_name(res));
+        metrics_stream_close(client->metrics_slot);
+        release_client(client);
+        return ESP_FAIL;
+    }
+
+    xSemaphoreTake(clients_lock, portMAX_DELAY);
+    client->active = true;
+    client->closing = false;
+    req->sess_ctx = client;
+    req->free_ctx = ws_client_closed;
+    xSemaphoreGive(clients_lock);
+    xSemaphoreGive(ws_wake);
+
+    Serial.printf("WebSocket: client connected, video %s, audio %s, events %s\r\n", client->video ? client->video->name : "off",
+                  client->audio ? client->audio->encoder.codec->name : "off", client->events ? "on" : "off");
+    return ESP_OK;
+}
+
+// Messages from the client are ignored, however long. httpd does not skip
+// what the handler leaves unread, so it is read here and dropped.
+static esp_err_t skip_payload(httpd_req_t *req, size_t len)
+{
+    char discard[64];
+    int fd = httpd_req_to_sockfd(req);
+
+    while (len > 0)
+    {
+        int n = httpd_socket_recv(req->handle, fd, discard, len < sizeof(discard) ? len : sizeof(discard), 0);
+        if (n <= 0)
+        {
+            return ESP_FAIL;
+        }
+        len -= n;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ws_mux_handler(httpd_req_t *req)
+{
+    httpd_ws_frame_t frame = {};
+    uint8_t payload[WS_CONTROL_MAX];
+
+    if (req->method == HTTP_GET)
+    {
+        return ws_open(req);
+    }
+
+    ws_client_t *client = (ws_client_t *)req->sess_ctx;
+    if (!client || httpd_ws_recv_frame(req, &frame, 0) != ESP_OK)
+    {
+        return ESP_FAIL;
+    }
+    if (frame.type != HTTPD_WS_TYPE_PING && frame.type != HTTPD_WS_TYPE_CLOSE)
+    {
+        return skip_payload(req, frame.len);
+    }
+    if (frame.len > sizeof(payload))
+    {
+        return ESP_FAIL; // Not a valid control frame
+    }
+    frame.payload = payload;
+    if (frame.len && httpd_ws_recv_frame(req, &frame, frame.len) != ESP_OK)
+    {
+        return ESP_FAIL;
+    }
+
+    // Left to the ws task rather than answered by httpd, so they cannot cut
+    // into a message it is writing and this task never waits on a send.
+    // A newer ping's pong replaces an unsent one; a close is never replaced.
+    if (frame.type == HTTPD_WS_TYPE_PING || frame.type == HTTPD_WS_TYPE_CLOSE)
+    {
+        xSemaphoreTake(clients_lock, portMAX_DELAY);
+        if (client->active && !client->closing && client->control_op != WS_OP_CLOSE)
+        {
+            client->control_op = (frame.type == HTTPD_WS_TYPE_PING) ? WS_OP_PONG : WS_OP_CLOSE;
+            client->control_len = frame.len;
+            memcpy(client->control, payload, frame.len);
+        }
+        xSemaphoreGive(clients_lock);
+        xSemaphoreGive(ws_wake);
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,282 @@
+// Encoders against reference vectors: G.711 mu-law against its expansion
+// table and CPython's audioop, IMA-ADPCM against blocks audioop.lin2adpcm
+// produced from the same input, repacked into WAV blocks. Ends with the
+// encoders' throughput.
+#include <esp_timer.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unity.h>
+
+#include "audio_codec.h"
+
+#define TEST_SAMPLES (ADPCM_SAMPLES_PER_BLOCK * 2)
+#define BENCH_SAMPLES (16000 * 60) // A minute of audio at the default rate
+
+typedef struct
+{
+    int16_t pcm;
+    uint8_t ulaw;
+} ulaw_vector_t;
+
+// audioop.lin2ulaw() on either side of a few decision levels
+static const ulaw_vector_t ulaw_vectors[] = {
+    {0, 0xff}, {3, 0xff}, {4, 0xfe}, {31, 0xfb}, {33, 0xfb}, {95, 0xf3}, {96, 0xf3}, {223, 0xe9},
+    {224, 0xe9}, {479, 0xdc}, {480, 0xdc}, {991, 0xce}, {992, 0xce}, {2015, 0xbf}, {2016, 0xbf},
+    {4063, 0xaf}, {4064, 0xaf}, {8159, 0x9f}, {8160, 0x9f}, {16000, 0x90}, {32124, 0x80}, {32767, 0x80}};
+
+// Two blocks of test_signal(): audioop.lin2adpcm(), state (first sample, index) per block
+static const uint8_t adpcm_reference[ADPCM_BLOCK_ALIGN * 2] = {
+    0xbc, 0xb1, 0x00, 0x00, 0x77, 0x77, 0x77, 0xa7, 0xa6, 0x02, 0x18, 0x02, 0x29, 0x7b, 0x19, 0x91,
+    0x20, 0x04, 0x2a, 0x02, 0x14, 0x1c, 0xa5, 0x31, 0x88, 0x10, 0x79, 0xa2, 0x82, 0x51, 0x5a, 0x18,
+    0x90, 0xb3, 0x82, 0x53, 0xd1, 0x83, 0xb5, 0xa5, 0x12, 0x2b, 0x20, 0x31, 0x8a, 0xa6, 0x04, 0x19,
+    0x03, 0x38, 0x3c, 0xb0, 0x27, 0x88, 0x59, 0xa0, 0x93, 0x06, 0x19, 0x38, 0xa8, 0x94, 0x06, 0xb0,
+    0x86, 0x80, 0x11, 0x4b, 0xa0, 0x94, 0xf4, 0xff, 0x89, 0x80, 0x80, 0x00, 0x08, 0x80, 0x80, 0x10,
+    0x88, 0x81, 0x81, 0x00, 0x80, 0x12, 0x01, 0x29, 0x7a, 0x2a, 0x30, 0xb1, 0x51, 0x81, 0xa2, 0x90,
+    0x23, 0xb4, 0x27, 0x4a, 0x2a, 0x80, 0x22, 0x60, 0x98, 0x50, 0xa1, 0x11, 0x28, 0x83, 0x3b, 0x38,
+    0x37, 0x93, 0x11, 0x6a, 0xd3, 0x93, 0x95, 0xc3, 0x93, 0x02, 0x50, 0x88, 0x81, 0xa4, 0xa4, 0x43,
+    0xa8, 0x92, 0x63, 0x0a, 0x92, 0x07, 0x18, 0x08, 0x19, 0xff, 0xff, 0x08, 0x80, 0x80, 0x00, 0x08,
+    0x80, 0x80, 0x80, 0x81, 0x00, 0x00, 0x28, 0x19, 0x81, 0xb2, 0x84, 0xa2, 0x60, 0x2a, 0x20, 0x1a,
+    0x31, 0x02, 0x80, 0x78, 0x90, 0x94, 0x91, 0x34, 0x20, 0x3e, 0x80, 0x24, 0x1b, 0x01, 0x41, 0x4b,
+    0x18, 0x92, 0x17, 0x10, 0x4b, 0x69, 0x2b, 0x38, 0x18, 0x04, 0x0b, 0x85, 0x00, 0x01, 0x68, 0x2a,
+    0x40, 0x01, 0xa9, 0x96, 0x22, 0x98, 0xa6, 0x04, 0x89, 0x94, 0xa2, 0xf3, 0xff, 0x8e, 0x00, 0x08,
+    0x80, 0x18, 0x08, 0x08, 0x80, 0x00, 0x18, 0x19, 0x01, 0x89, 0x20, 0x90, 0x30, 0x14, 0x4d, 0x3a,
+    0x29, 0xa1, 0x96, 0x08, 0x04, 0x3b, 0x91, 0x83, 0x28, 0xa5, 0x83, 0x85, 0x6b, 0x3a, 0x38, 0x88,
+    0x10, 0x13, 0xa1, 0x28, 0x48, 0x86, 0x92, 0x17, 0xb0, 0x00, 0x97, 0x30, 0x1b, 0x31, 0x08, 0x92,
+    0xcc, 0x2a, 0x31, 0x00, 0x78, 0x20, 0x91, 0xd4, 0xa3, 0x96, 0x81, 0x80, 0x32, 0x29, 0x9a, 0x42,
+    0x38, 0x22, 0xff, 0xff, 0x8b, 0x80, 0x80, 0x00, 0x80, 0x08, 0x81, 0x00, 0x00, 0x39, 0x88, 0x10,
+    0x01, 0xc2, 0x31, 0x91, 0x43, 0xc1, 0x13, 0x7b, 0x09, 0x23, 0x4c, 0x98, 0x13, 0x80, 0xc4, 0x94,
+    0x81, 0x50, 0x90, 0x84, 0x81, 0x38, 0x39, 0x80, 0x61, 0x4b, 0x38, 0x2b, 0x10, 0x42, 0xb8, 0x97,
+    0x82, 0xa5, 0x83, 0xa3, 0x94, 0x23, 0x5b, 0x99, 0x83, 0x97, 0x93, 0xc3, 0x04, 0x90, 0x00, 0x84,
+    0x20, 0x91, 0x39, 0x97, 0xf2, 0xff, 0x8e, 0x00, 0x08, 0x08, 0x00, 0x88, 0x81, 0x00, 0x08, 0x19,
+    0x91, 0x92, 0x82, 0x92, 0x38, 0x7f, 0x7f, 0x7d, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f,
+    0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f,
+    0x7f, 0x7f, 0x7f, 0x0a, 0x88, 0x00, 0x08, 0x08, 0x80, 0x80, 0x00, 0x18, 0x88, 0x01, 0x08, 0x00,
+    0x00, 0xa0, 0x83, 0x21, 0xa1, 0x14, 0x2c, 0xff, 0xef, 0x80, 0x80, 0x00, 0x08, 0x08, 0x08, 0x80,
+    0x00, 0x00, 0x29, 0x08, 0x00, 0x28, 0x09, 0xa4, 0x22, 0x80, 0x83, 0x10, 0x1c, 0x14, 0x93, 0x21,
+    0xc1, 0x14, 0x30, 0x87, 0x11, 0x12, 0xc9, 0x17, 0x08, 0x19, 0x81, 0x84, 0xa3, 0xb2, 0x87, 0x13,
+    0x4c, 0x29, 0x90, 0x84, 0x91, 0x24, 0x4d, 0x80, 0x29, 0x29, 0xa4, 0x82, 0xa2, 0x94, 0x30, 0x05,
+    0x6a, 0x4b, 0x90, 0x21, 0x89, 0x84, 0x00, 0xa3, 0x61, 0x02, 0xff, 0xff, 0x08, 0x08, 0x80, 0x00,
+    0x08, 0x08, 0x18, 0x09, 0x10, 0x08, 0x00, 0x08, 0x38, 0x88, 0x91, 0xb5, 0x94, 0x81, 0x02, 0xb1,
+    0x84, 0x22, 0x8a, 0x51, 0x81, 0x31, 0x88, 0x62, 0x18, 0xb7, 0x32, 0x1a, 0x10, 0x42, 0x1c, 0x00,
+};
+
+static int16_t signal_buf[TEST_SAMPLES];
+static uint8_t out_buf[ADPCM_BLOCK_ALIGN * 2];
+
+// A sawtooth with noise on it and a burst of full-scale square wave, so the
+// step index runs up and down and the predictor clamps
+static void test_signal(int16_t *out)
+{
+    uint32_t state = 12345;
+    for (int n = 0; n < TEST_SAMPLES; n++)
+    {
+        state = state * 1103515245 + 12345;
+        int v = (n * 300) % 40000 - 20000 + (int)((state >> 16) & 0x7ff) - 1024;
+        if (n >= 700 && n < 760)
+        {
+            v = (n & 1) ? 32767 : -32768;
+        }
+        out[n] = v > 32767 ? 32767 : v < -32768 ? -32768 : v;
+    }
+}
+
+// G.711 expansion
+static int ulaw_decode(uint8_t code)
+{
+    code = ~code;
+    int t = (((code & 0x0f) << 3) + 0x84) << ((code & 0x70) >> 4);
+    return (code & 0x80) ? 0x84 - t : t - 0x84;
+}
+
+// The IMA reference decoder, for one mono WAV block
+static void adpcm_decode_block(const uint8_t *in, int16_t *out)
+{
+    static const int8_t index_table[16] = {-1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8};
+    static const int16_t step_table[89] = {
+        7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66,
+        73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449,
+        494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272,
+        2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442,
+        11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767};
+
+    int predictor = (int16_t)(in[0] | (in[1] << 8));
+    int index = in[2];
+    out[0] = predictor;
+    for (int i = 1; i < ADPCM_SAMPLES_PER_BLOCK; i++)
+    {
+        uint8_t byte = in[4 + (i - 1) / 2];
+        uint8_t nibble = (i & 1) ? byte & 0x0f : byte >> 4;
+        int step = step_table[index];
+        int diff = step >> 3;
+        if (nibble & 4)
+            diff += step;
+        if (nibble & 2)
+            diff += step >> 1;
+        if (nibble & 1)
+            diff += step >> 2;
+        predictor += (nibble & 8) ? -diff : diff;
+        predictor = predictor > 32767 ? 32767 : predictor < -32768 ? -32768 : predictor;
+        index += index_table[nibble];
+        index = index < 0 ? 0 : index > 88 ? 88 : index;
+        out[i] = predictor;
+    }
+}
+
+void setUp(void)
+{
+    test_signal(signal_buf);
+    memset(out_buf, 0, sizeof(out_buf));
+}
+
+void tearDown(void)
+{
+}
+
+static void test_ulaw_matches_reference_vectors(void)
+{
+    for (size_t i = 0; i < sizeof(ulaw_vectors) / sizeof(ulaw_vectors[0]); i++)
+    {
+        TEST_ASSERT_EQUAL_HEX8(ulaw_vectors[i].ulaw, ulaw_encode_sample(ulaw_vectors[i].pcm));
+        // Decision levels are symmetric around zero; only the sign bit differs
+        if (ulaw_vectors[i].pcm)
+        {
+            TEST_ASSERT_EQUAL_HEX8(ulaw_vectors[i].ulaw & 0x7f, ulaw_encode_sample(-ulaw_vectors[i].pcm));
+        }
+    }
+    TEST_ASSERT_EQUAL_HEX8(0x00, ulaw_encode_sample(-32768));
+}
+
+static void test_ulaw_round_trips_every_code(void)
+{
+    for (int code = 0; code < 256; code++)
+    {
+        if (code == 0x7f)
+        {
+            continue; // Negative zero, which encodes back as 0xff
+        }
+        TEST_ASSERT_EQUAL_HEX8(code, ulaw_encode_sample(ulaw_decode(code)));
+    }
+}
+
+// Below the clip level every input decodes back to within half a step of its segment
+static void test_ulaw_error_within_half_step(void)
+{
+    for (int pcm = -32124; pcm <= 32124; pcm++)
+    {
+        uint8_t code = ulaw_encode_sample(pcm);
+        int exponent = ((~code) & 0x70) >> 4;
+        TEST_ASSERT_INT_WITHIN(4 << exponent, pcm, ulaw_decode(code));
+    }
+}
+
+static void test_adpcm_matches_reference_blocks(void)
+{
+    audio_encoder_t encoder;
+
+    audio_encoder_init(&encoder, &audio_codec_adpcm);
+    TEST_ASSERT_EQUAL(sizeof(out_buf), audio_encoder_max_output(&encoder, TEST_SAMPLES));
+    TEST_ASSERT_EQUAL(sizeof(out_buf), audio_encoder_encode(&encoder, signal_buf, TEST_SAMPLES, out_buf));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(adpcm_reference, out_buf, sizeof(out_buf));
+}
+
+// i2s_read() hands over whatever it has; blocks must not depend on it
+static void test_adpcm_split_input_matches_whole(void)
+{
+    static const size_t splits[] = {1, 7, 100, 504, 505, 506};
+    audio_encoder_t encoder;
+
+    for (size_t s = 0; s < sizeof(splits) / sizeof(splits[0]); s++)
+    {
+        size_t written = 0;
+        audio_encoder_init(&encoder, &audio_codec_adpcm);
+        memset(out_buf, 0, sizeof(out_buf));
+        for (size_t i = 0; i < TEST_SAMPLES; i += splits[s])
+        {
+            size_t n = TEST_SAMPLES - i < splits[s] ? TEST_SAMPLES - i : splits[s];
+            TEST_ASSERT_LESS_OR_EQUAL(sizeof(out_buf) - written, audio_encoder_max_output(&encoder, n));
+            written += audio_encoder_encode(&encoder, signal_buf + i, n, out_buf + written);
+        }
+        TEST_ASSERT_EQUAL(sizeof(out_buf), written);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(adpcm_reference, out_buf, sizeof(out_buf));
+    }
+}
+
+static void test_adpcm_round_trip_keeps_a_tone(void)
+{
+    static int16_t tone[ADPCM_SAMPLES_PER_BLOCK * 2];
+    static int16_t decoded[ADPCM_SAMPLES_PER_BLOCK * 2];
+    audio_encoder_t encoder;
+    double signal = 0, noise = 0;
+
+    for (size_t i = 0; i < sizeof(tone) / sizeof(tone[0]); i++)
+    {
+        tone[i] = (int16_t)(8000 * sin(2 * M_PI * 440 * i / 16000.0));
+    }
+    audio_encoder_init(&encoder, &audio_codec_adpcm);
+    audio_encoder_encode(&encoder, tone, sizeof(tone) / sizeof(tone[0]), out_buf);
+    adpcm_decode_block(out_buf, decoded);
+    adpcm_decode_block(out_buf + ADPCM_BLOCK_ALIGN, decoded + ADPCM_SAMPLES_PER_BLOCK);
+
+    for (size_t i = 0; i < sizeof(tone) / sizeof(tone[0]); i++)
+    {
+        signal += (double)tone[i] * tone[i];
+        noise += (double)(tone[i] - decoded[i]) * (tone[i] - decoded[i]);
+    }
+    char message[64];
+    snprintf(message, sizeof(message), "snr %.1f dB", 10 * log10(signal / noise));
+    TEST_MESSAGE(message);
+    TEST_ASSERT_GREATER_THAN_MESSAGE(20, 10 * log10(signal / noise), message);
+}
+
+static void bench_codec(const audio_codec_t *codec)
+{
+    int16_t *in = (int16_t *)malloc(BENCH_SAMPLES * sizeof(int16_t));
+    uint8_t *out = (uint8_t *)malloc(BENCH_SAMPLES * sizeof(int16_t));
+    audio_encoder_t encoder;
+
+    TEST_ASSERT_NOT_NULL(in);
+    TEST_ASSERT_NOT_NULL(out);
+    for (size_t i = 0; i < BENCH_SAMPLES; i++)
+    {
+        in[i] = signal_buf[i % TEST_SAMPLES];
+    }
+    audio_encoder_init(&encoder, codec);
+
+    // The capture task's read size
+    int64_t start = esp_timer_get_time();
+    size_t written = 0;
+    for (size_t i = 0; i < BENCH_SAMPLES; i += 512)
+    {
+        written += audio_encoder_encode(&encoder, in + i, 512, out + written);
+    }
+    int64_t us = esp_timer_get_time() - start;
+
+    char message[96];
+    snprintf(message, sizeof(message), "%s: %.1f Msamples/s, %u bytes", codec->name,
+             us ? BENCH_SAMPLES / (double)us : 0.0, (unsigned)written);
+    TEST_MESSAGE(message);
+    free(in);
+    free(out);
+}
+
+static void test_encoder_throughput(void)
+{
+    bench_codec(&audio_codec_pcm);
+    bench_codec(&audio_codec_ulaw);
+    bench_codec(&audio_codec_adpcm);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_ulaw_matches_reference_vectors);
+    RUN_TEST(test_ulaw_round_trips_every_code);
+    RUN_TEST(test_ulaw_error_within_half_step);
+    RUN_TEST(test_adpcm_matches_reference_blocks);
+    RUN_TEST(test_adpcm_split_input_matches_whole);
+    RUN_TEST(test_adpcm_round_trip_keeps_a_tone);
+    RUN_TEST(test_encoder_throughput);
+    return UNITY_END();
+}
@@ -0,0 +1,220 @@
+// The capture DSP chain: a golden run of the default chain over a fixed
+// signal, each stage's effect on its own, and the chain's throughput.
+#include <esp_timer.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unity.h>
+
+#include "audio_config.h"
+#include "audio_dsp.h"
+
+#define GOLDEN_SAMPLES (SAMPLE_RATE * 2)
+#define GOLDEN_STRIDE 2000
+#define BENCH_SAMPLES (SAMPLE_RATE * 60)
+
+// golden_signal() through the default chain: FNV-1a of the output and every
+// GOLDEN_STRIDE-th sample. Regenerate with GOLDEN_PRINT defined after a
+// change that is meant to alter the output.
+static const uint32_t golden_hash = 0x30f5507f;
+static const int16_t golden_samples[GOLDEN_SAMPLES / GOLDEN_STRIDE] = {
+    764, -2864, 2683, -2684, 2690, -2690, 2670, -2662, 2702, -173, 0, 0, 0, 0, 0, 0};
+
+static int16_t buf[BENCH_SAMPLES];
+
+// Speech band tones with a DC offset, hum and noise, loud for a second,
+// then quiet enough for the gate
+static void golden_signal(int16_t *out, size_t count)
+{
+    uint32_t state = 1;
+    for (size_t n = 0; n < count; n++)
+    {
+        double t = (double)n / SAMPLE_RATE;
+        double level = n < SAMPLE_RATE ? 6000 : 20;
+        state = state * 1664525 + 1013904223;
+        double v = 800 + 150 * sin(2 * M_PI * 50 * t) + level * (sin(2 * M_PI * 300 * t) + 0.5 * sin(2 * M_PI * 1100 * t)) +
+                   (int)((state >> 20) & 0x1f) - 16;
+        out[n] = (int16_t)lrint(v);
+    }
+}
+
+static void tone(int16_t *out, size_t count, double hz, double amplitude, double offset)
+{
+    for (size_t n = 0; n < count; n++)
+    {
+        out[n] = (int16_t)lrint(offset + amplitude * sin(2 * M_PI * hz * n / SAMPLE_RATE));
+    }
+}
+
+// As the capture task does, one i2s_read() block at a time
+static void process(int16_t *samples, size_t count)
+{
+    for (size_t i = 0; i < count; i += AUDIO_BLOCK_SAMPLES)
+    {
+        size_t n = count - i < AUDIO_BLOCK_SAMPLES ? count - i : AUDIO_BLOCK_SAMPLES;
+        audio_dsp_filter(samples + i, n);
+        audio_dsp_gain(samples + i, n);
+    }
+}
+
+static double rms(const int16_t *samples, size_t count)
+{
+    double sum = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        sum += (double)samples[i] * samples[i];
+    }
+    return sqrt(sum / count);
+}
+
+static void set(const char *name, int value)
+{
+    TEST_ASSERT_EQUAL(0, audio_dsp_set(name, value));
+}
+
+void setUp(void)
+{
+    set("audio_dc", 1);
+    set("audio_hpf", 1);
+    set("audio_hpf_hz", 120);
+    set("audio_agc", 1);
+    set("audio_agc_target", 20);
+    set("audio_agc_max_gain", 30);
+    set("audio_gate", 1);
+    set("audio_gate_threshold", 55);
+    audio_dsp_init();
+}
+
+void tearDown(void)
+{
+}
+
+static void test_default_chain_matches_golden(void)
+{
+    golden_signal(buf, GOLDEN_SAMPLES);
+    process(buf, GOLDEN_SAMPLES);
+
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < GOLDEN_SAMPLES; i++)
+    {
+        hash = (hash ^ (uint16_t)buf[i]) * 16777619u;
+    }
+#ifdef GOLDEN_PRINT
+    printf("static const uint32_t golden_hash = 0x%08x;\n", hash);
+    for (size_t i = 0; i < GOLDEN_SAMPLES; i += GOLDEN_STRIDE)
+    {
+        printf("%d, ", buf[i]);
+    }
+    printf("\n");
+#endif
+    for (size_t i = 0; i < GOLDEN_SAMPLES; i += GOLDEN_STRIDE)
+    {
+        TEST_ASSERT_EQUAL_INT16(golden_samples[i / GOLDEN_STRIDE], buf[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(golden_hash, hash);
+}
+
+static void test_dc_offset_is_removed(void)
+{
+    set("audio_agc", 0);
+    set("audio_gate", 0);
+    tone(buf, SAMPLE_RATE * 2, 1000, 4000, 3000);
+    process(buf, SAMPLE_RATE * 2);
+
+    double mean = 0;
+    for (size_t i = SAMPLE_RATE; i < SAMPLE_RATE * 2; i++)
+    {
+        mean += buf[i];
+    }
+    TEST_ASSERT_INT_WITHIN(20, 0, lrint(mean / SAMPLE_RATE));
+}
+
+static void test_highpass_stops_hum_and_passes_speech(void)
+{
+    set("audio_agc", 0);
+    set("audio_gate", 0);
+    tone(buf, SAMPLE_RATE, 30, 8000, 0);
+    process(buf, SAMPLE_RATE);
+    double hum = rms(buf + SAMPLE_RATE / 2, SAMPLE_RATE / 2);
+
+    audio_dsp_init();
+    tone(buf, SAMPLE_RATE, 1000, 8000, 0);
+    process(buf, SAMPLE_RATE);
+    double speech = rms(buf + SAMPLE_RATE / 2, SAMPLE_RATE / 2);
+
+    double in = 8000 / sqrt(2);
+    TEST_ASSERT_LESS_THAN(in / 10, hum);
+    TEST_ASSERT_GREATER_THAN(in * 0.95, speech);
+}
+
+static void test_gate_mutes_quiet_blocks(void)
+{
+    set("audio_agc", 0);
+    tone(buf, SAMPLE_RATE, 1000, 10, 0); // About -70 dBFS
+    process(buf, SAMPLE_RATE);
+    for (size_t i = SAMPLE_RATE / 2; i < SAMPLE_RATE; i++)
+    {
+        TEST_ASSERT_EQUAL_INT16(0, buf[i]);
+    }
+}
+
+static void test_agc_reaches_target(void)
+{
+    set("audio_gate", 0);
+    tone(buf, SAMPLE_RATE * 4, 1000, 800, 0); // About -35 dBFS peak
+    process(buf, SAMPLE_RATE * 4);
+
+    // Target is 20 dB below full scale, as a mean square level
+    double target = 32767 * pow(10, -20 / 20.0);
+    double level = rms(buf + SAMPLE_RATE * 3, SAMPLE_RATE);
+    TEST_ASSERT_INT_WITHIN(target * 0.2, target, level);
+}
+
+// At the largest gain the Q12 product needs more than 32 bits; a loud block
+// arriving then must saturate, not wrap around to the other sign
+static void test_full_gain_saturates_instead_of_wrapping(void)
+{
+    set("audio_gate", 0);
+    set("audio_agc_max_gain", 40);
+    tone(buf, SAMPLE_RATE * 4, 1000, 30, 0);
+    process(buf, SAMPLE_RATE * 4);
+
+    static int16_t loud[AUDIO_BLOCK_SAMPLES];
+    tone(loud, AUDIO_BLOCK_SAMPLES, 1000, 30000, 0);
+    memcpy(buf, loud, sizeof(loud));
+    audio_dsp_filter(buf, AUDIO_BLOCK_SAMPLES);
+    int16_t filtered[AUDIO_BLOCK_SAMPLES];
+    memcpy(filtered, buf, sizeof(filtered));
+    audio_dsp_gain(buf, AUDIO_BLOCK_SAMPLES);
+    for (size_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++)
+    {
+        TEST_ASSERT_TRUE((int32_t)filtered[i] * buf[i] >= 0);
+    }
+}
+
+static void test_chain_throughput(void)
+{
+    golden_signal(buf, BENCH_SAMPLES);
+    int64_t start = esp_timer_get_time();
+    process(buf, BENCH_SAMPLES);
+    int64_t us = esp_timer_get_time() - start;
+
+    char message[96];
+    snprintf(message, sizeof(message), "%.1f Msamples/s, %.2f us per %d sample block", us ? BENCH_SAMPLES / (double)us : 0.0,
+             (double)us * AUDIO_BLOCK_SAMPLES / BENCH_SAMPLES, AUDIO_BLOCK_SAMPLES);
+    TEST_MESSAGE(message);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_default_chain_matches_golden);
+    RUN_TEST(test_dc_offset_is_removed);
+    RUN_TEST(test_highpass_stops_hum_and_passes_speech);
+    RUN_TEST(test_gate_mutes_quiet_blocks);
+    RUN_TEST(test_agc_reaches_target);
+    RUN_TEST(test_full_gain_saturates_instead_of_wrapping);
+    RUN_TEST(test_chain_throughput);
+    return UNITY_END();
+}
@@ -0,0 +1,272 @@
+// /control parsing against a mock sensor that logs every setter call, so a
+// test sees which settings were applied, with what value and in what order,
+// and that a request turned down touched nothing.
+#include <string.h>
+#include <unity.h>
+
+#include "control.h"
+
+#define LOG_MAX 64
+
+typedef struct
+{
+    const char *setter;
+    int value;
+} setter_call_t;
+
+static sensor_t sensor;
+static setter_call_t calls[LOG_MAX];
+static int call_count;
+static char answer[CONTROL_ANSWER_MAX];
+
+static int record(const char *setter, int value)
+{
+    if (call_count < LOG_MAX)
+    {
+        calls[call_count].setter = setter;
+        calls[call_count].value = value;
+    }
+    call_count++;
+    return 0;
+}
+
+#define MOCK_SETTER(setter)                            \
+    static int mock_##setter(sensor_t *, int value)    \
+    {                                                  \
+        return record(#setter, value);                 \
+    }
+MOCK_SETTER(set_ae_level)
+MOCK_SETTER(set_exposure_ctrl)
+MOCK_SETTER(set_aec2)
+MOCK_SETTER(set_aec_value)
+MOCK_SETTER(set_gain_ctrl)
+MOCK_SETTER(set_agc_gain)
+MOCK_SETTER(set_whitebal)
+MOCK_SETTER(set_awb_gain)
+MOCK_SETTER(set_hmirror)
+MOCK_SETTER(set_vflip)
+MOCK_SETTER(set_wpc)
+
+// The real driver turns down a quality it cannot do
+static int mock_set_quality(sensor_t *, int value)
+{
+    record("set_quality", value);
+    return (value < 4 || value > 63) ? -1 : 0;
+}
+
+static int mock_set_framesize(sensor_t *, framesize_t value)
+{
+    return record("set_framesize", value);
+}
+
+static int mock_set_gainceiling(sensor_t *, gainceiling_t value)
+{
+    return record("set_gainceiling", value);
+}
+
+static void assert_calls(int count, const setter_call_t *expected)
+{
+    TEST_ASSERT_EQUAL_INT(count, call_count);
+    for (int i = 0; i < count; i++)
+    {
+        TEST_ASSERT_EQUAL_STRING(expected[i].setter, calls[i].setter);
+        TEST_ASSERT_EQUAL_INT(expected[i].value, calls[i].value);
+    }
+}
+
+static int apply_query(const char *query)
+{
+    char copy[512];
+    strncpy(copy, query, sizeof(copy) - 1);
+    copy[sizeof(copy) - 1] = 0;
+    return control_apply(&sensor, copy, NULL, answer);
+}
+
+static int apply_json(const char *body)
+{
+    return control_apply(&sensor, NULL, body, answer);
+}
+
+void setUp(void)
+{
+    memset(&sensor, 0, sizeof(sensor));
+    sensor.pixformat = PIXFORMAT_JPEG;
+    sensor.set_ae_level = mock_set_ae_level;
+    sensor.set_exposure_ctrl = mock_set_exposure_ctrl;
+    sensor.set_aec2 = mock_set_aec2;
+    sensor.set_aec_value = mock_set_aec_value;
+    sensor.set_gain_ctrl = mock_set_gain_ctrl;
+    sensor.set_agc_gain = mock_set_agc_gain;
+    sensor.set_whitebal = mock_set_whitebal;
+    sensor.set_awb_gain = mock_set_awb_gain;
+    sensor.set_hmirror = mock_set_hmirror;
+    sensor.set_vflip = mock_set_vflip;
+    sensor.set_wpc = mock_set_wpc;
+    sensor.set_quality = mock_set_quality;
+    sensor.set_framesize = mock_set_framesize;
+    sensor.set_gainceiling = mock_set_gainceiling;
+    call_count = 0;
+    answer[0] = 0;
+}
+
+void tearDown(void)
+{
+}
+
+// find_control() compares whole names: a prefix of one, or one with more after it, is unknown
+void test_find_control_matches_whole_names(void)
+{
+    static const setter_call_t expected[] = {
+        {"set_ae_level", -2}, {"set_exposure_ctrl", 1}, {"set_aec2", 0}, {"set_aec_value", 300}, {"set_wpc", 1},
+    };
+
+    TEST_ASSERT_EQUAL_INT(0, control_set(&sensor, "ae_level", -2)); // First in the table
+    TEST_ASSERT_EQUAL_INT(0, control_set(&sensor, "aec", 1));
+    TEST_ASSERT_EQUAL_INT(0, control_set(&sensor, "aec2", 0));
+    TEST_ASSERT_EQUAL_INT(0, control_set(&sensor, "aec_value", 300));
+    TEST_ASSERT_EQUAL_INT(0, control_set(&sensor, "wpc", 1)); // Last
+    assert_calls(5, expected);
+
+    static const char *unknown[] = {"", "a", "ae", "aec22", "aec_", "wpcx", "zzz", "AEC", "sharpness"};
+    for (size_t i = 0; i < sizeof(unknown) / sizeof(unknown[0]); i++)
+    {
+        TEST_ASSERT_EQUAL_INT_MESSAGE(-2, control_set(&sensor, unknown[i], 1), unknown[i]);
+    }
+    TEST_ASSERT_EQUAL_INT(5, call_count);
+}
+
+void test_query_legacy_form(void)
+{
+    static const setter_call_t expected[] = {{"set_framesize", 9}};
+
+    TEST_ASSERT_EQUAL_INT(200, apply_query("var=framesize&val=9"));
+    assert_calls(1, expected);
+    TEST_ASSERT_EQUAL_STRING("{\"applied\":1,\"failed\":0,\"results\":{\"framesize\":0}}", answer);
+
+    TEST_ASSERT_EQUAL_INT(400, apply_query("var=framesize"));
+    TEST_ASSERT_EQUAL_INT(400, apply_query("var=framesize&val=big"));
+    TEST_ASSERT_EQUAL_INT(400, apply_query("var=frame&val=9"));
+    TEST_ASSERT_EQUAL_STRING("{\"error\":\"unknown setting\"}", answer);
+    TEST_ASSERT_EQUAL_INT(1, call_count);
+}
+
+void test_query_applies_in_order(void)
+{
+    static const setter_call_t expected[] = {
+        {"set_quality", 10}, {"set_hmirror", 1}, {"set_vflip", 0}, {"set_ae_level", -2}, {"set_aec2", 1},
+    };
+
+    TEST_ASSERT_EQUAL_INT(200, apply_query("quality=10&hmirror=1&vflip=0&ae_level=-2&aec2=1"));
+    assert_calls(5, expected);
+    TEST_ASSERT_EQUAL_STRING(
+        "{\"applied\":5,\"failed\":0,\"results\":{\"quality\":0,\"hmirror\":0,\"vflip\":0,\"ae_level\":0,\"aec2\":0}}",
+        answer);
+}
+
+// Nothing is applied unless every pair parses and names a known setting
+void test_query_rejects_before_applying(void)
+{
+    static const char *bad[] = {
+        "quality=10&bogus=1", "quality=10&vflip", "quality=", "quality=1x&vflip=1", "=5", "quality=10&&vflip=1",
+    };
+
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++)
+    {
+        TEST_ASSERT_EQUAL_INT_MESSAGE(400, apply_query(bad[i]), bad[i]);
+    }
+    TEST_ASSERT_EQUAL_INT(0, call_count);
+}
+
+void test_json_applies_in_order(void)
+{
+    static const setter_call_t expected[] = {
+        {"set_framesize", 9}, {"set_quality", 10}, {"set_hmirror", 1}, {"set_vflip", 0}, {"set_gainceiling", 2}, {"set_aec2", 1},
+    };
+
+    TEST_ASSERT_EQUAL_INT(200, apply_json(" {\"framesize\":9, \"quality\" : 10,\n\"hmirror\":true,\"vflip\":false,"
+                                          "\"gainceiling\":2,\"aec2\":1}\r\n"));
+    assert_calls(6, expected);
+    TEST_ASSERT_EQUAL_STRING("{\"applied\":6,\"failed\":0,\"results\":{\"framesize\":0,\"quality\":0,\"hmirror\":0,"
+                             "\"vflip\":0,\"gainceiling\":0,\"aec2\":0}}",
+                             answer);
+
+    TEST_ASSERT_EQUAL_INT(200, apply_json("{ }"));
+    TEST_ASSERT_EQUAL_STRING("{\"applied\":0,\"failed\":0,\"results\":{}}", answer);
+    TEST_ASSERT_EQUAL_INT(6, call_count);
+}
+
+void test_json_rejects_before_applying(void)
+{
+    static const char *bad[] = {
+        "",
+        "[\"quality\"]",
+        "{\"quality\":10",
+        "{\"quality\":10,}",
+        "{\"quality\":\"10\"}",
+        "{\"quality\":10} x",
+        "{\"quality\" 10}",
+        "{quality:10}",
+        "{\"quality",
+        "{\"quality\":10,\"aec2\":nul}",
+        "{\"quality\":10,\"aec\":1,\"aec22\":1}",
+    };
+
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++)
+    {
+        TEST_ASSERT_EQUAL_INT_MESSAGE(400, apply_json(bad[i]), bad[i]);
+    }
+    TEST_ASSERT_EQUAL_STRING("{\"error\":\"unknown setting\"}", answer);
+    TEST_ASSERT_EQUAL_INT(0, call_count);
+}
+
+void test_too_many_settings(void)
+{
+    char query[512];
+    int len = 0;
+
+    for (int i = 0; i <= CONTROL_MAX_SETTINGS; i++)
+    {
+        len += snprintf(query + len, sizeof(query) - len, "%svflip=%d", i ? "&" : "", i & 1);
+    }
+    TEST_ASSERT_EQUAL_INT(400, apply_query(query));
+    TEST_ASSERT_EQUAL_STRING("{\"error\":\"too many settings\"}", answer);
+    TEST_ASSERT_EQUAL_INT(0, call_count);
+
+    // Exactly the limit is fine
+    *strrchr(query, '&') = 0;
+    TEST_ASSERT_EQUAL_INT(200, apply_query(query));
+    TEST_ASSERT_EQUAL_INT(CONTROL_MAX_SETTINGS, call_count);
+}
+
+// A setter that fails makes it a 500, but the others are still applied
+void test_failed_setter_is_reported(void)
+{
+    static const setter_call_t expected[] = {{"set_hmirror", 1}, {"set_quality", 99}, {"set_vflip", 1}};
+
+    TEST_ASSERT_EQUAL_INT(500, apply_json("{\"hmirror\":1,\"quality\":99,\"vflip\":1}"));
+    assert_calls(3, expected);
+    TEST_ASSERT_EQUAL_STRING("{\"applied\":2,\"failed\":1,\"results\":{\"hmirror\":0,\"quality\":-1,\"vflip\":0}}", answer);
+}
+
+// Frame size only means something for JPEG; other formats leave it alone
+void test_framesize_needs_jpeg(void)
+{
+    sensor.pixformat = PIXFORMAT_RGB565;
+    TEST_ASSERT_EQUAL_INT(200, apply_query("framesize=9"));
+    TEST_ASSERT_EQUAL_INT(0, call_count);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_find_control_matches_whole_names);
+    RUN_TEST(test_query_legacy_form);
+    RUN_TEST(test_query_applies_in_order);
+    RUN_TEST(test_query_rejects_before_applying);
+    RUN_TEST(test_json_applies_in_order);
+    RUN_TEST(test_json_rejects_before_applying);
+    RUN_TEST(test_too_many_settings);
+    RUN_TEST(test_failed_setter_is_reported);
+    RUN_TEST(test_framesize_needs_jpeg);
+    return UNITY_END();
+}
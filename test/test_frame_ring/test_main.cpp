@@ -0,0 +1,193 @@
+// Frame ring against a synthetic frame source: every frame is filled with a
+// byte derived from its seq, so a consumer can tell a torn or reused slot.
+#include <atomic>
+#include <esp_heap_caps.h>
+#include <string.h>
+#include <thread>
+#include <unity.h>
+
+#include "frame_ring.h"
+#include "stream_config.h"
+
+#define TEST_SLOT_SIZE 1024
+
+static frame_ring_t ring;
+
+static uint8_t pattern(uint32_t seq)
+{
+    return (uint8_t)(seq * 37 + 11);
+}
+
+// The next frame from the synthetic source; returns its seq, or 0 when it was dropped
+static uint32_t produce(size_t len)
+{
+    frame_slot_t *slot = frame_ring_begin_write(&ring, len);
+    if (!slot)
+    {
+        return 0;
+    }
+    uint32_t seq = ring.seq + 1; // Only this thread commits
+    memset(slot->buf, pattern(seq), len);
+    slot->len = len;
+    frame_ring_commit(&ring, slot, 160, 120, seq);
+    return seq;
+}
+
+static bool intact(const frame_slot_t *slot)
+{
+    for (size_t i = 0; i < slot->len; i++)
+    {
+        if (slot->buf[i] != pattern(slot->seq))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void setUp(void)
+{
+    TEST_ASSERT_EQUAL(ESP_OK, frame_ring_init(&ring, FRAME_RING_SLOTS, TEST_SLOT_SIZE));
+}
+
+void tearDown(void)
+{
+    for (int i = 0; i < ring.slot_count; i++)
+    {
+        heap_caps_free(ring.slots[i].buf);
+    }
+    heap_caps_free(ring.slots);
+}
+
+static void test_acquire_returns_latest_once(void)
+{
+    TEST_ASSERT_NULL(frame_ring_acquire(&ring, 0));
+    uint32_t seq = produce(100);
+    frame_slot_t *frame = frame_ring_acquire(&ring, 0);
+    TEST_ASSERT_NOT_NULL(frame);
+    TEST_ASSERT_EQUAL_UINT32(seq, frame->seq);
+    TEST_ASSERT_TRUE(intact(frame));
+    TEST_ASSERT_NULL(frame_ring_acquire(&ring, frame->seq));
+    frame_ring_release(&ring, frame);
+}
+
+static void test_unread_frames_count_as_overruns(void)
+{
+    produce(100);
+    produce(100);
+    produce(100);
+    TEST_ASSERT_EQUAL_UINT32(2, ring.overruns);
+    TEST_ASSERT_EQUAL_UINT32(0, ring.dropped);
+}
+
+// Every subscriber pins a different frame: capture must still find a slot
+static void test_capture_survives_every_consumer_pinning(void)
+{
+    frame_slot_t *held[FRAME_SUBSCRIBERS];
+
+    for (int i = 0; i < FRAME_SUBSCRIBERS; i++)
+    {
+        TEST_ASSERT_NOT_EQUAL(0, produce(100));
+        held[i] = frame_ring_acquire_latest(&ring);
+    }
+    for (int i = 0; i < 10; i++)
+    {
+        TEST_ASSERT_NOT_EQUAL(0, produce(100));
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, ring.dropped);
+    for (int i = 0; i < FRAME_SUBSCRIBERS; i++)
+    {
+        TEST_ASSERT_TRUE(intact(held[i]));
+        frame_ring_release(&ring, held[i]);
+    }
+}
+
+static void test_drops_when_every_slot_is_pinned(void)
+{
+    frame_slot_t *held[FRAME_RING_SLOTS];
+
+    for (int i = 0; i < FRAME_RING_SLOTS - 1; i++)
+    {
+        produce(100);
+        held[i] = frame_ring_acquire_latest(&ring);
+    }
+    produce(100); // The last free slot becomes the latest
+    TEST_ASSERT_EQUAL_UINT32(0, produce(100));
+    TEST_ASSERT_EQUAL_UINT32(1, ring.dropped);
+    frame_ring_release(&ring, held[0]);
+    TEST_ASSERT_NOT_EQUAL(0, produce(100));
+    for (int i = 1; i < FRAME_RING_SLOTS - 1; i++)
+    {
+        frame_ring_release(&ring, held[i]);
+    }
+}
+
+static void test_slot_grows_for_larger_frames(void)
+{
+    uint32_t seq = produce(TEST_SLOT_SIZE * 3);
+    TEST_ASSERT_NOT_EQUAL(0, seq);
+    frame_slot_t *frame = frame_ring_acquire_latest(&ring);
+    TEST_ASSERT_EQUAL(TEST_SLOT_SIZE * 3, frame->len);
+    TEST_ASSERT_GREATER_OR_EQUAL(TEST_SLOT_SIZE * 3, frame->capacity);
+    TEST_ASSERT_TRUE(intact(frame));
+    frame_ring_release(&ring, frame);
+}
+
+// Consumers hold frames for a while as a slow send would; none may ever see
+// a slot the producer is rewriting
+static void test_concurrent_consumers_never_see_torn_frames(void)
+{
+    std::atomic<bool> done(false);
+    std::atomic<int> torn(0);
+    std::atomic<int> seen(0);
+    std::thread consumers[FRAME_SUBSCRIBERS];
+
+    for (int c = 0; c < FRAME_SUBSCRIBERS; c++)
+    {
+        consumers[c] = std::thread([&, c]() {
+            uint32_t last = 0;
+            while (!done)
+            {
+                frame_slot_t *frame = frame_ring_acquire(&ring, last);
+                if (!frame)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                last = frame->seq;
+                std::this_thread::sleep_for(std::chrono::microseconds(50 * (c + 1)));
+                if (!intact(frame))
+                {
+                    torn++;
+                }
+                seen++;
+                frame_ring_release(&ring, frame);
+            }
+        });
+    }
+    for (int i = 0; i < 5000; i++)
+    {
+        produce(64 + i % 512);
+        std::this_thread::sleep_for(std::chrono::microseconds(20));
+    }
+    done = true;
+    for (int c = 0; c < FRAME_SUBSCRIBERS; c++)
+    {
+        consumers[c].join();
+    }
+    TEST_ASSERT_EQUAL(0, torn.load());
+    TEST_ASSERT_GREATER_THAN(0, seen.load());
+    TEST_ASSERT_EQUAL_UINT32(0, ring.dropped);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_acquire_returns_latest_once);
+    RUN_TEST(test_unread_frames_count_as_overruns);
+    RUN_TEST(test_capture_survives_every_consumer_pinning);
+    RUN_TEST(test_drops_when_every_slot_is_pinned);
+    RUN_TEST(test_slot_grows_for_larger_frames);
+    RUN_TEST(test_concurrent_consumers_never_see_torn_frames);
+    return UNITY_END();
+}
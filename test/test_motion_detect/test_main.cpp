@@ -0,0 +1,312 @@
+// The DC-only JPEG decoder against libjpeg, and the motion detector replayed
+// over a synthetic JPEG sequence: a still scene, an object crossing it and an
+// exposure step. Ends with the per-frame cost at VGA and UXGA.
+#include <esp_timer.h>
+#include <img_converters.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unity.h>
+
+#include "jpeg_dc.h"
+#include "motion_detect.h"
+
+#define SCENE_WIDTH 320
+#define SCENE_HEIGHT 240
+#define FRAME_INTERVAL_US 50000 // 20 fps
+#define BENCH_FRAMES 20
+
+typedef struct
+{
+    uint8_t *buf;
+    size_t len;
+    size_t capacity;
+} jpeg_buf_t;
+
+static jpeg_dc_decoder_t decoder;
+static uint8_t luma[MOTION_MAX_BLOCKS];
+static jpeg_buf_t jpeg;
+
+static size_t append(void *arg, size_t index, const void *data, size_t len)
+{
+    jpeg_buf_t *out = (jpeg_buf_t *)arg;
+    if (out->len + len > out->capacity)
+    {
+        out->capacity = (out->len + len) * 2;
+        out->buf = (uint8_t *)realloc(out->buf, out->capacity);
+    }
+    memcpy(out->buf + out->len, data, len);
+    out->len += len;
+    return len;
+}
+
+// Encodes a grey image as the camera would, three components
+static void encode(const uint8_t *grey, uint16_t width, uint16_t height)
+{
+    uint8_t *rgb = (uint8_t *)malloc((size_t)width * height * 3);
+    for (size_t i = 0; i < (size_t)width * height; i++)
+    {
+        rgb[i * 3] = rgb[i * 3 + 1] = rgb[i * 3 + 2] = grey[i];
+    }
+    jpeg.len = 0;
+    TEST_ASSERT_TRUE(fmt2jpg_cb(rgb, (size_t)width * height * 3, width, height, PIXFORMAT_RGB888, 80, append, &jpeg));
+    free(rgb);
+}
+
+// A textured still scene, brightness shifted by exposure, with a bright
+// square at (x, y) when x >= 0
+static void scene(uint8_t *grey, uint16_t width, uint16_t height, int exposure, int x, int y, uint32_t seed)
+{
+    for (int row = 0; row < height; row++)
+    {
+        for (int col = 0; col < width; col++)
+        {
+            seed = seed * 1664525 + 1013904223;
+            int v = 60 + ((col / 24 + row / 16) % 5) * 20 + (int)((seed >> 28) & 3) + exposure;
+            if (x >= 0 && col >= x && col < x + 48 && row >= y && row < y + 48)
+            {
+                v = 235;
+            }
+            grey[row * width + col] = v > 255 ? 255 : v;
+        }
+    }
+}
+
+void setUp(void)
+{
+    motion_detect_set("motion_threshold", MOTION_THRESHOLD_DEFAULT);
+    motion_detect_set("motion_min_blocks", MOTION_MIN_BLOCKS_DEFAULT);
+}
+
+void tearDown(void)
+{
+}
+
+// Block means from a full libjpeg decode; the DC path skips the AC terms
+// and rounding, so allow a level or two
+static void test_dc_matches_libjpeg_block_means(void)
+{
+    static uint8_t grey[SCENE_WIDTH * SCENE_HEIGHT];
+    static uint8_t rgb[SCENE_WIDTH * SCENE_HEIGHT * 3];
+    uint16_t width, height;
+
+    scene(grey, SCENE_WIDTH, SCENE_HEIGHT, 0, 100, 80, 1);
+    encode(grey, SCENE_WIDTH, SCENE_HEIGHT);
+    TEST_ASSERT_EQUAL(ESP_OK, jpeg_dc_decode(&decoder, jpeg.buf, jpeg.len, luma, sizeof(luma), &width, &height));
+    TEST_ASSERT_EQUAL(SCENE_WIDTH / 8, width);
+    TEST_ASSERT_EQUAL(SCENE_HEIGHT / 8, height);
+    TEST_ASSERT_TRUE(jpg2rgb888(jpeg.buf, jpeg.len, rgb, JPG_SCALE_NONE));
+
+    for (int by = 0; by < height; by++)
+    {
+        for (int bx = 0; bx < width; bx++)
+        {
+            int sum = 0;
+            for (int y = 0; y < 8; y++)
+            {
+                for (int x = 0; x < 8; x++)
+                {
+                    const uint8_t *p = rgb + ((by * 8 + y) * SCENE_WIDTH + bx * 8 + x) * 3;
+                    sum += (114 * p[0] + 587 * p[1] + 299 * p[2]) / 1000; // Blue first
+                }
+            }
+            TEST_ASSERT_INT_WITHIN(2, sum / 64, luma[by * width + bx]);
+        }
+    }
+}
+
+static void test_size_matches_decode(void)
+{
+    static uint8_t grey[SCENE_WIDTH * SCENE_HEIGHT];
+    uint16_t width, height;
+
+    scene(grey, SCENE_WIDTH, SCENE_HEIGHT, 0, -1, 0, 1);
+    encode(grey, SCENE_WIDTH, SCENE_HEIGHT);
+    TEST_ASSERT_EQUAL(ESP_OK, jpeg_dc_size(jpeg.buf, jpeg.len, &width, &height));
+    TEST_ASSERT_EQUAL(SCENE_WIDTH, width);
+    TEST_ASSERT_EQUAL(SCENE_HEIGHT, height);
+}
+
+// A frame header cut short must be rejected before any of it is read
+static void test_short_frame_header_is_rejected(void)
+{
+    static const uint8_t header[] = {0xFF, 0xD8, 0xFF, 0xC0, 0x00, 0x02};
+    for (size_t len = 0; len <= sizeof(header); len++)
+    {
+        uint8_t *exact = (uint8_t *)malloc(len ? len : 1);
+        memcpy(exact, header, len);
+        uint16_t width, height;
+        TEST_ASSERT_NOT_EQUAL(ESP_OK, jpeg_dc_decode(&decoder, exact, len, luma, sizeof(luma), &width, &height));
+        free(exact);
+    }
+}
+
+// Headers cut anywhere before the scan are rejected; a cut scan decodes as
+// if the rest were zeros, without reading past the end
+static void test_truncated_headers_are_rejected(void)
+{
+    static uint8_t grey[SCENE_WIDTH * SCENE_HEIGHT];
+    uint16_t width, height;
+
+    scene(grey, SCENE_WIDTH, SCENE_HEIGHT, 0, -1, 0, 1);
+    encode(grey, SCENE_WIDTH, SCENE_HEIGHT);
+    size_t scan = 0;
+    for (size_t i = 2; i + 4 <= jpeg.len && !scan; i += 2 + ((jpeg.buf[i + 2] << 8) | jpeg.buf[i + 3]))
+    {
+        if (jpeg.buf[i + 1] == 0xDA)
+        {
+            scan = i + 2 + ((jpeg.buf[i + 2] << 8) | jpeg.buf[i + 3]);
+        }
+    }
+    TEST_ASSERT_GREATER_THAN(0, scan);
+
+    for (size_t len = 0; len <= jpeg.len; len++)
+    {
+        uint8_t *exact = (uint8_t *)malloc(len ? len : 1);
+        memcpy(exact, jpeg.buf, len);
+        esp_err_t res = jpeg_dc_decode(&decoder, exact, len, luma, sizeof(luma), &width, &height);
+        if (len < scan)
+        {
+            TEST_ASSERT_NOT_EQUAL(ESP_OK, res);
+        }
+        else
+        {
+            TEST_ASSERT_EQUAL(ESP_OK, res);
+        }
+        free(exact);
+    }
+}
+
+// A frame with no blocks would leave the detector dividing by zero
+static void test_zero_sized_frame_is_rejected(void)
+{
+    static uint8_t grey[SCENE_WIDTH * SCENE_HEIGHT];
+    uint16_t width, height;
+
+    scene(grey, SCENE_WIDTH, SCENE_HEIGHT, 0, -1, 0, 1);
+    encode(grey, SCENE_WIDTH, SCENE_HEIGHT);
+    size_t sof = 0;
+    for (size_t i = 2; i + 4 <= jpeg.len && !sof; i += 2 + ((jpeg.buf[i + 2] << 8) | jpeg.buf[i + 3]))
+    {
+        if (jpeg.buf[i + 1] == 0xC0)
+        {
+            sof = i;
+        }
+    }
+    TEST_ASSERT_GREATER_THAN(0, sof);
+
+    for (int field = 0; field < 2; field++)
+    {
+        uint8_t *copy = (uint8_t *)malloc(jpeg.len);
+        memcpy(copy, jpeg.buf, jpeg.len);
+        copy[sof + 5 + 2 * field] = 0; // Height, then width
+        copy[sof + 6 + 2 * field] = 0;
+        TEST_ASSERT_NOT_EQUAL(ESP_OK, jpeg_dc_decode(&decoder, copy, jpeg.len, luma, sizeof(luma), &width, &height));
+        free(copy);
+    }
+}
+
+typedef struct
+{
+    const char *name;
+    int frames;
+    int exposure;
+    bool moving;
+    int checked_from; // Frames before this may still see the previous segment
+} segment_t;
+
+static void test_replay_reports_the_object_and_not_exposure(void)
+{
+    static const segment_t segments[] = {
+        {"still", 24, 0, false, 0},
+        {"object", 16, 0, true, 1},
+        // The object's trail fades from the background over about 12 frames
+        {"settle", 24, 0, false, 14},
+        {"exposure", 16, 40, false, 0},
+    };
+    static uint8_t grey[SCENE_WIDTH * SCENE_HEIGHT];
+    motion_state_t state;
+    int64_t timestamp = 1000000;
+    uint32_t seed = 1;
+
+    for (size_t s = 0; s < sizeof(segments) / sizeof(segments[0]); s++)
+    {
+        int detected = 0;
+        for (int f = 0; f < segments[s].frames; f++)
+        {
+            int x = segments[s].moving ? f * 16 : -1;
+            scene(grey, SCENE_WIDTH, SCENE_HEIGHT, segments[s].exposure, x, 96, seed++);
+            encode(grey, SCENE_WIDTH, SCENE_HEIGHT);
+            TEST_ASSERT_EQUAL(ESP_OK, motion_detect_feed(jpeg.buf, jpeg.len, timestamp));
+            timestamp += FRAME_INTERVAL_US;
+            motion_detect_get(&state);
+            if (f >= segments[s].checked_from)
+            {
+                detected += state.motion;
+            }
+        }
+        int checked = segments[s].frames - segments[s].checked_from;
+        char message[64];
+        snprintf(message, sizeof(message), "%s: motion in %d of %d frames", segments[s].name, detected, checked);
+        TEST_MESSAGE(message);
+        if (segments[s].moving)
+        {
+            TEST_ASSERT_EQUAL_MESSAGE(checked, detected, message);
+        }
+        else
+        {
+            TEST_ASSERT_EQUAL_MESSAGE(0, detected, message);
+        }
+    }
+    TEST_ASSERT_EQUAL(0, state.errors);
+    TEST_ASSERT_EQUAL(24 + 16 + 24 + 16, state.frames);
+}
+
+static void bench_size(uint16_t width, uint16_t height)
+{
+    uint8_t *grey = (uint8_t *)malloc((size_t)width * height);
+    jpeg_buf_t frames[2] = {};
+
+    // Two frames, so the compare sees a change each time
+    for (int i = 0; i < 2; i++)
+    {
+        scene(grey, width, height, 0, i ? width / 2 : width / 4, height / 2, i + 1);
+        encode(grey, width, height);
+        append(&frames[i], 0, jpeg.buf, jpeg.len);
+    }
+    motion_detect_feed(frames[0].buf, frames[0].len, 0); // Size the background outside the timing
+
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < BENCH_FRAMES; i++)
+    {
+        motion_detect_feed(frames[i & 1].buf, frames[i & 1].len, (i + 1) * FRAME_INTERVAL_US);
+    }
+    int64_t us = (esp_timer_get_time() - start) / BENCH_FRAMES;
+
+    char message[96];
+    snprintf(message, sizeof(message), "%ux%u: %u byte frames, %lld us per frame, %.0f fps", width, height,
+             (unsigned)frames[0].len, (long long)us, us ? 1e6 / us : 0.0);
+    TEST_MESSAGE(message);
+    free(frames[0].buf);
+    free(frames[1].buf);
+    free(grey);
+}
+
+static void test_detector_throughput(void)
+{
+    bench_size(640, 480);
+    bench_size(1600, 1200);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_dc_matches_libjpeg_block_means);
+    RUN_TEST(test_size_matches_decode);
+    RUN_TEST(test_short_frame_header_is_rejected);
+    RUN_TEST(test_truncated_headers_are_rejected);
+    RUN_TEST(test_zero_sized_frame_is_rejected);
+    RUN_TEST(test_replay_reports_the_object_and_not_exposure);
+    RUN_TEST(test_detector_throughput);
+    return UNITY_END();
+}
@@ -0,0 +1,310 @@
+// Retention against months of recording on an emulated 8 GB card: busy days
+// that run over the day quota and fill the card, a quiet stretch of small
+// clips that runs into RETENTION_MAX_CLIPS, clips from before the clock was
+// set, restarts and a reset in the middle of a clip. Clips are sparse files,
+// so the run takes hardly any disk, but it does wipe CLIP_DIR: give it a
+// scratch directory at STORAGE_MOUNT_POINT.
+#include <Arduino.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <host.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <unity.h>
+#include <vector>
+
+#include "avi_writer.h"
+#include "catalog.h"
+#include "record_config.h"
+#include "retention.h"
+#include "storage.h"
+
+#define CARD_BYTES (8ULL * 1024 * 1024 * 1024)
+#define DAY_MS 86400000LL
+#define FIRST_DAY 19723 // 2024-01-01
+#define BUSY_DAYS 30
+#define QUIET_DAYS 40
+#define RESTART_DAYS 7  // A power cut, or a firmware update
+#define RESET_DAY 20    // The one that hits in the middle of a clip
+#define UNSET_CLOCK_DAY 50
+#define MB (1024 * 1024)
+
+typedef struct
+{
+    char name[16];
+    int64_t start_ms;
+} test_clip_t;
+
+static std::vector<test_clip_t> recorded; // Every clip opened, in order
+static size_t oldest = 0;                 // No clip before this one is still stored
+static uint32_t rng = 0x2545F491;
+static uint32_t reclaimed = 0;
+static uint32_t over_quota = 0;
+static uint32_t max_clips = 0;
+static uint32_t uptime_s = 0;
+
+static uint32_t next_random(uint32_t lo, uint32_t hi)
+{
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return lo + rng % (hi - lo + 1);
+}
+
+static void clip_path(const char *name, char *path, size_t len)
+{
+    snprintf(path, len, "%s/%s.avi", CLIP_DIR, name);
+}
+
+static bool clip_size(const char *name, off_t *size)
+{
+    char path[64];
+    struct stat st;
+
+    clip_path(name, path, sizeof(path));
+    if (stat(path, &st) != 0)
+    {
+        return false;
+    }
+    *size = st.st_size;
+    return true;
+}
+
+static void wipe_clip_dir()
+{
+    DIR *dir = opendir(CLIP_DIR);
+    struct dirent *e;
+    char path[300];
+
+    while (dir && (e = readdir(dir)) != NULL)
+    {
+        if (e->d_name[0] != '.')
+        {
+            snprintf(path, sizeof(path), "%s/%s", CLIP_DIR, e->d_name);
+            unlink(path);
+        }
+    }
+    if (dir)
+    {
+        closedir(dir);
+    }
+}
+
+// As the recorder does it: journal the clip, then preallocate its file
+static void open_clip(int64_t start_ms)
+{
+    test_clip_t clip = {};
+    char path[64];
+
+    if (start_ms >= 0)
+    {
+        time_t at = start_ms / 1000;
+        struct tm tm;
+        gmtime_r(&at, &tm);
+        strftime(clip.name, sizeof(clip.name), "%Y%m%d-%H%M%S", &tm);
+    }
+    else
+    {
+        snprintf(clip.name, sizeof(clip.name), "up%08u", uptime_s += next_random(60, 600));
+    }
+    clip.start_ms = start_ms;
+    recorded.push_back(clip);
+
+    TEST_ASSERT_EQUAL(ESP_OK, retention_open(clip.name, start_ms));
+    clip_path(clip.name, path, sizeof(path));
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0664);
+    TEST_ASSERT_TRUE(fd >= 0);
+    TEST_ASSERT_EQUAL(0, ftruncate(fd, AVI_PREALLOCATE_BYTES));
+    close(fd);
+}
+
+static void close_clip(uint32_t bytes)
+{
+    const test_clip_t *clip = &recorded.back();
+    char path[64];
+
+    clip_path(clip->name, path, sizeof(path));
+    TEST_ASSERT_EQUAL(0, truncate(path, bytes));
+    if (clip->start_ms >= 0)
+    {
+        catalog_entry_t entry = {};
+        entry.start_ms = clip->start_ms;
+        entry.us_per_frame = 50000;
+        entry.duration_ms = bytes / (40 * 1024) * 50;
+        entry.frames = entry.duration_ms / 50;
+        entry.bytes = bytes;
+        strcpy(entry.name, clip->name);
+        TEST_ASSERT_EQUAL(ESP_OK, catalog_add(&entry));
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, retention_close(bytes));
+
+    retention_stats_t stats;
+    retention_get_stats(&stats);
+    max_clips = (stats.clips > max_clips) ? stats.clips : max_clips;
+}
+
+// The journal has to bring back exactly what was stored
+static void restart()
+{
+    retention_stats_t before, after;
+
+    retention_get_stats(&before);
+    reclaimed += before.reclaimed;
+    over_quota += before.over_quota;
+    retention_stop();
+    TEST_ASSERT_EQUAL(ESP_OK, retention_start());
+    retention_get_stats(&after);
+    TEST_ASSERT_EQUAL(before.clips, after.clips);
+    TEST_ASSERT_EQUAL_UINT64(before.bytes, after.bytes);
+    TEST_ASSERT_EQUAL(before.journal_seq, after.journal_seq);
+}
+
+// What is on the card has to match what retention thinks is on it
+static void check_card(int64_t day)
+{
+    retention_stats_t stats;
+    uint32_t files = 0;
+    uint64_t bytes = 0;
+    uint64_t dayBytes = 0;
+    uint32_t dayClips = 0;
+    off_t size;
+
+    for (size_t i = 0; i < recorded.size(); i++)
+    {
+        if (!clip_size(recorded[i].name, &size))
+        {
+            continue;
+        }
+        files++;
+        bytes += size;
+        if (recorded[i].start_ms >= 0 && recorded[i].start_ms / DAY_MS == day)
+        {
+            dayBytes += size;
+            dayClips++;
+        }
+    }
+    retention_get_stats(&stats);
+    TEST_ASSERT_EQUAL(stats.clips, files);
+    TEST_ASSERT_EQUAL_UINT64(stats.bytes, bytes);
+    TEST_ASSERT_LESS_OR_EQUAL(RETENTION_MAX_CLIPS, stats.clips);
+    TEST_ASSERT_GREATER_OR_EQUAL(RETENTION_FREE_LOW, storage_free_bytes());
+    // The newest clip stays even when it alone is over
+    TEST_ASSERT_TRUE(dayBytes <= RETENTION_DAY_QUOTA || dayClips == 1);
+
+    while (oldest < recorded.size() && !clip_size(recorded[oldest].name, &size))
+    {
+        oldest++;
+    }
+    TEST_ASSERT_TRUE(oldest < recorded.size());
+    TEST_ASSERT_EQUAL_INT64(recorded[oldest].start_ms, retention_oldest_ms());
+}
+
+static void record_day(int64_t day, uint32_t clips, uint32_t minMb, uint32_t maxMb)
+{
+    int64_t spacing = DAY_MS / clips;
+
+    for (uint32_t i = 0; i < clips; i++)
+    {
+        int64_t start = day * DAY_MS + i * spacing + next_random(0, spacing / 2000) * 1000;
+        if (day == UNSET_CLOCK_DAY && i < 5)
+        {
+            start = -1; // Booted without the network
+        }
+        open_clip(start);
+        if (day == RESET_DAY && i == clips / 2)
+        {
+            restart(); // The clip stays at its preallocated size
+            continue;
+        }
+        close_clip(next_random(minMb * MB, maxMb * MB));
+    }
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_months_of_churn(void)
+{
+    host_config.sd_bytes = CARD_BYTES;
+    if (storage_mount() != ESP_OK)
+    {
+        TEST_IGNORE_MESSAGE("No writable directory at " STORAGE_MOUNT_POINT);
+    }
+    wipe_clip_dir();
+    TEST_ASSERT_EQUAL(ESP_OK, catalog_init());
+    TEST_ASSERT_EQUAL(ESP_OK, retention_start());
+
+    struct stat journal;
+    TEST_ASSERT_EQUAL(0, stat(RETENTION_JOURNAL_PATH, &journal));
+
+    for (int64_t day = FIRST_DAY; day < FIRST_DAY + BUSY_DAYS + QUIET_DAYS; day++)
+    {
+        if ((day - FIRST_DAY) % RESTART_DAYS == 0)
+        {
+            restart();
+        }
+        if (day < FIRST_DAY + BUSY_DAYS)
+        {
+            record_day(day, next_random(140, 180), 20, 40); // About 5 GB
+        }
+        else
+        {
+            record_day(day, next_random(60, 80), 1, 3);
+        }
+        check_card(day);
+    }
+    restart();
+
+    TEST_ASSERT_GREATER_THAN(0, reclaimed);
+    TEST_ASSERT_GREATER_THAN(0, over_quota);
+    TEST_ASSERT_EQUAL(RETENTION_MAX_CLIPS, max_clips);
+
+    struct stat st;
+    TEST_ASSERT_EQUAL(0, stat(RETENTION_JOURNAL_PATH, &st));
+    TEST_ASSERT_EQUAL(journal.st_size, st.st_size);
+
+    // Reclaimed clips are flagged in the catalog, stored ones are not
+    catalog_entry_t entries[64];
+    uint32_t total = 0;
+    uint32_t deleted = 0;
+    for (uint32_t first = 0;; first += 64)
+    {
+        uint32_t n = catalog_read(first, entries, 64);
+        for (uint32_t i = 0; i < n; i++)
+        {
+            off_t size;
+            bool gone = !clip_size(entries[i].name, &size);
+            TEST_ASSERT_EQUAL_MESSAGE(gone, (entries[i].flags & CATALOG_DELETED) != 0, entries[i].name);
+            deleted += gone;
+        }
+        total += n;
+        if (n < 64)
+        {
+            break;
+        }
+    }
+    TEST_ASSERT_EQUAL(catalog_count(), total);
+    TEST_ASSERT_GREATER_THAN(0, deleted);
+
+    char summary[128];
+    snprintf(summary, sizeof(summary), "%u clips recorded, %u reclaimed for space or count, %u over quota",
+             (unsigned)recorded.size(), reclaimed, over_quota);
+    TEST_MESSAGE(summary);
+
+    retention_stop();
+    wipe_clip_dir();
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_months_of_churn);
+    return UNITY_END();
+}
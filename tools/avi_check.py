@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+"""Checks a recorded AVI clip.
+
+Walks the RIFF structure, compares the header frame counts with the movi
+list, checks every idx1 entry against the chunk it points at and that each
+video chunk holds a whole JPEG (SOI ... EOI).
+
+    python3 tools/avi_check.py clip.avi [...]
+
+Exits non-zero if any file has a problem.
+"""
+
+import struct
+import sys
+
+
+def chunks(data, start, end):
+    pos = start
+    while pos + 8 <= end:
+        fourcc = data[pos:pos + 4]
+        size = struct.unpack_from("<I", data, pos + 4)[0]
+        yield pos, fourcc, size
+        pos += 8 + size + (size & 1)
+
+
+def check(path):
+    errors = []
+    try:
+        with open(path, "rb") as f:
+            data = f.read()
+    except OSError as e:
+        return [str(e)]
+
+    if data[0:4] != b"RIFF" or data[8:12] != b"AVI ":
+        return ["not a RIFF AVI file"]
+    riff_size = struct.unpack_from("<I", data, 4)[0]
+    if riff_size + 8 > len(data):
+        errors.append("RIFF size %d, file size %d" % (riff_size + 8, len(data)))
+    elif riff_size + 8 < len(data):
+        # A clip cut off by a reset keeps its preallocated tail
+        print("%s: %d bytes past the RIFF data" % (path, len(data) - riff_size - 8))
+        data = data[:riff_size + 8]
+
+    avih = None
+    streams = []
+    movi = None
+    idx1 = None
+    for pos, fourcc, size in chunks(data, 12, len(data)):
+        if fourcc == b"LIST" and data[pos + 8:pos + 12] == b"hdrl":
+            for hpos, hfourcc, hsize in chunks(data, pos + 12, pos + 8 + size):
+                if hfourcc == b"avih":
+                    avih = struct.unpack_from("<10I", data, hpos + 8)
+                elif hfourcc == b"LIST" and data[hpos + 8:hpos + 12] == b"strl":
+                    for spos, sfourcc, ssize in chunks(data, hpos + 12, hpos + 8 + hsize):
+                        if sfourcc == b"strh":
+                            streams.append((data[spos + 8:spos + 12], struct.unpack_from("<I", data, spos + 40)[0]))
+        elif fourcc == b"LIST" and data[pos + 8:pos + 12] == b"movi":
+            movi = (pos + 8, pos + 8 + size)
+        elif fourcc == b"idx1":
+            idx1 = (pos + 8, size)
+
+    if avih is None or not streams:
+        return errors + ["no avih or stream headers"]
+    if movi is None:
+        return errors + ["no movi list"]
+    us_per_frame, _, _, flags, total_frames = avih[:5]
+    width, height = avih[8:10]
+
+    frames = []
+    audio_bytes = 0
+    for pos, fourcc, size in chunks(data, movi[0] + 4, movi[1]):
+        if fourcc == b"00dc":
+            frames.append((pos, size))
+        elif fourcc == b"01wb":
+            audio_bytes += size
+        elif fourcc != b"JUNK":
+            errors.append("unexpected chunk %r at %d" % (fourcc, pos))
+        if pos + 8 + size > movi[1]:
+            errors.append("chunk at %d runs past movi" % pos)
+
+    if total_frames != len(frames):
+        errors.append("avih frames %d, movi frames %d" % (total_frames, len(frames)))
+    if streams[0][1] != len(frames):
+        errors.append("video strh length %d, movi frames %d" % (streams[0][1], len(frames)))
+    if len(streams) > 1 and streams[1][1] * 2 != audio_bytes:
+        errors.append("audio strh length %d, movi samples %d" % (streams[1][1], audio_bytes // 2))
+
+    for pos, size in frames:
+        jpg = data[pos + 8:pos + 8 + size]
+        if jpg[:2] != b"\xff\xd8" or jpg[-2:] != b"\xff\xd9":
+            errors.append("frame at %d is not a whole JPEG" % pos)
+
+    if idx1 is None:
+        if flags & 0x10:
+            errors.append("AVIF_HASINDEX set but no idx1")
+    else:
+        start, size = idx1
+        video = 0
+        for i in range(size // 16):
+            ckid, _, offset, length = struct.unpack_from("<4sIII", data, start + i * 16)
+            at = movi[0] + offset
+            if data[at:at + 4] != ckid or struct.unpack_from("<I", data, at + 4)[0] != length:
+                errors.append("idx1 entry %d does not match its chunk" % i)
+            video += ckid == b"00dc"
+        if video != len(frames):
+            errors.append("idx1 has %d frames, movi %d" % (video, len(frames)))
+
+    seconds = total_frames * us_per_frame / 1e6
+    print("%s: %dx%d, %d frames, %.1f fps, %.1f s, %s%s" % (
+        path, width, height, total_frames, 1e6 / us_per_frame if us_per_frame else 0, seconds,
+        "indexed" if idx1 else "not indexed", ", audio" if len(streams) > 1 else ""))
+    return errors
+
+
+def main():
+    failed = False
+    for path in sys.argv[1:]:
+        for error in check(path):
+            print("%s: %s" % (path, error))
+            failed = True
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
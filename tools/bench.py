@@ -0,0 +1,522 @@
+#!/usr/bin/env python3
+"""Throughput and latency benchmark for the native build.
+
+Replays a JPEG sequence and a PCM WAV file through the [env:native] program
+and drives 1 to N concurrent loopback clients against each handler in turn:
+the main stream (port 81 /), the substream (port 81 /sub), /capture (port
+80, keep-alive, one request after the other), the audio stream (port 82)
+and the main stream over the /ws WebSocket.
+Every run gets a fresh server, so runs do not share camera or ring state.
+
+    python3 tools/bench.py --frames DIR --audio FILE [--clients N] [--seconds S]
+                           [--handlers stream,sub,capture,audio,ws] [--fps N]
+                           [--program .pio/build/native/program] [-o results.json]
+
+--frames may also be an AVI clip from /recordings; its frames are replayed.
+Give it more than once, e.g. a UXGA and a VGA sequence, to run every handler
+against each; every run records the frame size it was served.
+
+Per client it reports frames per second, bytes per second and the p50/p99
+delivery latency: for stream parts and captures the time from the camera
+taking the frame (X-Timestamp, X-Frame-Timestamp) to the client having all
+of it, for audio how far behind real time each chunk arrives. Per run it
+reports the server's CPU time per delivered frame and per camera frame,
+from /proc and /metrics, and the socket sends it made per delivered frame,
+from the native build's send counter. While the substream runs, it also reports
+the mean decode and encode time per substream frame, from the server's
+substream_step_seconds_total. The JSON goes to stdout or -o; keys are stable so
+two result files can be diffed.
+"""
+
+import argparse
+import base64
+import json
+import os
+import re
+import shutil
+import signal
+import socket
+import struct
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+import urllib.request
+
+PORT_HTTP = 80
+PORT_STREAM = 81
+PORT_AUDIO = 82
+HANDLERS = ("stream", "sub", "capture", "audio", "ws")
+SUBSTREAM_STEPS = ("decode", "encode")
+
+RECV_SIZE = 65536
+STARTUP_TIMEOUT = 10.0
+SENDS_TIMEOUT = 5.0
+WS_MSG_JPEG = 1
+
+
+def percentile(values, p):
+    if not values:
+        return None
+    values = sorted(values)
+    return values[min(len(values) - 1, int(round(p / 100.0 * (len(values) - 1))))]
+
+
+def ms(seconds):
+    return None if seconds is None else round(seconds * 1000.0, 3)
+
+
+def avi_chunks(data, start, end):
+    """(position, fourcc, size) of each RIFF chunk between start and end."""
+    pos = start
+    while pos + 8 <= end:
+        fourcc = data[pos:pos + 4]
+        size = struct.unpack_from("<I", data, pos + 4)[0]
+        yield pos, fourcc, size
+        pos += 8 + size + (size & 1)
+
+
+def extract_avi(path, out_dir):
+    """Writes the 00dc chunks in an AVI clip's movi list as numbered JPEG files."""
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[0:4] != b"RIFF" or data[8:12] != b"AVI ":
+        sys.exit("%s: not a RIFF AVI file" % path)
+    # A clip cut off by a reset keeps its preallocated tail past the RIFF data
+    end = min(len(data), struct.unpack_from("<I", data, 4)[0] + 8)
+    count = 0
+    for pos, fourcc, size in avi_chunks(data, 12, end):
+        if fourcc != b"LIST" or data[pos + 8:pos + 12] != b"movi":
+            continue
+        for fpos, ffourcc, fsize in avi_chunks(data, pos + 12, min(end, pos + 8 + size)):
+            frame = data[fpos + 8:fpos + 8 + fsize]
+            if ffourcc == b"00dc" and frame[:2] == b"\xff\xd8" and frame[-2:] == b"\xff\xd9":
+                with open(os.path.join(out_dir, "%06d.jpg" % count), "wb") as f:
+                    f.write(frame)
+                count += 1
+    if not count:
+        sys.exit("%s: no JPEG frames found" % path)
+    return count
+
+
+def jpeg_size(frames_dir):
+    """Width x height of the first JPEG in the directory, from its SOF marker."""
+    names = sorted(n for n in os.listdir(frames_dir) if n.lower().endswith((".jpg", ".jpeg")))
+    if not names:
+        return None
+    with open(os.path.join(frames_dir, names[0]), "rb") as f:
+        data = f.read()
+    pos = 2
+    while pos + 4 <= len(data) and data[pos] == 0xFF:
+        marker = data[pos + 1]
+        length = struct.unpack_from(">H", data, pos + 2)[0]
+        if 0xC0 <= marker <= 0xCF and marker not in (0xC4, 0xC8, 0xCC) and pos + 9 <= len(data):
+            height, width = struct.unpack_from(">HH", data, pos + 5)
+            return "%dx%d" % (width, height)
+        pos += 2 + length
+    return None
+
+
+class Server:
+    """One native program, from start until the ports answer, and its CPU time."""
+
+    def __init__(self, args, frames):
+        cmd = [args.program, "--frames", frames, "--fps", str(args.fps), "--port-offset", str(args.port_offset)]
+        if args.audio:
+            cmd += ["--audio", args.audio]
+        self.port_offset = args.port_offset
+        self.origin = None
+        self.log = []
+        self.sends = None
+        self.sends_ready = threading.Condition()
+        self.proc = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True)
+        self.reader = threading.Thread(target=self.read_log, daemon=True)
+        self.reader.start()
+        self.wait_ready()
+
+    def read_log(self):
+        for line in self.proc.stdout:
+            self.log.append(line.rstrip())
+            match = re.match(r"host: esp_timer starts at CLOCK_MONOTONIC (\d+)\.(\d+)", line)
+            if match:
+                self.origin = int(match.group(1)) + int(match.group(2)) / 1e6
+            match = re.match(r"host: socket sends (\d+)", line)
+            if match:
+                with self.sends_ready:
+                    self.sends = int(match.group(1))
+                    self.sends_ready.notify_all()
+
+    def wait_ready(self):
+        deadline = time.monotonic() + STARTUP_TIMEOUT
+        while time.monotonic() < deadline:
+            if self.proc.poll() is not None:
+                sys.exit("server exited:\n" + "\n".join(self.log))
+            if self.origin is not None:
+                try:
+                    for port in (PORT_HTTP, PORT_STREAM, PORT_AUDIO):
+                        socket.create_connection(("127.0.0.1", self.port(port)), 1).close()
+                    return
+                except OSError:
+                    pass
+            time.sleep(0.05)
+        self.stop()
+        sys.exit("server did not come up:\n" + "\n".join(self.log))
+
+    def port(self, port):
+        return port + self.port_offset
+
+    def cpu_seconds(self):
+        with open("/proc/%d/stat" % self.proc.pid) as f:
+            fields = f.read().rsplit(")", 1)[1].split()
+        # utime and stime are fields 14 and 15, counted from the pid
+        return (int(fields[11]) + int(fields[12])) / os.sysconf("SC_CLK_TCK")
+
+    def socket_sends(self):
+        """Asks the program for its send counter; None when it does not answer."""
+        with self.sends_ready:
+            self.sends = None
+            self.proc.send_signal(signal.SIGUSR1)
+            self.sends_ready.wait_for(lambda: self.sends is not None, SENDS_TIMEOUT)
+            return self.sends
+
+    def metric(self, name):
+        url = "http://127.0.0.1:%d/metrics" % self.port(PORT_HTTP)
+        with urllib.request.urlopen(url, timeout=5) as r:
+            for line in r.read().decode().splitlines():
+                if line.startswith(name + " "):
+                    return float(line.split()[1])
+        return None
+
+    def stop(self):
+        self.proc.terminate()
+        try:
+            self.proc.wait(5)
+        except subprocess.TimeoutExpired:
+            self.proc.kill()
+            self.proc.wait()
+
+
+class Client(threading.Thread):
+    """Base for one loopback client; run() fills in the counters until deadline."""
+
+    def __init__(self, server, deadline):
+        super().__init__(daemon=True)
+        self.server = server
+        self.deadline = deadline
+        self.started = None
+        self.first = None  # Time the first frame or block was complete
+        self.frames = 0
+        self.bytes = 0
+        self.latency = []
+        self.error = None
+
+    def connect(self, port, path):
+        sock = socket.create_connection(("127.0.0.1", self.server.port(port)), 5)
+        sock.settimeout(max(0.1, self.deadline - time.monotonic()))
+        sock.sendall(("GET %s HTTP/1.1\r\nHost: bench\r\n\r\n" % path).encode())
+        return sock
+
+    def recv(self, sock):
+        data = sock.recv(RECV_SIZE)
+        if not data:
+            raise OSError("connection closed")
+        self.bytes += len(data)
+        return data
+
+    def read_head(self, sock, status=b"HTTP/1.1 200"):
+        """Reads up to the end of the response headers; returns what came after them."""
+        buf = b""
+        while b"\r\n\r\n" not in buf:
+            buf += self.recv(sock)
+        head, buf = buf.split(b"\r\n\r\n", 1)
+        if not head.startswith(status):
+            raise OSError(head.split(b"\r\n")[0].decode())
+        self.head = head
+        return buf
+
+    def age(self, timestamp_us):
+        return time.monotonic() - (self.server.origin + timestamp_us / 1e6)
+
+    def run(self):
+        self.started = time.monotonic()
+        try:
+            self.receive()
+        except socket.timeout:
+            pass
+        except OSError as e:
+            self.error = str(e)
+
+    def result(self, seconds):
+        return {
+            "frames": self.frames,
+            "bytes": self.bytes,
+            "fps": round(self.frames / seconds, 2),
+            "bytes_per_second": round(self.bytes / seconds),
+            "first_frame_ms": ms(self.first - self.started) if self.first else None,
+            "latency_p50_ms": ms(percentile(self.latency, 50)),
+            "latency_p99_ms": ms(percentile(self.latency, 99)),
+            "error": self.error,
+        }
+
+
+class StreamClient(Client):
+    """Reads multipart parts; latency is from X-Timestamp to the end of the part."""
+
+    def __init__(self, server, deadline, path):
+        super().__init__(server, deadline)
+        self.path = path
+
+    def receive(self):
+        sock = self.connect(PORT_STREAM, self.path)
+        with sock:
+            buf = self.read_head(sock)
+            while time.monotonic() < self.deadline:
+                head = buf.find(b"\r\n\r\n")
+                match = re.search(rb"Content-Length: (\d+)", buf[:head]) if head >= 0 else None
+                if match:
+                    end = head + 4 + int(match.group(1))
+                    if len(buf) >= end:
+                        stamp = re.search(rb"X-Timestamp: (\d+)\.(\d+)", buf[:head])
+                        if stamp:
+                            self.latency.append(self.age(int(stamp.group(1)) * 1000000 + int(stamp.group(2))))
+                        self.first = self.first or time.monotonic()
+                        self.frames += 1
+                        buf = buf[end:]
+                        continue
+                buf += self.recv(sock)
+
+class CaptureClient(Client):
+    """Asks for /capture over one keep-alive connection, as fast as answers come."""
+
+    def receive(self):
+        sock = socket.create_connection(("127.0.0.1", self.server.port(PORT_HTTP)), 5)
+        with sock:
+            while time.monotonic() < self.deadline:
+                sock.settimeout(max(0.1, self.deadline - time.monotonic()))
+                sock.sendall(b"GET /capture HTTP/1.1\r\nHost: bench\r\n\r\n")
+                buf = self.read_head(sock)
+                head = self.head
+                length = int(re.search(rb"(?i)content-length: (\d+)", head).group(1))
+                while len(buf) < length:
+                    buf += self.recv(sock)
+                stamp = re.search(rb"X-Frame-Timestamp: (\d+)", head)
+                if stamp:
+                    self.latency.append(self.age(int(stamp.group(1)) * 1000))
+                self.first = self.first or time.monotonic()
+                self.frames += 1
+
+
+class AudioClient(Client):
+    """Reads the WAV stream, chunked or delimited by the close. Latency is
+    how far each read lags the header's byte rate, over the read that came
+    earliest against it, so it is the jitter the player's buffer has to
+    cover."""
+
+    def receive(self):
+        sock = self.connect(PORT_AUDIO, "/")
+        self.byte_rate = None
+        with sock:
+            buf = self.read_head(sock)
+            chunked = re.search(rb"(?i)transfer-encoding: chunked", self.head) is not None
+            audio = 0
+            while time.monotonic() < self.deadline:
+                data = None
+                if not chunked and buf:
+                    data, buf = buf, b""
+                line = buf.find(b"\r\n") if chunked else -1
+                size = int(buf[:line], 16) if line > 0 else -1
+                if size >= 0 and len(buf) >= line + 2 + size + 2:
+                    data = buf[line + 2:line + 2 + size]
+                    buf = buf[line + 2 + size + 2:]
+                    if not size:
+                        break
+                if data is None:
+                    buf += self.recv(sock)
+                    continue
+                if self.byte_rate is None:
+                    # RIFF, then the fmt chunk with the byte rate at 28
+                    if len(data) < 44:
+                        buf = data + buf
+                        buf += self.recv(sock)
+                        continue
+                    self.byte_rate = struct.unpack_from("<I", data, 28)[0]
+                    self.first = time.monotonic()
+                    audio = len(data) - (data.find(b"data") + 8)
+                    continue
+                audio += len(data)
+                self.latency.append(time.monotonic() - (self.first + audio / self.byte_rate))
+                self.frames += 1
+
+    def result(self, seconds):
+        if self.latency:
+            earliest = min(self.latency)
+            self.latency = [l - earliest for l in self.latency]
+        result = super().result(seconds)
+        result["expected_bytes_per_second"] = self.byte_rate
+        return result
+
+
+class WsClient(Client):
+    """Reads JPEG messages from /ws; latency is from the message timestamp to
+    the end of the message, as for the stream."""
+
+    def receive(self):
+        sock = socket.create_connection(("127.0.0.1", self.server.port(PORT_HTTP)), 5)
+        sock.settimeout(max(0.1, self.deadline - time.monotonic()))
+        key = base64.b64encode(os.urandom(16)).decode()
+        sock.sendall(("GET /ws?video=main&events=0 HTTP/1.1\r\nHost: bench\r\nUpgrade: websocket\r\n"
+                      "Connection: Upgrade\r\nSec-WebSocket-Key: %s\r\nSec-WebSocket-Version: 13\r\n\r\n" % key).encode())
+        with sock:
+            buf = self.read_head(sock, b"HTTP/1.1 101")
+            while time.monotonic() < self.deadline:
+                if len(buf) >= 2:
+                    size = buf[1] & 0x7f
+                    start = 2 + {126: 2, 127: 8}.get(size, 0)
+                    if len(buf) >= start:
+                        if size >= 126:
+                            size = int.from_bytes(buf[2:start], "big")
+                        if len(buf) >= start + size:
+                            kind, seq, stamp = struct.unpack_from("<B3xIq", buf, start)
+                            if kind == WS_MSG_JPEG:
+                                self.latency.append(self.age(stamp))
+                                self.first = self.first or time.monotonic()
+                                self.frames += 1
+                            buf = buf[start + size:]
+                            continue
+                buf += self.recv(sock)
+
+
+def make_client(handler, server, deadline):
+    if handler == "stream":
+        return StreamClient(server, deadline, "/")
+    if handler == "sub":
+        return StreamClient(server, deadline, "/sub")
+    if handler == "capture":
+        return CaptureClient(server, deadline)
+    if handler == "ws":
+        return WsClient(server, deadline)
+    return AudioClient(server, deadline)
+
+
+def substream_step_seconds(server):
+    return {step: server.metric('esp32cam_substream_step_seconds_total{step="%s"}' % step)
+            for step in SUBSTREAM_STEPS}
+
+
+def run(args, frames, handler, count):
+    server = Server(args, frames)
+    try:
+        cpu_before = server.cpu_seconds()
+        camera_before = server.metric("esp32cam_capture_frames_total")
+        sub_before = server.metric("esp32cam_substream_frames_total")
+        steps_before = substream_step_seconds(server)
+        sends_before = server.socket_sends()
+        started = time.monotonic()
+        clients = [make_client(handler, server, started + args.seconds) for _ in range(count)]
+        for client in clients:
+            client.start()
+        for client in clients:
+            client.join(args.seconds + 10)
+        seconds = time.monotonic() - started
+        cpu = server.cpu_seconds() - cpu_before
+        sends_after = server.socket_sends()
+        camera = server.metric("esp32cam_capture_frames_total") - camera_before
+        sub = server.metric("esp32cam_substream_frames_total") - sub_before
+        steps_after = substream_step_seconds(server)
+    finally:
+        server.stop()
+
+    results = [client.result(seconds) for client in clients]
+    delivered = sum(c.frames for c in clients)
+    latency = [l for c in clients for l in c.latency]
+    unit = "block" if handler == "audio" else "frame"
+    # /metrics answers itself count too, one scrape in each reading
+    sends = sends_after - sends_before if sends_before is not None and sends_after is not None else None
+    sub_steps = {}
+    for step in SUBSTREAM_STEPS:
+        known = steps_before[step] is not None and steps_after[step] is not None
+        sub_steps[step] = ms((steps_after[step] - steps_before[step]) / sub) if known and sub else None
+    return {
+        "handler": handler,
+        "clients": count,
+        "frame_size": jpeg_size(frames),
+        "seconds": round(seconds, 3),
+        "server_cpu_seconds": round(cpu, 3),
+        "server_cpu_percent": round(100.0 * cpu / seconds, 1),
+        "camera_frames": int(camera),
+        "substream_frames": int(sub),
+        "substream_ms_per_frame": sub_steps,
+        "delivered_%ss" % unit: delivered,
+        "cpu_ms_per_delivered_%s" % unit: ms(cpu / delivered) if delivered else None,
+        "cpu_ms_per_camera_frame": ms(cpu / camera) if camera else None,
+        "socket_sends": sends,
+        "socket_sends_per_delivered_%s" % unit: round(sends / delivered, 2) if sends is not None and delivered else None,
+        "fps": round(delivered / seconds, 2),
+        "bytes_per_second": sum(r["bytes_per_second"] for r in results),
+        "latency_p50_ms": ms(percentile(latency, 50)),
+        "latency_p99_ms": ms(percentile(latency, 99)),
+        "per_client": results,
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--program", default=".pio/build/native/program")
+    parser.add_argument("--frames", required=True, action="append",
+                        help="Directory of JPEG files, or an AVI clip; may be given more than once")
+    parser.add_argument("--audio", help="16-bit mono PCM WAV file")
+    parser.add_argument("--fps", type=int, default=20, help="Camera frame rate, 0 for as fast as asked")
+    parser.add_argument("--clients", type=int, default=4, help="Runs each handler with 1 up to this many clients")
+    parser.add_argument("--seconds", type=float, default=5.0, help="Length of each run")
+    parser.add_argument("--handlers", default=",".join(HANDLERS))
+    parser.add_argument("--port-offset", type=int, default=8000)
+    parser.add_argument("-o", "--output", help="Write the JSON here instead of stdout")
+    args = parser.parse_args()
+
+    handlers = args.handlers.split(",")
+    for handler in handlers:
+        if handler not in HANDLERS:
+            parser.error("unknown handler %s" % handler)
+
+    sources = args.frames
+    clip_dirs = []
+    runs = []
+    try:
+        for source in sources:
+            frames = source
+            if os.path.isfile(source):
+                frames = tempfile.mkdtemp(prefix="bench-frames-")
+                clip_dirs.append(frames)
+                extract_avi(source, frames)
+            for handler in handlers:
+                for count in range(1, args.clients + 1):
+                    print("bench: %s, %s with %d client(s)" % (source, handler, count), file=sys.stderr)
+                    result = run(args, frames, handler, count)
+                    result["frames"] = source
+                    runs.append(result)
+    finally:
+        for clip_dir in clip_dirs:
+            shutil.rmtree(clip_dir)
+
+    report = {
+        "config": {
+            "frames": sources,
+            "audio": args.audio,
+            "fps": args.fps,
+            "seconds": args.seconds,
+            "clients": args.clients,
+            "cpus": os.cpu_count(),
+        },
+        "runs": runs,
+    }
+    text = json.dumps(report, indent=2, sort_keys=True)
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write(text + "\n")
+    else:
+        print(text)
+
+
+if __name__ == "__main__":
+    main()
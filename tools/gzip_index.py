@@ -0,0 +1,91 @@
+"""Builds include/index_page_gz.h, the gzip copy of the web page.
+
+Runs before every PlatformIO build (extra_scripts = pre:tools/gzip_index.py)
+and can be run by hand: python3 tools/gzip_index.py [--check].
+
+The page stays editable in include/index_page.h. The output is deterministic
+(no timestamp or file name in the gzip header), so the ETags only change when
+the page does, and the header is only rewritten then. The build fails if the
+compressed page is larger than MAX_RATIO of the original.
+"""
+
+import gzip
+import hashlib
+import os
+import re
+import sys
+
+MAX_RATIO = 0.25
+
+if "__file__" in globals():
+    ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+else:
+    Import("env")  # noqa: F821 - PlatformIO runs this file with exec()
+    ROOT = env["PROJECT_DIR"]  # noqa: F821
+
+SOURCE = os.path.join(ROOT, "include", "index_page.h")
+OUTPUT = os.path.join(ROOT, "include", "index_page_gz.h")
+
+
+def page_bytes():
+    with open(SOURCE, "r", encoding="utf-8") as f:
+        text = f.read()
+    match = re.search(r'R"=====\((.*)\)====="', text, re.S)
+    if not match:
+        raise SystemExit("gzip_index: no raw string literal in " + SOURCE)
+    return match.group(1).encode("utf-8")
+
+
+def render(page):
+    compressed = gzip.compress(page, compresslevel=9, mtime=0)
+    if len(compressed) > len(page) * MAX_RATIO:
+        raise SystemExit("gzip_index: page compresses to %d of %d bytes, more than %d%%"
+                         % (len(compressed), len(page), MAX_RATIO * 100))
+    etag = hashlib.sha256(page).hexdigest()[:16]
+
+    lines = [
+        "// Generated by tools/gzip_index.py from index_page.h; do not edit.",
+        "#pragma once",
+        "",
+        "#include <stddef.h>",
+        "#include <stdint.h>",
+        "",
+        '#define INDEX_PAGE_ETAG "\\"%s\\""       // The page as it is' % etag,
+        '#define INDEX_PAGE_ETAG_GZ "\\"%s-gz\\"" // This gzip copy of it' % etag,
+        "",
+        "// %d bytes, %d uncompressed" % (len(compressed), len(page)),
+        "const uint8_t index_simple_html_gz[] = {",
+    ]
+    for i in range(0, len(compressed), 16):
+        lines.append("    " + ", ".join("0x%02x" % b for b in compressed[i:i + 16]) + ",")
+    lines += [
+        "};",
+        "const size_t index_simple_html_gz_len = sizeof(index_simple_html_gz);",
+        "",
+    ]
+    return "\n".join(lines), len(compressed)
+
+
+def main(check=False):
+    page = page_bytes()
+    header, size = render(page)
+    current = None
+    if os.path.exists(OUTPUT):
+        with open(OUTPUT, "r", encoding="utf-8") as f:
+            current = f.read()
+    if current == header:
+        print("gzip_index: index page %d -> %d bytes, up to date" % (len(page), size))
+        return 0
+    if check:
+        print("gzip_index: %s is out of date" % OUTPUT)
+        return 1
+    with open(OUTPUT, "w", encoding="utf-8") as f:
+        f.write(header)
+    print("gzip_index: index page %d -> %d bytes, written" % (len(page), size))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main("--check" in sys.argv[1:]))
+else:
+    main()